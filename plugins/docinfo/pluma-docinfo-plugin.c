@@ -40,6 +40,20 @@
 
 #define MENU_PATH "/MenuBar/ToolsMenu/ToolsOps_2"
 
+/* Text is counted in chunks of about this many characters, so that the
+ * memory needed does not depend on the size of the document. */
+#define CHUNK_CHARS		65536
+
+/* In live mode an edit recounts the text up to the white spaces around
+ * it, which are looked for at most this many characters away; past that
+ * the whole line is recounted. */
+#define MAX_WORD_SCAN		4096
+
+/* Time spent counting in each idle slice, in microseconds */
+#define SCAN_TIME_SLICE		10000
+
+#define PENDING_COUNT		"\342\200\246"
+
 static void pluma_window_activatable_iface_init (PlumaWindowActivatableInterface *iface);
 
 typedef struct
@@ -57,8 +71,19 @@ typedef struct
 	GtkWidget *selected_chars_label;
 	GtkWidget *selected_chars_ns_label;
 	GtkWidget *selected_bytes_label;
+	GtkWidget *live_checkbutton;
 } DocInfoDialog;
 
+typedef struct
+{
+	gint chars;
+	gint words;
+	gint white_chars;
+	gint bytes;
+} DocInfoCounts;
+
+typedef struct _DocInfoScan DocInfoScan;
+
 struct _PlumaDocInfoPluginPrivate
 {
 	PlumaWindow *window;
@@ -67,6 +92,49 @@ struct _PlumaDocInfoPluginPrivate
 	guint ui_id;
 
 	DocInfoDialog *dialog;
+
+	/* document shown in the dialog */
+	PlumaDocument *doc;
+
+	DocInfoScan *doc_scan;
+	DocInfoScan *selection_scan;
+
+	/* valid once the document has been counted; in live mode the counts
+	 * are then kept up to date from the edits */
+	DocInfoCounts doc_counts;
+	gboolean counts_valid;
+
+	gboolean live;
+	guint refresh_id;
+
+	/* start offset of the text around an edit in progress, its old
+	 * counts have been subtracted from doc_counts */
+	gint edit_start;
+	gboolean edit_pending;
+};
+
+typedef void (* DocInfoScanDone) (PlumaDocInfoPluginPrivate *data,
+				  DocInfoScan               *scan);
+
+/* Counts a range of the document in idle slices */
+struct _DocInfoScan
+{
+	PlumaDocInfoPluginPrivate *data;
+
+	GtkTextMark *pos;
+	GtkTextMark *end;
+
+	DocInfoCounts counts;
+	gint lines;
+
+	PangoLogAttr *attrs;
+	gint n_attrs;
+
+	/* the last chunk ended inside a word */
+	gboolean in_word;
+
+	guint idle_id;
+	DocInfoScanDone done;
 };
 
 G_DEFINE_DYNAMIC_TYPE_EXTENDED (PlumaDocInfoPlugin,
@@ -86,6 +154,12 @@ static void docinfo_dialog_response_cb (GtkDialog   *widget,
 					gint	    res_id,
 					PlumaDocInfoPluginPrivate *data);
 
+static void live_toggled_cb (GtkToggleButton           *button,
+			     PlumaDocInfoPluginPrivate *data);
+
+static void set_document (PlumaDocInfoPluginPrivate *data,
+			  PlumaDocument             *doc);
+
 static void
 docinfo_dialog_destroy_cb (GObject  *obj,
 			   PlumaDocInfoPluginPrivate *data)
@@ -94,6 +168,14 @@ docinfo_dialog_destroy_cb (GObject  *obj,
 
 	if (data != NULL)
 	{
+		set_document (data, NULL);
+
+		if (data->refresh_id != 0)
+		{
+			g_source_remove (data->refresh_id);
+			data->refresh_id = 0;
+		}
+
 		g_free (data->dialog);
 		data->dialog = NULL;
 	}
@@ -137,6 +219,7 @@ get_docinfo_dialog (PlumaDocInfoPlugin *plugin)
 					  "selected_lines_label", &dialog->selected_lines_label,
 					  "selected_chars_label", &dialog->selected_chars_label,
 					  "selected_chars_ns_label", &dialog->selected_chars_ns_label,
+					  "live_checkbutton", &dialog->live_checkbutton,
 					  NULL);
 
 	g_free (data_dir);
@@ -160,6 +243,9 @@ get_docinfo_dialog (PlumaDocInfoPlugin *plugin)
 	gtk_window_set_transient_for (GTK_WINDOW (dialog->dialog),
 				      GTK_WINDOW (window));
 
+	gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (dialog->live_checkbutton),
+				      data->live);
+
 	g_signal_connect (dialog->dialog,
 			  "destroy",
 			  G_CALLBACK (docinfo_dialog_destroy_cb),
@@ -170,189 +256,713 @@ get_docinfo_dialog (PlumaDocInfoPlugin *plugin)
 			  G_CALLBACK (docinfo_dialog_response_cb),
 			  data);
 
+	g_signal_connect (dialog->live_checkbutton,
+			  "toggled",
+			  G_CALLBACK (live_toggled_cb),
+			  data);
+
 	return dialog;
 }
 
+/* Words do not span lines, so a chunk normally ends at the start of a
+ * line. Returns TRUE when a line longer than a chunk has to be split. */
+static gboolean
+get_chunk_end (const GtkTextIter *start,
+	       const GtkTextIter *end,
+	       GtkTextIter       *chunk_end)
+{
+	GtkTextIter line_start;
+
+	*chunk_end = *start;
+
+	if (!gtk_text_iter_forward_chars (chunk_end, CHUNK_CHARS) ||
+	    gtk_text_iter_compare (chunk_end, end) >= 0)
+	{
+		*chunk_end = *end;
+		return FALSE;
+	}
+
+	if (gtk_text_iter_starts_line (chunk_end))
+		return FALSE;
+
+	line_start = *chunk_end;
+	gtk_text_iter_set_line_offset (&line_start, 0);
+
+	if (gtk_text_iter_compare (&line_start, start) > 0)
+	{
+		*chunk_end = line_start;
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Counts the chunk starting at @iter and moves @iter to its end. A split
+ * line is cut at a word start in the second half of the chunk, and the
+ * rest of the line goes with the next chunk. When a word does not fit in
+ * that half, @in_word tells the next chunk that it starts inside it. */
 static void
-calculate_info (PlumaDocument *doc,
-		GtkTextIter   *start,
-		GtkTextIter   *end,
-		gint          *chars,
-		gint          *words,
-		gint          *white_chars,
-		gint          *bytes)
+count_next_chunk (GtkTextIter       *iter,
+		  const GtkTextIter *end,
+		  DocInfoCounts     *counts,
+		  PangoLogAttr     **attrs,
+		  gint              *n_attrs,
+		  gboolean          *in_word)
 {
+	GtkTextIter chunk_end;
+	gboolean split;
+	gboolean inside = FALSE;
 	gchar *text;
+	gint len;
+	gint chars;
+	gint counted;
+	gint i;
 
-	pluma_debug (DEBUG_PLUGINS);
+	split = get_chunk_end (iter, end, &chunk_end);
+
+	text = gtk_text_iter_get_slice (iter, &chunk_end);
+	len = strlen (text);
+	chars = g_utf8_strlen (text, len);
+
+	if (chars == 0)
+	{
+		g_free (text);
+		*iter = chunk_end;
+		return;
+	}
+
+	if (*n_attrs < chars + 1)
+	{
+		*n_attrs = chars + 1;
+		*attrs = g_renew (PangoLogAttr, *attrs, *n_attrs);
+	}
 
-	text = gtk_text_buffer_get_slice (GTK_TEXT_BUFFER (doc),
-					  start,
-					  end,
-					  TRUE);
+	pango_get_log_attrs (text,
+			     len,
+			     0,
+			     pango_language_from_string ("C"),
+			     *attrs,
+			     chars + 1);
 
-	*chars = g_utf8_strlen (text, -1);
-	*bytes = strlen (text);
+	counted = chars;
 
-	if (*chars > 0)
+	if (split)
 	{
-		PangoLogAttr *attrs;
-		gint i;
+		for (i = chars - 1; i > 0 && i >= chars / 2; i--)
+		{
+			if ((*attrs)[i].is_word_start)
+			{
+				counted = i;
+				break;
+			}
+		}
+	}
 
-		attrs = g_new0 (PangoLogAttr, *chars + 1);
+	for (i = 0; i < counted; i++)
+	{
+		if ((*attrs)[i].is_white)
+			++counts->white_chars;
 
-		pango_get_log_attrs (text,
-				     -1,
-				     0,
-				     pango_language_from_string ("C"),
-				     attrs,
-				     *chars + 1);
+		if ((*attrs)[i].is_word_end)
+			inside = FALSE;
 
-		for (i = 0; i < (*chars); i++)
+		if ((*attrs)[i].is_word_start)
 		{
-			if (attrs[i].is_white)
-				++(*white_chars);
+			if (i > 0 || !*in_word)
+				++counts->words;
 
-			if (attrs[i].is_word_start)
-				++(*words);
+			inside = TRUE;
 		}
+	}
+
+	if (counted < chars)
+	{
+		counts->bytes += g_utf8_offset_to_pointer (text, counted) - text;
 
-		g_free (attrs);
+		chunk_end = *iter;
+		gtk_text_iter_forward_chars (&chunk_end, counted);
 	}
 	else
 	{
-		*white_chars = 0;
-		*words = 0;
+		counts->bytes += len;
 	}
 
+	counts->chars += counted;
+
+	*in_word = split && counted == chars && inside;
+
 	g_free (text);
+
+	*iter = chunk_end;
 }
 
 static void
-docinfo_real (PlumaDocument *doc,
-	      DocInfoDialog *dialog)
+calculate_info (const GtkTextIter *start,
+		const GtkTextIter *end,
+		DocInfoCounts     *counts)
 {
-	GtkTextIter start, end;
-	gint words = 0;
-	gint chars = 0;
-	gint white_chars = 0;
-	gint lines = 0;
-	gint bytes = 0;
-	gchar *tmp_str;
-	gchar *doc_name;
+	GtkTextIter iter;
+	PangoLogAttr *attrs = NULL;
+	gint n_attrs = 0;
+	gboolean in_word = FALSE;
 
-	pluma_debug (DEBUG_PLUGINS);
+	iter = *start;
 
-	gtk_text_buffer_get_bounds (GTK_TEXT_BUFFER (doc),
-				    &start,
-				    &end);
+	while (gtk_text_iter_compare (&iter, end) < 0)
+		count_next_chunk (&iter, end, counts, &attrs, &n_attrs, &in_word);
 
-	lines = gtk_text_buffer_get_line_count (GTK_TEXT_BUFFER (doc));
+	g_free (attrs);
+}
 
-	calculate_info (doc,
-			&start, &end,
-			&chars, &words, &white_chars, &bytes);
+/* Moves @iter back after the white space preceding it. Words are counted
+ * the same in the text between two white spaces as in the whole line. */
+static void
+backward_to_word_bound (GtkTextIter *iter)
+{
+	gint i;
 
-	if (chars == 0)
-		lines = 0;
+	for (i = 0; i < MAX_WORD_SCAN; i++)
+	{
+		if (gtk_text_iter_is_start (iter))
+			return;
 
-	pluma_debug_message (DEBUG_PLUGINS, "Chars: %d", chars);
-	pluma_debug_message (DEBUG_PLUGINS, "Lines: %d", lines);
-	pluma_debug_message (DEBUG_PLUGINS, "Words: %d", words);
-	pluma_debug_message (DEBUG_PLUGINS, "Chars non-space: %d", chars - white_chars);
-	pluma_debug_message (DEBUG_PLUGINS, "Bytes: %d", bytes);
+		gtk_text_iter_backward_char (iter);
 
-	doc_name = pluma_document_get_short_name_for_display (doc);
+		if (g_unichar_isspace (gtk_text_iter_get_char (iter)))
+		{
+			gtk_text_iter_forward_char (iter);
+			return;
+		}
+	}
+
+	gtk_text_iter_set_line_offset (iter, 0);
+}
+
+/* Moves @iter forward to the next white space */
+static void
+forward_to_word_bound (GtkTextIter *iter)
+{
+	gint i;
+
+	for (i = 0; i < MAX_WORD_SCAN; i++)
+	{
+		if (gtk_text_iter_is_end (iter) ||
+		    g_unichar_isspace (gtk_text_iter_get_char (iter)))
+			return;
+
+		gtk_text_iter_forward_char (iter);
+	}
+
+	if (!gtk_text_iter_ends_line (iter))
+		gtk_text_iter_forward_to_line_end (iter);
+}
+
+static void
+counts_add (DocInfoCounts       *counts,
+	    const DocInfoCounts *other,
+	    gint                 sign)
+{
+	counts->chars += sign * other->chars;
+	counts->words += sign * other->words;
+	counts->white_chars += sign * other->white_chars;
+	counts->bytes += sign * other->bytes;
+}
+
+static void
+scan_free (DocInfoScan *scan)
+{
+	if (scan->idle_id != 0)
+		g_source_remove (scan->idle_id);
+
+	gtk_text_buffer_delete_mark (gtk_text_mark_get_buffer (scan->pos),
+				     scan->pos);
+	gtk_text_buffer_delete_mark (gtk_text_mark_get_buffer (scan->end),
+				     scan->end);
+
+	g_free (scan->attrs);
+	g_slice_free (DocInfoScan, scan);
+}
+
+static DocInfoScan *
+scan_new (PlumaDocInfoPluginPrivate *data,
+	  const GtkTextIter         *start,
+	  const GtkTextIter         *end,
+	  DocInfoScanDone            done)
+{
+	GtkTextBuffer *buffer;
+	DocInfoScan *scan;
+
+	buffer = GTK_TEXT_BUFFER (data->doc);
+
+	scan = g_slice_new0 (DocInfoScan);
+	scan->data = data;
+	scan->pos = gtk_text_buffer_create_mark (buffer, NULL, start, TRUE);
+	scan->end = gtk_text_buffer_create_mark (buffer, NULL, end, FALSE);
+	scan->done = done;
+
+	return scan;
+}
+
+/* Returns TRUE when the whole range has been counted */
+static gboolean
+scan_step (DocInfoScan *scan)
+{
+	GtkTextBuffer *buffer;
+	GtkTextIter iter, end;
+	gint64 start_time;
+
+	buffer = gtk_text_mark_get_buffer (scan->pos);
+	start_time = g_get_monotonic_time ();
+
+	gtk_text_buffer_get_iter_at_mark (buffer, &iter, scan->pos);
+	gtk_text_buffer_get_iter_at_mark (buffer, &end, scan->end);
+
+	while (gtk_text_iter_compare (&iter, &end) < 0)
+	{
+		count_next_chunk (&iter, &end, &scan->counts, &scan->attrs, &scan->n_attrs, &scan->in_word);
+
+		if (g_get_monotonic_time () - start_time > SCAN_TIME_SLICE)
+			break;
+	}
+
+	gtk_text_buffer_move_mark (buffer, scan->pos, &iter);
+
+	return gtk_text_iter_compare (&iter, &end) >= 0;
+}
+
+static gboolean
+scan_idle (DocInfoScan *scan)
+{
+	if (!scan_step (scan))
+		return G_SOURCE_CONTINUE;
+
+	scan->idle_id = 0;
+	scan->done (scan->data, scan);
+
+	return G_SOURCE_REMOVE;
+}
+
+/* Counts a first slice right away, so that small documents do not show
+ * pending labels at all. @done is responsible for freeing @scan. */
+static void
+scan_run (DocInfoScan *scan)
+{
+	if (scan_step (scan))
+	{
+		scan->done (scan->data, scan);
+		return;
+	}
+
+	scan->idle_id = g_idle_add ((GSourceFunc) scan_idle, scan);
+}
+
+static void
+set_label_count (GtkWidget *label,
+		 gint       count)
+{
+	gchar *tmp_str;
+
+	tmp_str = g_strdup_printf("%d", count);
+	gtk_label_set_text (GTK_LABEL (label), tmp_str);
+	g_free (tmp_str);
+}
+
+static void
+set_file_name (PlumaDocInfoPluginPrivate *data)
+{
+	gchar *tmp_str;
+	gchar *doc_name;
+
+	doc_name = pluma_document_get_short_name_for_display (data->doc);
 	tmp_str = g_strdup_printf ("<span weight=\"bold\">%s</span>", doc_name);
-	gtk_label_set_markup (GTK_LABEL (dialog->file_name_label), tmp_str);
+	gtk_label_set_markup (GTK_LABEL (data->dialog->file_name_label), tmp_str);
 	g_free (doc_name);
 	g_free (tmp_str);
+}
 
-	tmp_str = g_strdup_printf("%d", lines);
-	gtk_label_set_text (GTK_LABEL (dialog->lines_label), tmp_str);
-	g_free (tmp_str);
+static void
+show_document_counts (PlumaDocInfoPluginPrivate *data)
+{
+	DocInfoDialog *dialog = data->dialog;
+	DocInfoCounts *counts = &data->doc_counts;
+	gint lines = 0;
 
-	tmp_str = g_strdup_printf("%d", words);
-	gtk_label_set_text (GTK_LABEL (dialog->words_label), tmp_str);
-	g_free (tmp_str);
+	if (counts->chars > 0)
+		lines = gtk_text_buffer_get_line_count (GTK_TEXT_BUFFER (data->doc));
 
-	tmp_str = g_strdup_printf("%d", chars);
-	gtk_label_set_text (GTK_LABEL (dialog->chars_label), tmp_str);
-	g_free (tmp_str);
+	pluma_debug_message (DEBUG_PLUGINS, "Chars: %d", counts->chars);
+	pluma_debug_message (DEBUG_PLUGINS, "Lines: %d", lines);
+	pluma_debug_message (DEBUG_PLUGINS, "Words: %d", counts->words);
+	pluma_debug_message (DEBUG_PLUGINS, "Chars non-space: %d", counts->chars - counts->white_chars);
+	pluma_debug_message (DEBUG_PLUGINS, "Bytes: %d", counts->bytes);
+
+	set_label_count (dialog->lines_label, lines);
+	set_label_count (dialog->words_label, counts->words);
+	set_label_count (dialog->chars_label, counts->chars);
+	set_label_count (dialog->chars_ns_label, counts->chars - counts->white_chars);
+	set_label_count (dialog->bytes_label, counts->bytes);
+}
 
-	tmp_str = g_strdup_printf("%d", chars - white_chars);
-	gtk_label_set_text (GTK_LABEL (dialog->chars_ns_label), tmp_str);
-	g_free (tmp_str);
+static void
+document_scan_done (PlumaDocInfoPluginPrivate *data,
+		    DocInfoScan               *scan)
+{
+	data->doc_counts = scan->counts;
+	data->counts_valid = TRUE;
 
-	tmp_str = g_strdup_printf("%d", bytes);
-	gtk_label_set_text (GTK_LABEL (dialog->bytes_label), tmp_str);
-	g_free (tmp_str);
+	scan_free (scan);
+	data->doc_scan = NULL;
+
+	show_document_counts (data);
 }
 
 static void
-selectioninfo_real (PlumaDocument *doc,
-		    DocInfoDialog *dialog)
+docinfo_real (PlumaDocInfoPluginPrivate *data)
 {
-	gboolean sel;
+	DocInfoDialog *dialog = data->dialog;
+	GtkTextBuffer *buffer;
 	GtkTextIter start, end;
-	gint words = 0;
-	gint chars = 0;
-	gint white_chars = 0;
+	gint chars;
 	gint lines = 0;
-	gint bytes = 0;
-	gchar *tmp_str;
 
 	pluma_debug (DEBUG_PLUGINS);
 
-	sel = gtk_text_buffer_get_selection_bounds (GTK_TEXT_BUFFER (doc),
+	buffer = GTK_TEXT_BUFFER (data->doc);
+
+	if (data->doc_scan != NULL)
+	{
+		scan_free (data->doc_scan);
+		data->doc_scan = NULL;
+	}
+
+	data->counts_valid = FALSE;
+
+	set_file_name (data);
+
+	/* Lines and characters are known right away, the other labels are
+	 * filled in once the text has been counted */
+	chars = gtk_text_buffer_get_char_count (buffer);
+
+	if (chars > 0)
+		lines = gtk_text_buffer_get_line_count (buffer);
+
+	set_label_count (dialog->lines_label, lines);
+	set_label_count (dialog->chars_label, chars);
+	gtk_label_set_text (GTK_LABEL (dialog->words_label), PENDING_COUNT);
+	gtk_label_set_text (GTK_LABEL (dialog->chars_ns_label), PENDING_COUNT);
+	gtk_label_set_text (GTK_LABEL (dialog->bytes_label), PENDING_COUNT);
+
+	gtk_text_buffer_get_bounds (buffer, &start, &end);
+
+	data->doc_scan = scan_new (data, &start, &end, document_scan_done);
+	scan_run (data->doc_scan);
+}
+
+static void
+show_selection_counts (DocInfoDialog       *dialog,
+		       gint                 lines,
+		       const DocInfoCounts *counts)
+{
+	if (counts->chars == 0)
+		lines = 0;
+
+	set_label_count (dialog->selected_lines_label, lines);
+	set_label_count (dialog->selected_words_label, counts->words);
+	set_label_count (dialog->selected_chars_label, counts->chars);
+	set_label_count (dialog->selected_chars_ns_label, counts->chars - counts->white_chars);
+	set_label_count (dialog->selected_bytes_label, counts->bytes);
+}
+
+static void
+selection_scan_done (PlumaDocInfoPluginPrivate *data,
+		     DocInfoScan               *scan)
+{
+	pluma_debug_message (DEBUG_PLUGINS, "Selected chars: %d", scan->counts.chars);
+	pluma_debug_message (DEBUG_PLUGINS, "Selected lines: %d", scan->lines);
+	pluma_debug_message (DEBUG_PLUGINS, "Selected words: %d", scan->counts.words);
+	pluma_debug_message (DEBUG_PLUGINS, "Selected chars non-space: %d", scan->counts.chars - scan->counts.white_chars);
+	pluma_debug_message (DEBUG_PLUGINS, "Selected bytes: %d", scan->counts.bytes);
+
+	show_selection_counts (data->dialog, scan->lines, &scan->counts);
+
+	scan_free (scan);
+	data->selection_scan = NULL;
+}
+
+static void
+selectioninfo_real (PlumaDocInfoPluginPrivate *data)
+{
+	DocInfoDialog *dialog = data->dialog;
+	gboolean sel;
+	GtkTextIter start, end;
+
+	pluma_debug (DEBUG_PLUGINS);
+
+	if (data->selection_scan != NULL)
+	{
+		scan_free (data->selection_scan);
+		data->selection_scan = NULL;
+	}
+
+	sel = gtk_text_buffer_get_selection_bounds (GTK_TEXT_BUFFER (data->doc),
 						    &start,
 						    &end);
 
 	if (sel)
 	{
-		lines = gtk_text_iter_get_line (&end) - gtk_text_iter_get_line (&start) + 1;
+		gint lines;
 
-		calculate_info (doc,
-				&start, &end,
-				&chars, &words, &white_chars, &bytes);
+		gtk_widget_set_sensitive (dialog->selection_vbox, TRUE);
 
-		pluma_debug_message (DEBUG_PLUGINS, "Selected chars: %d", chars);
-		pluma_debug_message (DEBUG_PLUGINS, "Selected lines: %d", lines);
-		pluma_debug_message (DEBUG_PLUGINS, "Selected words: %d", words);
-		pluma_debug_message (DEBUG_PLUGINS, "Selected chars non-space: %d", chars - white_chars);
-		pluma_debug_message (DEBUG_PLUGINS, "Selected bytes: %d", bytes);
+		lines = gtk_text_iter_get_line (&end) - gtk_text_iter_get_line (&start) + 1;
 
-		gtk_widget_set_sensitive (dialog->selection_vbox, TRUE);
+		set_label_count (dialog->selected_lines_label, lines);
+		set_label_count (dialog->selected_chars_label,
+				 gtk_text_iter_get_offset (&end) - gtk_text_iter_get_offset (&start));
+		gtk_label_set_text (GTK_LABEL (dialog->selected_words_label), PENDING_COUNT);
+		gtk_label_set_text (GTK_LABEL (dialog->selected_chars_ns_label), PENDING_COUNT);
+		gtk_label_set_text (GTK_LABEL (dialog->selected_bytes_label), PENDING_COUNT);
+
+		data->selection_scan = scan_new (data, &start, &end, selection_scan_done);
+		data->selection_scan->lines = lines;
+		scan_run (data->selection_scan);
 	}
 	else
 	{
+		DocInfoCounts counts = { 0, };
+
 		gtk_widget_set_sensitive (dialog->selection_vbox, FALSE);
 
 		pluma_debug_message (DEBUG_PLUGINS, "Selection empty");
+
+		show_selection_counts (dialog, 0, &counts);
 	}
+}
 
-	if (chars == 0)
-		lines = 0;
+static gboolean
+refresh_idle (PlumaDocInfoPluginPrivate *data)
+{
+	data->refresh_id = 0;
 
-	tmp_str = g_strdup_printf("%d", lines);
-	gtk_label_set_text (GTK_LABEL (dialog->selected_lines_label), tmp_str);
-	g_free (tmp_str);
+	/* A scan in progress has counted stale text, start it again */
+	if (data->doc_scan != NULL || (data->live && !data->counts_valid))
+	{
+		docinfo_real (data);
+	}
+	else if (data->live)
+	{
+		set_file_name (data);
+		show_document_counts (data);
+	}
 
-	tmp_str = g_strdup_printf("%d", words);
-	gtk_label_set_text (GTK_LABEL (dialog->selected_words_label), tmp_str);
-	g_free (tmp_str);
+	if (data->live || data->selection_scan != NULL)
+		selectioninfo_real (data);
 
-	tmp_str = g_strdup_printf("%d", chars);
-	gtk_label_set_text (GTK_LABEL (dialog->selected_chars_label), tmp_str);
-	g_free (tmp_str);
+	return G_SOURCE_REMOVE;
+}
 
-	tmp_str = g_strdup_printf("%d", chars - white_chars);
-	gtk_label_set_text (GTK_LABEL (dialog->selected_chars_ns_label), tmp_str);
-	g_free (tmp_str);
+static void
+schedule_refresh (PlumaDocInfoPluginPrivate *data)
+{
+	if (data->refresh_id == 0)
+		data->refresh_id = g_idle_add ((GSourceFunc) refresh_idle, data);
+}
 
-	tmp_str = g_strdup_printf("%d", bytes);
-	gtk_label_set_text (GTK_LABEL (dialog->selected_bytes_label), tmp_str);
-	g_free (tmp_str);
+static void
+document_changed_cb (GtkTextBuffer             *buffer,
+		     PlumaDocInfoPluginPrivate *data)
+{
+	if (!data->live)
+		data->counts_valid = FALSE;
+
+	if (data->live || data->doc_scan != NULL || data->selection_scan != NULL)
+		schedule_refresh (data);
+}
+
+static void
+mark_set_cb (GtkTextBuffer             *buffer,
+	     GtkTextIter               *location,
+	     GtkTextMark               *mark,
+	     PlumaDocInfoPluginPrivate *data)
+{
+	if (!data->live)
+		return;
+
+	if (mark == gtk_text_buffer_get_insert (buffer) ||
+	    mark == gtk_text_buffer_get_selection_bound (buffer))
+	{
+		schedule_refresh (data);
+	}
+}
+
+/* In live mode the counts of the text around an edit, up to the white
+ * spaces before and after it, are subtracted before the edit and the
+ * counts of the resulting text are added back after it, so that typing
+ * costs a recount of the current word only. The text before the edit
+ * does not change, so its start is kept as an offset. */
+static void
+insert_text_cb (GtkTextBuffer             *buffer,
+		GtkTextIter               *location,
+		gchar                     *text,
+		gint                       len,
+		PlumaDocInfoPluginPrivate *data)
+{
+	DocInfoCounts counts = { 0, };
+	GtkTextIter start, end;
+
+	if (!data->live || !data->counts_valid)
+		return;
+
+	start = *location;
+	backward_to_word_bound (&start);
+	end = *location;
+	forward_to_word_bound (&end);
+
+	data->edit_start = gtk_text_iter_get_offset (&start);
+	data->edit_pending = TRUE;
+
+	calculate_info (&start, &end, &counts);
+	counts_add (&data->doc_counts, &counts, -1);
+}
+
+static void
+insert_text_after_cb (GtkTextBuffer             *buffer,
+		      GtkTextIter               *location,
+		      gchar                     *text,
+		      gint                       len,
+		      PlumaDocInfoPluginPrivate *data)
+{
+	DocInfoCounts counts = { 0, };
+	GtkTextIter start, end;
+
+	if (!data->edit_pending)
+		return;
+
+	data->edit_pending = FALSE;
+
+	/* @location is at the end of the inserted text */
+	gtk_text_buffer_get_iter_at_offset (buffer, &start, data->edit_start);
+	end = *location;
+	forward_to_word_bound (&end);
+
+	calculate_info (&start, &end, &counts);
+	counts_add (&data->doc_counts, &counts, 1);
+}
+
+static void
+delete_range_cb (GtkTextBuffer             *buffer,
+		 GtkTextIter               *start,
+		 GtkTextIter               *end,
+		 PlumaDocInfoPluginPrivate *data)
+{
+	DocInfoCounts counts = { 0, };
+	GtkTextIter edit_start, edit_end;
+
+	if (!data->live || !data->counts_valid)
+		return;
+
+	edit_start = *start;
+	backward_to_word_bound (&edit_start);
+	edit_end = *end;
+	forward_to_word_bound (&edit_end);
+
+	data->edit_start = gtk_text_iter_get_offset (&edit_start);
+	data->edit_pending = TRUE;
+
+	calculate_info (&edit_start, &edit_end, &counts);
+	counts_add (&data->doc_counts, &counts, -1);
+}
+
+static void
+delete_range_after_cb (GtkTextBuffer             *buffer,
+		       GtkTextIter               *start,
+		       GtkTextIter               *end,
+		       PlumaDocInfoPluginPrivate *data)
+{
+	DocInfoCounts counts = { 0, };
+	GtkTextIter edit_start, edit_end;
+
+	if (!data->edit_pending)
+		return;
+
+	data->edit_pending = FALSE;
+
+	gtk_text_buffer_get_iter_at_offset (buffer, &edit_start, data->edit_start);
+	edit_end = *start;
+	forward_to_word_bound (&edit_end);
+
+	calculate_info (&edit_start, &edit_end, &counts);
+	counts_add (&data->doc_counts, &counts, 1);
+}
+
+static void
+set_document (PlumaDocInfoPluginPrivate *data,
+	      PlumaDocument             *doc)
+{
+	if (data->doc == doc)
+		return;
+
+	if (data->doc_scan != NULL)
+	{
+		scan_free (data->doc_scan);
+		data->doc_scan = NULL;
+	}
+
+	if (data->selection_scan != NULL)
+	{
+		scan_free (data->selection_scan);
+		data->selection_scan = NULL;
+	}
+
+	if (data->doc != NULL)
+	{
+		g_signal_handlers_disconnect_by_data (data->doc, data);
+		g_object_unref (data->doc);
+	}
+
+	data->doc = doc;
+	data->counts_valid = FALSE;
+	data->edit_pending = FALSE;
+
+	if (doc == NULL)
+		return;
+
+	g_object_ref (doc);
+
+	g_signal_connect (doc,
+			  "changed",
+			  G_CALLBACK (document_changed_cb),
+			  data);
+	g_signal_connect (doc,
+			  "mark-set",
+			  G_CALLBACK (mark_set_cb),
+			  data);
+	g_signal_connect (doc,
+			  "insert-text",
+			  G_CALLBACK (insert_text_cb),
+			  data);
+	g_signal_connect_after (doc,
+				"insert-text",
+				G_CALLBACK (insert_text_after_cb),
+				data);
+	g_signal_connect (doc,
+			  "delete-range",
+			  G_CALLBACK (delete_range_cb),
+			  data);
+	g_signal_connect_after (doc,
+				"delete-range",
+				G_CALLBACK (delete_range_after_cb),
+				data);
+}
+
+static void
+docinfo_update (PlumaDocInfoPluginPrivate *data,
+		PlumaDocument             *doc)
+{
+	set_document (data, doc);
+
+	docinfo_real (data);
+	selectioninfo_real (data);
 }
 
 static void
@@ -387,10 +997,29 @@ docinfo_cb (GtkAction	*action,
 		gtk_widget_show (GTK_WIDGET (dialog->dialog));
 	}
 
-	docinfo_real (doc,
-		      data->dialog);
-	selectioninfo_real (doc,
-			    data->dialog);
+	docinfo_update (data, doc);
+}
+
+static void
+live_toggled_cb (GtkToggleButton           *button,
+		 PlumaDocInfoPluginPrivate *data)
+{
+	PlumaDocument *doc;
+
+	pluma_debug (DEBUG_PLUGINS);
+
+	data->live = gtk_toggle_button_get_active (button);
+
+	if (!data->live)
+		return;
+
+	/* In live mode the dialog follows the active document */
+	doc = pluma_window_get_active_document (PLUMA_WINDOW (data->window));
+
+	if (doc != NULL && doc != data->doc)
+		docinfo_update (data, doc);
+	else
+		schedule_refresh (data);
 }
 
 static void
@@ -423,11 +1052,7 @@ docinfo_dialog_response_cb (GtkDialog	*widget,
 			doc = pluma_window_get_active_document (window);
 			g_return_if_fail (doc != NULL);
 
-			docinfo_real (doc,
-				      data->dialog);
-
-			selectioninfo_real (doc,
-					    data->dialog);
+			docinfo_update (data, doc);
 
 			break;
 		}
@@ -463,6 +1088,17 @@ update_ui (PlumaDocInfoPluginPrivate *data)
 		gtk_dialog_set_response_sensitive (GTK_DIALOG (data->dialog->dialog),
 						   GTK_RESPONSE_OK,
 						   (view != NULL));
+
+		/* In live mode the dialog follows the active document */
+		if (data->live && view != NULL)
+		{
+			PlumaDocument *doc;
+
+			doc = pluma_window_get_active_document (window);
+
+			if (doc != data->doc)
+				docinfo_update (data, doc);
+		}
 	}
 }
 
@@ -590,6 +1226,9 @@ pluma_docinfo_plugin_deactivate (PlumaWindowActivatable *activatable)
 	data = PLUMA_DOCINFO_PLUGIN (activatable)->priv;
 	window = PLUMA_WINDOW (data->window);
 
+	if (data->dialog != NULL)
+		gtk_widget_destroy (data->dialog->dialog);
+
 	manager = pluma_window_get_ui_manager (window);
 
 	gtk_ui_manager_remove_ui (manager,
@@ -0,0 +1,308 @@
+/*
+ * pluma-file-browser-filter.c - Pluma plugin providing easy file access
+ * from the sidepanel
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * A filter is compiled from a whitespace separated list of rules, which are
+ * evaluated gitignore-style: the last rule matching a name decides whether
+ * it is shown.
+ *
+ *   *.c        glob, shows matching files
+ *   !*.o       negated glob, hides matching files
+ *   /^a.*z$/   regular expression between slashes
+ *   build/     trailing slash, the rule only applies to directories
+ *
+ * Files are hidden when there are positive file rules and none of them
+ * matches. Directories are always shown unless a directory rule hides them.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+
+#include "pluma-file-browser-filter.h"
+
+typedef enum
+{
+	RULE_LITERAL,	/* no wildcards, plain comparison */
+	RULE_SUFFIX,	/* "*literal", e.g. "*.c" */
+	RULE_PREFIX,	/* "literal*" */
+	RULE_GLOB,
+	RULE_REGEX
+} RuleType;
+
+typedef struct
+{
+	RuleType type;
+	gboolean negate;
+	gboolean dir_only;
+
+	gchar *literal;
+	gsize literal_len;
+
+	GPatternSpec *glob;
+	GRegex *regex;
+} Rule;
+
+struct _PlumaFileBrowserFilter
+{
+	/* Rules are stored in reverse order so that the first match wins */
+	GSList *rules;
+
+	gboolean has_file_includes;
+};
+
+static void
+rule_free (Rule *rule)
+{
+	g_free (rule->literal);
+
+	if (rule->glob)
+		g_pattern_spec_free (rule->glob);
+
+	if (rule->regex)
+		g_regex_unref (rule->regex);
+
+	g_slice_free (Rule, rule);
+}
+
+static gboolean
+has_wildcards (const gchar *str,
+	       gsize        len)
+{
+	gsize i;
+
+	for (i = 0; i < len; ++i)
+	{
+		if (str[i] == '*' || str[i] == '?')
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+static Rule *
+rule_new (const gchar *token)
+{
+	Rule *rule;
+	gsize len;
+
+	rule = g_slice_new0 (Rule);
+
+	if (*token == '!')
+	{
+		rule->negate = TRUE;
+		++token;
+	}
+
+	len = strlen (token);
+
+	if (len > 2 && token[0] == '/' && token[len - 1] == '/')
+	{
+		gchar *source = g_strndup (token + 1, len - 2);
+
+		rule->type = RULE_REGEX;
+		rule->regex = g_regex_new (source, G_REGEX_OPTIMIZE, 0, NULL);
+		g_free (source);
+
+		/* An incomplete expression while the user is still typing */
+		if (rule->regex == NULL)
+		{
+			rule_free (rule);
+			return NULL;
+		}
+
+		return rule;
+	}
+
+	if (len > 1 && token[len - 1] == '/')
+	{
+		rule->dir_only = TRUE;
+		--len;
+	}
+
+	if (len == 0)
+	{
+		rule_free (rule);
+		return NULL;
+	}
+
+	/* Most patterns are "*.ext" or a plain name, which can be matched
+	   without going through GPatternSpec */
+	if (!has_wildcards (token, len))
+	{
+		rule->type = RULE_LITERAL;
+		rule->literal = g_strndup (token, len);
+	}
+	else if (token[0] == '*' && !has_wildcards (token + 1, len - 1))
+	{
+		rule->type = RULE_SUFFIX;
+		rule->literal = g_strndup (token + 1, len - 1);
+	}
+	else if (token[len - 1] == '*' && !has_wildcards (token, len - 1))
+	{
+		rule->type = RULE_PREFIX;
+		rule->literal = g_strndup (token, len - 1);
+	}
+	else
+	{
+		gchar *glob = g_strndup (token, len);
+
+		rule->type = RULE_GLOB;
+		rule->glob = g_pattern_spec_new (glob);
+		g_free (glob);
+	}
+
+	if (rule->literal != NULL)
+		rule->literal_len = strlen (rule->literal);
+
+	return rule;
+}
+
+static gboolean
+rule_match (Rule        *rule,
+	    const gchar *name,
+	    gsize        len)
+{
+	switch (rule->type)
+	{
+		case RULE_LITERAL:
+			return len == rule->literal_len &&
+			       memcmp (name, rule->literal, len) == 0;
+		case RULE_SUFFIX:
+			return len >= rule->literal_len &&
+			       memcmp (name + len - rule->literal_len,
+				       rule->literal,
+				       rule->literal_len) == 0;
+		case RULE_PREFIX:
+			return len >= rule->literal_len &&
+			       memcmp (name, rule->literal, rule->literal_len) == 0;
+		case RULE_GLOB:
+			return g_pattern_match_string (rule->glob, name);
+		case RULE_REGEX:
+			return g_regex_match (rule->regex, name, 0, NULL);
+	}
+
+	g_return_val_if_reached (FALSE);
+}
+
+/**
+ * pluma_file_browser_filter_new:
+ * @pattern: the filter rules
+ *
+ * Compiles @pattern into a filter. Rules which can not be compiled, such as
+ * an incomplete regular expression, are ignored.
+ *
+ * Returns: a new #PlumaFileBrowserFilter, or %NULL when @pattern does not
+ * contain any valid rule.
+ **/
+PlumaFileBrowserFilter *
+pluma_file_browser_filter_new (const gchar *pattern)
+{
+	PlumaFileBrowserFilter *filter;
+	gchar **tokens;
+	gchar **token;
+
+	g_return_val_if_fail (pattern != NULL, NULL);
+
+	filter = g_slice_new0 (PlumaFileBrowserFilter);
+	tokens = g_strsplit_set (pattern, " \t\n", -1);
+
+	for (token = tokens; *token != NULL; ++token)
+	{
+		Rule *rule;
+
+		if (**token == '\0')
+			continue;
+
+		rule = rule_new (*token);
+
+		if (rule == NULL)
+			continue;
+
+		if (!rule->negate && !rule->dir_only)
+			filter->has_file_includes = TRUE;
+
+		filter->rules = g_slist_prepend (filter->rules, rule);
+	}
+
+	g_strfreev (tokens);
+
+	if (filter->rules == NULL)
+	{
+		pluma_file_browser_filter_free (filter);
+		return NULL;
+	}
+
+	return filter;
+}
+
+void
+pluma_file_browser_filter_free (PlumaFileBrowserFilter *filter)
+{
+	if (filter == NULL)
+		return;
+
+	g_slist_free_full (filter->rules, (GDestroyNotify) rule_free);
+	g_slice_free (PlumaFileBrowserFilter, filter);
+}
+
+/**
+ * pluma_file_browser_filter_match:
+ * @filter: a #PlumaFileBrowserFilter
+ * @name: the display name of the file
+ * @is_dir: whether the file is a directory
+ *
+ * Returns: %TRUE if the file should be shown.
+ **/
+gboolean
+pluma_file_browser_filter_match (PlumaFileBrowserFilter *filter,
+				 const gchar            *name,
+				 gboolean                is_dir)
+{
+	GSList *item;
+	gsize len;
+
+	g_return_val_if_fail (filter != NULL, TRUE);
+
+	if (name == NULL)
+		return TRUE;
+
+	len = strlen (name);
+
+	for (item = filter->rules; item; item = item->next)
+	{
+		Rule *rule = item->data;
+
+		/* Plain file rules never hide directories, otherwise it
+		   would be impossible to navigate to the matching files */
+		if (is_dir != rule->dir_only)
+			continue;
+
+		if (rule_match (rule, name, len))
+			return !rule->negate;
+	}
+
+	return is_dir || !filter->has_file_includes;
+}
+
+// ex:ts=8:noet:
@@ -0,0 +1,42 @@
+/*
+ * pluma-file-browser-filter.h - Pluma plugin providing easy file access
+ * from the sidepanel
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PLUMA_FILE_BROWSER_FILTER_H__
+#define __PLUMA_FILE_BROWSER_FILTER_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _PlumaFileBrowserFilter PlumaFileBrowserFilter;
+
+PlumaFileBrowserFilter	*pluma_file_browser_filter_new		(const gchar *pattern);
+void			 pluma_file_browser_filter_free		(PlumaFileBrowserFilter *filter);
+
+gboolean		 pluma_file_browser_filter_match	(PlumaFileBrowserFilter *filter,
+								 const gchar *name,
+								 gboolean is_dir);
+
+G_END_DECLS
+
+#endif /* __PLUMA_FILE_BROWSER_FILTER_H__ */
+
+// ex:ts=8:noet:
@@ -237,40 +237,15 @@ message_set_emblem_cb (PlumaMessageBus *bus,
 
 	if (path != NULL)
 	{
-		GError *error = NULL;
-		GdkPixbuf *pixbuf;
+		GtkTreeIter iter;
 
-		pixbuf = gtk_icon_theme_load_icon (gtk_icon_theme_get_default (),
-						   emblem,
-						   10,
-						   0,
-						   &error);
+		store = pluma_file_browser_widget_get_browser_store (data->widget);
 
-		if (pixbuf)
+		if (gtk_tree_model_get_iter (GTK_TREE_MODEL (store), &iter, path))
 		{
-			GValue value = { 0, };
-			GtkTreeIter iter;
-
-			store = pluma_file_browser_widget_get_browser_store (data->widget);
-
-			if (gtk_tree_model_get_iter (GTK_TREE_MODEL (store), &iter, path))
-			{
-				g_value_init (&value, GDK_TYPE_PIXBUF);
-				g_value_set_object (&value, pixbuf);
-
-				pluma_file_browser_store_set_value (store,
-								    &iter,
-								    PLUMA_FILE_BROWSER_STORE_COLUMN_EMBLEM,
-								    &value);
-
-				g_value_unset (&value);
-			}
-
-			g_object_unref (pixbuf);
+			/* the store shares the emblem composites by name */
+			pluma_file_browser_store_set_emblem (store, &iter, emblem);
 		}
-
-		if (error)
-			g_error_free (error);
 	}
 
 	g_free (id);
@@ -347,6 +322,30 @@ set_item_message (WindowData   *data,
 	g_free (track_id);
 }
 
+static void
+send_item_message (WindowData   *data,
+		   GtkTreeIter  *iter,
+		   GtkTreePath  *path,
+		   PlumaMessage *cached)
+{
+	PlumaMessage *message;
+
+	/* the message is queued, so it cannot be the cached one which is
+	 * overwritten by the next event */
+	message = pluma_message_type_instantiate (pluma_message_get_message_type (cached),
+						  "id", NULL,
+						  "uri", NULL,
+						  NULL);
+
+	if (pluma_message_has_key (message, "is_directory"))
+		pluma_message_set (message, "is_directory", FALSE, NULL);
+
+	set_item_message (data, iter, path, message);
+
+	pluma_message_bus_send_message (data->bus, message);
+	g_object_unref (message);
+}
+
 static gboolean
 custom_message_filter_func (PlumaFileBrowserWidget *widget,
 			    PlumaFileBrowserStore  *store,
@@ -762,8 +761,7 @@ store_row_inserted (PlumaFileBrowserStore *store,
 	{
 		WindowData *wdata = get_window_data (data->window);
 
-		set_item_message (wdata, iter, path, data->message);
-		pluma_message_bus_send_message_sync (wdata->bus, data->message);
+		send_item_message (wdata, iter, path, data->message);
 	}
 
 	g_free (uri);
@@ -790,8 +788,7 @@ store_row_deleted (PlumaFileBrowserStore *store,
 	{
 		WindowData *wdata = get_window_data (data->window);
 
-		set_item_message (wdata, &iter, path, data->message);
-		pluma_message_bus_send_message_sync (wdata->bus, data->message);
+		send_item_message (wdata, &iter, path, data->message);
 	}
 
 	g_free (uri);
@@ -803,6 +800,7 @@ store_virtual_root_changed (PlumaFileBrowserStore *store,
 			    MessageCacheData      *data)
 {
 	WindowData *wdata = get_window_data (data->window);
+	PlumaMessage *message;
 	gchar *uri;
 
 	uri = pluma_file_browser_store_get_virtual_root (store);
@@ -810,12 +808,14 @@ store_virtual_root_changed (PlumaFileBrowserStore *store,
 	if (!uri)
 		return;
 
-	pluma_message_set (data->message,
-			   "uri", uri,
-			   NULL);
+	message = pluma_message_type_instantiate (pluma_message_get_message_type (data->message),
+						  "id", NULL,
+						  "uri", uri,
+						  NULL);
 
-	pluma_message_bus_send_message_sync (wdata->bus, data->message);
+	pluma_message_bus_send_message (wdata->bus, message);
 
+	g_object_unref (message);
 	g_free (uri);
 }
 
@@ -829,9 +829,7 @@ store_begin_loading (PlumaFileBrowserStore *store,
 
 	path = gtk_tree_model_get_path (GTK_TREE_MODEL (store), iter);
 
-	set_item_message (wdata, iter, path, data->message);
-
-	pluma_message_bus_send_message_sync (wdata->bus, data->message);
+	send_item_message (wdata, iter, path, data->message);
 	gtk_tree_path_free (path);
 }
 
@@ -845,9 +843,7 @@ store_end_loading (PlumaFileBrowserStore *store,
 
 	path = gtk_tree_model_get_path (GTK_TREE_MODEL (store), iter);
 
-	set_item_message (wdata, iter, path, data->message);
-
-	pluma_message_bus_send_message_sync (wdata->bus, data->message);
+	send_item_message (wdata, iter, path, data->message);
 	gtk_tree_path_free (path);
 }
 
@@ -904,6 +900,34 @@ register_signals (PlumaWindow            *window,
 						   "is_directory", G_TYPE_BOOLEAN,
 						   NULL);
 
+	/* The events are delivered asynchronously. They share one lane and
+	 * are never coalesced, so that they arrive in the order they were
+	 * sent: the events about a root come before the change to the next */
+	pluma_message_bus_set_delivery (bus,
+					MESSAGE_OBJECT_PATH, "root_changed",
+					PLUMA_MESSAGE_BUS_PRIORITY_LOW,
+					PLUMA_MESSAGE_BUS_DELIVERY_QUEUE);
+
+	pluma_message_bus_set_delivery (bus,
+					MESSAGE_OBJECT_PATH, "begin_loading",
+					PLUMA_MESSAGE_BUS_PRIORITY_LOW,
+					PLUMA_MESSAGE_BUS_DELIVERY_QUEUE);
+
+	pluma_message_bus_set_delivery (bus,
+					MESSAGE_OBJECT_PATH, "end_loading",
+					PLUMA_MESSAGE_BUS_PRIORITY_LOW,
+					PLUMA_MESSAGE_BUS_DELIVERY_QUEUE);
+
+	pluma_message_bus_set_delivery (bus,
+					MESSAGE_OBJECT_PATH, "inserted",
+					PLUMA_MESSAGE_BUS_PRIORITY_LOW,
+					PLUMA_MESSAGE_BUS_DELIVERY_QUEUE);
+
+	pluma_message_bus_set_delivery (bus,
+					MESSAGE_OBJECT_PATH, "deleted",
+					PLUMA_MESSAGE_BUS_PRIORITY_LOW,
+					PLUMA_MESSAGE_BUS_DELIVERY_QUEUE);
+
 	store = pluma_file_browser_widget_get_browser_store (widget);
 
 	message = pluma_message_type_instantiate (inserted_type,
@@ -27,6 +27,18 @@
 #include <pluma/pluma-message-bus.h>
 #include "pluma-file-browser-widget.h"
 
+/*
+ * Besides its methods, the file browser sends these events on the bus of
+ * the window, at the "/plugins/filebrowser" object path:
+ *
+ * root_changed (id, uri)
+ * begin_loading (id, uri), end_loading (id, uri)
+ * inserted (id, uri, is_directory), deleted (id, uri, is_directory)
+ *
+ * They are sent asynchronously: a listener gets them from an idle handler
+ * after the change, when the row may already be gone. They are delivered
+ * in the order in which they were sent.
+ */
 void pluma_file_browser_messages_register   (PlumaWindow *window,
 					     PlumaFileBrowserWidget *widget);
 void pluma_file_browser_messages_unregister (PlumaWindow *window);
@@ -54,6 +54,7 @@ typedef struct _FileBrowserNode    FileBrowserNode;
 typedef struct _FileBrowserNodeDir FileBrowserNodeDir;
 typedef struct _AsyncData	   AsyncData;
 typedef struct _AsyncNode	   AsyncNode;
+typedef struct _IconCacheEntry	   IconCacheEntry;
 
 typedef gint (*SortFunc) (FileBrowserNode * node1,
 			  FileBrowserNode * node2);
@@ -88,14 +89,32 @@ struct _FileBrowserNode
 	guint flags;
 	gchar *name;
 
-	GdkPixbuf *icon;
+	GIcon *gicon;
+	IconCacheEntry *icon;
 	GdkPixbuf *emblem;
+	GIcon *emblem_icon;
+	gboolean icon_resolved;
+
+	/* Result of the filter function, valid while filter_stamp matches
+	   the one of the store */
+	guint filter_stamp;
+	gboolean filter_result;
 
 	FileBrowserNode *parent;
 	gint pos;
 	gboolean inserted;
 };
 
+struct _IconCacheEntry
+{
+	GIcon *gicon;
+	GIcon *emblem;
+	GdkPixbuf *pixbuf;
+
+	/* Number of nodes using the entry, it is dropped at 0 */
+	guint use_count;
+};
+
 struct _FileBrowserNodeDir
 {
 	FileBrowserNode node;
@@ -115,11 +134,15 @@ struct _PlumaFileBrowserStorePrivate
 	PlumaFileBrowserStoreFilterMode filter_mode;
 	PlumaFileBrowserStoreFilterFunc filter_func;
 	gpointer filter_user_data;
+	guint filter_stamp;
 
 	SortFunc sort_func;
 
 	GSList *async_handles;
 	MountInfo *mount_info;
+
+	/* Set of IconCacheEntry, shared between all the nodes */
+	GHashTable *icon_cache;
 };
 
 static FileBrowserNode *model_find_node 		    (PlumaFileBrowserStore *model,
@@ -187,6 +210,10 @@ static gint model_sort_default                              (FileBrowserNode * n
 							     FileBrowserNode * node2);
 static void model_check_dummy                               (PlumaFileBrowserStore * model,
 							     FileBrowserNode * node);
+static void model_resolve_icon                              (PlumaFileBrowserStore * model,
+							     FileBrowserNode * node);
+static void model_release_icon                              (PlumaFileBrowserStore * model,
+							     FileBrowserNode * node);
 static void next_files_async 				    (GFileEnumerator * enumerator,
 							     AsyncNode * async);
 
@@ -258,9 +285,63 @@ pluma_file_browser_store_finalize (GObject * object)
 	cancel_mount_operation (obj);
 
 	g_slist_free (obj->priv->async_handles);
+	g_hash_table_destroy (obj->priv->icon_cache);
+
 	G_OBJECT_CLASS (pluma_file_browser_store_parent_class)->finalize (object);
 }
 
+static guint
+icon_cache_entry_hash (gconstpointer data)
+{
+	IconCacheEntry const *entry = data;
+	guint hash = 0;
+
+	if (entry->gicon)
+		hash = g_icon_hash ((gpointer) entry->gicon);
+
+	if (entry->emblem)
+		hash = hash * 31 + g_icon_hash ((gpointer) entry->emblem);
+
+	return hash;
+}
+
+static gboolean
+icon_equal (GIcon * icon1,
+	    GIcon * icon2)
+{
+	if (icon1 == NULL || icon2 == NULL)
+		return icon1 == icon2;
+
+	return g_icon_equal (icon1, icon2);
+}
+
+static gboolean
+icon_cache_entry_equal (gconstpointer a,
+			gconstpointer b)
+{
+	IconCacheEntry const *entry1 = a;
+	IconCacheEntry const *entry2 = b;
+
+	return icon_equal (entry1->gicon, entry2->gicon) &&
+	       icon_equal (entry1->emblem, entry2->emblem);
+}
+
+static void
+icon_cache_entry_free (gpointer data)
+{
+	IconCacheEntry *entry = data;
+
+	if (entry->gicon)
+		g_object_unref (entry->gicon);
+
+	if (entry->emblem)
+		g_object_unref (entry->emblem);
+
+	g_object_unref (entry->pixbuf);
+
+	g_slice_free (IconCacheEntry, entry);
+}
+
 static void
 set_gvalue_from_node (GValue          *value,
                       FileBrowserNode *node)
@@ -463,6 +544,12 @@ pluma_file_browser_store_init (PlumaFileBrowserStore * obj)
 	// Default filter mode is hiding the hidden files
 	obj->priv->filter_mode = pluma_file_browser_store_filter_mode_get_default ();
 	obj->priv->sort_func = model_sort_default;
+	obj->priv->filter_stamp = 1;
+
+	obj->priv->icon_cache = g_hash_table_new_full (icon_cache_entry_hash,
+						       icon_cache_entry_equal,
+						       icon_cache_entry_free,
+						       NULL);
 }
 
 static gboolean
@@ -681,7 +768,9 @@ pluma_file_browser_store_get_value (GtkTreeModel * tree_model,
 		g_value_set_uint (value, node->flags);
 		break;
 	case PLUMA_FILE_BROWSER_STORE_COLUMN_ICON:
-		g_value_set_object (value, node->icon);
+		/* Icons are only resolved once a row is actually asked for */
+		model_resolve_icon (PLUMA_FILE_BROWSER_STORE (tree_model), node);
+		g_value_set_object (value, node->icon ? node->icon->pixbuf : NULL);
 		break;
 	case PLUMA_FILE_BROWSER_STORE_COLUMN_EMBLEM:
 		g_value_set_object (value, node->emblem);
@@ -999,16 +1088,31 @@ model_node_update_visibility (PlumaFileBrowserStore * model,
 		 (!NODE_IS_TEXT (node) && !NODE_IS_DIR (node)))
 		node->flags |= PLUMA_FILE_BROWSER_STORE_FLAG_IS_FILTERED;
 	else if (model->priv->filter_func) {
-		iter.user_data = node;
+		/* Only ask the filter function again when the filter or
+		   the node changed since the last time */
+		if (node->filter_stamp != model->priv->filter_stamp) {
+			iter.user_data = node;
+
+			node->filter_result =
+			    model->priv->filter_func (model, &iter,
+						      model->priv->filter_user_data);
+			node->filter_stamp = model->priv->filter_stamp;
+		}
 
-		if (!model->priv->
-		    filter_func (model, &iter,
-				 model->priv->filter_user_data))
+		if (!node->filter_result)
 			node->flags |=
 			    PLUMA_FILE_BROWSER_STORE_FLAG_IS_FILTERED;
 	}
 }
 
+static void
+model_invalidate_filter (PlumaFileBrowserStore * model)
+{
+	/* Skip 0, which is the stamp of nodes never filtered */
+	if (++model->priv->filter_stamp == 0)
+		model->priv->filter_stamp = 1;
+}
+
 static gint
 collate_nodes (FileBrowserNode * node1, FileBrowserNode * node2)
 {
@@ -1263,6 +1367,7 @@ static void
 file_browser_node_set_name (FileBrowserNode * node)
 {
 	g_free (node->name);
+	node->filter_stamp = 0;
 
 	if (node->file) {
 		node->name = pluma_file_browser_utils_file_basename (node->file);
@@ -1371,12 +1476,17 @@ file_browser_node_free (PlumaFileBrowserStore * model,
 		g_object_unref (node->file);
 	}
 
-	if (node->icon)
-		g_object_unref (node->icon);
+	if (node->gicon)
+		g_object_unref (node->gicon);
+
+	model_release_icon (model, node);
 
 	if (node->emblem)
 		g_object_unref (node->emblem);
 
+	if (node->emblem_icon)
+		g_object_unref (node->emblem_icon);
+
 	g_free (node->name);
 
 	if (NODE_IS_DIR (node))
@@ -1580,13 +1690,138 @@ file_browser_node_unload (PlumaFileBrowserStore * model,
 	node->flags &= ~PLUMA_FILE_BROWSER_STORE_FLAG_LOADED;
 }
 
+static GdkPixbuf *
+model_composite_icon (GIcon     * gicon,
+		      GdkPixbuf * emblem)
+{
+	GdkPixbuf *icon;
+	GdkPixbuf *composite;
+	gint icon_size;
+
+	icon = pluma_file_browser_utils_pixbuf_from_icon (gicon, GTK_ICON_SIZE_MENU);
+
+	if (emblem == NULL)
+		return icon;
+
+	gtk_icon_size_lookup (GTK_ICON_SIZE_MENU, NULL, &icon_size);
+
+	if (icon == NULL) {
+		composite =
+		    gdk_pixbuf_new (gdk_pixbuf_get_colorspace (emblem),
+				    gdk_pixbuf_get_has_alpha (emblem),
+				    gdk_pixbuf_get_bits_per_sample (emblem),
+				    icon_size,
+				    icon_size);
+	} else {
+		composite = gdk_pixbuf_copy (icon);
+		g_object_unref (icon);
+	}
+
+	gdk_pixbuf_composite (emblem, composite,
+			      icon_size - 10, icon_size - 10, 10,
+			      10, icon_size - 10, icon_size - 10,
+			      1, 1, GDK_INTERP_NEAREST, 255);
+
+	return composite;
+}
+
+/**
+ * model_resolve_icon:
+ * @model: the #PlumaFileBrowserStore
+ * @node: the FileBrowserNode to resolve the icon for
+ *
+ * Loads the pixbuf for the GIcon and emblem of @node. Nodes sharing the same
+ * GIcon and emblem share the same pixbuf, which is kept in the icon cache of
+ * the store. This is called lazily when the icon column is requested, so
+ * only rows which are actually shown pay for the icon theme lookup.
+ **/
+static void
+model_resolve_icon (PlumaFileBrowserStore * model,
+		    FileBrowserNode * node)
+{
+	IconCacheEntry lookup;
+	IconCacheEntry *entry;
+	GdkPixbuf *pixbuf;
+
+	if (node->icon_resolved)
+		return;
+
+	node->icon_resolved = TRUE;
+
+	/* Nodes added without file info ask the file for its icon */
+	if (node->gicon == NULL && node->file != NULL && !NODE_IS_DUMMY (node)) {
+		GFileInfo *info;
+
+		info = g_file_query_info (node->file,
+					  G_FILE_ATTRIBUTE_STANDARD_ICON,
+					  G_FILE_QUERY_INFO_NONE,
+					  NULL,
+					  NULL);
+
+		if (info) {
+			GIcon *gicon = g_file_info_get_icon (info);
+
+			node->gicon = gicon ? g_object_ref (gicon) : NULL;
+			g_object_unref (info);
+		}
+	}
+
+	if (node->gicon == NULL && node->emblem == NULL)
+		return;
+
+	lookup.gicon = node->gicon;
+	lookup.emblem = node->emblem_icon;
+
+	entry = g_hash_table_lookup (model->priv->icon_cache, &lookup);
+
+	if (entry == NULL) {
+		pixbuf = model_composite_icon (node->gicon, node->emblem);
+
+		if (pixbuf == NULL)
+			return;
+
+		entry = g_slice_new (IconCacheEntry);
+		entry->gicon = node->gicon ? g_object_ref (node->gicon) : NULL;
+		entry->emblem = node->emblem_icon ? g_object_ref (node->emblem_icon) : NULL;
+		entry->pixbuf = pixbuf;
+		entry->use_count = 0;
+
+		g_hash_table_add (model->priv->icon_cache, entry);
+	}
+
+	entry->use_count++;
+	node->icon = entry;
+}
+
+/**
+ * model_release_icon:
+ * @model: the #PlumaFileBrowserStore
+ * @node: the FileBrowserNode to release the icon of
+ *
+ * Stops @node from using its cached icon, the cache entry is dropped when
+ * no other node uses it anymore.
+ **/
+static void
+model_release_icon (PlumaFileBrowserStore * model,
+		    FileBrowserNode * node)
+{
+	IconCacheEntry *entry = node->icon;
+
+	node->icon = NULL;
+	node->icon_resolved = FALSE;
+
+	if (entry == NULL)
+		return;
+
+	if (--entry->use_count == 0)
+		g_hash_table_remove (model->priv->icon_cache, entry);
+}
+
 static void
 model_recomposite_icon_real (PlumaFileBrowserStore * tree_model,
 			     FileBrowserNode * node,
 			     GFileInfo * info)
 {
-	GdkPixbuf *icon;
-
 	g_return_if_fail (PLUMA_IS_FILE_BROWSER_STORE (tree_model));
 	g_return_if_fail (node != NULL);
 
@@ -1595,41 +1830,15 @@ model_recomposite_icon_real (PlumaFileBrowserStore * tree_model,
 
 	if (info) {
 		GIcon *gicon = g_file_info_get_icon (info);
-		if (gicon != NULL)
-			icon = pluma_file_browser_utils_pixbuf_from_icon (gicon, GTK_ICON_SIZE_MENU);
-		else
-			icon = NULL;
-	} else {
-		icon = pluma_file_browser_utils_pixbuf_from_file (node->file, GTK_ICON_SIZE_MENU);
-	}
-
-	if (node->icon)
-		g_object_unref (node->icon);
-
-	if (node->emblem) {
-		gint icon_size;
 
-		gtk_icon_size_lookup (GTK_ICON_SIZE_MENU, NULL, &icon_size);
-
-		if (icon == NULL) {
-			node->icon =
-			    gdk_pixbuf_new (gdk_pixbuf_get_colorspace (node->emblem),
-					    gdk_pixbuf_get_has_alpha (node->emblem),
-					    gdk_pixbuf_get_bits_per_sample (node->emblem),
-					    icon_size,
-					    icon_size);
-		} else {
-			node->icon = gdk_pixbuf_copy (icon);
-			g_object_unref (icon);
-		}
+		if (node->gicon)
+			g_object_unref (node->gicon);
 
-		gdk_pixbuf_composite (node->emblem, node->icon,
-				      icon_size - 10, icon_size - 10, 10,
-				      10, icon_size - 10, icon_size - 10,
-				      1, 1, GDK_INTERP_NEAREST, 255);
-	} else {
-		node->icon = icon;
+		node->gicon = gicon ? g_object_ref (gicon) : NULL;
 	}
+
+	/* The actual pixbuf is loaded in model_resolve_icon when needed */
+	model_release_icon (tree_model, node);
 }
 
 static void
@@ -1925,6 +2134,8 @@ file_browser_node_set_from_info (PlumaFileBrowserStore * model,
 		free_info = TRUE;
 	}
 
+	node->filter_stamp = 0;
+
 	if (g_file_info_get_is_hidden (info) || g_file_info_get_is_backup (info))
 		node->flags |= PLUMA_FILE_BROWSER_STORE_FLAG_IS_HIDDEN;
 
@@ -2093,8 +2304,9 @@ model_add_node_from_dir (PlumaFileBrowserStore * model,
 			file_browser_node_set_name (node);
 		}
 
-		if (node->icon == NULL) {
-			node->icon = pluma_file_browser_utils_pixbuf_from_theme ("folder", GTK_ICON_SIZE_MENU);
+		if (node->gicon == NULL) {
+			node->gicon = g_themed_icon_new ("folder");
+			model_release_icon (model, node);
 		}
 
 		model_add_node (model, node, parent);
@@ -2716,14 +2928,42 @@ pluma_file_browser_store_new (gchar const *root)
 	return obj;
 }
 
+static void
+model_set_emblem (PlumaFileBrowserStore * tree_model,
+		  GtkTreeIter * iter,
+		  GdkPixbuf * emblem,
+		  GIcon * emblem_icon)
+{
+	FileBrowserNode *node;
+	GtkTreePath *path;
+
+	node = (FileBrowserNode *) (iter->user_data);
+
+	if (node->emblem)
+		g_object_unref (node->emblem);
+
+	if (node->emblem_icon)
+		g_object_unref (node->emblem_icon);
+
+	node->emblem = emblem ? g_object_ref (emblem) : NULL;
+	node->emblem_icon = emblem_icon ? g_object_ref (emblem_icon) : NULL;
+
+	model_recomposite_icon (tree_model, iter);
+
+	if (model_node_visibility (tree_model, node)) {
+		path = pluma_file_browser_store_get_path (GTK_TREE_MODEL (tree_model),
+							  iter);
+		row_changed (tree_model, &path, iter);
+		gtk_tree_path_free (path);
+	}
+}
+
 void
 pluma_file_browser_store_set_value (PlumaFileBrowserStore * tree_model,
 				    GtkTreeIter * iter, gint column,
 				    GValue * value)
 {
 	gpointer data;
-	FileBrowserNode *node;
-	GtkTreePath *path;
 
 	g_return_if_fail (PLUMA_IS_FILE_BROWSER_STORE (tree_model));
 	g_return_if_fail (column ==
@@ -2737,26 +2977,55 @@ pluma_file_browser_store_set_value (PlumaFileBrowserStore * tree_model,
 	if (data)
 		g_return_if_fail (GDK_IS_PIXBUF (data));
 
-	node = (FileBrowserNode *) (iter->user_data);
+	/* A pixbuf is its own GIcon, equal only to itself */
+	model_set_emblem (tree_model, iter, data, data);
+}
 
-	if (node->emblem)
-		g_object_unref (node->emblem);
+/**
+ * pluma_file_browser_store_set_emblem:
+ * @model: the #PlumaFileBrowserStore
+ * @iter: the row to set the emblem of
+ * @icon_name: (allow-none): the name of the emblem in the icon theme
+ *
+ * Sets the emblem drawn over the icon of @iter. Rows with the same icon and
+ * the same emblem name share one composited icon, unlike emblems set as
+ * pixbufs with pluma_file_browser_store_set_value().
+ **/
+void
+pluma_file_browser_store_set_emblem (PlumaFileBrowserStore * model,
+				     GtkTreeIter * iter,
+				     const gchar * icon_name)
+{
+	GdkPixbuf *pixbuf = NULL;
+	GIcon *emblem_icon = NULL;
 
-	if (data)
-		node->emblem = g_object_ref (GDK_PIXBUF (data));
-	else
-		node->emblem = NULL;
+	g_return_if_fail (PLUMA_IS_FILE_BROWSER_STORE (model));
+	g_return_if_fail (iter != NULL);
+	g_return_if_fail (iter->user_data != NULL);
 
-	model_recomposite_icon (tree_model, iter);
+	if (icon_name) {
+		pixbuf = gtk_icon_theme_load_icon (gtk_icon_theme_get_default (),
+						   icon_name,
+						   10,
+						   0,
+						   NULL);
 
-	if (model_node_visibility (tree_model, node)) {
-		path = pluma_file_browser_store_get_path (GTK_TREE_MODEL (tree_model),
-							  iter);
-		row_changed (tree_model, &path, iter);
-		gtk_tree_path_free (path);
+		if (pixbuf == NULL)
+			return;
+
+		emblem_icon = g_themed_icon_new (icon_name);
 	}
+
+	model_set_emblem (model, iter, pixbuf, emblem_icon);
+
+	if (pixbuf)
+		g_object_unref (pixbuf);
+
+	if (emblem_icon)
+		g_object_unref (emblem_icon);
 }
 
+
 PlumaFileBrowserStoreResult
 pluma_file_browser_store_set_virtual_root (PlumaFileBrowserStore * model,
 					   GtkTreeIter * iter)
@@ -3093,12 +3362,14 @@ pluma_file_browser_store_set_filter_func (PlumaFileBrowserStore * model,
 
 	model->priv->filter_func = func;
 	model->priv->filter_user_data = user_data;
+	model_invalidate_filter (model);
 	model_refilter (model);
 }
 
 void
 pluma_file_browser_store_refilter (PlumaFileBrowserStore * model)
 {
+	model_invalidate_filter (model);
 	model_refilter (model);
 }
 
@@ -155,6 +155,9 @@ void pluma_file_browser_store_set_value               (PlumaFileBrowserStore * t
                                                        GtkTreeIter * iter,
                                                        gint column,
                                                        GValue * value);
+void pluma_file_browser_store_set_emblem              (PlumaFileBrowserStore * model,
+                                                       GtkTreeIter * iter,
+                                                       const gchar * icon_name);
 
 void _pluma_file_browser_store_iter_expanded          (PlumaFileBrowserStore * model,
                                                        GtkTreeIter * iter);
@@ -39,6 +39,7 @@
 #include "pluma-file-browser-widget.h"
 #include "pluma-file-browser-view.h"
 #include "pluma-file-browser-store.h"
+#include "pluma-file-browser-filter.h"
 #include "pluma-file-bookmarks-store.h"
 #include "pluma-file-browser-enum-types.h"
 
@@ -139,7 +140,7 @@ struct _PlumaFileBrowserWidgetPrivate
 	GSList *filter_funcs;
 	gulong filter_id;
 	gulong glob_filter_id;
-	GPatternSpec *filter_pattern;
+	PlumaFileBrowserFilter *filter_pattern;
 	gchar *filter_pattern_str;
 
 	GList *locations;
@@ -344,6 +345,8 @@ pluma_file_browser_widget_finalize (GObject * object)
 	g_object_unref (obj->priv->combo_model);
 
 	g_slist_free_full (obj->priv->filter_funcs, g_free);
+	g_free (obj->priv->filter_pattern_str);
+	pluma_file_browser_filter_free (obj->priv->filter_pattern);
 
 	for (loc = obj->priv->locations; loc; loc = loc->next)
 		location_free ((Location *) (loc->data));
@@ -1387,12 +1390,13 @@ filter_glob (PlumaFileBrowserWidget * obj, PlumaFileBrowserStore * store,
 			    PLUMA_FILE_BROWSER_STORE_COLUMN_FLAGS, &flags,
 			    -1);
 
-	if (FILE_IS_DIR (flags) || FILE_IS_DUMMY (flags))
+	if (FILE_IS_DUMMY (flags))
 		result = TRUE;
 	else
 		result =
-		    g_pattern_match_string (obj->priv->filter_pattern,
-					    name);
+		    pluma_file_browser_filter_match (obj->priv->filter_pattern,
+						     name,
+						     FILE_IS_DIR (flags));
 
 	g_free (name);
 
@@ -1738,6 +1742,7 @@ set_filter_pattern_real (PlumaFileBrowserWidget * obj,
                         gboolean update_entry)
 {
 	GtkTreeModel *model;
+	gboolean refiltered = FALSE;
 
 	model =
 	    gtk_tree_view_get_model (GTK_TREE_VIEW (obj->priv->treeview));
@@ -1757,7 +1762,7 @@ set_filter_pattern_real (PlumaFileBrowserWidget * obj,
 	obj->priv->filter_pattern_str = g_strdup (pattern);
 
 	if (obj->priv->filter_pattern) {
-		g_pattern_spec_free (obj->priv->filter_pattern);
+		pluma_file_browser_filter_free (obj->priv->filter_pattern);
 		obj->priv->filter_pattern = NULL;
 	}
 
@@ -1768,16 +1773,19 @@ set_filter_pattern_real (PlumaFileBrowserWidget * obj,
 								 priv->
 								 glob_filter_id);
 			obj->priv->glob_filter_id = 0;
+			refiltered = TRUE;
 		}
 	} else {
-		obj->priv->filter_pattern = g_pattern_spec_new (pattern);
+		obj->priv->filter_pattern = pluma_file_browser_filter_new (pattern);
 
-		if (obj->priv->glob_filter_id == 0)
+		if (obj->priv->glob_filter_id == 0) {
 			obj->priv->glob_filter_id =
 			    pluma_file_browser_widget_add_filter (obj,
 								  filter_glob,
 								  NULL,
 								  NULL);
+			refiltered = TRUE;
+		}
 	}
 
 	if (update_entry) {
@@ -1793,7 +1801,8 @@ set_filter_pattern_real (PlumaFileBrowserWidget * obj,
 		}
 	}
 
-	if (PLUMA_IS_FILE_BROWSER_STORE (model))
+	/* Adding or removing the glob filter already refiltered the store */
+	if (!refiltered && PLUMA_IS_FILE_BROWSER_STORE (model))
 		pluma_file_browser_store_refilter (PLUMA_FILE_BROWSER_STORE
 						   (model));
 
@@ -1963,6 +1972,8 @@ pluma_file_browser_widget_remove_filter (PlumaFileBrowserWidget * obj,
 {
 	GSList *item;
 	FilterFunc *func;
+	GtkTreeModel *model =
+	    gtk_tree_view_get_model (GTK_TREE_VIEW (obj->priv->treeview));
 
 	for (item = obj->priv->filter_funcs; item; item = item->next)
 	{
@@ -1974,9 +1985,14 @@ pluma_file_browser_widget_remove_filter (PlumaFileBrowserWidget * obj,
 				func->destroy_notify (func->user_data);
 
 			obj->priv->filter_funcs =
-			    g_slist_remove_link (obj->priv->filter_funcs,
+			    g_slist_delete_link (obj->priv->filter_funcs,
 						 item);
 			g_free (func);
+
+			/* The store caches the filter results per node */
+			if (PLUMA_IS_FILE_BROWSER_STORE (model))
+				pluma_file_browser_store_refilter (PLUMA_FILE_BROWSER_STORE
+								   (model));
 			break;
 		}
 	}
@@ -32,6 +32,18 @@
 
 #define MODELINES_LANGUAGE_MAPPINGS_FILE "language-mappings"
 
+/* Modelines are looked for in the first and last lines only */
+#define HEAD_LINES	10
+#define TAIL_LINES	10
+
+/* Only the start of each of these lines is read, a modeline further away
+ * in a very long line (minified code, logs) is ignored */
+#define MAX_LINE_PREFIX	1024
+
+/* From this number of lines on, a line is either in the head or in the
+ * tail and its options do not depend on the number of lines */
+#define MIN_SPLIT_LINE_COUNT	(HEAD_LINES + TAIL_LINES + 1)
+
 /* base dir to lookup configuration files */
 static gchar *modelines_data_dir;
 
@@ -40,6 +52,9 @@ static GHashTable *vim_languages;
 static GHashTable *emacs_languages;
 static GHashTable *kate_languages;
 
+/* Shared by all the views */
+static GSettings *settings;
+
 typedef enum
 {
 	MODELINE_SET_NONE = 0,
@@ -67,6 +82,11 @@ typedef struct _ModelineOptions
 	guint		right_margin_position;
 
 	ModelineSet	set;
+
+	/* what the options were parsed from, see get_fingerprint () */
+	guint		head_hash;
+	guint		tail_hash;
+	gint		line_count;
 } ModelineOptions;
 
 #define MODELINE_OPTIONS_DATA_KEY "ModelineOptionsDataKey"
@@ -101,6 +121,8 @@ modeline_parser_shutdown ()
 	emacs_languages = NULL;
 	kate_languages = NULL;
 
+	g_clear_object (&settings);
+
 	g_free (modelines_data_dir);
 	modelines_data_dir = NULL;
 }
@@ -670,15 +692,77 @@ free_modeline_options (ModelineOptions *options)
 	g_slice_free (ModelineOptions, options);
 }
 
+/* Returns at most MAX_LINE_PREFIX characters of the line starting at
+ * @iter, and moves @iter to the start of the next line */
+static gchar *
+get_line_prefix (GtkTextBuffer *buffer,
+		 GtkTextIter   *iter)
+{
+	GtkTextIter line_start;
+	GtkTextIter line_end;
+	GtkTextIter prefix_end;
+	gchar *line;
+
+	line_start = *iter;
+
+	line_end = line_start;
+	if (!gtk_text_iter_ends_line (&line_end))
+		gtk_text_iter_forward_to_line_end (&line_end);
+
+	prefix_end = line_start;
+	gtk_text_iter_forward_chars (&prefix_end, MAX_LINE_PREFIX);
+
+	if (gtk_text_iter_compare (&prefix_end, &line_end) > 0)
+		prefix_end = line_end;
+
+	line = gtk_text_buffer_get_text (buffer, &line_start, &prefix_end, TRUE);
+
+	*iter = line_end;
+	gtk_text_iter_forward_line (iter);
+
+	return line;
+}
+
+static guint
+hash_lines (GPtrArray *lines)
+{
+	guint hash = 5381;
+	guint i;
+
+	for (i = 0; i < lines->len; i++)
+		hash = hash * 33 + g_str_hash (g_ptr_array_index (lines, i));
+
+	return hash;
+}
+
+static void
+get_fingerprint (GPtrArray *head,
+		 GPtrArray *tail,
+		 gint       line_count,
+		 guint     *head_hash,
+		 guint     *tail_hash,
+		 gint      *fingerprint_line_count)
+{
+	*head_hash = hash_lines (head);
+	*tail_hash = hash_lines (tail);
+	*fingerprint_line_count = MIN (line_count, MIN_SPLIT_LINE_COUNT);
+}
+
 void
 modeline_parser_apply_modeline (GtkSourceView *view)
 {
 	ModelineOptions options;
+	ModelineOptions *previous;
 	GtkTextBuffer *buffer;
-	GtkTextIter iter, liter;
+	GtkTextIter iter;
+	GPtrArray *head;
+	GPtrArray *tail;
 	gint line_count;
-	/* FIXME: avoid making a new gsettings variable */
-	GSettings *settings = g_settings_new (PLUMA_SCHEMA_ID);
+	gint tail_first_line;
+	guint i;
+
+	if (settings == NULL)
+		settings = g_settings_new (PLUMA_SCHEMA_ID);
 
 	options.language_id = NULL;
 	options.set = MODELINE_SET_NONE;
@@ -688,63 +772,73 @@ modeline_parser_apply_modeline (GtkSourceView *view)
 
 	line_count = gtk_text_buffer_get_line_count (buffer);
 
-	/* Parse the modelines on the 10 first lines... */
-	while ((gtk_text_iter_get_line (&iter) < 10) &&
+	head = g_ptr_array_new_with_free_func (g_free);
+	tail = g_ptr_array_new_with_free_func (g_free);
+
+	/* Read the 10 first lines... */
+	while ((gtk_text_iter_get_line (&iter) < HEAD_LINES) &&
 	       !gtk_text_iter_is_end (&iter))
 	{
-		gchar *line;
-
-		liter = iter;
-		gtk_text_iter_forward_to_line_end (&iter);
-		line = gtk_text_buffer_get_text (buffer, &liter, &iter, TRUE);
-
-		parse_modeline (line,
-				1 + gtk_text_iter_get_line (&iter),
-				line_count,
-				&options);
-
-		gtk_text_iter_forward_line (&iter);
-
-		g_free (line);
+		g_ptr_array_add (head, get_line_prefix (buffer, &iter));
 	}
 
-	/* ...and on the 10 last ones (modelines are not allowed in between) */
-	if (!gtk_text_iter_is_end (&iter))
+	/* ...and the 10 last ones (modelines are not allowed in between) */
+	if (!gtk_text_iter_is_end (&iter) &&
+	    line_count - gtk_text_iter_get_line (&iter) - 1 > TAIL_LINES)
 	{
-		gint cur_line;
-		guint remaining_lines;
-
-		/* we are on the 11th line (count from 0) */
-		cur_line = gtk_text_iter_get_line (&iter);
-		/* g_assert (10 == cur_line); */
-
-		remaining_lines = line_count - cur_line - 1;
-
-		if (remaining_lines > 10)
-		{
-			gtk_text_buffer_get_end_iter (buffer, &iter);
-			gtk_text_iter_backward_lines (&iter, 9);
-		}
+		gtk_text_buffer_get_end_iter (buffer, &iter);
+		gtk_text_iter_backward_lines (&iter, TAIL_LINES - 1);
 	}
 
+	tail_first_line = gtk_text_iter_get_line (&iter);
+
 	while (!gtk_text_iter_is_end (&iter))
 	{
-		gchar *line;
+		g_ptr_array_add (tail, get_line_prefix (buffer, &iter));
+	}
 
-		liter = iter;
-		gtk_text_iter_forward_to_line_end (&iter);
-		line = gtk_text_buffer_get_text (buffer, &liter, &iter, TRUE);
+	get_fingerprint (head, tail, line_count,
+			 &options.head_hash,
+			 &options.tail_hash,
+			 &options.line_count);
 
-		parse_modeline (line,
-				1 + gtk_text_iter_get_line (&iter),
-				line_count,
-				&options);
+	previous = g_object_get_data (G_OBJECT (buffer),
+	                              MODELINE_OPTIONS_DATA_KEY);
 
-		gtk_text_iter_forward_line (&iter);
+	/* Saving usually leaves the first and last lines alone, there is no
+	 * need to parse them again then */
+	if (previous != NULL &&
+	    previous->head_hash == options.head_hash &&
+	    previous->tail_hash == options.tail_hash &&
+	    previous->line_count == options.line_count)
+	{
+		pluma_debug_message (DEBUG_PLUGINS, "Modelines unchanged");
+
+		options = *previous;
+		options.language_id = g_strdup (previous->language_id);
+	}
+	else
+	{
+		for (i = 0; i < head->len; i++)
+		{
+			parse_modeline (g_ptr_array_index (head, i),
+					1 + i,
+					line_count,
+					&options);
+		}
 
-		g_free (line);
+		for (i = 0; i < tail->len; i++)
+		{
+			parse_modeline (g_ptr_array_index (tail, i),
+					1 + tail_first_line + i,
+					line_count,
+					&options);
+		}
 	}
 
+	g_ptr_array_free (head, TRUE);
+	g_ptr_array_free (tail, TRUE);
+
 	/* Try to set language */
 	if (has_option (&options, MODELINE_SET_LANGUAGE) && options.language_id)
 	{
@@ -762,9 +856,6 @@ modeline_parser_apply_modeline (GtkSourceView *view)
 		}
 	}
 
-	ModelineOptions *previous = g_object_get_data (G_OBJECT (buffer),
-	                                               MODELINE_OPTIONS_DATA_KEY);
-
 	/* Apply the options we got from modelines and restore defaults if
 	   we set them before */
 	if (has_option (&options, MODELINE_SET_INSERT_SPACES))
@@ -830,6 +921,8 @@ modeline_parser_apply_modeline (GtkSourceView *view)
 
 	if (previous)
 	{
+		g_free (previous->language_id);
+
 		*previous = options;
 		previous->language_id = g_strdup (options.language_id);
 	}
@@ -846,7 +939,6 @@ modeline_parser_apply_modeline (GtkSourceView *view)
 	}
 
 	g_free (options.language_id);
-	g_object_unref (settings);
 }
 
 void
@@ -211,12 +211,45 @@ disconnect_handlers (PlumaView *view)
 	}
 }
 
+static void
+on_tab_view_created (PlumaTab   *tab,
+		     GParamSpec *pspec,
+		     gpointer    user_data)
+{
+	PlumaView *view;
+
+	g_signal_handlers_disconnect_by_func (tab, on_tab_view_created, user_data);
+
+	view = pluma_tab_get_view (tab);
+
+	connect_handlers (view);
+
+	/* the document may have been loaded before its view was created */
+	if (pluma_tab_get_state (tab) == PLUMA_TAB_STATE_NORMAL)
+		modeline_parser_apply_modeline (GTK_SOURCE_VIEW (view));
+}
+
 static void
 on_window_tab_added (PlumaWindow *window,
 		     PlumaTab *tab,
 		     gpointer user_data)
 {
-	connect_handlers (pluma_tab_get_view (tab));
+	PlumaView *view;
+
+	/* do not force the creation of the view of a tab opened
+	 * in the background */
+	g_object_get (tab, "view", &view, NULL);
+
+	if (view != NULL)
+	{
+		connect_handlers (view);
+		g_object_unref (view);
+	}
+	else
+	{
+		g_signal_connect (tab, "notify::view",
+				  G_CALLBACK (on_tab_view_created), NULL);
+	}
 }
 
 static void
@@ -224,7 +257,19 @@ on_window_tab_removed (PlumaWindow *window,
 		       PlumaTab *tab,
 		       gpointer user_data)
 {
-	disconnect_handlers (pluma_tab_get_view (tab));
+	PlumaView *view;
+
+	g_object_get (tab, "view", &view, NULL);
+
+	if (view != NULL)
+	{
+		disconnect_handlers (view);
+		g_object_unref (view);
+	}
+	else
+	{
+		g_signal_handlers_disconnect_by_func (tab, on_tab_view_created, NULL);
+	}
 }
 
 static void
@@ -232,7 +277,7 @@ pluma_modeline_plugin_activate (PlumaWindowActivatable *activatable)
 {
 	PlumaModelinePluginPrivate *data;
 	PlumaWindow *window;
-	GList *views;
+	GList *docs;
 	GList *l;
 
 	pluma_debug (DEBUG_PLUGINS);
@@ -240,13 +285,28 @@ pluma_modeline_plugin_activate (PlumaWindowActivatable *activatable)
 	data = PLUMA_MODELINE_PLUGIN (activatable)->priv;
 	window = PLUMA_WINDOW (data->window);
 
-	views = pluma_window_get_views (window);
-	for (l = views; l != NULL; l = l->next)
+	docs = pluma_window_get_documents (window);
+	for (l = docs; l != NULL; l = l->next)
 	{
-		connect_handlers (PLUMA_VIEW (l->data));
-		modeline_parser_apply_modeline (GTK_SOURCE_VIEW (l->data));
+		PlumaTab *tab;
+		PlumaView *view;
+
+		tab = pluma_tab_get_from_document (PLUMA_DOCUMENT (l->data));
+		g_object_get (tab, "view", &view, NULL);
+
+		if (view != NULL)
+		{
+			connect_handlers (view);
+			modeline_parser_apply_modeline (GTK_SOURCE_VIEW (view));
+			g_object_unref (view);
+		}
+		else
+		{
+			g_signal_connect (tab, "notify::view",
+					  G_CALLBACK (on_tab_view_created), NULL);
+		}
 	}
-	g_list_free (views);
+	g_list_free (docs);
 
 	data->tab_added_handler_id =
 		g_signal_connect (window, "tab-added",
@@ -262,7 +322,7 @@ pluma_modeline_plugin_deactivate (PlumaWindowActivatable *activatable)
 {
 	PlumaModelinePluginPrivate *data;
 	PlumaWindow *window;
-	GList *views;
+	GList *docs;
 	GList *l;
 
 	pluma_debug (DEBUG_PLUGINS);
@@ -273,16 +333,29 @@ pluma_modeline_plugin_deactivate (PlumaWindowActivatable *activatable)
 	g_signal_handler_disconnect (window, data->tab_added_handler_id);
 	g_signal_handler_disconnect (window, data->tab_removed_handler_id);
 
-	views = pluma_window_get_views (window);
+	/* pluma_window_get_views () would create the views of the tabs
+	   that were never shown, they have nothing to undo */
+	docs = pluma_window_get_documents (window);
 
-	for (l = views; l != NULL; l = l->next)
+	for (l = docs; l != NULL; l = l->next)
 	{
-		disconnect_handlers (PLUMA_VIEW (l->data));
+		PlumaTab *tab;
+		PlumaView *view;
+
+		tab = pluma_tab_get_from_document (PLUMA_DOCUMENT (l->data));
+		g_signal_handlers_disconnect_by_func (tab, on_tab_view_created, NULL);
+
+		g_object_get (tab, "view", &view, NULL);
 
-		modeline_parser_deactivate (GTK_SOURCE_VIEW (l->data));
+		if (view != NULL)
+		{
+			disconnect_handlers (view);
+			modeline_parser_deactivate (GTK_SOURCE_VIEW (view));
+			g_object_unref (view);
+		}
 	}
 
-	g_list_free (views);
+	g_list_free (docs);
 }
 
 static void
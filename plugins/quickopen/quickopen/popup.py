@@ -28,7 +28,13 @@ from .virtualdirs import VirtualDirectory
 class Popup(Gtk.Dialog):
     __gtype_name__ = "QuickOpenPopup"
 
-    def __init__(self, window, paths, handler):
+    # Maximum number of results taken from a file index
+    MAX_INDEX_RESULTS = 200
+
+    # Number of index results added to the store per idle callback
+    INDEX_RESULTS_PER_IDLE = 25
+
+    def __init__(self, window, paths, handler, indexed=None):
         Gtk.Dialog.__init__(self,
                             title=_('Quick Open'),
                             parent=window,
@@ -44,6 +50,10 @@ class Popup(Gtk.Dialog):
         self._size = (0, 0)
         self._dirs = []
         self._cache = {}
+        self._indexes = {}
+        self._index_handlers = []
+        self._pending = []
+        self._pending_id = 0
         self._theme = None
         self._cursor = None
         self._shift_start = None
@@ -65,6 +75,15 @@ class Popup(Gtk.Dialog):
                 self._dirs.append(path)
                 unique.append(path.get_uri())
 
+        # Directories searched recursively through the shared file index
+        for path in indexed or []:
+            index = Pluma.FileIndex.get_for_root(path)
+            self._indexes[path.get_uri()] = index
+
+            if index.is_scanning():
+                handler = index.connect('scan-finished', self.on_index_scan_finished)
+                self._index_handlers.append((index, handler))
+
     def get_final_size(self):
         return self._size
 
@@ -230,6 +249,42 @@ class Popup(Gtk.Dialog):
 
         return found
 
+    def _search_index(self, index, text):
+        found = []
+        root = index.get_root()
+
+        for path in index.query(text, self.MAX_INDEX_RESULTS):
+            if path.endswith('/'):
+                gfile = root.resolve_relative_path(path[:-1])
+                icon = Gio.ThemedIcon.new('folder')
+                file_type = Gio.FileType.DIRECTORY
+            else:
+                gfile = root.resolve_relative_path(path)
+                content_type, uncertain = Gio.content_type_guess(path, None)
+                icon = Gio.content_type_get_icon(content_type)
+                file_type = Gio.FileType.REGULAR
+
+            found.append((gfile, path, file_type, icon))
+
+        return found
+
+    def _markup_subsequence(self, s, find):
+        out = ''
+        l = s.lower()
+        find = find.lower()
+        last = 0
+
+        for c in find:
+            m = l.find(c, last)
+
+            if m == -1:
+                break
+
+            out += xml.sax.saxutils.escape(s[last:m]) + '<b>%s</b>' % (xml.sax.saxutils.escape(s[m]),)
+            last = m + 1
+
+        return out + xml.sax.saxutils.escape(s[last:])
+
     def _replace_insensitive(self, s, find, rep):
         out = ''
         l = s.lower()
@@ -319,6 +374,33 @@ class Popup(Gtk.Dialog):
                                            entry[0],
                                            entry[1].get_file_type()))
 
+    def _cancel_pending(self):
+        if self._pending_id:
+            GLib.source_remove(self._pending_id)
+            self._pending_id = 0
+
+        self._pending = []
+
+    def _flush_pending(self):
+        batch = self._pending[:self.INDEX_RESULTS_PER_IDLE]
+        del self._pending[:self.INDEX_RESULTS_PER_IDLE]
+
+        for item in batch:
+            self._append_to_store(item)
+
+        if not self._pending:
+            self._pending_id = 0
+            return False
+
+        return True
+
+    def _queue_index_results(self, index, text):
+        for entry in self._search_index(index, text):
+            self._pending.append((entry[3],
+                                  self._markup_subsequence(entry[1], text),
+                                  entry[0],
+                                  entry[2]))
+
     def _set_busy(self, busy):
         if busy:
             self.get_window().set_cursor(self._busy_cursor)
@@ -339,6 +421,7 @@ class Popup(Gtk.Dialog):
         self._remove_cursor()
 
         text = self._entry.get_text().strip()
+        self._cancel_pending()
         self._clear_store()
 
         if text == '':
@@ -348,6 +431,12 @@ class Popup(Gtk.Dialog):
             files = []
 
             for d in self._dirs:
+                index = self._indexes.get(d.get_uri())
+
+                if index and not '..' in parts:
+                    self._queue_index_results(index, text)
+                    continue
+
                 for entry in self.do_search_dir(parts, d):
                     pathparts = self._make_parts(d, entry[0], parts)
                     self._append_to_store((entry[3],
@@ -355,6 +444,13 @@ class Popup(Gtk.Dialog):
                                            entry[0],
                                            entry[2]))
 
+            # Show the best ranked results right away, stream in the rest
+            if self._pending:
+                self._flush_pending()
+
+            if self._pending:
+                self._pending_id = GLib.idle_add(self._flush_pending)
+
         piter = self._store.get_iter_first()
 
         if piter:
@@ -371,6 +467,21 @@ class Popup(Gtk.Dialog):
 
         self.do_search()
 
+    def on_index_scan_finished(self, index):
+        if self.get_visible() and self._entry.get_text().strip() != '':
+            self.do_search()
+
+    def do_destroy(self):
+        self._cancel_pending()
+
+        for index, handler in self._index_handlers:
+            index.disconnect(handler)
+
+        self._index_handlers = []
+        self._indexes = {}
+
+        Gtk.Dialog.do_destroy(self)
+
     def on_changed(self, editable):
         self.do_search()
         self.on_selection_changed(self._treeview.get_selection())
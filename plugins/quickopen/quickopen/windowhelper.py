@@ -75,6 +75,7 @@ class WindowHelper:
 
     def _create_popup(self):
         paths = []
+        indexed = []
 
         # Open documents
         paths.append(CurrentDocumentsDirectory(self._window))
@@ -100,6 +101,7 @@ class WindowHelper:
 
                     if gfile and gfile.is_native():
                         paths.append(gfile)
+                        indexed.append(gfile)
 
         except Exception:
             pass
@@ -120,7 +122,7 @@ class WindowHelper:
         # Home directory
         paths.append(Gio.file_new_for_path(os.path.expanduser('~')))
 
-        self._popup = Popup(self._window, paths, self.on_activated)
+        self._popup = Popup(self._window, paths, self.on_activated, indexed)
 
         self._popup.set_default_size(*self._plugin.get_popup_size())
         self._popup.set_transient_for(self._window)
@@ -43,9 +43,8 @@ class WindowHelper:
         window.connect('tab-added', self.on_tab_added)
 
         # Add controllers to all the current views
-        for view in self.window.get_views():
-            if isinstance(view, Pluma.View) and not self.has_controller(view):
-                view._snippet_controller = Document(self, view)
+        for doc in self.window.get_documents():
+            self.on_tab_added(self.window, Pluma.Tab.get_from_document(doc))
 
         self.update()
 
@@ -55,8 +54,10 @@ class WindowHelper:
 
         self.remove_menu()
 
-        # Iterate over all the tabs and remove every controller
-        for view in self.window.get_views():
+        # Iterate over all the tabs and remove every controller, the tabs
+        # that were never shown have no view and no controller
+        for doc in self.window.get_documents():
+            view = Pluma.Tab.get_from_document(doc).props.view
             if isinstance(view, Pluma.View) and self.has_controller(view):
                 view._snippet_controller.stop()
                 view._snippet_controller = None
@@ -135,14 +136,25 @@ class WindowHelper:
     # Callbacks
 
     def on_tab_added(self, window, tab):
-        # Create a new controller for this tab if it has a standard pluma view
-        view = tab.get_view()
+        # Tabs opened in the background get their view when first shown
+        view = tab.props.view
+
+        if view is None:
+            tab.connect('notify::view', self.on_tab_view_created)
+            return
 
+        # Create a new controller for this tab if it has a standard pluma view
         if isinstance(view, Pluma.View) and not self.has_controller(view):
             view._snippet_controller = Document(self, view)
 
         self.update()
 
+    def on_tab_view_created(self, tab, pspec):
+        tab.disconnect_by_func(self.on_tab_view_created)
+
+        if self.window is not None:
+            self.on_tab_added(self.window, tab)
+
     def on_action_snippets_activate(self, item):
         self.plugin.create_configure_dialog()
 
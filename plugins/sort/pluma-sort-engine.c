@@ -0,0 +1,761 @@
+/*
+ * pluma-sort-engine.c
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Sorts the lines of a text. The lines are not copied: they are described
+ * by an array of SortLine pointing into the text, and the keys that need
+ * to be transformed (case folded or collation keys) are computed once per
+ * line into per thread arenas. The sort itself is a stable merge sort,
+ * whose halves are sorted on separate threads down to a depth matching
+ * the number of processors.
+ *
+ * Line terminators stay where they were: the n-th line of the result is
+ * followed by the terminator which followed the n-th line of the text,
+ * and the result ends the way the text did.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <math.h>
+#include <string.h>
+
+#include "pluma-sort-engine.h"
+
+/* Ranges smaller than this are not worth a thread */
+#define MIN_PARALLEL_LINES	16384
+
+typedef struct
+{
+	const gchar *line;
+	gsize line_len;
+
+	/* length of the terminator following the line */
+	guint term_len;
+
+	const gchar *key;
+	gsize key_len;
+
+	/* PLUMA_SORT_KEY_NUMERIC only, lines without a number sort first
+	 * and by their key text among themselves */
+	gdouble number;
+	gboolean has_number;
+} SortLine;
+
+typedef struct
+{
+	SortLine *lines;
+	gsize n_lines;
+	const PlumaSortOptions *options;
+
+	GString *arena;
+} KeyJob;
+
+typedef struct
+{
+	SortLine **lines;
+	SortLine **tmp;
+	gsize n_lines;
+	gint depth;
+	const PlumaSortOptions *options;
+} SortJob;
+
+static gsize
+get_terminator_len (const gchar *p,
+		    const gchar *end)
+{
+	if (*p == '\n')
+		return 1;
+
+	if (*p == '\r')
+		return (p + 1 < end && p[1] == '\n') ? 2 : 1;
+
+	/* U+2028 LINE SEPARATOR and U+2029 PARAGRAPH SEPARATOR, which are
+	 * line terminators for GtkTextBuffer too */
+	if ((guchar) *p == 0xe2 && p + 2 < end &&
+	    (guchar) p[1] == 0x80 &&
+	    ((guchar) p[2] == 0xa8 || (guchar) p[2] == 0xa9))
+		return 3;
+
+	return 0;
+}
+
+static SortLine *
+split_lines (const gchar *text,
+	     gsize        len,
+	     gsize       *n_lines)
+{
+	const gchar *end = text + len;
+	const gchar *line;
+	const gchar *p;
+	SortLine *lines;
+	gsize allocated = 1024;
+	gsize n = 0;
+
+	lines = g_new (SortLine, allocated);
+
+	line = text;
+	p = text;
+
+	while (p < end)
+	{
+		gsize term_len;
+
+		term_len = get_terminator_len (p, end);
+
+		if (term_len == 0)
+		{
+			++p;
+			continue;
+		}
+
+		if (n == allocated)
+		{
+			allocated *= 2;
+			lines = g_renew (SortLine, lines, allocated);
+		}
+
+		lines[n].line = line;
+		lines[n].line_len = p - line;
+		lines[n].term_len = term_len;
+		++n;
+
+		p += term_len;
+		line = p;
+	}
+
+	/* The text after the last terminator, if any */
+	if (line < end)
+	{
+		if (n == allocated)
+			lines = g_renew (SortLine, lines, allocated + 1);
+
+		lines[n].line = line;
+		lines[n].line_len = end - line;
+		lines[n].term_len = 0;
+		++n;
+	}
+
+	*n_lines = n;
+
+	return lines;
+}
+
+static const gchar *
+skip_blanks (const gchar *p,
+	     const gchar *end)
+{
+	while (p < end && (*p == ' ' || *p == '\t'))
+		++p;
+
+	return p;
+}
+
+/* Finds the field of the line to compare, then the start column in it */
+static void
+get_key_bounds (const SortLine         *line,
+		const PlumaSortOptions *options,
+		const gchar           **key_start,
+		const gchar           **key_end)
+{
+	const gchar *start = line->line;
+	const gchar *end = line->line + line->line_len;
+	gint i;
+
+	if (options->field > 0)
+	{
+		for (i = 1; start < end; ++i)
+		{
+			const gchar *field_end;
+
+			if (options->delimiter == 0)
+				start = skip_blanks (start, end);
+
+			field_end = start;
+
+			while (field_end < end)
+			{
+				if (options->delimiter == 0 ?
+				    (*field_end == ' ' || *field_end == '\t') :
+				    g_utf8_get_char (field_end) == options->delimiter)
+					break;
+
+				field_end = g_utf8_next_char (field_end);
+			}
+
+			if (i == options->field)
+			{
+				end = field_end;
+				break;
+			}
+
+			if (field_end == end)
+			{
+				/* the line has no such field */
+				start = end;
+				break;
+			}
+
+			start = g_utf8_next_char (field_end);
+		}
+	}
+
+	for (i = 0; i < options->start_column && start < end; ++i)
+		start = g_utf8_next_char (start);
+
+	*key_start = MIN (start, end);
+	*key_end = end;
+}
+
+static gboolean
+parse_number (const gchar *p,
+	      const gchar *end,
+	      gdouble     *number)
+{
+	const gchar *digits;
+
+	p = skip_blanks (p, end);
+
+	digits = p;
+
+	if (digits < end && (*digits == '-' || *digits == '+'))
+		++digits;
+
+	/* g_ascii_strtod also parses "inf" and "nan", which are not numbers
+	 * in the sense of the text; it stops before the line terminator */
+	if (digits < end && (g_ascii_isdigit (*digits) || *digits == '.'))
+	{
+		gchar *number_end;
+
+		*number = g_ascii_strtod (p, &number_end);
+
+		if (number_end != p && number_end <= end && !isnan (*number))
+			return TRUE;
+	}
+
+	*number = -HUGE_VAL;
+
+	return FALSE;
+}
+
+static gpointer
+key_job_run (KeyJob *job)
+{
+	const PlumaSortOptions *options = job->options;
+	gboolean use_arena;
+	gsize i;
+
+	use_arena = options->mode == PLUMA_SORT_KEY_TEXT ||
+		    (options->ignore_case && options->mode != PLUMA_SORT_KEY_NUMERIC);
+
+	if (use_arena)
+		job->arena = g_string_sized_new (64);
+
+	/* Arena offsets are stored in the key pointers at first, since the
+	 * arena may move while it grows */
+	for (i = 0; i < job->n_lines; ++i)
+	{
+		SortLine *line = &job->lines[i];
+		const gchar *key_start;
+		const gchar *key_end;
+		gchar *folded = NULL;
+		gchar *collated = NULL;
+		const gchar *key;
+		gsize key_len;
+
+		get_key_bounds (line, options, &key_start, &key_end);
+
+		if (options->mode == PLUMA_SORT_KEY_NUMERIC)
+		{
+			line->key = key_start;
+			line->key_len = key_end - key_start;
+			line->has_number = parse_number (key_start, key_end, &line->number);
+			continue;
+		}
+
+		if (!use_arena)
+		{
+			line->key = key_start;
+			line->key_len = key_end - key_start;
+			continue;
+		}
+
+		key = key_start;
+		key_len = key_end - key_start;
+
+		if (options->ignore_case)
+		{
+			folded = g_utf8_casefold (key, key_len);
+			key = folded;
+			key_len = strlen (folded);
+		}
+
+		if (options->mode == PLUMA_SORT_KEY_TEXT)
+		{
+			collated = g_utf8_collate_key (key, key_len);
+			key = collated;
+			key_len = strlen (collated);
+		}
+
+		line->key = GSIZE_TO_POINTER (job->arena->len);
+		line->key_len = key_len;
+
+		g_string_append_len (job->arena, key, key_len);
+
+		g_free (folded);
+		g_free (collated);
+	}
+
+	if (use_arena)
+	{
+		for (i = 0; i < job->n_lines; ++i)
+		{
+			SortLine *line = &job->lines[i];
+
+			line->key = job->arena->str + GPOINTER_TO_SIZE (line->key);
+		}
+	}
+
+	return NULL;
+}
+
+static gint
+compare_bytes (const gchar *key1,
+	       gsize        len1,
+	       const gchar *key2,
+	       gsize        len2)
+{
+	gint ret;
+
+	ret = memcmp (key1, key2, MIN (len1, len2));
+
+	if (ret != 0)
+		return ret < 0 ? -1 : 1;
+
+	return (len1 > len2) - (len1 < len2);
+}
+
+/* Runs of digits compare by value, everything else byte by byte */
+static gint
+compare_natural (const gchar *key1,
+		 gsize        len1,
+		 const gchar *key2,
+		 gsize        len2)
+{
+	const gchar *end1 = key1 + len1;
+	const gchar *end2 = key2 + len2;
+
+	while (key1 < end1 && key2 < end2)
+	{
+		if (g_ascii_isdigit (*key1) && g_ascii_isdigit (*key2))
+		{
+			const gchar *digits1;
+			const gchar *digits2;
+			gint ret;
+
+			while (key1 < end1 && *key1 == '0')
+				++key1;
+			while (key2 < end2 && *key2 == '0')
+				++key2;
+
+			digits1 = key1;
+			digits2 = key2;
+
+			while (key1 < end1 && g_ascii_isdigit (*key1))
+				++key1;
+			while (key2 < end2 && g_ascii_isdigit (*key2))
+				++key2;
+
+			if (key1 - digits1 != key2 - digits2)
+				return (key1 - digits1) < (key2 - digits2) ? -1 : 1;
+
+			ret = memcmp (digits1, digits2, key1 - digits1);
+
+			if (ret != 0)
+				return ret < 0 ? -1 : 1;
+
+			continue;
+		}
+
+		if (*key1 != *key2)
+			return (guchar) *key1 < (guchar) *key2 ? -1 : 1;
+
+		++key1;
+		++key2;
+	}
+
+	return (key1 < end1) - (key2 < end2);
+}
+
+static gint
+version_order (const gchar *p,
+	       const gchar *end)
+{
+	if (p >= end || g_ascii_isdigit (*p))
+		return 0;
+
+	if (g_ascii_isalpha (*p))
+		return (guchar) *p;
+
+	/* a tilde sorts before anything, even the end of the version */
+	if (*p == '~')
+		return -1;
+
+	return (guchar) *p + 256;
+}
+
+/* Debian version ordering: "1.9" < "1.10" and "1.0~rc1" < "1.0" */
+static gint
+compare_version (const gchar *key1,
+		 gsize        len1,
+		 const gchar *key2,
+		 gsize        len2)
+{
+	const gchar *end1 = key1 + len1;
+	const gchar *end2 = key2 + len2;
+
+	while (key1 < end1 || key2 < end2)
+	{
+		gint first_diff = 0;
+
+		while ((key1 < end1 && !g_ascii_isdigit (*key1)) ||
+		       (key2 < end2 && !g_ascii_isdigit (*key2)))
+		{
+			gint order1 = version_order (key1, end1);
+			gint order2 = version_order (key2, end2);
+
+			if (order1 != order2)
+				return order1 < order2 ? -1 : 1;
+
+			if (key1 < end1)
+				++key1;
+			if (key2 < end2)
+				++key2;
+		}
+
+		while (key1 < end1 && *key1 == '0')
+			++key1;
+		while (key2 < end2 && *key2 == '0')
+			++key2;
+
+		while (key1 < end1 && g_ascii_isdigit (*key1) &&
+		       key2 < end2 && g_ascii_isdigit (*key2))
+		{
+			if (first_diff == 0)
+				first_diff = *key1 - *key2;
+
+			++key1;
+			++key2;
+		}
+
+		if (key1 < end1 && g_ascii_isdigit (*key1))
+			return 1;
+		if (key2 < end2 && g_ascii_isdigit (*key2))
+			return -1;
+		if (first_diff != 0)
+			return first_diff < 0 ? -1 : 1;
+	}
+
+	return 0;
+}
+
+static gint
+compare_keys (const SortLine         *line1,
+	      const SortLine         *line2,
+	      const PlumaSortOptions *options)
+{
+	switch (options->mode)
+	{
+		case PLUMA_SORT_KEY_NUMERIC:
+			/* otherwise all the lines without a number would be
+			 * duplicates of each other */
+			if (!line1->has_number && !line2->has_number)
+				return compare_bytes (line1->key, line1->key_len,
+						      line2->key, line2->key_len);
+
+			return (line1->number > line2->number) - (line1->number < line2->number);
+
+		case PLUMA_SORT_KEY_NATURAL:
+			return compare_natural (line1->key, line1->key_len,
+						line2->key, line2->key_len);
+
+		case PLUMA_SORT_KEY_VERSION:
+			return compare_version (line1->key, line1->key_len,
+						line2->key, line2->key_len);
+
+		case PLUMA_SORT_KEY_TEXT:
+		case PLUMA_SORT_KEY_BYTES:
+		default:
+			/* collation keys compare byte by byte too */
+			return compare_bytes (line1->key, line1->key_len,
+					      line2->key, line2->key_len);
+	}
+}
+
+static gint
+compare_lines (gconstpointer a,
+	       gconstpointer b,
+	       gpointer      user_data)
+{
+	const PlumaSortOptions *options = user_data;
+	gint ret;
+
+	ret = compare_keys (*(SortLine * const *) a,
+			    *(SortLine * const *) b,
+			    options);
+
+	return options->reverse ? -ret : ret;
+}
+
+static void
+merge (SortLine               **left,
+       gsize                    n_left,
+       SortLine               **right,
+       gsize                    n_right,
+       SortLine               **dest,
+       const PlumaSortOptions  *options)
+{
+	gsize i = 0;
+	gsize j = 0;
+
+	/* ties are taken from the left to keep the sort stable */
+	while (i < n_left && j < n_right)
+	{
+		if (compare_lines (&left[i], &right[j], (gpointer) options) <= 0)
+			*dest++ = left[i++];
+		else
+			*dest++ = right[j++];
+	}
+
+	memcpy (dest, left + i, (n_left - i) * sizeof (SortLine *));
+	dest += n_left - i;
+	memcpy (dest, right + j, (n_right - j) * sizeof (SortLine *));
+}
+
+static gpointer
+sort_job_run (SortJob *job)
+{
+	SortJob left;
+	SortJob right;
+	GThread *thread;
+
+	if (job->depth == 0 || job->n_lines < 2 * MIN_PARALLEL_LINES)
+	{
+		/* g_qsort_with_data is a stable merge sort */
+		g_qsort_with_data (job->lines,
+				   job->n_lines,
+				   sizeof (SortLine *),
+				   compare_lines,
+				   (gpointer) job->options);
+		return NULL;
+	}
+
+	left = *job;
+	left.n_lines = job->n_lines / 2;
+	left.depth = job->depth - 1;
+
+	right = left;
+	right.lines = job->lines + left.n_lines;
+	right.tmp = job->tmp + left.n_lines;
+	right.n_lines = job->n_lines - left.n_lines;
+
+	thread = g_thread_try_new ("pluma-sort",
+				   (GThreadFunc) sort_job_run,
+				   &left,
+				   NULL);
+
+	if (thread == NULL)
+		sort_job_run (&left);
+
+	sort_job_run (&right);
+
+	if (thread != NULL)
+		g_thread_join (thread);
+
+	merge (left.lines, left.n_lines,
+	       right.lines, right.n_lines,
+	       job->tmp,
+	       job->options);
+
+	memcpy (job->lines, job->tmp, job->n_lines * sizeof (SortLine *));
+
+	return NULL;
+}
+
+static gint
+get_sort_depth (gsize n_lines)
+{
+	guint n_processors;
+	gint depth = 0;
+
+	n_processors = g_get_num_processors ();
+
+	while ((1u << (depth + 1)) <= n_processors &&
+	       (n_lines >> (depth + 1)) >= MIN_PARALLEL_LINES)
+		++depth;
+
+	return depth;
+}
+
+static void
+compute_keys (SortLine               *lines,
+	      gsize                   n_lines,
+	      const PlumaSortOptions *options,
+	      GPtrArray              *arenas)
+{
+	KeyJob *jobs;
+	GThread **threads;
+	gint n_jobs;
+	gint i;
+
+	n_jobs = 1 << get_sort_depth (n_lines);
+
+	jobs = g_new0 (KeyJob, n_jobs);
+	threads = g_new0 (GThread *, n_jobs);
+
+	for (i = 0; i < n_jobs; ++i)
+	{
+		gsize first = n_lines * i / n_jobs;
+
+		jobs[i].lines = lines + first;
+		jobs[i].n_lines = n_lines * (i + 1) / n_jobs - first;
+		jobs[i].options = options;
+
+		if (i > 0)
+			threads[i] = g_thread_try_new ("pluma-sort-keys",
+						       (GThreadFunc) key_job_run,
+						       &jobs[i],
+						       NULL);
+
+		if (threads[i] == NULL)
+			key_job_run (&jobs[i]);
+	}
+
+	for (i = 0; i < n_jobs; ++i)
+	{
+		if (threads[i] != NULL)
+			g_thread_join (threads[i]);
+
+		if (jobs[i].arena != NULL)
+			g_ptr_array_add (arenas, jobs[i].arena);
+	}
+
+	g_free (threads);
+	g_free (jobs);
+}
+
+static void
+free_arena (GString *arena)
+{
+	g_string_free (arena, TRUE);
+}
+
+/**
+ * pluma_sort_lines:
+ * @text: the lines to sort
+ * @len: the length of @text in bytes, or -1 if it is nul-terminated
+ * @options: how to sort the lines
+ *
+ * Sorts the lines of @text. With @options->remove_duplicates only the
+ * first of the lines with equal keys is kept, since the sort is stable
+ * it is the first of them in @text.
+ *
+ * Returns: (transfer full): the sorted text, of the same length as @text
+ * unless duplicates were removed.
+ */
+gchar *
+pluma_sort_lines (const gchar            *text,
+		  gssize                  len,
+		  const PlumaSortOptions *options)
+{
+	SortLine *lines;
+	SortLine **sorted;
+	GPtrArray *arenas;
+	GString *result;
+	SortJob job;
+	gsize n_lines;
+	gsize n_sorted;
+	gsize i;
+
+	g_return_val_if_fail (text != NULL, NULL);
+	g_return_val_if_fail (options != NULL, NULL);
+
+	if (len < 0)
+		len = strlen (text);
+
+	lines = split_lines (text, len, &n_lines);
+
+	arenas = g_ptr_array_new_with_free_func ((GDestroyNotify) free_arena);
+	compute_keys (lines, n_lines, options, arenas);
+
+	sorted = g_new (SortLine *, n_lines);
+
+	for (i = 0; i < n_lines; ++i)
+		sorted[i] = &lines[i];
+
+	job.lines = sorted;
+	job.tmp = g_new (SortLine *, n_lines);
+	job.n_lines = n_lines;
+	job.depth = get_sort_depth (n_lines);
+	job.options = options;
+
+	sort_job_run (&job);
+
+	g_free (job.tmp);
+
+	n_sorted = n_lines;
+
+	if (options->remove_duplicates && n_lines > 0)
+	{
+		n_sorted = 1;
+
+		for (i = 1; i < n_lines; ++i)
+		{
+			if (compare_keys (sorted[n_sorted - 1], sorted[i], options) != 0)
+				sorted[n_sorted++] = sorted[i];
+		}
+	}
+
+	result = g_string_sized_new (len + 1);
+
+	for (i = 0; i < n_sorted; ++i)
+	{
+		const SortLine *term;
+
+		g_string_append_len (result, sorted[i]->line, sorted[i]->line_len);
+
+		/* The terminator of the line which was at this position, the
+		 * text keeps ending the way it did when lines were removed */
+		term = (i + 1 < n_sorted) ? &lines[i] : &lines[n_lines - 1];
+
+		g_string_append_len (result,
+				     term->line + term->line_len,
+				     term->term_len);
+	}
+
+	g_free (sorted);
+	g_free (lines);
+	g_ptr_array_free (arenas, TRUE);
+
+	return g_string_free (result, FALSE);
+}
@@ -0,0 +1,66 @@
+/*
+ * pluma-sort-engine.h
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ */
+
+#ifndef __PLUMA_SORT_ENGINE_H__
+#define __PLUMA_SORT_ENGINE_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef enum
+{
+	/* in the collation order of the locale */
+	PLUMA_SORT_KEY_TEXT,
+	PLUMA_SORT_KEY_BYTES,
+	PLUMA_SORT_KEY_NATURAL,
+	PLUMA_SORT_KEY_NUMERIC,
+	PLUMA_SORT_KEY_VERSION
+} PlumaSortKeyMode;
+
+typedef struct _PlumaSortOptions PlumaSortOptions;
+
+struct _PlumaSortOptions
+{
+	PlumaSortKeyMode mode;
+
+	gboolean ignore_case;
+	gboolean reverse;
+	gboolean remove_duplicates;
+
+	/* 1 based, 0 compares the whole line */
+	gint field;
+
+	/* separates the fields, 0 for runs of white space */
+	gunichar delimiter;
+
+	/* in characters, 0 based, inside the field */
+	gint start_column;
+};
+
+gchar	*pluma_sort_lines	(const gchar            *text,
+				 gssize                  len,
+				 const PlumaSortOptions *options);
+
+G_END_DECLS
+
+#endif /* __PLUMA_SORT_ENGINE_H__ */
@@ -26,6 +26,7 @@
 #endif
 
 #include "pluma-sort-plugin.h"
+#include "pluma-sort-engine.h"
 
 #include <string.h>
 #include <glib/gi18n-lib.h>
@@ -58,6 +59,9 @@ struct _PlumaSortPluginPrivate
 	GtkWidget *reverse_order_checkbutton;
 	GtkWidget *ignore_case_checkbutton;
 	GtkWidget *remove_dups_checkbutton;
+	GtkWidget *key_mode_combo;
+	GtkWidget *field_spinbutton;
+	GtkWidget *delimiter_entry;
 
 	GtkTextIter start, end; /* selection */
 };
@@ -82,13 +86,33 @@ static const GtkActionEntry action_entries[] =
 	  G_CALLBACK (sort_cb) }
 };
 
+/* Extends the range to whole lines, without the empty line following a
+ * selection which ends at the start of a line */
+static void
+get_sort_range (GtkTextIter *start,
+		GtkTextIter *end)
+{
+	gtk_text_iter_order (start, end);
+
+	gtk_text_iter_set_line_offset (start, 0);
+
+	if (gtk_text_iter_starts_line (end) &&
+	    gtk_text_iter_get_line (end) > gtk_text_iter_get_line (start))
+		return;
+
+	if (!gtk_text_iter_ends_line (end))
+		gtk_text_iter_forward_to_line_end (end);
+}
+
 static void
 do_sort (PlumaSortPlugin *plugin)
 {
 	PlumaSortPluginPrivate *priv;
 	PlumaDocument *doc;
-	GtkSourceSortFlags sort_flags = 0;
-	gint starting_column;
+	PlumaSortOptions options;
+	const gchar *delimiter;
+	gchar *text;
+	gchar *sorted;
 
 	pluma_debug (DEBUG_PLUGINS);
 
@@ -97,28 +121,44 @@ do_sort (PlumaSortPlugin *plugin)
 	doc = pluma_window_get_active_document (priv->window);
 	g_return_if_fail (doc != NULL);
 
-	if (gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (priv->ignore_case_checkbutton)))
-	{
-		sort_flags |= GTK_SOURCE_SORT_FLAGS_CASE_SENSITIVE;
-	}
+	options.mode = gtk_combo_box_get_active (GTK_COMBO_BOX (priv->key_mode_combo));
+	options.ignore_case = gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (priv->ignore_case_checkbutton));
+	options.reverse = gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (priv->reverse_order_checkbutton));
+	options.remove_duplicates = gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (priv->remove_dups_checkbutton));
+	options.field = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->field_spinbutton));
+	options.start_column = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->col_num_spinbutton)) - 1;
 
-	if (gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (priv->reverse_order_checkbutton)))
-	{
-		sort_flags |= GTK_SOURCE_SORT_FLAGS_REVERSE_ORDER;
-	}
+	delimiter = gtk_entry_get_text (GTK_ENTRY (priv->delimiter_entry));
+	options.delimiter = g_utf8_get_char (delimiter);
+
+	get_sort_range (&priv->start, &priv->end);
+
+	text = gtk_text_buffer_get_slice (GTK_TEXT_BUFFER (doc),
+					  &priv->start,
+					  &priv->end,
+					  TRUE);
 
-	if (gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (priv->remove_dups_checkbutton)))
+	sorted = pluma_sort_lines (text, -1, &options);
+
+	/* Replace the lines at once, so that the sort is undone in one step
+	 * and the buffer does not see one edit per line */
+	if (strcmp (text, sorted) != 0)
 	{
-		sort_flags |= GTK_SOURCE_SORT_FLAGS_REMOVE_DUPLICATES;
-	}
+		gtk_text_buffer_begin_user_action (GTK_TEXT_BUFFER (doc));
 
-	starting_column = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->col_num_spinbutton)) - 1;
+		gtk_text_buffer_delete (GTK_TEXT_BUFFER (doc),
+					&priv->start,
+					&priv->end);
+		gtk_text_buffer_insert (GTK_TEXT_BUFFER (doc),
+					&priv->start,
+					sorted,
+					-1);
+
+		gtk_text_buffer_end_user_action (GTK_TEXT_BUFFER (doc));
+	}
 
-	gtk_source_buffer_sort_lines (GTK_SOURCE_BUFFER (doc),
-	                              &priv->start,
-	                              &priv->end,
-	                              sort_flags,
-	                              starting_column);
+	g_free (text);
+	g_free (sorted);
 
 	pluma_debug_message (DEBUG_PLUGINS, "Done.");
 }
@@ -197,6 +237,9 @@ create_sort_dialog (PlumaSortPlugin *plugin)
 					  "col_num_spinbutton", &priv->col_num_spinbutton,
 					  "ignore_case_checkbutton", &priv->ignore_case_checkbutton,
 					  "remove_dups_checkbutton", &priv->remove_dups_checkbutton,
+					  "key_mode_combo", &priv->key_mode_combo,
+					  "field_spinbutton", &priv->field_spinbutton,
+					  "delimiter_entry", &priv->delimiter_entry,
 					  NULL);
 	g_free (data_dir);
 	g_free (ui_file);
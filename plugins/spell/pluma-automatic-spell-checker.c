@@ -43,6 +43,13 @@
 
 #include "pluma-automatic-spell-checker.h"
 #include "pluma-spell-utils.h"
+#include "pluma-spell-worker.h"
+
+/* Time spent handing out text to the workers per idle slice, in
+ * microseconds */
+#define RECHECK_TIME_BUDGET	8000
+#define RECHECK_CHUNK_LINES	512
+#define MAX_CHECK_JOBS		4
 
 struct _PlumaAutomaticSpellChecker {
 	PlumaDocument		*doc;
@@ -55,9 +62,34 @@ struct _PlumaAutomaticSpellChecker {
 	GtkTextTag 		*tag_highlight;
 	GtkTextMark		*mark_click;
 
+	/* text which still has to be checked by the idle recheck, the
+	 * tag follows the edits made in the meantime */
+	GtkTextTag		*tag_unchecked;
+	GtkTextMark		*mark_recheck;
+	guint			 recheck_idle_id;
+
+	/* text being checked by the workers */
+	GSList			*jobs;
+
        	PlumaSpellChecker	*spell_checker;
 };
 
+typedef struct
+{
+	PlumaAutomaticSpellChecker	*spell; /* NULL once the checker is gone */
+
+	GtkTextMark			*start;
+	GtkTextMark			*end;
+
+	gchar				*text;
+	const PlumaSpellCheckerLanguage	*language;
+
+	/* the text was edited while being checked */
+	gboolean			 stale;
+
+	GCancellable			*cancellable;
+} CheckJob;
+
 static GQuark automatic_spell_checker_id = 0;
 static GQuark suggestion_id = 0;
 
@@ -224,6 +256,42 @@ check_deferred_range (PlumaAutomaticSpellChecker *spell,
 	check_range (spell, start, end, force_all);
 }
 
+static void
+check_job_free (CheckJob *job)
+{
+	g_free (job->text);
+	g_object_unref (job->cancellable);
+
+	g_slice_free (CheckJob, job);
+}
+
+static void
+invalidate_jobs (PlumaAutomaticSpellChecker *spell,
+		 const GtkTextIter          *start,
+		 const GtkTextIter          *end)
+{
+	GSList *l;
+
+	for (l = spell->jobs; l != NULL; l = g_slist_next (l))
+	{
+		CheckJob *job = (CheckJob *)l->data;
+		GtkTextIter job_start, job_end;
+
+		gtk_text_buffer_get_iter_at_mark (GTK_TEXT_BUFFER (spell->doc),
+						  &job_start,
+						  job->start);
+		gtk_text_buffer_get_iter_at_mark (GTK_TEXT_BUFFER (spell->doc),
+						  &job_end,
+						  job->end);
+
+		if (gtk_text_iter_compare (start, &job_end) <= 0 &&
+		    gtk_text_iter_compare (end, &job_start) >= 0)
+		{
+			job->stale = TRUE;
+		}
+	}
+}
+
 /* insertion works like this:
  *  - before the text is inserted, we mark the position in the buffer.
  *  - after the text is inserted, we see where our mark is and use that and
@@ -247,6 +315,7 @@ insert_text_after (GtkTextBuffer *buffer, GtkTextIter *iter,
 	/* we need to check a range of text. */
 	gtk_text_buffer_get_iter_at_mark (buffer, &start, spell->mark_insert_start);
 
+	invalidate_jobs (spell, &start, iter);
 	check_range (spell, start, *iter, FALSE);
 
 	gtk_text_buffer_move_mark (buffer, spell->mark_insert_end, iter);
@@ -263,6 +332,7 @@ static void
 delete_range_after (GtkTextBuffer *buffer, GtkTextIter *start, GtkTextIter *end,
 		PlumaAutomaticSpellChecker *spell)
 {
+	invalidate_jobs (spell, start, end);
 	check_range (spell, *start, *end, FALSE);
 }
 
@@ -563,6 +633,364 @@ populate_popup (GtkTextView *textview, GtkMenu *menu, PlumaAutomaticSpellChecker
 	gtk_menu_shell_prepend (GTK_MENU_SHELL (menu), mi);
 }
 
+/* Moves @start to the beginning of the next unchecked text, and @end to
+ * its end, both before @limit if not %NULL */
+static gboolean
+get_next_unchecked_range (PlumaAutomaticSpellChecker *spell,
+			  GtkTextIter                *start,
+			  GtkTextIter                *end,
+			  const GtkTextIter          *limit)
+{
+	if (!gtk_text_iter_has_tag (start, spell->tag_unchecked) &&
+	    !gtk_text_iter_forward_to_tag_toggle (start, spell->tag_unchecked))
+		return FALSE;
+
+	if (limit != NULL && gtk_text_iter_compare (start, limit) >= 0)
+		return FALSE;
+
+	*end = *start;
+	gtk_text_iter_forward_to_tag_toggle (end, spell->tag_unchecked);
+
+	if (limit != NULL && gtk_text_iter_compare (end, limit) > 0)
+		*end = *limit;
+
+	return TRUE;
+}
+
+static void
+check_unchecked_range (PlumaAutomaticSpellChecker *spell,
+		       GtkTextIter                 start,
+		       GtkTextIter                 end)
+{
+	GtkTextIter range_end;
+
+	while (get_next_unchecked_range (spell, &start, &range_end, &end))
+	{
+		check_range (spell, start, range_end, TRUE);
+
+		gtk_text_buffer_remove_tag (GTK_TEXT_BUFFER (spell->doc),
+					    spell->tag_unchecked,
+					    &start,
+					    &range_end);
+
+		start = range_end;
+	}
+}
+
+static void
+check_visible_ranges (PlumaAutomaticSpellChecker *spell)
+{
+	GSList *l;
+
+	for (l = spell->views; l != NULL; l = g_slist_next (l))
+	{
+		GtkTextView *view = GTK_TEXT_VIEW (l->data);
+		GdkRectangle rect;
+		GtkTextIter start, end;
+
+		if (!gtk_widget_get_realized (GTK_WIDGET (view)))
+			continue;
+
+		gtk_text_view_get_visible_rect (view, &rect);
+		gtk_text_view_get_line_at_y (view, &start, rect.y, NULL);
+		gtk_text_view_get_line_at_y (view, &end, rect.y + rect.height, NULL);
+		gtk_text_iter_forward_line (&end);
+
+		check_unchecked_range (spell, start, end);
+	}
+}
+
+static gboolean recheck_idle (PlumaAutomaticSpellChecker *spell);
+
+static void
+schedule_recheck (PlumaAutomaticSpellChecker *spell)
+{
+	if (spell->recheck_idle_id == 0)
+		spell->recheck_idle_id = g_idle_add ((GSourceFunc)recheck_idle, spell);
+}
+
+/* The highlighting is needed to know what not to check, so it cannot be
+ * looked at from the worker */
+static GArray *
+get_no_spell_check_ranges (PlumaAutomaticSpellChecker *spell,
+			   const GtkTextIter          *start,
+			   const GtkTextIter          *end)
+{
+	GtkSourceBuffer *buffer = GTK_SOURCE_BUFFER (spell->doc);
+	GArray *ranges;
+	GtkTextIter iter;
+	gint base;
+	gint limit;
+
+	ranges = g_array_new (FALSE, FALSE, sizeof (PlumaSpellWorkerRange));
+
+	base = gtk_text_iter_get_offset (start);
+	limit = gtk_text_iter_get_offset (end);
+	iter = *start;
+
+	while (gtk_text_iter_compare (&iter, end) < 0)
+	{
+		PlumaSpellWorkerRange range = { 0, 0, 0, 0 };
+
+		if (!gtk_source_buffer_iter_has_context_class (buffer, &iter, "no-spell-check"))
+		{
+			if (!gtk_source_buffer_iter_forward_to_context_class_toggle (buffer,
+										     &iter,
+										     "no-spell-check"))
+				break;
+
+			continue;
+		}
+
+		range.start = gtk_text_iter_get_offset (&iter) - base;
+
+		if (!gtk_source_buffer_iter_forward_to_context_class_toggle (buffer,
+									     &iter,
+									     "no-spell-check"))
+			iter = *end;
+
+		range.end = MIN (gtk_text_iter_get_offset (&iter), limit) - base;
+
+		g_array_append_val (ranges, range);
+	}
+
+	return ranges;
+}
+
+static void
+apply_misspelled (PlumaAutomaticSpellChecker *spell,
+		  CheckJob                   *job,
+		  GtkTextIter                *start,
+		  GtkTextIter                *end,
+		  GArray                     *misspelled)
+{
+	GtkTextIter iter;
+	gint offset = 0;
+	guint i;
+
+	gtk_text_buffer_remove_tag (GTK_TEXT_BUFFER (spell->doc),
+				    spell->tag_highlight,
+				    start,
+				    end);
+
+	iter = *start;
+
+	for (i = 0; i < misspelled->len; ++i)
+	{
+		PlumaSpellWorkerRange *range;
+		GtkTextIter word_end;
+
+		range = &g_array_index (misspelled, PlumaSpellWorkerRange, i);
+
+		/* the worker does not know about the session and the
+		 * personal words added since its dictionary was loaded */
+		if (pluma_spell_checker_check_word (spell->spell_checker,
+						    job->text + range->byte_start,
+						    range->byte_end - range->byte_start))
+			continue;
+
+		gtk_text_iter_forward_chars (&iter, range->start - offset);
+		word_end = iter;
+		gtk_text_iter_forward_chars (&word_end, range->end - range->start);
+
+		gtk_text_buffer_apply_tag (GTK_TEXT_BUFFER (spell->doc),
+					   spell->tag_highlight,
+					   &iter,
+					   &word_end);
+
+		iter = word_end;
+		offset = range->end;
+	}
+}
+
+static void
+check_job_done (GObject      *source_object,
+		GAsyncResult *result,
+		CheckJob     *job)
+{
+	PlumaAutomaticSpellChecker *spell = job->spell;
+	GtkTextIter start, end;
+	GArray *misspelled;
+
+	misspelled = pluma_spell_worker_check_finish (result, NULL);
+
+	if (spell == NULL)
+	{
+		if (misspelled != NULL)
+			g_array_unref (misspelled);
+
+		check_job_free (job);
+		return;
+	}
+
+	spell->jobs = g_slist_remove (spell->jobs, job);
+
+	gtk_text_buffer_get_iter_at_mark (GTK_TEXT_BUFFER (spell->doc),
+					  &start,
+					  job->start);
+	gtk_text_buffer_get_iter_at_mark (GTK_TEXT_BUFFER (spell->doc),
+					  &end,
+					  job->end);
+
+	if (job->stale ||
+	    job->language != pluma_spell_checker_get_language (spell->spell_checker))
+	{
+		/* check it again later */
+		gtk_text_buffer_apply_tag (GTK_TEXT_BUFFER (spell->doc),
+					   spell->tag_unchecked,
+					   &start,
+					   &end);
+	}
+	else if (misspelled == NULL)
+	{
+		/* the worker could not load the dictionary */
+		check_range (spell, start, end, TRUE);
+	}
+	else
+	{
+		apply_misspelled (spell, job, &start, &end, misspelled);
+	}
+
+	if (misspelled != NULL)
+		g_array_unref (misspelled);
+
+	gtk_text_buffer_delete_mark (GTK_TEXT_BUFFER (spell->doc), job->start);
+	gtk_text_buffer_delete_mark (GTK_TEXT_BUFFER (spell->doc), job->end);
+	check_job_free (job);
+
+	schedule_recheck (spell);
+}
+
+/* Hands the text from @start to @end, extended to whole lines, to a
+ * worker. @end is moved to the end of the text handed out. */
+static gboolean
+submit_check_job (PlumaAutomaticSpellChecker *spell,
+		  GtkTextIter                *start,
+		  GtkTextIter                *end)
+{
+	const PlumaSpellCheckerLanguage *language;
+	CheckJob *job;
+	GArray *no_check;
+
+	language = pluma_spell_checker_get_language (spell->spell_checker);
+
+	if (language == NULL)
+		return FALSE;
+
+	gtk_text_iter_set_line_offset (start, 0);
+
+	if (gtk_text_iter_get_line_offset (end) != 0 && !gtk_text_iter_ends_line (end))
+		gtk_text_iter_forward_to_line_end (end);
+
+	job = g_slice_new0 (CheckJob);
+	job->spell = spell;
+	job->language = language;
+	job->text = gtk_text_buffer_get_slice (GTK_TEXT_BUFFER (spell->doc), start, end, TRUE);
+	job->cancellable = g_cancellable_new ();
+
+	no_check = get_no_spell_check_ranges (spell, start, end);
+
+	job->start = gtk_text_buffer_create_mark (GTK_TEXT_BUFFER (spell->doc), NULL, start, TRUE);
+	job->end = gtk_text_buffer_create_mark (GTK_TEXT_BUFFER (spell->doc), NULL, end, FALSE);
+
+	gtk_text_buffer_remove_tag (GTK_TEXT_BUFFER (spell->doc),
+				    spell->tag_unchecked,
+				    start,
+				    end);
+
+	spell->jobs = g_slist_prepend (spell->jobs, job);
+
+	pluma_spell_worker_check_async (pluma_spell_checker_language_to_key (language),
+					job->text,
+					no_check,
+					job->cancellable,
+					(GAsyncReadyCallback)check_job_done,
+					job);
+
+	return TRUE;
+}
+
+static guint
+get_max_check_jobs (void)
+{
+	/* leave a core for the main thread */
+	return CLAMP (g_get_num_processors () - 1, 1, MAX_CHECK_JOBS);
+}
+
+static gboolean
+recheck_idle (PlumaAutomaticSpellChecker *spell)
+{
+	GtkTextIter start, end, limit;
+	gboolean wrapped = FALSE;
+	gint64 start_time;
+
+	start_time = g_get_monotonic_time ();
+
+	/* the views may have been scrolled since the last slice */
+	check_visible_ranges (spell);
+
+	gtk_text_buffer_get_iter_at_mark (GTK_TEXT_BUFFER (spell->doc),
+					  &start,
+					  spell->mark_recheck);
+
+	while (g_slist_length (spell->jobs) < get_max_check_jobs ())
+	{
+		if (!get_next_unchecked_range (spell, &start, &end, NULL))
+		{
+			if (wrapped)
+				break;
+
+			/* text can still be unchecked before the mark if
+			 * the visible range was checked first */
+			gtk_text_buffer_get_start_iter (GTK_TEXT_BUFFER (spell->doc), &start);
+			wrapped = TRUE;
+			continue;
+		}
+
+		limit = start;
+		gtk_text_iter_forward_lines (&limit, RECHECK_CHUNK_LINES);
+
+		if (gtk_text_iter_compare (&limit, &end) < 0)
+			end = limit;
+
+		if (!submit_check_job (spell, &start, &end))
+		{
+			check_range (spell, start, end, TRUE);
+
+			gtk_text_buffer_remove_tag (GTK_TEXT_BUFFER (spell->doc),
+						    spell->tag_unchecked,
+						    &start,
+						    &end);
+		}
+
+		start = end;
+
+		if (g_get_monotonic_time () - start_time >= RECHECK_TIME_BUDGET)
+		{
+			gtk_text_buffer_move_mark (GTK_TEXT_BUFFER (spell->doc),
+						   spell->mark_recheck,
+						   &start);
+			return TRUE;
+		}
+	}
+
+	gtk_text_buffer_move_mark (GTK_TEXT_BUFFER (spell->doc),
+				   spell->mark_recheck,
+				   &start);
+
+	/* rescheduled when a job is done */
+	spell->recheck_idle_id = 0;
+	return FALSE;
+}
+
+static void
+mark_job_stale (CheckJob *job)
+{
+	job->stale = TRUE;
+}
+
+/* The visible text of the attached views is checked right away, the rest
+ * of the document in idle slices so that long documents do not block */
 void
 pluma_automatic_spell_checker_recheck_all (PlumaAutomaticSpellChecker *spell)
 {
@@ -572,7 +1000,19 @@ pluma_automatic_spell_checker_recheck_all (PlumaAutomaticSpellChecker *spell)
 
 	gtk_text_buffer_get_bounds (GTK_TEXT_BUFFER (spell->doc), &start, &end);
 
-	check_range (spell, start, end, TRUE);
+	gtk_text_buffer_apply_tag (GTK_TEXT_BUFFER (spell->doc),
+				   spell->tag_unchecked,
+				   &start,
+				   &end);
+	gtk_text_buffer_move_mark (GTK_TEXT_BUFFER (spell->doc),
+				   spell->mark_recheck,
+				   &start);
+
+	/* the text of the running jobs is checked again */
+	g_slist_foreach (spell->jobs, (GFunc)mark_job_stale, NULL);
+
+	check_visible_ranges (spell);
+	schedule_recheck (spell);
 }
 
 static void
@@ -790,6 +1230,10 @@ pluma_automatic_spell_checker_new (PlumaDocument     *doc,
 	                   (GWeakNotify)spell_tag_destroyed,
 	                   spell);
 
+	spell->tag_unchecked = gtk_text_buffer_create_tag (GTK_TEXT_BUFFER (doc),
+							   NULL,
+							   NULL);
+
 	tag_table = gtk_text_buffer_get_tag_table (GTK_TEXT_BUFFER (doc));
 
 	gtk_text_tag_set_priority (spell->tag_highlight,
@@ -866,6 +1310,18 @@ pluma_automatic_spell_checker_new (PlumaDocument     *doc,
 					   &start);
 	}
 
+	spell->mark_recheck = gtk_text_buffer_get_mark (GTK_TEXT_BUFFER (doc),
+					"pluma-automatic-spell-checker-recheck");
+
+	if (spell->mark_recheck == NULL)
+	{
+		spell->mark_recheck =
+			gtk_text_buffer_create_mark (GTK_TEXT_BUFFER (doc),
+						     "pluma-automatic-spell-checker-recheck",
+						     &start,
+						     TRUE);
+	}
+
 	spell->deferred_check = FALSE;
 
 	return spell;
@@ -903,6 +1359,23 @@ pluma_automatic_spell_checker_free_internal (PlumaAutomaticSpellChecker *spell)
 
 	g_return_if_fail (spell != NULL);
 
+	if (spell->recheck_idle_id != 0)
+		g_source_remove (spell->recheck_idle_id);
+
+	for (list = spell->jobs; list != NULL; list = g_slist_next (list))
+	{
+		CheckJob *job = (CheckJob *)list->data;
+
+		/* freed when the worker is done */
+		g_cancellable_cancel (job->cancellable);
+		job->spell = NULL;
+
+		gtk_text_buffer_delete_mark (GTK_TEXT_BUFFER (spell->doc), job->start);
+		gtk_text_buffer_delete_mark (GTK_TEXT_BUFFER (spell->doc), job->end);
+	}
+
+	g_slist_free (spell->jobs);
+
 	table = gtk_text_buffer_get_tag_table (GTK_TEXT_BUFFER (spell->doc));
 
 	if (table != NULL && spell->tag_highlight != NULL)
@@ -921,6 +1394,7 @@ pluma_automatic_spell_checker_free_internal (PlumaAutomaticSpellChecker *spell)
 					spell);
 
 		gtk_text_tag_table_remove (table, spell->tag_highlight);
+		gtk_text_tag_table_remove (table, spell->tag_unchecked);
 	}
 
 	g_signal_handlers_disconnect_matched (G_OBJECT (spell->doc),
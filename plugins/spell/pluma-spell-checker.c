@@ -42,6 +42,14 @@
 #include "pluma-spell-checker.h"
 #include "pluma-spell-utils.h"
 
+/* The cache is dropped as a whole when it gets too big, which is cheap and
+ * good enough since the vocabulary of a document is mostly small */
+#define MAX_CACHED_WORDS	16384
+#define MAX_CACHED_WORD_LEN	64
+
+#define WORD_CORRECT		GINT_TO_POINTER (1)
+#define WORD_MISSPELLED		GINT_TO_POINTER (2)
+
 struct _PlumaSpellChecker
 {
 	GObject parent_instance;
@@ -49,6 +57,10 @@ struct _PlumaSpellChecker
 	EnchantDict                     *dict;
 	EnchantBroker                   *broker;
 	const PlumaSpellCheckerLanguage *active_lang;
+
+	/* word -> WORD_CORRECT or WORD_MISSPELLED, for cache_lang */
+	GHashTable                      *cache;
+	const PlumaSpellCheckerLanguage *cache_lang;
 };
 
 /* GObject properties */
@@ -125,6 +137,8 @@ pluma_spell_checker_finalize (GObject *object)
 	if (spell_checker->broker != NULL)
 		enchant_broker_free (spell_checker->broker);
 
+	g_hash_table_destroy (spell_checker->cache);
+
 	G_OBJECT_CLASS (pluma_spell_checker_parent_class)->finalize (object);
 }
 
@@ -195,6 +209,19 @@ pluma_spell_checker_init (PlumaSpellChecker *spell_checker)
 	spell_checker->broker = enchant_broker_init ();
 	spell_checker->dict = NULL;
 	spell_checker->active_lang = NULL;
+
+	spell_checker->cache = g_hash_table_new_full (g_str_hash,
+						      g_str_equal,
+						      g_free,
+						      NULL);
+	spell_checker->cache_lang = NULL;
+}
+
+static void
+invalidate_cache (PlumaSpellChecker *spell)
+{
+	g_hash_table_remove_all (spell->cache);
+	spell->cache_lang = NULL;
 }
 
 PlumaSpellChecker *
@@ -298,6 +325,8 @@ pluma_spell_checker_set_language (PlumaSpellChecker               *spell,
 		spell->dict = NULL;
 	}
 
+	invalidate_cache (spell);
+
 	ret = lazy_init (spell, language);
 
 	if (ret)
@@ -325,6 +354,9 @@ pluma_spell_checker_check_word (PlumaSpellChecker *spell,
 				const gchar       *word,
 				gssize             len)
 {
+	gchar key[MAX_CACHED_WORD_LEN + 1];
+	gboolean cacheable;
+	gpointer cached;
 	gint enchant_result;
 	gboolean res = FALSE;
 
@@ -337,13 +369,34 @@ pluma_spell_checker_check_word (PlumaSpellChecker *spell,
 	if (len < 0)
 		len = strlen (word);
 
-	if (strcmp (word, "pluma") == 0)
+	if (len == 5 && strncmp (word, "pluma", len) == 0)
 		return TRUE;
 
 	if (pluma_spell_utils_is_digit (word, len))
 		return TRUE;
 
 	g_return_val_if_fail (spell->dict != NULL, FALSE);
+
+	if (spell->cache_lang != spell->active_lang)
+	{
+		invalidate_cache (spell);
+		spell->cache_lang = spell->active_lang;
+	}
+
+	/* @word does not need to be nul-terminated at @len */
+	cacheable = len <= MAX_CACHED_WORD_LEN;
+
+	if (cacheable)
+	{
+		memcpy (key, word, len);
+		key[len] = '\0';
+
+		cached = g_hash_table_lookup (spell->cache, key);
+
+		if (cached != NULL)
+			return cached == WORD_CORRECT;
+	}
+
 	enchant_result = enchant_dict_check (spell->dict, word, len);
 
 	switch (enchant_result)
@@ -368,6 +421,17 @@ pluma_spell_checker_check_word (PlumaSpellChecker *spell,
 			g_return_val_if_reached (FALSE);
 	}
 
+	/* errors are not cached, the next check may succeed */
+	if (cacheable && enchant_result != -1)
+	{
+		if (g_hash_table_size (spell->cache) >= MAX_CACHED_WORDS)
+			g_hash_table_remove_all (spell->cache);
+
+		g_hash_table_insert (spell->cache,
+				     g_strdup (key),
+				     res ? WORD_CORRECT : WORD_MISSPELLED);
+	}
+
 	return res;
 }
 
@@ -433,6 +497,9 @@ pluma_spell_checker_add_word_to_personal (PlumaSpellChecker *spell,
 
 	enchant_dict_add (spell->dict, word, len);
 
+	/* the word may be accepted in other cases too, so forget everything */
+	invalidate_cache (spell);
+
 
 	g_signal_emit (G_OBJECT (spell), signals[ADD_WORD_TO_PERSONAL], 0, word, len);
 
@@ -457,6 +524,8 @@ pluma_spell_checker_add_word_to_session (PlumaSpellChecker *spell,
 
 	enchant_dict_add_to_session (spell->dict, word, len);
 
+	invalidate_cache (spell);
+
 	g_signal_emit (G_OBJECT (spell), signals[ADD_WORD_TO_SESSION], 0, word, len);
 
 	return TRUE;
@@ -474,6 +543,8 @@ pluma_spell_checker_clear_session (PlumaSpellChecker *spell)
 		spell->dict = NULL;
 	}
 
+	invalidate_cache (spell);
+
 	if (!lazy_init (spell, spell->active_lang))
 		return FALSE;
 
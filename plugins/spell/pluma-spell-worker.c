@@ -0,0 +1,332 @@
+/*
+ * pluma-spell-worker.c
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Checks a snapshot of text on a worker thread: the text is split in
+ * words with the same Pango word boundaries GtkTextIter uses, and every
+ * word is looked up in an enchant dictionary owned by the job for its
+ * duration. Neither enchant brokers nor dictionaries can be shared between
+ * threads, so they are kept in a small pool and handed out to one job at
+ * a time.
+ *
+ * The words added to the session or to the personal dictionary of the
+ * PlumaSpellChecker are not known here, the caller is expected to confirm
+ * the misspelled words on the main thread.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+
+#include <enchant.h>
+#include <pango/pango.h>
+
+#include "pluma-spell-worker.h"
+#include "pluma-spell-utils.h"
+
+#define MAX_POOLED_DICTS	4
+
+/* checked for cancellation every so many characters */
+#define CANCEL_CHECK_INTERVAL	4096
+
+typedef struct
+{
+	gchar *language_key;
+
+	EnchantBroker *broker;
+	EnchantDict *dict;
+} PooledDict;
+
+typedef struct
+{
+	gchar *language_key;
+	const gchar *text;
+	GArray *no_check;
+} CheckData;
+
+G_LOCK_DEFINE_STATIC (dict_pool);
+static GSList *dict_pool = NULL;
+
+static void
+pooled_dict_free (PooledDict *pooled)
+{
+	enchant_broker_free_dict (pooled->broker, pooled->dict);
+	enchant_broker_free (pooled->broker);
+
+	g_free (pooled->language_key);
+	g_slice_free (PooledDict, pooled);
+}
+
+static PooledDict *
+dict_pool_get (const gchar *language_key)
+{
+	PooledDict *pooled = NULL;
+	GSList *l;
+
+	G_LOCK (dict_pool);
+
+	for (l = dict_pool; l != NULL; l = g_slist_next (l))
+	{
+		PooledDict *candidate = (PooledDict *)l->data;
+
+		if (strcmp (candidate->language_key, language_key) == 0)
+		{
+			pooled = candidate;
+			dict_pool = g_slist_delete_link (dict_pool, l);
+			break;
+		}
+	}
+
+	G_UNLOCK (dict_pool);
+
+	if (pooled != NULL)
+		return pooled;
+
+	pooled = g_slice_new (PooledDict);
+	pooled->language_key = g_strdup (language_key);
+	pooled->broker = enchant_broker_init ();
+	pooled->dict = enchant_broker_request_dict (pooled->broker, language_key);
+
+	if (pooled->dict == NULL)
+	{
+		enchant_broker_free (pooled->broker);
+		g_free (pooled->language_key);
+		g_slice_free (PooledDict, pooled);
+
+		return NULL;
+	}
+
+	return pooled;
+}
+
+static void
+dict_pool_put (PooledDict *pooled)
+{
+	GSList *drop = NULL;
+
+	G_LOCK (dict_pool);
+
+	dict_pool = g_slist_prepend (dict_pool, pooled);
+
+	/* the least recently used dictionaries are at the end */
+	if (g_slist_length (dict_pool) > MAX_POOLED_DICTS)
+	{
+		GSList *last = g_slist_nth (dict_pool, MAX_POOLED_DICTS - 1);
+
+		drop = last->next;
+		last->next = NULL;
+	}
+
+	G_UNLOCK (dict_pool);
+
+	g_slist_free_full (drop, (GDestroyNotify)pooled_dict_free);
+}
+
+static void
+check_data_free (CheckData *data)
+{
+	g_free (data->language_key);
+
+	if (data->no_check != NULL)
+		g_array_unref (data->no_check);
+
+	g_slice_free (CheckData, data);
+}
+
+static gboolean
+is_misspelled (EnchantDict *dict,
+	       const gchar *word,
+	       gsize        len)
+{
+	if (len == 5 && strncmp (word, "pluma", len) == 0)
+		return FALSE;
+
+	if (pluma_spell_utils_is_digit (word, len))
+		return FALSE;
+
+	/* only report unknown words, errors are ignored */
+	return enchant_dict_check (dict, word, len) == 1;
+}
+
+static void
+check_thread (GTask        *task,
+	      gpointer      source_object,
+	      CheckData    *data,
+	      GCancellable *cancellable)
+{
+	PooledDict *pooled;
+	PangoLogAttr *attrs;
+	GArray *misspelled;
+	const gchar *p;
+	const gchar *word_p = NULL;
+	glong n_chars;
+	gint word_start = -1;
+	guint next_no_check = 0;
+	gint i;
+
+	pooled = dict_pool_get (data->language_key);
+
+	if (pooled == NULL)
+	{
+		g_task_return_new_error (task,
+					 G_IO_ERROR,
+					 G_IO_ERROR_NOT_FOUND,
+					 "No dictionary for %s",
+					 data->language_key);
+		return;
+	}
+
+	n_chars = g_utf8_strlen (data->text, -1);
+	attrs = g_new (PangoLogAttr, n_chars + 1);
+
+	pango_get_log_attrs (data->text,
+			     strlen (data->text),
+			     -1,
+			     pango_language_from_string (data->language_key),
+			     attrs,
+			     n_chars + 1);
+
+	misspelled = g_array_new (FALSE, FALSE, sizeof (PlumaSpellWorkerRange));
+
+	for (i = 0, p = data->text; i <= n_chars; ++i)
+	{
+		if (i % CANCEL_CHECK_INTERVAL == 0 &&
+		    g_cancellable_is_cancelled (cancellable))
+			break;
+
+		if (word_start >= 0 && attrs[i].is_word_end)
+		{
+			gboolean skip = FALSE;
+
+			if (data->no_check != NULL)
+			{
+				PlumaSpellWorkerRange *range;
+
+				while (next_no_check < data->no_check->len &&
+				       g_array_index (data->no_check,
+						      PlumaSpellWorkerRange,
+						      next_no_check).end <= word_start)
+				{
+					++next_no_check;
+				}
+
+				range = next_no_check < data->no_check->len ?
+					&g_array_index (data->no_check, PlumaSpellWorkerRange, next_no_check) :
+					NULL;
+
+				skip = range != NULL && range->start < i;
+			}
+
+			if (!skip && is_misspelled (pooled->dict, word_p, p - word_p))
+			{
+				PlumaSpellWorkerRange range;
+
+				range.start = word_start;
+				range.end = i;
+				range.byte_start = word_p - data->text;
+				range.byte_end = p - data->text;
+
+				g_array_append_val (misspelled, range);
+			}
+
+			word_start = -1;
+		}
+
+		if (i == n_chars)
+			break;
+
+		if (attrs[i].is_word_start)
+		{
+			word_start = i;
+			word_p = p;
+		}
+
+		p = g_utf8_next_char (p);
+	}
+
+	g_free (attrs);
+	dict_pool_put (pooled);
+
+	if (g_task_return_error_if_cancelled (task))
+	{
+		g_array_unref (misspelled);
+		return;
+	}
+
+	g_task_return_pointer (task, misspelled, (GDestroyNotify)g_array_unref);
+}
+
+/**
+ * pluma_spell_worker_check_async:
+ * @language_key: the key of the language to check the text with
+ * @text: the text to check, which must stay alive until @callback is called
+ * @no_check: (allow-none) (transfer full): sorted #PlumaSpellWorkerRange
+ * character ranges of @text which must not be checked
+ * @cancellable: (allow-none): a #GCancellable
+ * @callback: called when the check is done
+ * @user_data: data for @callback
+ *
+ * Checks the words of @text on a worker thread.
+ */
+void
+pluma_spell_worker_check_async (const gchar         *language_key,
+				const gchar         *text,
+				GArray              *no_check,
+				GCancellable        *cancellable,
+				GAsyncReadyCallback  callback,
+				gpointer             user_data)
+{
+	GTask *task;
+	CheckData *data;
+
+	g_return_if_fail (language_key != NULL);
+	g_return_if_fail (text != NULL);
+
+	data = g_slice_new (CheckData);
+	data->language_key = g_strdup (language_key);
+	data->text = text;
+	data->no_check = no_check;
+
+	task = g_task_new (NULL, cancellable, callback, user_data);
+	g_task_set_task_data (task, data, (GDestroyNotify)check_data_free);
+	g_task_run_in_thread (task, (GTaskThreadFunc)check_thread);
+	g_object_unref (task);
+}
+
+/**
+ * pluma_spell_worker_check_finish:
+ * @result: the #GAsyncResult passed to the callback
+ * @error: return location for a #GError
+ *
+ * Returns: (transfer full): the #PlumaSpellWorkerRange of the misspelled
+ * words, in text order, or %NULL on error.
+ */
+GArray *
+pluma_spell_worker_check_finish (GAsyncResult  *result,
+				 GError       **error)
+{
+	g_return_val_if_fail (G_IS_TASK (result), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
@@ -0,0 +1,55 @@
+/*
+ * pluma-spell-worker.h
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ */
+
+#ifndef __PLUMA_SPELL_WORKER_H__
+#define __PLUMA_SPELL_WORKER_H__
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+typedef struct _PlumaSpellWorkerRange PlumaSpellWorkerRange;
+
+struct _PlumaSpellWorkerRange
+{
+	/* in characters */
+	gint start;
+	gint end;
+
+	/* in bytes */
+	gint byte_start;
+	gint byte_end;
+};
+
+void	 pluma_spell_worker_check_async		(const gchar         *language_key,
+						 const gchar         *text,
+						 GArray              *no_check,
+						 GCancellable        *cancellable,
+						 GAsyncReadyCallback  callback,
+						 gpointer             user_data);
+
+GArray	*pluma_spell_worker_check_finish	(GAsyncResult        *result,
+						 GError             **error);
+
+G_END_DECLS
+
+#endif /* __PLUMA_SPELL_WORKER_H__ */
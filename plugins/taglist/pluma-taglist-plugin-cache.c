@@ -0,0 +1,338 @@
+/*
+ * pluma-taglist-plugin-cache.c
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * The parsed tag lists are saved in a binary file in the user cache dir,
+ * which is mapped instead of parsing the XML files again as long as the
+ * key it was saved with matches. The key is made of the languages of the
+ * locale, since the best translation of each group is picked when parsing,
+ * and of the path, modification time and size of every tag list file.
+ *
+ * The file is made of a header, the groups, the tags of all the groups
+ * one group after the other, and the nul-terminated strings. The strings
+ * are used in place, a group only gets Tag structures when it is shown.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <string.h>
+#include <glib.h>
+
+#include <pluma/pluma-debug.h>
+
+#include "pluma-taglist-plugin-cache.h"
+
+#define CACHE_MAGIC "PLTAGS01"
+#define CACHE_FILE_NAME "taglist.cache"
+
+#define NO_STRING G_MAXUINT32
+
+typedef struct
+{
+	gchar magic[8];
+
+	/* offset of the key in the strings */
+	guint32 key;
+
+	guint32 n_groups;
+	guint32 n_tags;
+	guint32 strings_size;
+} CacheHeader;
+
+typedef struct
+{
+	guint32 name;
+	guint32 first_tag;
+	guint32 n_tags;
+} CacheGroup;
+
+typedef struct
+{
+	guint32 name;
+	guint32 begin;
+	guint32 end;
+} CacheTag;
+
+static gchar *
+get_cache_file_name (void)
+{
+	return g_build_filename (g_get_user_cache_dir (),
+				 "pluma",
+				 CACHE_FILE_NAME,
+				 NULL);
+}
+
+static gboolean
+check_string (guint32 offset,
+	      guint32 strings_size)
+{
+	return offset == NO_STRING || offset < strings_size;
+}
+
+static gboolean
+check_cache (const gchar *data,
+	     gsize        length)
+{
+	const CacheHeader *header = (const CacheHeader *) data;
+	const CacheGroup *groups;
+	const CacheTag *tags;
+	const gchar *strings;
+	guint32 i;
+
+	if (length < sizeof (CacheHeader) ||
+	    memcmp (header->magic, CACHE_MAGIC, sizeof (header->magic)) != 0)
+		return FALSE;
+
+	if (length != sizeof (CacheHeader) +
+		      (gsize) header->n_groups * sizeof (CacheGroup) +
+		      (gsize) header->n_tags * sizeof (CacheTag) +
+		      header->strings_size)
+		return FALSE;
+
+	groups = (const CacheGroup *) (header + 1);
+	tags = (const CacheTag *) (groups + header->n_groups);
+	strings = (const gchar *) (tags + header->n_tags);
+
+	/* every offset in range and a nul at the end keep all the strings
+	 * inside the file */
+	if (header->strings_size == 0 ||
+	    strings[header->strings_size - 1] != '\0' ||
+	    header->key >= header->strings_size)
+		return FALSE;
+
+	for (i = 0; i < header->n_groups; i++)
+	{
+		if (groups[i].name >= header->strings_size ||
+		    groups[i].first_tag > header->n_tags ||
+		    groups[i].n_tags > header->n_tags - groups[i].first_tag)
+			return FALSE;
+	}
+
+	for (i = 0; i < header->n_tags; i++)
+	{
+		if (tags[i].name >= header->strings_size ||
+		    !check_string (tags[i].begin, header->strings_size) ||
+		    !check_string (tags[i].end, header->strings_size))
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+TagList* taglist_cache_load(const gchar* key)
+{
+	GMappedFile* file;
+	const gchar* data;
+	const CacheHeader* header;
+	const CacheGroup* groups;
+	const CacheTag* tags;
+	const gchar* strings;
+	TagList* tag_list;
+	gchar* file_name;
+	guint32 i;
+
+	file_name = get_cache_file_name ();
+	file = g_mapped_file_new (file_name, FALSE, NULL);
+	g_free (file_name);
+
+	if (file == NULL)
+		return NULL;
+
+	data = g_mapped_file_get_contents (file);
+
+	if (data == NULL || !check_cache (data, g_mapped_file_get_length (file)))
+	{
+		pluma_debug_message (DEBUG_PLUGINS, "Invalid tag list cache");
+
+		g_mapped_file_unref (file);
+		return NULL;
+	}
+
+	header = (const CacheHeader *) data;
+	groups = (const CacheGroup *) (header + 1);
+	tags = (const CacheTag *) (groups + header->n_groups);
+	strings = (const gchar *) (tags + header->n_tags);
+
+	if (strcmp (strings + header->key, key) != 0)
+	{
+		pluma_debug_message (DEBUG_PLUGINS, "Outdated tag list cache");
+
+		g_mapped_file_unref (file);
+		return NULL;
+	}
+
+	tag_list = g_new0 (TagList, 1);
+	tag_list->cache = file;
+
+	for (i = 0; i < header->n_groups; i++)
+	{
+		TagGroup* tag_group;
+
+		tag_group = g_new0 (TagGroup, 1);
+		tag_group->name = (xmlChar*) (strings + groups[i].name);
+		tag_group->cached = TRUE;
+		tag_group->cached_tags = tags + groups[i].first_tag;
+		tag_group->n_cached_tags = groups[i].n_tags;
+		tag_group->cached_strings = strings;
+
+		tag_list->tag_groups = g_list_prepend (tag_list->tag_groups, tag_group);
+	}
+
+	tag_list->tag_groups = g_list_reverse (tag_list->tag_groups);
+
+	pluma_debug_message (DEBUG_PLUGINS, "%u tag groups read from the cache", header->n_groups);
+
+	return tag_list;
+}
+
+static const xmlChar*
+get_cached_string (const gchar* strings,
+		   guint32      offset)
+{
+	if (offset == NO_STRING)
+		return NULL;
+
+	return (const xmlChar*) (strings + offset);
+}
+
+void taglist_cache_load_tags(TagGroup* tag_group)
+{
+	const CacheTag* tags;
+	guint i;
+
+	g_return_if_fail (tag_group->cached);
+
+	tags = tag_group->cached_tags;
+
+	for (i = tag_group->n_cached_tags; i > 0; i--)
+	{
+		Tag* tag;
+
+		tag = g_new0 (Tag, 1);
+		tag->name = (xmlChar*) get_cached_string (tag_group->cached_strings, tags[i - 1].name);
+		tag->begin = (xmlChar*) get_cached_string (tag_group->cached_strings, tags[i - 1].begin);
+		tag->end = (xmlChar*) get_cached_string (tag_group->cached_strings, tags[i - 1].end);
+
+		tag_group->tags = g_list_prepend (tag_group->tags, tag);
+	}
+
+	tag_group->n_cached_tags = 0;
+}
+
+static guint32
+add_string (GString*       strings,
+	    const xmlChar* str)
+{
+	guint32 offset;
+
+	if (str == NULL)
+		return NO_STRING;
+
+	offset = strings->len;
+	g_string_append_len (strings, (const gchar*) str, strlen ((const gchar*) str) + 1);
+
+	return offset;
+}
+
+void taglist_cache_save(TagList* tag_list, const gchar* key)
+{
+	CacheHeader header;
+	GArray* groups;
+	GArray* tags;
+	GString* strings;
+	GString* contents;
+	GError* error = NULL;
+	gchar* file_name;
+	gchar* dir_name;
+	GList* l;
+
+	memcpy (header.magic, CACHE_MAGIC, sizeof (header.magic));
+
+	groups = g_array_new (FALSE, FALSE, sizeof (CacheGroup));
+	tags = g_array_new (FALSE, FALSE, sizeof (CacheTag));
+	strings = g_string_new (NULL);
+
+	header.key = add_string (strings, (const xmlChar*) key);
+
+	for (l = tag_list->tag_groups; l != NULL; l = g_list_next (l))
+	{
+		TagGroup* tag_group = (TagGroup*) l->data;
+		CacheGroup cache_group;
+		GList* t;
+
+		cache_group.name = add_string (strings, tag_group->name);
+		cache_group.first_tag = tags->len;
+
+		for (t = tag_group_get_tags (tag_group); t != NULL; t = g_list_next (t))
+		{
+			Tag* tag = (Tag*) t->data;
+			CacheTag cache_tag;
+
+			cache_tag.name = add_string (strings, tag->name);
+			cache_tag.begin = add_string (strings, tag->begin);
+			cache_tag.end = add_string (strings, tag->end);
+
+			g_array_append_val (tags, cache_tag);
+		}
+
+		cache_group.n_tags = tags->len - cache_group.first_tag;
+
+		g_array_append_val (groups, cache_group);
+	}
+
+	header.n_groups = groups->len;
+	header.n_tags = tags->len;
+	header.strings_size = strings->len;
+
+	contents = g_string_sized_new (sizeof (CacheHeader) +
+				       groups->len * sizeof (CacheGroup) +
+				       tags->len * sizeof (CacheTag) +
+				       strings->len);
+
+	g_string_append_len (contents, (const gchar*) &header, sizeof (CacheHeader));
+	g_string_append_len (contents, groups->data, groups->len * sizeof (CacheGroup));
+	g_string_append_len (contents, tags->data, tags->len * sizeof (CacheTag));
+	g_string_append_len (contents, strings->str, strings->len);
+
+	file_name = get_cache_file_name ();
+	dir_name = g_path_get_dirname (file_name);
+
+	if (g_mkdir_with_parents (dir_name, 0700) != 0 ||
+	    !g_file_set_contents (file_name, contents->str, contents->len, &error))
+	{
+		pluma_debug_message (DEBUG_PLUGINS,
+				     "Cannot save the tag list cache: %s",
+				     error != NULL ? error->message : g_strerror (errno));
+
+		g_clear_error (&error);
+	}
+
+	g_free (dir_name);
+	g_free (file_name);
+	g_string_free (contents, TRUE);
+	g_string_free (strings, TRUE);
+	g_array_free (tags, TRUE);
+	g_array_free (groups, TRUE);
+}
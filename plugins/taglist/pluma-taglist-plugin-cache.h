@@ -0,0 +1,36 @@
+/*
+ * pluma-taglist-plugin-cache.h
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PLUMA_TAGLIST_PLUGIN_CACHE_H__
+#define __PLUMA_TAGLIST_PLUGIN_CACHE_H__
+
+#include <glib.h>
+
+#include "pluma-taglist-plugin-parser.h"
+
+TagList* taglist_cache_load(const gchar* key);
+
+void taglist_cache_save(TagList* tag_list, const gchar* key);
+
+void taglist_cache_load_tags(TagGroup* tag_group);
+
+#endif /* __PLUMA_TAGLIST_PLUGIN_CACHE_H__ */
@@ -265,7 +265,7 @@ tag_list_row_activated_cb (GtkTreeView             *tag_list,
 	pluma_debug_message (DEBUG_PLUGINS, "Index: %d", index);
 
 	insert_tag (panel,
-		    (Tag*)g_list_nth_data (panel->priv->selected_tag_group->tags, index),
+		    (Tag*)g_list_nth_data (tag_group_get_tags (panel->priv->selected_tag_group), index),
 		    TRUE);
 }
 
@@ -298,7 +298,7 @@ tag_list_key_press_event_cb (GtkTreeView             *tag_list,
 			pluma_debug_message (DEBUG_PLUGINS, "Index: %d", index);
 
 			insert_tag (panel,
-				    (Tag*)g_list_nth_data (panel->priv->selected_tag_group->tags, index),
+				    (Tag*)g_list_nth_data (tag_group_get_tags (panel->priv->selected_tag_group), index),
 				    grab_focus);
 		}
 
@@ -322,7 +322,7 @@ create_model (PlumaTaglistPluginPanel *panel)
 	store = gtk_list_store_new (NUM_COLUMNS, G_TYPE_STRING, G_TYPE_INT);
 
 	/* add data to the list store */
-	list = panel->priv->selected_tag_group->tags;
+	list = tag_group_get_tags (panel->priv->selected_tag_group);
 
 	while (list != NULL)
 	{
@@ -509,7 +509,7 @@ tag_list_cursor_changed_cb (GtkTreeView *tag_list,
 		pluma_debug_message (DEBUG_PLUGINS, "Index: %d", index);
 
 		update_preview (panel,
-			        (Tag*)g_list_nth_data (panel->priv->selected_tag_group->tags, index));
+			        (Tag*)g_list_nth_data (tag_group_get_tags (panel->priv->selected_tag_group), index));
 	}
 }
 
@@ -562,7 +562,7 @@ tags_list_query_tooltip_cb (GtkWidget               *widget,
 			    COLUMN_TAG_INDEX_IN_GROUP, &index,
 			    -1);
 
-	tag = g_list_nth_data (panel->priv->selected_tag_group->tags, index);
+	tag = g_list_nth_data (tag_group_get_tags (panel->priv->selected_tag_group), index);
 	if (tag != NULL)
 	{
 		gchar *tip;
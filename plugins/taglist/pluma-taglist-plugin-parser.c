@@ -39,10 +39,12 @@
 #include <libxml/parser.h>
 #include <glib.h>
 #include <glib/gi18n.h>
+#include <glib/gstdio.h>
 
 #include <pluma/pluma-debug.h>
 
 #include "pluma-taglist-plugin-parser.h"
+#include "pluma-taglist-plugin-cache.h"
 
 #define USER_PLUMA_TAGLIST_PLUGIN_LOCATION "pluma/taglist/"
 
@@ -58,7 +60,6 @@ static TagGroup* get_tag_group (const gchar* filename, xmlDocPtr doc,
 static TagList* lookup_best_lang (TagList *taglist, const gchar *filename,
 				xmlDocPtr doc, xmlNsPtr ns, xmlNodePtr cur);
 static TagList 	*parse_taglist_file (const gchar* filename);
-static TagList  *parse_taglist_dir (const gchar *dir);
 
 static void	 free_tag (Tag *tag);
 static void	 free_tag_group (TagGroup *tag_group);
@@ -510,6 +511,14 @@ free_tag (Tag *tag)
 	g_free (tag);
 }
 
+static void
+free_cached_tag_group (TagGroup *tag_group)
+{
+	/* the strings belong to the cache */
+	g_list_free_full (tag_group->tags, g_free);
+	g_free (tag_group);
+}
+
 static void
 free_tag_group (TagGroup *tag_group)
 {
@@ -519,6 +528,12 @@ free_tag_group (TagGroup *tag_group)
 
 	g_return_if_fail (tag_group != NULL);
 
+	if (tag_group->cached)
+	{
+		free_cached_tag_group (tag_group);
+		return;
+	}
+
 	free (tag_group->name);
 
 	for (l = tag_group->tags; l != NULL; l = g_list_next (l))
@@ -558,13 +573,17 @@ void free_taglist(void)
 	}
 
 	g_list_free (taglist->tag_groups);
+
+	if (taglist->cache != NULL)
+		g_mapped_file_unref (taglist->cache);
+
 	g_free (taglist);
 	taglist = NULL;
 
 	pluma_debug_message (DEBUG_PLUGINS, "Really freed");
 }
 
-static TagList* parse_taglist_dir(const gchar* dir)
+static void collect_taglist_files(const gchar* dir, GPtrArray* files)
 {
 	GError* error = NULL;
 	GDir* d;
@@ -578,27 +597,60 @@ static TagList* parse_taglist_dir(const gchar* dir)
 	{
 		pluma_debug_message(DEBUG_PLUGINS, "%s", error->message);
 		g_error_free (error);
-		return taglist;
+		return;
 	}
 
 	while ((dirent = g_dir_read_name(d)))
 	{
 		if (g_str_has_suffix(dirent, ".tags") || g_str_has_suffix(dirent, ".tags.gz"))
 		{
-			gchar* tags_file = g_build_filename(dir, dirent, NULL);
-			parse_taglist_file(tags_file);
-			g_free (tags_file);
+			g_ptr_array_add (files, g_build_filename(dir, dirent, NULL));
 		}
 	}
 
 	g_dir_close (d);
+}
 
-	return taglist;
+/* The cache is valid as long as the same files, unchanged, are parsed
+ * for the same languages */
+static gchar* get_cache_key(GPtrArray* files)
+{
+	const gchar* const* langs;
+	GString* key;
+	guint i;
+
+	key = g_string_new (NULL);
+
+	for (langs = g_get_language_names (); *langs != NULL; langs++)
+	{
+		g_string_append (key, *langs);
+		g_string_append_c (key, ':');
+	}
+
+	for (i = 0; i < files->len; i++)
+	{
+		const gchar* file = g_ptr_array_index (files, i);
+		GStatBuf buf;
+
+		if (g_stat (file, &buf) != 0)
+		{
+			buf.st_mtime = 0;
+			buf.st_size = 0;
+		}
+
+		g_string_append_printf (key, "\n%s\t%" G_GINT64_FORMAT "\t%" G_GINT64_FORMAT,
+					file, (gint64) buf.st_mtime, (gint64) buf.st_size);
+	}
+
+	return g_string_free (key, FALSE);
 }
 
 TagList* create_taglist(const gchar* data_dir)
 {
+	GPtrArray* files;
 	gchar* pdir;
+	gchar* key;
+	guint i;
 
 	pluma_debug_message(DEBUG_PLUGINS, "ref_count: %d", taglist_ref_count);
 
@@ -611,21 +663,55 @@ TagList* create_taglist(const gchar* data_dir)
 
 	const gchar* home;
 
-	/* load user's taglists */
+	files = g_ptr_array_new_with_free_func (g_free);
+
+	/* user's taglists */
 
 	home = g_get_home_dir ();
 	if (home != NULL)
 	{
 		pdir = g_build_filename(home, ".config", USER_PLUMA_TAGLIST_PLUGIN_LOCATION, NULL);
-		parse_taglist_dir(pdir);
+		collect_taglist_files(pdir, files);
 		g_free (pdir);
 	}
 
-	/* load system's taglists */
-	parse_taglist_dir(data_dir);
+	/* system's taglists */
+	collect_taglist_files(data_dir, files);
+
+	key = get_cache_key (files);
+
+	taglist = taglist_cache_load (key);
+
+	if (taglist == NULL)
+	{
+		for (i = 0; i < files->len; i++)
+		{
+			parse_taglist_file(g_ptr_array_index (files, i));
+		}
+
+		if (taglist != NULL)
+		{
+			taglist_cache_save (taglist, key);
+		}
+	}
+
+	g_free (key);
+	g_ptr_array_free (files, TRUE);
 
 	++taglist_ref_count;
 	g_return_val_if_fail(taglist_ref_count == 1, taglist);
 
 	return taglist;
 }
+
+GList* tag_group_get_tags(TagGroup* tag_group)
+{
+	g_return_val_if_fail (tag_group != NULL, NULL);
+
+	if (tag_group->n_cached_tags > 0)
+	{
+		taglist_cache_load_tags (tag_group);
+	}
+
+	return tag_group->tags;
+}
@@ -41,12 +41,23 @@ typedef struct _Tag Tag;
 
 struct _TagList {
 	GList* tag_groups;
+
+	/* the cache the tag groups were read from, if any */
+	GMappedFile* cache;
 };
 
 struct _TagGroup {
 	xmlChar* name;
 
+	/* use tag_group_get_tags (), tags read from the cache are only
+	 * added to the list the first time it is needed */
 	GList* tags;
+
+	/* the strings of the group and of its tags are in the cache */
+	gboolean cached;
+	gconstpointer cached_tags;
+	guint n_cached_tags;
+	const gchar* cached_strings;
 };
 
 struct _Tag {
@@ -62,5 +73,7 @@ TagList* create_taglist(const gchar* data_dir);
 
 void free_taglist(void);
 
+GList* tag_group_get_tags(TagGroup* tag_group);
+
 #endif /* __PLUMA_TAGLIST_PLUGIN_PARSER_H__ */
 
@@ -27,12 +27,21 @@
 #include <pluma/pluma-debug.h>
 
 #include "pluma-trail-save-plugin.h"
+#include "pluma-trail-save-strip.h"
+
+#define TRAIL_SAVE_SCHEMA	"org.mate.pluma.plugins.trailsave"
+#define MODIFIED_LINES_ONLY_KEY	"modified-lines-only"
+
+/* Marks the lines changed since the document was loaded or saved */
+#define MODIFIED_TAG_KEY	"pluma-trail-save-modified-tag"
 
 static void pluma_window_activatable_iface_init (PlumaWindowActivatableInterface *iface);
 
 struct _PlumaTrailSavePluginPrivate
 {
 	PlumaWindow *window;
+
+	GSettings *settings;
 };
 
 enum {
@@ -49,79 +58,70 @@ G_DEFINE_DYNAMIC_TYPE_EXTENDED (PlumaTrailSavePlugin,
                                                                pluma_window_activatable_iface_init))
 
 static void
-strip_trailing_spaces (GtkTextBuffer *text_buffer)
+tag_modified_lines (GtkTextBuffer *text_buffer,
+		    GtkTextIter   *start,
+		    GtkTextIter   *end)
 {
-	gint line_count, line_num;
+	GtkTextTag *tag;
 	GtkTextIter line_start, line_end;
-	gchar *slice;
-	gchar byte;
-	gint byte_index;
-	gint strip_start_index, strip_end_index;
-	gboolean should_strip;
-	GtkTextIter strip_start, strip_end;
 
-	g_assert (text_buffer != NULL);
+	tag = g_object_get_data (G_OBJECT (text_buffer), MODIFIED_TAG_KEY);
 
-	line_count = gtk_text_buffer_get_line_count (text_buffer);
+	line_start = *start;
+	gtk_text_iter_set_line_offset (&line_start, 0);
 
-	for (line_num = 0; line_num < line_count; ++line_num)
-	{
-		/* Get line text */
-		gtk_text_buffer_get_iter_at_line (text_buffer, &line_start, line_num);
-
-		if (line_num == line_count - 1)
-		{
-			gtk_text_buffer_get_end_iter (text_buffer, &line_end);
-		}
-		else
-		{
-			gtk_text_buffer_get_iter_at_line (text_buffer, &line_end, line_num + 1);
-		}
-
-		slice = gtk_text_buffer_get_slice (text_buffer, &line_start, &line_end, TRUE);
-
-		if (slice == NULL)
-		{
-			continue;
-		}
-
-		/* Find indices of bytes that should be stripped */
-		should_strip = FALSE;
-
-		for (byte_index = 0; slice [byte_index] != 0; ++byte_index)
-		{
-			byte = slice [byte_index];
-
-			if ((byte == ' ') || (byte == '\t'))
-			{
-				if (!should_strip)
-				{
-					strip_start_index = byte_index;
-					should_strip = TRUE;
-				}
-
-				strip_end_index = byte_index + 1;
-			}
-			else if ((byte == '\r') || (byte == '\n'))
-			{
-				break;
-			}
-			else
-			{
-				should_strip = FALSE;
-			}
-		}
-
-		g_free (slice);
-
-		/* Strip trailing spaces */
-		if (should_strip)
-		{
-			gtk_text_buffer_get_iter_at_line_index (text_buffer, &strip_start, line_num, strip_start_index);
-			gtk_text_buffer_get_iter_at_line_index (text_buffer, &strip_end, line_num, strip_end_index);
-			gtk_text_buffer_delete (text_buffer, &strip_start, &strip_end);
-		}
-	}
+	/* the line following a text ending with a newline is not modified */
+	line_end = *end;
+	if (!gtk_text_iter_starts_line (&line_end) || gtk_text_iter_equal (start, end))
+		gtk_text_iter_forward_line (&line_end);
+
+	gtk_text_buffer_apply_tag (text_buffer, tag, &line_start, &line_end);
+}
+
+static void
+on_insert_text (GtkTextBuffer        *text_buffer,
+		GtkTextIter          *location,
+		gchar                *text,
+		gint                  len,
+		PlumaTrailSavePlugin *plugin)
+{
+	GtkTextIter start;
+
+	/* location is at the end of the inserted text */
+	start = *location;
+	gtk_text_iter_backward_chars (&start, g_utf8_strlen (text, len));
+
+	tag_modified_lines (text_buffer, &start, location);
+}
+
+static void
+on_delete_range (GtkTextBuffer        *text_buffer,
+		 GtkTextIter          *start,
+		 GtkTextIter          *end,
+		 PlumaTrailSavePlugin *plugin)
+{
+	tag_modified_lines (text_buffer, start, end);
+}
+
+static void
+clear_modified_lines (PlumaDocument *document)
+{
+	GtkTextTag *tag;
+	GtkTextIter start, end;
+
+	tag = g_object_get_data (G_OBJECT (document), MODIFIED_TAG_KEY);
+
+	gtk_text_buffer_get_bounds (GTK_TEXT_BUFFER (document), &start, &end);
+	gtk_text_buffer_remove_tag (GTK_TEXT_BUFFER (document), tag, &start, &end);
+}
+
+static void
+on_loaded (PlumaDocument        *document,
+	   const GError         *error,
+	   PlumaTrailSavePlugin *plugin)
+{
+	if (error == NULL)
+		clear_modified_lines (document);
 }
 
 static void
@@ -132,8 +132,56 @@ on_save (PlumaDocument         *document,
 	 PlumaTrailSavePlugin  *plugin)
 {
 	GtkTextBuffer *text_buffer = GTK_TEXT_BUFFER (document);
+	GtkTextTag *modified_tag = NULL;
 
-	strip_trailing_spaces (text_buffer);
+	if (g_settings_get_boolean (plugin->priv->settings, MODIFIED_LINES_ONLY_KEY))
+		modified_tag = g_object_get_data (G_OBJECT (document), MODIFIED_TAG_KEY);
+
+	pluma_trail_save_strip_trailing_spaces (text_buffer, modified_tag);
+}
+
+static void
+on_saved (PlumaDocument        *document,
+	  const GError         *error,
+	  PlumaTrailSavePlugin *plugin)
+{
+	if (error == NULL)
+		clear_modified_lines (document);
+}
+
+static void
+connect_document (PlumaTrailSavePlugin *plugin,
+		  PlumaDocument        *document)
+{
+	GtkTextTag *tag;
+
+	/* Lines changed before the plugin was activated are not known */
+	tag = gtk_text_buffer_create_tag (GTK_TEXT_BUFFER (document), NULL, NULL);
+	g_object_set_data (G_OBJECT (document), MODIFIED_TAG_KEY, tag);
+
+	g_signal_connect (document, "save", G_CALLBACK (on_save), plugin);
+	g_signal_connect (document, "saved", G_CALLBACK (on_saved), plugin);
+	g_signal_connect (document, "loaded", G_CALLBACK (on_loaded), plugin);
+	g_signal_connect_after (document, "insert-text", G_CALLBACK (on_insert_text), plugin);
+	g_signal_connect_after (document, "delete-range", G_CALLBACK (on_delete_range), plugin);
+}
+
+static void
+disconnect_document (PlumaTrailSavePlugin *plugin,
+		     PlumaDocument        *document)
+{
+	GtkTextTag *tag;
+
+	g_signal_handlers_disconnect_by_data (document, plugin);
+
+	tag = g_object_get_data (G_OBJECT (document), MODIFIED_TAG_KEY);
+
+	if (tag != NULL)
+	{
+		gtk_text_tag_table_remove (gtk_text_buffer_get_tag_table (GTK_TEXT_BUFFER (document)),
+					   tag);
+		g_object_set_data (G_OBJECT (document), MODIFIED_TAG_KEY, NULL);
+	}
 }
 
 static void
@@ -144,7 +192,7 @@ on_tab_added (PlumaWindow *window,
 	PlumaDocument *document;
 
 	document = pluma_tab_get_document (tab);
-	g_signal_connect (document, "save", G_CALLBACK (on_save), plugin);
+	connect_document (plugin, document);
 }
 
 static void
@@ -155,7 +203,7 @@ on_tab_removed (PlumaWindow *window,
 	PlumaDocument *document;
 
 	document = pluma_tab_get_document (tab);
-	g_signal_handlers_disconnect_by_data (document, plugin);
+	disconnect_document (plugin, document);
 }
 
 static void
@@ -182,7 +230,7 @@ pluma_trail_save_plugin_activate (PlumaWindowActivatable *activatable)
 	     documents_iter = documents_iter->next)
 	{
 		document = (PlumaDocument *) documents_iter->data;
-		g_signal_connect (document, "save", G_CALLBACK (on_save), plugin);
+		connect_document (plugin, document);
 	}
 
 	g_list_free (documents);
@@ -211,7 +259,7 @@ pluma_trail_save_plugin_deactivate (PlumaWindowActivatable *activatable)
 	     documents_iter = documents_iter->next)
 	{
 		document = (PlumaDocument *) documents_iter->data;
-		g_signal_handlers_disconnect_by_data (document, plugin);
+		disconnect_document (plugin, document);
 	}
 
 	g_list_free (documents);
@@ -223,6 +271,8 @@ pluma_trail_save_plugin_init (PlumaTrailSavePlugin *plugin)
 	pluma_debug_message (DEBUG_PLUGINS, "PlumaTrailSavePlugin initializing");
 
 	plugin->priv = pluma_trail_save_plugin_get_instance_private (plugin);
+
+	plugin->priv->settings = g_settings_new (TRAIL_SAVE_SCHEMA);
 }
 
 static void
@@ -238,6 +288,8 @@ pluma_trail_save_plugin_dispose (GObject *object)
 		plugin->priv->window = NULL;
 	}
 
+	g_clear_object (&plugin->priv->settings);
+
 	G_OBJECT_CLASS (pluma_trail_save_plugin_parent_class)->dispose (object);
 }
 
@@ -0,0 +1,178 @@
+/*
+ * pluma-trail-save-strip.c
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+
+#include "pluma-trail-save-strip.h"
+
+typedef struct
+{
+	gint line;
+
+	/* byte indexes in the line */
+	gint start_index;
+	gint end_index;
+} StripRange;
+
+/* Appends the trailing spaces of the lines of @text, which starts at the
+ * beginning of @first_line, to @ranges. Lines already in @ranges are
+ * skipped, so that overlapping texts do not strip a line twice. */
+static void
+find_strip_ranges (const gchar *text,
+		   gint         first_line,
+		   GArray      *ranges)
+{
+	const gchar *line_start = text;
+	const gchar *text_end;
+	gint line = first_line;
+	gint last_line = -1;
+
+	if (ranges->len > 0)
+		last_line = g_array_index (ranges, StripRange, ranges->len - 1).line;
+
+	text_end = text + strlen (text);
+
+	while (TRUE)
+	{
+		const gchar *line_end;
+		const gchar *strip_start;
+		gint delimiter_index;
+		gint next_start;
+
+		/* the lines are split as GtkTextBuffer does, which ends them
+		 * at U+2029 PARAGRAPH SEPARATOR too */
+		pango_find_paragraph_boundary (line_start,
+					       text_end - line_start,
+					       &delimiter_index,
+					       &next_start);
+
+		line_end = line_start + delimiter_index;
+
+		strip_start = line_end;
+		while ((strip_start > line_start) &&
+		       ((strip_start[-1] == ' ') || (strip_start[-1] == '\t')))
+			--strip_start;
+
+		if (strip_start != line_end && line > last_line)
+		{
+			StripRange range;
+
+			range.line = line;
+			range.start_index = strip_start - line_start;
+			range.end_index = line_end - line_start;
+
+			g_array_append_val (ranges, range);
+		}
+
+		/* no delimiter: the last line */
+		if (next_start == delimiter_index)
+			break;
+
+		line_start += next_start;
+		++line;
+	}
+}
+
+static void
+find_modified_strip_ranges (GtkTextBuffer *text_buffer,
+			    GtkTextTag    *tag,
+			    GArray        *ranges)
+{
+	GtkTextIter start, end;
+
+	gtk_text_buffer_get_start_iter (text_buffer, &start);
+
+	if (!gtk_text_iter_has_tag (&start, tag))
+		gtk_text_iter_forward_to_tag_toggle (&start, tag);
+
+	while (!gtk_text_iter_is_end (&start))
+	{
+		gchar *slice;
+
+		end = start;
+		gtk_text_iter_forward_to_tag_toggle (&end, tag);
+
+		if (!gtk_text_iter_starts_line (&end) && !gtk_text_iter_ends_line (&end))
+			gtk_text_iter_forward_to_line_end (&end);
+
+		gtk_text_iter_set_line_offset (&start, 0);
+
+		slice = gtk_text_buffer_get_slice (text_buffer, &start, &end, TRUE);
+		find_strip_ranges (slice, gtk_text_iter_get_line (&start), ranges);
+		g_free (slice);
+
+		start = end;
+
+		if (!gtk_text_iter_has_tag (&start, tag))
+			gtk_text_iter_forward_to_tag_toggle (&start, tag);
+	}
+}
+
+/* Finds the trailing spaces of all the lines, or of the lines tagged with
+ * @modified_tag when it is not %NULL, then deletes them from the last to
+ * the first, so that the line indexes of the remaining ranges stay valid */
+void
+pluma_trail_save_strip_trailing_spaces (GtkTextBuffer *text_buffer,
+					GtkTextTag    *modified_tag)
+{
+	GArray *ranges;
+	gint i;
+
+	g_assert (text_buffer != NULL);
+
+	ranges = g_array_new (FALSE, FALSE, sizeof (StripRange));
+
+	if (modified_tag != NULL)
+	{
+		find_modified_strip_ranges (text_buffer, modified_tag, ranges);
+	}
+	else
+	{
+		GtkTextIter start, end;
+		gchar *text;
+
+		gtk_text_buffer_get_bounds (text_buffer, &start, &end);
+
+		text = gtk_text_buffer_get_slice (text_buffer, &start, &end, TRUE);
+		find_strip_ranges (text, 0, ranges);
+		g_free (text);
+	}
+
+	if (ranges->len > 0)
+	{
+		gtk_text_buffer_begin_user_action (text_buffer);
+
+		for (i = ranges->len - 1; i >= 0; --i)
+		{
+			StripRange *range = &g_array_index (ranges, StripRange, i);
+			GtkTextIter strip_start, strip_end;
+
+			gtk_text_buffer_get_iter_at_line_index (text_buffer, &strip_start, range->line, range->start_index);
+			gtk_text_buffer_get_iter_at_line_index (text_buffer, &strip_end, range->line, range->end_index);
+			gtk_text_buffer_delete (text_buffer, &strip_start, &strip_end);
+		}
+
+		gtk_text_buffer_end_user_action (text_buffer);
+	}
+
+	g_array_free (ranges, TRUE);
+}
@@ -35,6 +35,17 @@
 #define UNIX_PATH_MAX 108
 #endif
 
+/* Messages are lines ending with a newline, which every pluma server
+ * understands. A message that contains a newline itself is framed instead:
+ * a nul byte, the length of the message as a 32 bits big endian integer and
+ * the message. Servers older than the framing drop such a message, but they
+ * could not read it as a line either. The server reads both in large chunks
+ * and accepts many messages on the same connection. */
+#define FRAME_MARKER '\0'
+#define FRAME_HEADER_SIZE 5
+#define MAX_MESSAGE_SIZE (16 * 1024 * 1024)
+#define READ_CHUNK_SIZE 4096
+
 struct BaconMessageConnection {
 	/* A server accepts connections */
 	gboolean is_server;
@@ -52,6 +63,9 @@ struct BaconMessageConnection {
 	/* Connections accepted by this connection */
 	GSList *accepted_connections;
 
+	/* Data read but not dispatched yet */
+	GString *buffer;
+
 	/* callback */
 	void (*func) (const char *message, gpointer user_data);
 	gpointer data;
@@ -100,6 +114,7 @@ setup_connection (BaconMessageConnection *conn)
 	if (!conn->chan) {
 		return FALSE;
 	}
+	g_io_channel_set_encoding (conn->chan, NULL, NULL);
 	g_io_channel_set_line_term (conn->chan, "\n", 1);
 	conn->conn_id = g_io_add_watch (conn->chan, G_IO_IN, server_cb, conn);
 
@@ -127,57 +142,129 @@ accept_new_connection (BaconMessageConnection *server_conn)
 	setup_connection (conn);
 }
 
+static void
+dispatch_message (BaconMessageConnection *conn,
+		  const char             *message)
+{
+	if (conn->func != NULL && *message != '\0')
+		(*conn->func) (message, conn->data);
+}
+
+/* Dispatches the complete messages at the start of the buffer, returns
+ * FALSE if the data can not be a valid message */
+static gboolean
+dispatch_buffer (BaconMessageConnection *conn)
+{
+	GString *buffer = conn->buffer;
+	gsize start = 0;
+
+	while (start < buffer->len)
+	{
+		if (buffer->str[start] == FRAME_MARKER)
+		{
+			const guchar *header;
+			guint32 len;
+			char *message;
+
+			if (buffer->len - start < FRAME_HEADER_SIZE)
+				break;
+
+			header = (const guchar *) buffer->str + start;
+			len = ((guint32) header[1] << 24) |
+			      ((guint32) header[2] << 16) |
+			      ((guint32) header[3] << 8) |
+			      (guint32) header[4];
+
+			if (len > MAX_MESSAGE_SIZE)
+				return FALSE;
+
+			if (buffer->len - start - FRAME_HEADER_SIZE < len)
+				break;
+
+			message = g_strndup (buffer->str + start + FRAME_HEADER_SIZE, len);
+			dispatch_message (conn, message);
+			g_free (message);
+
+			start += FRAME_HEADER_SIZE + len;
+		}
+		else
+		{
+			char *end;
+			char *subs;
+
+			end = memchr (buffer->str + start, '\n', buffer->len - start);
+			if (end == NULL)
+			{
+				if (buffer->len - start > MAX_MESSAGE_SIZE)
+					return FALSE;
+
+				break;
+			}
+
+			*end = '\0';
+
+			/* a line may hold several nul separated messages */
+			for (subs = buffer->str + start; subs < end; subs += strlen (subs) + 1)
+				dispatch_message (conn, subs);
+
+			start = end - buffer->str + 1;
+		}
+	}
+
+	g_string_erase (buffer, 0, start);
+
+	return TRUE;
+}
+
+static void
+close_connection (BaconMessageConnection *conn)
+{
+	g_io_channel_shutdown (conn->chan, FALSE, NULL);
+	g_io_channel_unref (conn->chan);
+	conn->chan = NULL;
+	close (conn->fd);
+	conn->fd = -1;
+	conn->conn_id = 0;
+
+	if (conn->buffer != NULL)
+	{
+		g_string_free (conn->buffer, TRUE);
+		conn->buffer = NULL;
+	}
+}
+
 static gboolean
 server_cb (GIOChannel *source, GIOCondition condition, gpointer data)
 {
 	BaconMessageConnection *conn = (BaconMessageConnection *)data;
-	char *message, *subs, buf;
-	int cd, rc, offset;
-	gboolean finished;
+	char chunk[READ_CHUNK_SIZE];
+	ssize_t rc;
 
-	offset = 0;
 	if (conn->is_server && conn->fd == g_io_channel_unix_get_fd (source)) {
 		accept_new_connection (conn);
 		return TRUE;
 	}
-	message = g_malloc (1);
-	cd = conn->fd;
-	rc = read (cd, &buf, 1);
-	while (rc > 0 && buf != '\n')
-	{
-		message = g_realloc (message, rc + offset + 1);
-		message[offset] = buf;
-		offset = offset + rc;
-		rc = read (cd, &buf, 1);
-	}
-	if (rc <= 0) {
-		g_io_channel_shutdown (conn->chan, FALSE, NULL);
-		g_io_channel_unref (conn->chan);
-		conn->chan = NULL;
-		close (conn->fd);
-		conn->fd = -1;
-		g_free (message);
-		conn->conn_id = 0;
 
+	do
+		rc = read (conn->fd, chunk, sizeof (chunk));
+	while (rc == -1 && errno == EINTR);
+
+	if (rc <= 0) {
+		close_connection (conn);
 		return FALSE;
 	}
-	message[offset] = '\0';
 
-	subs = message;
-	finished = FALSE;
+	if (conn->buffer == NULL)
+		conn->buffer = g_string_sized_new (sizeof (chunk));
 
-	while (finished == FALSE && *subs != '\0')
-	{
-		if (conn->func != NULL)
-			(*conn->func) (subs, conn->data);
+	g_string_append_len (conn->buffer, chunk, rc);
 
-		subs += strlen (subs) + 1;
-		if (subs - message >= offset)
-			finished = TRUE;
+	if (!dispatch_buffer (conn)) {
+		g_warning ("Invalid message received, closing the connection");
+		close_connection (conn);
+		return FALSE;
 	}
 
-	g_free (message);
-
 	return TRUE;
 }
 
@@ -359,6 +446,10 @@ bacon_message_connection_free (BaconMessageConnection *conn)
 		close (conn->fd);
 	}
 
+	if (conn->buffer != NULL) {
+		g_string_free (conn->buffer, TRUE);
+	}
+
 	g_free (conn->path);
 	g_free (conn);
 }
@@ -378,12 +469,31 @@ void
 bacon_message_connection_send (BaconMessageConnection *conn,
 			       const char *message)
 {
+	guchar header[FRAME_HEADER_SIZE];
+	gsize len;
+
 	g_return_if_fail (conn != NULL);
 	g_return_if_fail (message != NULL);
 
-	g_io_channel_write_chars (conn->chan, message, strlen (message),
-				  NULL, NULL);
-	g_io_channel_write_chars (conn->chan, "\n", 1, NULL, NULL);
+	len = strlen (message);
+	g_return_if_fail (len <= MAX_MESSAGE_SIZE);
+
+	if (memchr (message, '\n', len) == NULL) {
+		g_io_channel_write_chars (conn->chan, message, len, NULL, NULL);
+		g_io_channel_write_chars (conn->chan, "\n", 1, NULL, NULL);
+		g_io_channel_flush (conn->chan, NULL);
+		return;
+	}
+
+	header[0] = FRAME_MARKER;
+	header[1] = (len >> 24) & 0xff;
+	header[2] = (len >> 16) & 0xff;
+	header[3] = (len >> 8) & 0xff;
+	header[4] = len & 0xff;
+
+	g_io_channel_write_chars (conn->chan, (const gchar *) header,
+				  FRAME_HEADER_SIZE, NULL, NULL);
+	g_io_channel_write_chars (conn->chan, message, len, NULL, NULL);
 	g_io_channel_flush (conn->chan, NULL);
 }
 
@@ -49,6 +49,7 @@
 #include "pluma-style-scheme-manager.h"
 #include "pluma-help.h"
 #include "pluma-dirs.h"
+#include "pluma-plugins-engine.h"
 #include "pluma-settings.h"
 #include "pluma-utils.h"
 
@@ -1144,6 +1145,9 @@ setup_plugins_page (PlumaPreferencesDialog *dlg)
 
 	pluma_debug (DEBUG_PREFS);
 
+	/* deferred plugins are enabled, show them as such */
+	pluma_plugins_engine_load_deferred (pluma_plugins_engine_get_default ());
+
 	page_content = peas_gtk_plugin_manager_new (NULL);
 	g_return_if_fail (page_content != NULL);
 
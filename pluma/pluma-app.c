@@ -824,6 +824,25 @@ pluma_app_get_views (PlumaApp *app)
     return res;
 }
 
+/* Returns the views that exist, without creating the views of the tabs
+ * opened in the background, see _pluma_window_get_created_views */
+GList *
+_pluma_app_get_created_views (PlumaApp *app)
+{
+    GList *res = NULL;
+    GList *windows;
+
+    g_return_val_if_fail (PLUMA_IS_APP (app), NULL);
+
+    for (windows = app->priv->windows; windows != NULL; windows = g_list_next (windows))
+    {
+        res = g_list_concat (res,
+                             _pluma_window_get_created_views (PLUMA_WINDOW (windows->data)));
+    }
+
+    return res;
+}
+
 /**
  * pluma_app_get_lockdown:
  * @app: a #PlumaApp
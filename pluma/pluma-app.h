@@ -124,6 +124,7 @@ void		 _pluma_app_set_lockdown		(PlumaApp          *app,
 void		 _pluma_app_set_lockdown_bit		(PlumaApp          *app,
 							 PlumaLockdownMask  bit,
 							 gboolean           value);
+GList		*_pluma_app_get_created_views		(PlumaApp          *app);
 /*
  * This one is a pluma-window function, but we declare it here to avoid
  * #include headaches since it needs the PlumaLockdownMask declaration.
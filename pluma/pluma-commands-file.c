@@ -44,6 +44,7 @@
 #include "pluma-commands.h"
 #include "pluma-window.h"
 #include "pluma-window-private.h"
+#include "pluma-notebook.h"
 #include "pluma-statusbar.h"
 #include "pluma-debug.h"
 #include "pluma-utils.h"
@@ -73,49 +74,155 @@ _pluma_cmd_file_new (GtkAction   *action,
 	pluma_window_create_tab (window, TRUE);
 }
 
-static PlumaTab *
-get_tab_from_file (GList *docs, GFile *file)
+/* When many files are opened at once, a tab is created for each of them
+ * right away but only MAX_CONCURRENT_LOADS documents are loaded at the
+ * same time, the others wait in their tab, in the order they were opened.
+ * A waiting tab is loaded as soon as it is shown. */
+#define MAX_CONCURRENT_LOADS 4
+
+static GQueue pending_loads = G_QUEUE_INIT;
+static guint  n_running_loads = 0;
+static guint  start_loads_id = 0;
+
+static gboolean start_pending_loads (gpointer data);
+
+static void running_load_done (PlumaTab *tab);
+
+static void
+running_load_state_changed (PlumaTab   *tab,
+			    GParamSpec *pspec,
+			    gpointer    data)
+{
+	if (pluma_tab_get_state (tab) != PLUMA_TAB_STATE_LOADING)
+		running_load_done (tab);
+}
+
+static void
+running_load_destroyed (PlumaTab *tab,
+			gpointer  data)
+{
+	running_load_done (tab);
+}
+
+static void
+running_load_done (PlumaTab *tab)
+{
+	g_signal_handlers_disconnect_by_func (tab,
+					      G_CALLBACK (running_load_state_changed),
+					      NULL);
+	g_signal_handlers_disconnect_by_func (tab,
+					      G_CALLBACK (running_load_destroyed),
+					      NULL);
+
+	--n_running_loads;
+
+	if (start_loads_id == 0)
+		start_loads_id = g_idle_add (start_pending_loads, NULL);
+}
+
+static gboolean
+start_pending_loads (gpointer data)
 {
-	PlumaTab *tab = NULL;
+	start_loads_id = 0;
 
-	while (docs != NULL)
+	while (n_running_loads < MAX_CONCURRENT_LOADS &&
+	       !g_queue_is_empty (&pending_loads))
 	{
-		PlumaDocument *d;
-		GFile *l;
+		PlumaTab *tab;
 
-		d = PLUMA_DOCUMENT (docs->data);
+		tab = g_queue_pop_head (&pending_loads);
 
-		l = pluma_document_get_location (d);
-		if (l != NULL)
+		/* skip the tabs closed while waiting */
+		if (gtk_widget_get_parent (GTK_WIDGET (tab)) != NULL &&
+		    _pluma_tab_start_deferred_load (tab))
 		{
-			if (g_file_equal (l, file))
-			{
-				tab = pluma_tab_get_from_document (d);
-				g_object_unref (l);
-				break;
-			}
+			++n_running_loads;
 
-			g_object_unref (l);
+			g_signal_connect (tab,
+					  "notify::state",
+					  G_CALLBACK (running_load_state_changed),
+					  NULL);
+			g_signal_connect (tab,
+					  "destroy",
+					  G_CALLBACK (running_load_destroyed),
+					  NULL);
 		}
 
-		docs = g_list_next (docs);
+		g_object_unref (tab);
 	}
 
-	return tab;
+	return G_SOURCE_REMOVE;
 }
 
-static gboolean
-is_duplicated_file (GSList *files, GFile *file)
+/* Adds a tab for uri at the end of the notebook of window, the document
+ * is loaded in the background along with the others or when the tab is
+ * shown */
+PlumaTab *
+_pluma_cmd_load_file_deferred (PlumaWindow         *window,
+			       const gchar         *uri,
+			       const PlumaEncoding *encoding,
+			       gint                 line_pos,
+			       gboolean             create)
 {
-	while (files != NULL)
+	GtkWidget *tab;
+
+	tab = _pluma_tab_new_unrealized ();
+
+	_pluma_tab_load_deferred (PLUMA_TAB (tab),
+				  uri,
+				  encoding,
+				  line_pos,
+				  create);
+
+	gtk_widget_show (tab);
+
+	pluma_notebook_add_tab (PLUMA_NOTEBOOK (_pluma_window_get_notebook (window)),
+				PLUMA_TAB (tab),
+				-1,
+				FALSE);
+
+	g_queue_push_tail (&pending_loads, g_object_ref (tab));
+
+	if (start_loads_id == 0)
+		start_loads_id = g_idle_add (start_pending_loads, NULL);
+
+	return PLUMA_TAB (tab);
+}
+
+static GHashTable *
+get_tabs_by_file (PlumaWindow *window)
+{
+	GHashTable *tabs;
+	GList *docs;
+	GList *l;
+
+	tabs = g_hash_table_new_full (g_file_hash,
+				      (GEqualFunc) g_file_equal,
+				      g_object_unref,
+				      NULL);
+
+	docs = pluma_window_get_documents (window);
+
+	for (l = docs; l != NULL; l = g_list_next (l))
 	{
-		if (g_file_equal (files->data, file))
-			return TRUE;
+		GFile *location;
+
+		location = pluma_document_get_location (PLUMA_DOCUMENT (l->data));
+
+		if (location == NULL)
+			continue;
 
-		files = g_slist_next (files);
+		if (g_hash_table_contains (tabs, location))
+			g_object_unref (location);
+		else
+			g_hash_table_insert (tabs,
+					     location,
+					     pluma_tab_get_from_document (PLUMA_DOCUMENT (l->data)));
 	}
 
-	return FALSE;
+	g_list_free (docs);
+
+	return tabs;
 }
 
 /* File loading */
@@ -129,53 +236,56 @@ load_file_list (PlumaWindow         *window,
 	PlumaTab      *tab;
 	gint           loaded_files = 0; /* Number of files to load */
 	gboolean       jump_to = TRUE; /* Whether to jump to the new tab */
-	GList         *win_docs;
+	GHashTable    *open_tabs;
+	GHashTable    *seen;
 	GSList        *files_to_load = NULL;
 	GSList        *l;
 
 	pluma_debug (DEBUG_COMMANDS);
 
-	win_docs = pluma_window_get_documents (window);
+	open_tabs = get_tabs_by_file (window);
+	seen = g_hash_table_new (g_file_hash, (GEqualFunc) g_file_equal);
 
 	/* Remove the uris corresponding to documents already open
 	 * in "window" and remove duplicates from "uris" list */
 	for (l = files; l != NULL; l = l->next)
 	{
-		if (!is_duplicated_file (files_to_load, l->data))
+		if (!g_hash_table_add (seen, l->data))
+			continue;
+
+		tab = g_hash_table_lookup (open_tabs, l->data);
+		if (tab != NULL)
 		{
-			tab = get_tab_from_file (win_docs, l->data);
-			if (tab != NULL)
+			if (l == files)
 			{
-				if (l == files)
-				{
-					pluma_window_set_active_tab (window, tab);
-					jump_to = FALSE;
+				pluma_window_set_active_tab (window, tab);
+				jump_to = FALSE;
 
-					if (line_pos > 0)
-					{
-						PlumaDocument *doc;
-						PlumaView *view;
+				if (line_pos > 0)
+				{
+					PlumaDocument *doc;
+					PlumaView *view;
 
-						doc = pluma_tab_get_document (tab);
-						view = pluma_tab_get_view (tab);
+					doc = pluma_tab_get_document (tab);
+					view = pluma_tab_get_view (tab);
 
-						/* document counts lines starting from 0 */
-						pluma_document_goto_line (doc, line_pos - 1);
-						pluma_view_scroll_to_cursor (view);
-					}
+					/* document counts lines starting from 0 */
+					pluma_document_goto_line (doc, line_pos - 1);
+					pluma_view_scroll_to_cursor (view);
 				}
-
-				++loaded_files;
-			}
-			else
-			{
-				files_to_load = g_slist_prepend (files_to_load,
-								 l->data);
 			}
+
+			++loaded_files;
+		}
+		else
+		{
+			files_to_load = g_slist_prepend (files_to_load,
+							 l->data);
 		}
 	}
 
-	g_list_free (win_docs);
+	g_hash_table_destroy (seen);
+	g_hash_table_destroy (open_tabs);
 
 	if (files_to_load == NULL)
 		return loaded_files;
@@ -219,12 +329,22 @@ load_file_list (PlumaWindow         *window,
 
 		// FIXME: pass the GFile to tab when api is there
 		uri = g_file_get_uri (l->data);
-		tab = pluma_window_create_tab_from_uri (window,
-							uri,
-							encoding,
-							line_pos,
-							create,
-							jump_to);
+
+		/* the tab that will be shown is loaded first, the
+		 * others when their turn comes */
+		if (jump_to || files_to_load->next == NULL)
+			tab = pluma_window_create_tab_from_uri (window,
+								uri,
+								encoding,
+								line_pos,
+								create,
+								jump_to);
+		else
+			tab = _pluma_cmd_load_file_deferred (window,
+							     uri,
+							     encoding,
+							     line_pos,
+							     create);
 		g_free (uri);
 
 		if (tab != NULL)
@@ -263,7 +383,7 @@ load_file_list (PlumaWindow         *window,
 					       loaded_files);
 	}
 
-	/* Free uris_to_load. Note that l points to the first element of uris_to_load */
+	/* Free files_to_load, the GFiles belong to "files" */
 	g_slist_free (files_to_load);
 
 	return loaded_files;
@@ -46,6 +46,7 @@
 #include "pluma-window.h"
 #include "pluma-window-private.h"
 #include "pluma-utils.h"
+#include "pluma-find-in-files-panel.h"
 #include "dialogs/pluma-search-dialog.h"
 
 #define PLUMA_SEARCH_DIALOG_KEY		"pluma-search-dialog-key"
@@ -431,12 +432,46 @@ do_replace (PlumaSearchDialog *dialog,
 	do_find (dialog, window);
 }
 
+typedef struct
+{
+	PlumaWindow *window;
+	gchar       *search_text;
+} ReplaceAllData;
+
+static void
+replace_all_ready_cb (PlumaTab       *tab,
+		      GAsyncResult   *result,
+		      ReplaceAllData *data)
+{
+	GError *error = NULL;
+	gint count;
+
+	count = _pluma_tab_replace_all_finish (tab, result, &error);
+
+	/* the window may be gone if the replacement was cancelled */
+	if (error != NULL)
+	{
+		g_error_free (error);
+	}
+	else if (count > 0)
+	{
+		text_found (data->window, count);
+	}
+	else
+	{
+		text_not_found (data->window, data->search_text);
+	}
+
+	g_free (data->search_text);
+	g_slice_free (ReplaceAllData, data);
+}
+
 static void
 do_replace_all (PlumaSearchDialog *dialog,
 		PlumaWindow       *window)
 {
-	PlumaView *active_view;
-	PlumaDocument *doc;
+	PlumaTab *active_tab;
+	ReplaceAllData *data;
 	const gchar *search_entry_text;
 	const gchar *replace_entry_text;
 	gboolean match_case;
@@ -444,13 +479,14 @@ do_replace_all (PlumaSearchDialog *dialog,
 	gboolean entire_word;
 	gboolean parse_escapes;
 	guint flags = 0;
-	gint count;
 
-	active_view = pluma_window_get_active_view (window);
-	if (active_view == NULL)
+	active_tab = pluma_window_get_active_tab (window);
+	if (active_tab == NULL)
 		return;
 
-	doc = PLUMA_DOCUMENT (gtk_text_view_get_buffer (GTK_TEXT_VIEW (active_view)));
+	/* a replace all may be still running */
+	if (pluma_tab_get_state (active_tab) != PLUMA_TAB_STATE_NORMAL)
+		return;
 
 	parse_escapes = pluma_search_dialog_get_parse_escapes (dialog);
 	if (!parse_escapes) {
@@ -477,24 +513,23 @@ do_replace_all (PlumaSearchDialog *dialog,
 	PLUMA_SEARCH_SET_MATCH_REGEX (flags, match_regex);
 	PLUMA_SEARCH_SET_ENTIRE_WORD (flags, entire_word);
 
-	count = pluma_document_replace_all (doc,
-					    search_entry_text,
-					    replace_entry_text,
-					    flags);
-
-	if (count > 0)
-	{
-		text_found (window, count);
-	}
-	else
-	{
-		if (!parse_escapes) {
-			text_not_found (window, pluma_utils_unescape_search_text (search_entry_text));
-		} else {
-			text_not_found (window, search_entry_text);
-		}
+	data = g_slice_new (ReplaceAllData);
+	data->window = window;
+	if (!parse_escapes) {
+		data->search_text = pluma_utils_unescape_search_text (search_entry_text);
+	} else {
+		data->search_text = g_strdup (search_entry_text);
 	}
 
+	/* large documents are processed in slices, see
+	 * pluma_document_replace_all_async () */
+	_pluma_tab_replace_all (active_tab,
+				search_entry_text,
+				replace_entry_text,
+				flags,
+				(GAsyncReadyCallback) replace_all_ready_cb,
+				data);
+
 	gtk_dialog_set_response_sensitive (GTK_DIALOG (dialog),
 					   PLUMA_SEARCH_DIALOG_REPLACE_RESPONSE,
 					   FALSE);
@@ -777,6 +812,145 @@ _pluma_cmd_search_clear_highlight (GtkAction   *action,
 					PLUMA_SEARCH_DONT_SET_FLAGS);
 }
 
+#define HIGHLIGHT_TERMS_RESPONSE_CLEAR	1
+
+void
+_pluma_cmd_search_highlight_terms (GtkAction   *action,
+				   PlumaWindow *window)
+{
+	PlumaDocument *doc;
+	GtkWidget *dialog;
+	GtkWidget *content;
+	GtkWidget *label;
+	GtkWidget *scrolled;
+	GtkWidget *text_view;
+	GtkWidget *case_check;
+	GtkWidget *word_check;
+	GtkTextBuffer *buffer;
+	gchar **terms;
+	guint flags = 0;
+	gint ret;
+
+	pluma_debug (DEBUG_COMMANDS);
+
+	doc = pluma_window_get_active_document (window);
+	if (doc == NULL)
+		return;
+
+	dialog = gtk_dialog_new ();
+	gtk_window_set_title (GTK_WINDOW (dialog), _("Highlight Terms"));
+	gtk_window_set_transient_for (GTK_WINDOW (dialog), GTK_WINDOW (window));
+	gtk_window_set_modal (GTK_WINDOW (dialog), TRUE);
+	gtk_window_set_destroy_with_parent (GTK_WINDOW (dialog), TRUE);
+	gtk_window_set_default_size (GTK_WINDOW (dialog), 360, 320);
+
+	pluma_dialog_add_button (GTK_DIALOG (dialog),
+				 _("C_lear"),
+				 "edit-clear",
+				 HIGHLIGHT_TERMS_RESPONSE_CLEAR);
+	pluma_dialog_add_button (GTK_DIALOG (dialog),
+				 _("_Cancel"),
+				 "process-stop",
+				 GTK_RESPONSE_CANCEL);
+	pluma_dialog_add_button (GTK_DIALOG (dialog),
+				 _("_Highlight"),
+				 "edit-find",
+				 GTK_RESPONSE_OK);
+	gtk_dialog_set_default_response (GTK_DIALOG (dialog), GTK_RESPONSE_OK);
+
+	content = gtk_dialog_get_content_area (GTK_DIALOG (dialog));
+	gtk_container_set_border_width (GTK_CONTAINER (content), 6);
+	gtk_box_set_spacing (GTK_BOX (content), 6);
+
+	label = gtk_label_new_with_mnemonic (_("_Terms, one per line:"));
+	gtk_label_set_xalign (GTK_LABEL (label), 0.0);
+	gtk_box_pack_start (GTK_BOX (content), label, FALSE, FALSE, 0);
+
+	scrolled = gtk_scrolled_window_new (NULL, NULL);
+	gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scrolled),
+					GTK_POLICY_AUTOMATIC,
+					GTK_POLICY_AUTOMATIC);
+	gtk_scrolled_window_set_shadow_type (GTK_SCROLLED_WINDOW (scrolled),
+					     GTK_SHADOW_IN);
+	gtk_box_pack_start (GTK_BOX (content), scrolled, TRUE, TRUE, 0);
+
+	text_view = gtk_text_view_new ();
+	gtk_text_view_set_monospace (GTK_TEXT_VIEW (text_view), TRUE);
+	gtk_container_add (GTK_CONTAINER (scrolled), text_view);
+	gtk_label_set_mnemonic_widget (GTK_LABEL (label), text_view);
+
+	case_check = gtk_check_button_new_with_mnemonic (_("_Match case"));
+	gtk_box_pack_start (GTK_BOX (content), case_check, FALSE, FALSE, 0);
+
+	word_check = gtk_check_button_new_with_mnemonic (_("Match _entire word only"));
+	gtk_box_pack_start (GTK_BOX (content), word_check, FALSE, FALSE, 0);
+
+	/* start from the terms already highlighted in the document */
+	buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (text_view));
+	terms = pluma_document_get_highlight_terms (doc, &flags);
+	if (terms != NULL)
+	{
+		gchar *text;
+
+		text = g_strjoinv ("\n", terms);
+		gtk_text_buffer_set_text (buffer, text, -1);
+		g_free (text);
+		g_strfreev (terms);
+	}
+
+	gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (case_check),
+				      PLUMA_SEARCH_IS_CASE_SENSITIVE (flags));
+	gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (word_check),
+				      PLUMA_SEARCH_IS_ENTIRE_WORD (flags));
+
+	gtk_widget_show_all (content);
+
+	ret = gtk_dialog_run (GTK_DIALOG (dialog));
+
+	if (ret == GTK_RESPONSE_OK)
+	{
+		GtkTextIter start;
+		GtkTextIter end;
+		GPtrArray *lines;
+		gchar *text;
+		gchar **split;
+		gint i;
+
+		gtk_text_buffer_get_bounds (buffer, &start, &end);
+		text = gtk_text_buffer_get_text (buffer, &start, &end, FALSE);
+		split = g_strsplit (text, "\n", -1);
+
+		/* blank lines are not terms */
+		lines = g_ptr_array_new ();
+		for (i = 0; split[i] != NULL; ++i)
+		{
+			if (*split[i] != '\0')
+				g_ptr_array_add (lines, split[i]);
+		}
+		g_ptr_array_add (lines, NULL);
+
+		flags = 0;
+		PLUMA_SEARCH_SET_CASE_SENSITIVE (flags,
+						 gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (case_check)));
+		PLUMA_SEARCH_SET_ENTIRE_WORD (flags,
+					      gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (word_check)));
+
+		pluma_document_set_highlight_terms (doc,
+						    (const gchar * const *) lines->pdata,
+						    flags);
+
+		g_ptr_array_free (lines, TRUE);
+		g_strfreev (split);
+		g_free (text);
+	}
+	else if (ret == HIGHLIGHT_TERMS_RESPONSE_CLEAR)
+	{
+		pluma_document_set_highlight_terms (doc, NULL, 0);
+	}
+
+	gtk_widget_destroy (dialog);
+}
+
 void
 _pluma_cmd_search_goto_line (GtkAction   *action,
 			     PlumaWindow *window)
@@ -825,3 +999,40 @@ _pluma_cmd_search_incremental_search (GtkAction   *action,
 			       GDK_KEY_k,
 			       GDK_CONTROL_MASK);
 }
+
+void
+_pluma_cmd_search_find_in_files (GtkAction   *action,
+				 PlumaWindow *window)
+{
+	PlumaPanel *panel;
+	PlumaDocument *doc;
+	gchar *find_text = NULL;
+	gint sel_len = 0;
+
+	pluma_debug (DEBUG_COMMANDS);
+
+	panel = pluma_window_get_bottom_panel (window);
+
+	/* the panel is only built the first time it is needed */
+	if (window->priv->find_in_files_panel == NULL)
+	{
+		window->priv->find_in_files_panel = pluma_find_in_files_panel_new (window);
+		pluma_panel_add_item_with_icon (panel,
+						window->priv->find_in_files_panel,
+						_("Find in Files"),
+						"edit-find");
+	}
+
+	gtk_widget_show (GTK_WIDGET (panel));
+	pluma_panel_activate_item (panel, window->priv->find_in_files_panel);
+
+	doc = pluma_window_get_active_document (window);
+	if (doc != NULL)
+		get_selected_text (GTK_TEXT_BUFFER (doc), &find_text, &sel_len);
+
+	/* like the find dialog, ignore long selections */
+	pluma_find_in_files_panel_focus_search (PLUMA_FIND_IN_FILES_PANEL (window->priv->find_in_files_panel),
+						sel_len < 80 ? find_text : NULL);
+
+	g_free (find_text);
+}
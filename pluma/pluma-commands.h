@@ -67,6 +67,12 @@ gint		_pluma_cmd_load_files_from_prompt	(PlumaWindow         *window,
 							 const PlumaEncoding *encoding,
 							 gint                 line_pos);
 
+PlumaTab	*_pluma_cmd_load_file_deferred		(PlumaWindow         *window,
+							 const gchar         *uri,
+							 const PlumaEncoding *encoding,
+							 gint                 line_pos,
+							 gboolean             create);
+
 void		_pluma_cmd_file_new			(GtkAction   *action,
 							 PlumaWindow *window);
 void		_pluma_cmd_file_open			(GtkAction   *action,
@@ -140,10 +146,14 @@ void		_pluma_cmd_search_replace		(GtkAction   *action,
 							 PlumaWindow *window);
 void		_pluma_cmd_search_clear_highlight	(GtkAction   *action,
 							 PlumaWindow *window);
+void		_pluma_cmd_search_highlight_terms	(GtkAction   *action,
+							 PlumaWindow *window);
 void		_pluma_cmd_search_goto_line		(GtkAction   *action,
 							 PlumaWindow *window);
 void		_pluma_cmd_search_incremental_search	(GtkAction   *action,
 							 PlumaWindow *window);
+void		_pluma_cmd_search_find_in_files		(GtkAction   *action,
+							 PlumaWindow *window);
 
 void		_pluma_cmd_documents_previous_document	(GtkAction   *action,
 							 PlumaWindow *window);
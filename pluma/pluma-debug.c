@@ -36,6 +36,7 @@
 #endif
 
 #include <stdio.h>
+#include <unistd.h>
 #include "pluma-debug.h"
 
 #define ENABLE_PROFILING
@@ -47,6 +48,25 @@ static gdouble last = 0.0;
 
 static PlumaDebugSection debug = PLUMA_NO_DEBUG;
 
+/* The trace events are kept in a ring buffer, the oldest ones are
+ * overwritten when it is full. Writers only need to atomically bump the
+ * index of the next event. */
+#define TRACE_BUFFER_SIZE 16384
+
+typedef struct
+{
+	const gchar   *name;
+	gconstpointer  id;
+	gpointer       thread;
+	gint64         time;
+	gchar          phase;
+} TraceEvent;
+
+static TraceEvent *trace_events = NULL;
+static gint trace_next = 0;
+static gint64 trace_start = 0;
+static gchar *trace_file = NULL;
+
 void
 pluma_debug_init (void)
 {
@@ -94,6 +114,14 @@ out:
 	if (debug != PLUMA_NO_DEBUG)
 		timer = g_timer_new ();
 #endif
+
+	if (g_getenv ("PLUMA_TRACE") != NULL)
+	{
+		trace_file = g_strdup (g_getenv ("PLUMA_TRACE"));
+		trace_events = g_new0 (TraceEvent, TRACE_BUFFER_SIZE);
+		trace_start = g_get_monotonic_time ();
+	}
+
 	return;
 }
 
@@ -157,3 +185,187 @@ void pluma_debug (PlumaDebugSection  section,
 		fflush (stdout);
 	}
 }
+
+static void
+trace_add (const gchar   *name,
+	   gchar          phase,
+	   gconstpointer  id)
+{
+	TraceEvent *event;
+	guint index;
+
+	index = (guint) g_atomic_int_add (&trace_next, 1);
+	event = &trace_events[index % TRACE_BUFFER_SIZE];
+
+	event->name = name;
+	event->id = id;
+	event->thread = g_thread_self ();
+	event->time = g_get_monotonic_time () - trace_start;
+	event->phase = phase;
+}
+
+void
+pluma_debug_trace_begin (const gchar *name)
+{
+	if (G_UNLIKELY (trace_events != NULL))
+		trace_add (name, 'B', NULL);
+}
+
+void
+pluma_debug_trace_end (const gchar *name)
+{
+	if (G_UNLIKELY (trace_events != NULL))
+		trace_add (name, 'E', NULL);
+}
+
+void
+pluma_debug_trace_async_begin (const gchar   *name,
+			       gconstpointer  id)
+{
+	if (G_UNLIKELY (trace_events != NULL))
+		trace_add (name, 'b', id);
+}
+
+void
+pluma_debug_trace_async_end (const gchar   *name,
+			     gconstpointer  id)
+{
+	if (G_UNLIKELY (trace_events != NULL))
+		trace_add (name, 'e', id);
+}
+
+void
+pluma_debug_trace_mark (const gchar *name)
+{
+	if (G_UNLIKELY (trace_events != NULL))
+		trace_add (name, 'i', NULL);
+}
+
+static void
+append_json_string (GString     *str,
+		    const gchar *text)
+{
+	g_string_append_c (str, '"');
+
+	for (; *text != '\0'; text++)
+	{
+		if (*text == '"' || *text == '\\')
+			g_string_append_printf (str, "\\%c", *text);
+		else if ((guchar) *text < 0x20)
+			g_string_append_printf (str, "\\u%04x", (guchar) *text);
+		else
+			g_string_append_c (str, *text);
+	}
+
+	g_string_append_c (str, '"');
+}
+
+static void
+append_json_event (GString    *str,
+		   TraceEvent *event,
+		   guint       tid)
+{
+	g_string_append (str, "{\"name\":");
+	append_json_string (str, event->name);
+	g_string_append_printf (str,
+				",\"cat\":\"pluma\",\"ph\":\"%c\",\"ts\":%" G_GINT64_FORMAT
+				",\"pid\":%d,\"tid\":%u",
+				event->phase,
+				event->time,
+				(gint) getpid (),
+				tid);
+
+	if (event->phase == 'b' || event->phase == 'e')
+		g_string_append_printf (str, ",\"id\":\"%p\"", event->id);
+	else if (event->phase == 'i')
+		g_string_append (str, ",\"s\":\"g\"");
+
+	g_string_append_c (str, '}');
+}
+
+static void
+append_csv_event (GString    *str,
+		  TraceEvent *event,
+		  guint       tid)
+{
+	gchar *name;
+
+	/* the names do not hold quotes */
+	name = g_strdelimit (g_strdup (event->name), "\"", '\'');
+
+	g_string_append_printf (str,
+				"%c,\"%s\",%p,%u,%" G_GINT64_FORMAT "\n",
+				event->phase,
+				name,
+				event->id,
+				tid,
+				event->time);
+
+	g_free (name);
+}
+
+void
+pluma_debug_trace_dump (void)
+{
+	GHashTable *threads;
+	GString *str;
+	GError *error = NULL;
+	gboolean csv;
+	guint next;
+	guint i;
+
+	if (trace_events == NULL)
+		return;
+
+	csv = g_str_has_suffix (trace_file, ".csv");
+
+	/* number the threads in the order they show up */
+	threads = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+	str = g_string_new (csv ? "phase,name,id,thread,time_us\n" : "{\"traceEvents\":[\n");
+
+	next = (guint) g_atomic_int_get (&trace_next);
+	i = next > TRACE_BUFFER_SIZE ? next - TRACE_BUFFER_SIZE : 0;
+
+	for (; i < next; i++)
+	{
+		TraceEvent *event = &trace_events[i % TRACE_BUFFER_SIZE];
+		guint tid;
+
+		tid = GPOINTER_TO_UINT (g_hash_table_lookup (threads, event->thread));
+		if (tid == 0)
+		{
+			tid = g_hash_table_size (threads) + 1;
+			g_hash_table_insert (threads, event->thread, GUINT_TO_POINTER (tid));
+		}
+
+		if (csv)
+		{
+			append_csv_event (str, event, tid);
+		}
+		else
+		{
+			append_json_event (str, event, tid);
+
+			if (i + 1 < next)
+				g_string_append_c (str, ',');
+
+			g_string_append_c (str, '\n');
+		}
+	}
+
+	if (!csv)
+		g_string_append (str, "],\"displayTimeUnit\":\"ms\"}\n");
+
+	if (!g_file_set_contents (trace_file, str->str, str->len, &error))
+	{
+		g_warning ("Cannot write the trace to %s: %s", trace_file, error->message);
+		g_error_free (error);
+	}
+
+	g_string_free (str, TRUE);
+	g_hash_table_destroy (threads);
+
+	g_clear_pointer (&trace_events, g_free);
+	g_clear_pointer (&trace_file, g_free);
+}
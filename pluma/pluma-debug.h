@@ -91,5 +91,24 @@ void pluma_debug_message (PlumaDebugSection  section,
 			  const gchar       *function,
 			  const gchar       *format, ...) G_GNUC_PRINTF(5, 6);
 
+/*
+ * Set PLUMA_TRACE to the name of a file to record the following spans
+ * and dump them when pluma quits, as CSV if the name ends with ".csv",
+ * as a Chrome trace (chrome://tracing) otherwise. The names are not
+ * copied, they must stay valid until then.
+ */
+void pluma_debug_trace_begin       (const gchar   *name);
+void pluma_debug_trace_end         (const gchar   *name);
+
+/* for spans that do not nest, like the stages of an async operation */
+void pluma_debug_trace_async_begin (const gchar   *name,
+				    gconstpointer  id);
+void pluma_debug_trace_async_end   (const gchar   *name,
+				    gconstpointer  id);
+
+void pluma_debug_trace_mark        (const gchar   *name);
+
+void pluma_debug_trace_dump        (void);
+
 
 #endif /* __PLUMA_DEBUG_H__ */
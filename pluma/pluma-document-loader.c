@@ -565,6 +565,8 @@ async_read_cb (GInputStream *stream,
     /* end of the file, we are done! */
     if (async->read == 0)
     {
+        pluma_debug_trace_async_end ("file read", loader);
+
         g_output_stream_flush (loader->priv->output,
                                NULL,
                                &loader->priv->error);
@@ -686,6 +688,7 @@ finish_query_info (AsyncData *async)
                   NULL);
 
     /* start reading */
+    pluma_debug_trace_async_begin ("file read", loader);
     read_file_chunk (async);
 }
 
@@ -699,6 +702,8 @@ query_info_cb (GFile        *source,
 
     pluma_debug (DEBUG_LOADER);
 
+    pluma_debug_trace_async_end ("file query info", async->loader);
+
     /* manually check the cancelled state */
     if (g_cancellable_is_cancelled (async->cancellable))
     {
@@ -785,6 +790,8 @@ async_read_ready_callback (GObject      *source,
 
     pluma_debug (DEBUG_LOADER);
 
+    pluma_debug_trace_async_end ("file open", async->loader);
+
     /* manual check for cancelled state */
     if (g_cancellable_is_cancelled (async->cancellable))
     {
@@ -822,6 +829,7 @@ async_read_ready_callback (GObject      *source,
      * Using the file instead of the stream is slightly racy, but for
      * loading this is not too bad...
      */
+    pluma_debug_trace_async_begin ("file query info", loader);
     g_file_query_info_async (loader->priv->gfile,
                              REMOTE_QUERY_ATTRIBUTES,
                              G_FILE_QUERY_INFO_NONE,
@@ -834,6 +842,7 @@ async_read_ready_callback (GObject      *source,
 static void
 open_async_read (AsyncData *async)
 {
+    pluma_debug_trace_async_begin ("file open", async->loader);
     g_file_read_async (async->loader->priv->gfile,
                        G_PRIORITY_HIGH,
                        async->cancellable,
@@ -858,6 +867,8 @@ pluma_document_loader_loading (PlumaDocumentLoader *loader,
 
     if (completed)
     {
+        pluma_debug_trace_async_end ("file load", loader);
+
         if (error == NULL)
             pluma_debug_message (DEBUG_LOADER, "load completed");
         else
@@ -886,6 +897,8 @@ pluma_document_loader_load (PlumaDocumentLoader *loader)
 
     loader->priv->gfile = g_file_new_for_uri (loader->priv->uri);
 
+    pluma_debug_trace_async_begin ("file load", loader);
+
     /* loading start */
     pluma_document_loader_loading (PLUMA_DOCUMENT_LOADER (loader),
                                    FALSE,
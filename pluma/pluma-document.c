@@ -50,6 +50,8 @@
 #include "pluma-document-loader.h"
 #include "pluma-document-saver.h"
 #include "pluma-enum-types.h"
+#include "pluma-multi-matcher.h"
+#include "pluma-undo-manager.h"
 #include "plumatextregion.h"
 
 #ifndef ENABLE_GVFS_METADATA
@@ -144,6 +146,13 @@ struct _PlumaDocumentPrivate
 	PlumaTextRegion *to_search_region;
 	GtkTextTag      *found_tag;
 
+	/* Highlighting of several terms at once */
+	gchar             **highlight_terms;
+	guint               highlight_flags;
+	PlumaMultiMatcher  *highlight_matcher;
+	GPtrArray          *highlight_tags;
+	PlumaTextRegion    *to_highlight_region;
+
 	/* Mount operation factory */
 	PlumaMountOperationFactory  mount_operation_factory;
 	gpointer		    mount_operation_userdata;
@@ -151,6 +160,7 @@ struct _PlumaDocumentPrivate
 	gint readonly : 1;
 	gint last_save_was_manually : 1;
 	gint language_set_by_user : 1;
+	gint highlight_deferred : 1;
 	gint stop_cursor_moved_emission : 1;
 	gint dispose_has_run : 1;
 };
@@ -298,6 +308,21 @@ pluma_document_dispose (GObject *object)
 	G_OBJECT_CLASS (pluma_document_parent_class)->dispose (object);
 }
 
+static void
+pluma_document_constructed (GObject *object)
+{
+	GtkSourceBuffer *buffer = GTK_SOURCE_BUFFER (object);
+	GtkSourceUndoManager *manager;
+
+	G_OBJECT_CLASS (pluma_document_parent_class)->constructed (object);
+
+	/* lets a cancelled replace all forget its redo step,
+	 * see replace_all_end () */
+	manager = pluma_undo_manager_new (buffer);
+	gtk_source_buffer_set_undo_manager (buffer, manager);
+	g_object_unref (manager);
+}
+
 static void
 pluma_document_finalize (GObject *object)
 {
@@ -322,6 +347,16 @@ pluma_document_finalize (GObject *object)
 		pluma_text_region_destroy (doc->priv->to_search_region, FALSE);
 	}
 
+	g_strfreev (doc->priv->highlight_terms);
+	pluma_multi_matcher_free (doc->priv->highlight_matcher);
+
+	/* the tags belong to the tag table */
+	if (doc->priv->highlight_tags != NULL)
+		g_ptr_array_free (doc->priv->highlight_tags, TRUE);
+
+	if (doc->priv->to_highlight_region != NULL)
+		pluma_text_region_destroy (doc->priv->to_highlight_region, FALSE);
+
 	G_OBJECT_CLASS (pluma_document_parent_class)->finalize (object);
 }
 
@@ -453,6 +488,7 @@ pluma_document_class_init (PlumaDocumentClass *klass)
 	GObjectClass *object_class = G_OBJECT_CLASS (klass);
 	GtkTextBufferClass *buf_class = GTK_TEXT_BUFFER_CLASS (klass);
 
+	object_class->constructed = pluma_document_constructed;
 	object_class->dispose = pluma_document_dispose;
 	object_class->finalize = pluma_document_finalize;
 	object_class->get_property = pluma_document_get_property;
@@ -722,6 +758,22 @@ file_with_bom (GFile *file)
 }
 #endif
 
+static void
+update_highlight_syntax (PlumaDocument *doc)
+{
+	gboolean syntax_hl = FALSE;
+
+	if (!doc->priv->highlight_deferred &&
+	    gtk_source_buffer_get_language (GTK_SOURCE_BUFFER (doc)) != NULL)
+	{
+		syntax_hl = g_settings_get_boolean (doc->priv->editor_settings,
+						    PLUMA_SETTINGS_SYNTAX_HIGHLIGHTING);
+	}
+
+	gtk_source_buffer_set_highlight_syntax (GTK_SOURCE_BUFFER (doc),
+						syntax_hl);
+}
+
 static void
 set_language (PlumaDocument     *doc,
               GtkSourceLanguage *lang,
@@ -769,19 +821,7 @@ set_language (PlumaDocument     *doc,
 #endif
 		gtk_source_buffer_set_language (GTK_SOURCE_BUFFER (doc), lang);
 
-	if (lang != NULL)
-	{
-		gboolean syntax_hl;
-
-		syntax_hl = g_settings_get_boolean (doc->priv->editor_settings,
-						    PLUMA_SETTINGS_SYNTAX_HIGHLIGHTING);
-
-		gtk_source_buffer_set_highlight_syntax (GTK_SOURCE_BUFFER (doc),
-							syntax_hl);
-	}
-	else
-		gtk_source_buffer_set_highlight_syntax (GTK_SOURCE_BUFFER (doc),
-				 FALSE);
+	update_highlight_syntax (doc);
 
 	if (set_by_user && (doc->priv->uri != NULL))
 	{
@@ -2273,52 +2313,68 @@ pluma_document_search_backward (PlumaDocument     *doc,
 	return found;
 }
 
-/* FIXME this is an issue for introspection regardning @find */
-gint
-pluma_document_replace_all (PlumaDocument       *doc,
-			    const gchar         *find,
-			    const gchar         *replace,
-			    guint                flags)
+/* Time budget of each slice of an asynchronous replace all, in
+ * microseconds: short enough to keep the window responsive */
+#define REPLACE_ALL_SLICE_USEC 10000
+
+typedef struct
 {
-	GtkTextIter iter;
-	GtkTextIter m_start;
-	GtkTextIter m_end;
-	GtkTextSearchFlags search_flags = 0;
-	gboolean found = TRUE;
-	gint cont = 0;
-	gchar *search_text;
-	gchar *replace_text = NULL;
-	gint replace_text_len = 0;
-	GtkTextBuffer *buffer;
-	gboolean brackets_highlighting;
-	gboolean search_highliting;
+	gchar              *search_text;
+	gchar              *replace;
+	gchar              *replace_text;
+	gint                replace_text_len;
+	guint               flags;
+	GtkTextSearchFlags  search_flags;
 
-	g_return_val_if_fail (PLUMA_IS_DOCUMENT (doc), 0);
-	g_return_val_if_fail (replace != NULL, 0);
-	g_return_val_if_fail ((find != NULL) || (doc->priv->search_text != NULL), 0);
+	/* where the next slice resumes the search */
+	GtkTextMark        *resume_mark;
+
+	gint                count;
+
+	gboolean            brackets_highlighting;
+	gboolean            search_highlighting;
+
+	PlumaDocumentReplaceAllProgress progress_callback;
+	gpointer            progress_user_data;
+} ReplaceAllData;
+
+static ReplaceAllData *
+replace_all_begin (PlumaDocument *doc,
+		   const gchar   *find,
+		   const gchar   *replace,
+		   guint          flags)
+{
+	ReplaceAllData *data;
+	GtkTextBuffer *buffer;
+	GtkTextIter iter;
 
 	buffer = GTK_TEXT_BUFFER (doc);
 
+	data = g_slice_new0 (ReplaceAllData);
+
 	if (find == NULL)
-		search_text = g_strdup (doc->priv->search_text);
+		data->search_text = g_strdup (doc->priv->search_text);
 	else
-		search_text = pluma_utils_unescape_search_text (find);
+		data->search_text = pluma_utils_unescape_search_text (find);
+
+	data->replace = g_strdup (replace);
+	data->flags = flags;
 
 	if(!PLUMA_SEARCH_IS_MATCH_REGEX(flags))
 	{
-		replace_text = pluma_utils_unescape_search_text (replace);
-		replace_text_len = strlen (replace_text);
+		data->replace_text = pluma_utils_unescape_search_text (replace);
+		data->replace_text_len = strlen (data->replace_text);
 	}
 
-	gtk_text_buffer_get_start_iter (buffer, &iter);
-
-	search_flags = GTK_TEXT_SEARCH_VISIBLE_ONLY | GTK_TEXT_SEARCH_TEXT_ONLY;
+	data->search_flags = GTK_TEXT_SEARCH_VISIBLE_ONLY | GTK_TEXT_SEARCH_TEXT_ONLY;
 
 	if (!PLUMA_SEARCH_IS_CASE_SENSITIVE (flags))
 	{
-		search_flags = search_flags | GTK_TEXT_SEARCH_CASE_INSENSITIVE;
+		data->search_flags = data->search_flags | GTK_TEXT_SEARCH_CASE_INSENSITIVE;
 	}
 
+	gtk_text_buffer_get_start_iter (buffer, &iter);
+	data->resume_mark = gtk_text_buffer_create_mark (buffer, NULL, &iter, FALSE);
 
 	/* disable cursor_moved emission until the end of the
 	 * replace_all so that we don't spend all the time
@@ -2327,40 +2383,63 @@ pluma_document_replace_all (PlumaDocument       *doc,
 	doc->priv->stop_cursor_moved_emission = TRUE;
 
 	/* also avoid spending time matching brackets */
-	brackets_highlighting = gtk_source_buffer_get_highlight_matching_brackets (GTK_SOURCE_BUFFER (buffer));
+	data->brackets_highlighting = gtk_source_buffer_get_highlight_matching_brackets (GTK_SOURCE_BUFFER (buffer));
 	gtk_source_buffer_set_highlight_matching_brackets (GTK_SOURCE_BUFFER (buffer), FALSE);
 
 	/* and do search highliting later */
-	search_highliting = pluma_document_get_enable_search_highlighting (doc);
+	data->search_highlighting = pluma_document_get_enable_search_highlighting (doc);
 	pluma_document_set_enable_search_highlighting (doc, FALSE);
 
+	/* the whole replace all is a single undoable action, even
+	 * when it is split in several slices */
 	gtk_text_buffer_begin_user_action (buffer);
 
+	return data;
+}
+
+/* Replaces the matches following the resume mark until either the end of
+ * the document or the @deadline (a monotonic time, -1 for none) is reached.
+ * Returns TRUE if there may be more matches to replace. */
+static gboolean
+replace_all_step (PlumaDocument  *doc,
+		  ReplaceAllData *data,
+		  gint64          deadline)
+{
+	GtkTextBuffer *buffer;
+	GtkTextIter iter;
+	GtkTextIter m_start;
+	GtkTextIter m_end;
+	gboolean found;
+
+	buffer = GTK_TEXT_BUFFER (doc);
+
+	gtk_text_buffer_get_iter_at_mark (buffer, &iter, data->resume_mark);
+
 	do
 	{
-		if(!PLUMA_SEARCH_IS_MATCH_REGEX(flags))
+		if(!PLUMA_SEARCH_IS_MATCH_REGEX(data->flags))
 		{
 			found = gtk_text_iter_forward_search (&iter,
-							      search_text,
-							      search_flags,
+							      data->search_text,
+							      data->search_flags,
 							      &m_start,
 							      &m_end,
 							      NULL);
 		} else {
-			g_free (replace_text);
-			replace_text = g_strdup (replace);
+			g_free (data->replace_text);
+			data->replace_text = g_strdup (data->replace);
 			found = pluma_gtk_text_iter_regex_search (&iter,
-							          search_text,
-							          search_flags,
+							          data->search_text,
+							          data->search_flags,
 							          &m_start,
 							          &m_end,
 							          NULL,
 							          TRUE,
-							          &replace_text);
-			replace_text_len = strlen (replace_text);
+							          &data->replace_text);
+			data->replace_text_len = strlen (data->replace_text);
 		}
 
-		if (found && PLUMA_SEARCH_IS_ENTIRE_WORD (flags))
+		if (found && PLUMA_SEARCH_IS_ENTIRE_WORD (data->flags))
 		{
 			gboolean word;
 
@@ -2376,23 +2455,57 @@ pluma_document_replace_all (PlumaDocument       *doc,
 
 		if (found)
 		{
-			++cont;
+			++data->count;
 
 			gtk_text_buffer_delete (buffer,
 						&m_start,
 						&m_end);
 			gtk_text_buffer_insert (buffer,
 						&m_start,
-						replace_text,
-						replace_text_len);
+						data->replace_text,
+						data->replace_text_len);
 
 			iter = m_start;
-        }
+		}
 
-	} while (found);
+	} while (found &&
+		 (deadline < 0 || g_get_monotonic_time () < deadline));
+
+	gtk_text_buffer_move_mark (buffer, data->resume_mark, &iter);
+
+	return found;
+}
+
+static void
+replace_all_end (PlumaDocument  *doc,
+		 ReplaceAllData *data,
+		 gboolean        rollback)
+{
+	GtkTextBuffer *buffer;
+
+	buffer = GTK_TEXT_BUFFER (doc);
 
 	gtk_text_buffer_end_user_action (buffer);
 
+	/* the replacements done so far are a single user action:
+	 * undoing it leaves the document and its undo history as they
+	 * were before, once the redo step bringing them back is gone */
+	if (rollback &&
+	    data->count > 0 &&
+	    gtk_source_buffer_can_undo (GTK_SOURCE_BUFFER (doc)))
+	{
+		GtkSourceUndoManager *manager;
+
+		gtk_source_buffer_undo (GTK_SOURCE_BUFFER (doc));
+
+		manager = gtk_source_buffer_get_undo_manager (GTK_SOURCE_BUFFER (doc));
+
+		if (PLUMA_IS_UNDO_MANAGER (manager))
+			pluma_undo_manager_forget_redo (PLUMA_UNDO_MANAGER (manager));
+	}
+
+	gtk_text_buffer_delete_mark (buffer, data->resume_mark);
+
 	/* re-enable cursor_moved emission and notify
 	 * the current position
 	 */
@@ -2400,15 +2513,190 @@ pluma_document_replace_all (PlumaDocument       *doc,
 	emit_cursor_moved (doc);
 
 	gtk_source_buffer_set_highlight_matching_brackets (GTK_SOURCE_BUFFER (buffer),
-							   brackets_highlighting);
-	pluma_document_set_enable_search_highlighting (doc, search_highliting);
+							   data->brackets_highlighting);
+	pluma_document_set_enable_search_highlighting (doc, data->search_highlighting);
+}
+
+static void
+replace_all_data_free (ReplaceAllData *data)
+{
+	g_free (data->search_text);
+	g_free (data->replace);
+	g_free (data->replace_text);
+
+	g_slice_free (ReplaceAllData, data);
+}
+
+/* FIXME this is an issue for introspection regardning @find */
+gint
+pluma_document_replace_all (PlumaDocument       *doc,
+			    const gchar         *find,
+			    const gchar         *replace,
+			    guint                flags)
+{
+	ReplaceAllData *data;
+	gint cont;
+
+	g_return_val_if_fail (PLUMA_IS_DOCUMENT (doc), 0);
+	g_return_val_if_fail (replace != NULL, 0);
+	g_return_val_if_fail ((find != NULL) || (doc->priv->search_text != NULL), 0);
+
+	data = replace_all_begin (doc, find, replace, flags);
+
+	replace_all_step (doc, data, -1);
+
+	replace_all_end (doc, data, FALSE);
 
-	g_free (search_text);
-	g_free (replace_text);
+	cont = data->count;
+	replace_all_data_free (data);
 
 	return cont;
 }
 
+static gboolean
+replace_all_idle (GTask *task)
+{
+	PlumaDocument *doc;
+	ReplaceAllData *data;
+	gboolean more;
+
+	doc = PLUMA_DOCUMENT (g_task_get_source_object (task));
+	data = g_task_get_task_data (task);
+
+	if (g_cancellable_is_cancelled (g_task_get_cancellable (task)))
+	{
+		replace_all_end (doc, data, TRUE);
+
+		g_task_return_new_error (task,
+					 G_IO_ERROR,
+					 G_IO_ERROR_CANCELLED,
+					 "%s",
+					 _("Operation was cancelled"));
+		g_object_unref (task);
+
+		return FALSE;
+	}
+
+	more = replace_all_step (doc, data,
+				 g_get_monotonic_time () + REPLACE_ALL_SLICE_USEC);
+
+	if (more)
+	{
+		if (data->progress_callback != NULL)
+		{
+			GtkTextIter iter;
+			gint total;
+
+			gtk_text_buffer_get_iter_at_mark (GTK_TEXT_BUFFER (doc),
+							  &iter,
+							  data->resume_mark);
+			total = gtk_text_buffer_get_char_count (GTK_TEXT_BUFFER (doc));
+
+			data->progress_callback (data->count,
+						 total > 0 ?
+						 (gdouble) gtk_text_iter_get_offset (&iter) / total : 1.0,
+						 data->progress_user_data);
+		}
+
+		return TRUE;
+	}
+
+	replace_all_end (doc, data, FALSE);
+
+	g_task_return_int (task, data->count);
+	g_object_unref (task);
+
+	return FALSE;
+}
+
+/**
+ * pluma_document_replace_all_async:
+ * @doc: a #PlumaDocument
+ * @find: (allow-none): the text to search, or %NULL for the current search text
+ * @replace: the replacement text
+ * @flags: the #PlumaSearchFlags
+ * @cancellable: (allow-none): a #GCancellable
+ * @progress_callback: (allow-none) (scope call): called after each slice
+ * @progress_user_data: data for @progress_callback
+ * @callback: called when the replacement is over
+ * @user_data: data for @callback
+ *
+ * Like pluma_document_replace_all(), but the document is processed in
+ * short slices from the main loop so that the user interface stays
+ * responsive on large files. Cancelling @cancellable reverts the
+ * replacements done so far, the earlier undo history is kept.
+ *
+ * Reverting relies on the undo history: when @doc keeps none (its
+ * #GtkSourceBuffer:max-undo-levels is 0) the operation fails with
+ * %G_IO_ERROR_NOT_SUPPORTED without changing the document, and
+ * pluma_document_replace_all() should be used instead.
+ **/
+void
+pluma_document_replace_all_async (PlumaDocument                   *doc,
+				  const gchar                     *find,
+				  const gchar                     *replace,
+				  guint                            flags,
+				  GCancellable                    *cancellable,
+				  PlumaDocumentReplaceAllProgress  progress_callback,
+				  gpointer                         progress_user_data,
+				  GAsyncReadyCallback              callback,
+				  gpointer                         user_data)
+{
+	GTask *task;
+	ReplaceAllData *data;
+
+	g_return_if_fail (PLUMA_IS_DOCUMENT (doc));
+	g_return_if_fail (replace != NULL);
+	g_return_if_fail ((find != NULL) || (doc->priv->search_text != NULL));
+
+	task = g_task_new (doc, cancellable, callback, user_data);
+
+	if (gtk_source_buffer_get_max_undo_levels (GTK_SOURCE_BUFFER (doc)) == 0)
+	{
+		g_task_return_new_error (task,
+					 G_IO_ERROR,
+					 G_IO_ERROR_NOT_SUPPORTED,
+					 "%s",
+					 _("Cannot revert the replacements without an undo history"));
+		g_object_unref (task);
+
+		return;
+	}
+
+	data = replace_all_begin (doc, find, replace, flags);
+	data->progress_callback = progress_callback;
+	data->progress_user_data = progress_user_data;
+
+	g_task_set_task_data (task,
+			      data,
+			      (GDestroyNotify) replace_all_data_free);
+
+	/* run below the redraw priority so that the view keeps painting */
+	g_idle_add_full (G_PRIORITY_DEFAULT_IDLE,
+			 (GSourceFunc) replace_all_idle,
+			 task,
+			 NULL);
+}
+
+/**
+ * pluma_document_replace_all_finish:
+ * @doc: a #PlumaDocument
+ * @result: the #GAsyncResult passed to the callback
+ * @error: return location for a #GError, or %NULL
+ *
+ * Returns: the number of replaced occurrences, or -1 on error
+ * (for instance when the operation was cancelled).
+ **/
+gint
+pluma_document_replace_all_finish (PlumaDocument  *doc,
+				   GAsyncResult   *result,
+				   GError        **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, doc), -1);
+
+	return g_task_propagate_int (G_TASK (result), error);
+}
+
 /**
  * pluma_document_set_language:
  * @doc:
@@ -2445,6 +2733,31 @@ pluma_document_get_encoding (PlumaDocument *doc)
 	return doc->priv->encoding;
 }
 
+/* The highlighting engine works on the whole buffer in the background,
+ * documents that are not shown yet can do without it. */
+void
+_pluma_document_set_highlight_deferred (PlumaDocument *doc,
+					gboolean       deferred)
+{
+	g_return_if_fail (PLUMA_IS_DOCUMENT (doc));
+
+	deferred = (deferred != FALSE);
+
+	if (doc->priv->highlight_deferred == deferred)
+		return;
+
+	doc->priv->highlight_deferred = deferred;
+	update_highlight_syntax (doc);
+}
+
+gboolean
+_pluma_document_get_highlight_deferred (PlumaDocument *doc)
+{
+	g_return_val_if_fail (PLUMA_IS_DOCUMENT (doc), FALSE);
+
+	return doc->priv->highlight_deferred;
+}
+
 glong
 _pluma_document_get_seconds_since_last_save_or_load (PlumaDocument *doc)
 {
@@ -2695,6 +3008,32 @@ to_search_region_range (PlumaDocument *doc,
 	g_signal_emit (doc, document_signals [SEARCH_HIGHLIGHT_UPDATED], 0, start, end);
 }
 
+static void
+to_highlight_region_range (PlumaDocument     *doc,
+			   const GtkTextIter *start,
+			   const GtkTextIter *end)
+{
+	GtkTextIter line_start;
+	GtkTextIter line_end;
+
+	if (doc->priv->to_highlight_region == NULL)
+		return;
+
+	/* terms never span lines, rescanning the whole lines is enough */
+	line_start = *start;
+	line_end = *end;
+
+	gtk_text_iter_set_line_offset (&line_start, 0);
+	if (!gtk_text_iter_ends_line (&line_end))
+		gtk_text_iter_forward_to_line_end (&line_end);
+
+	pluma_text_region_add (doc->priv->to_highlight_region,
+			       &line_start,
+			       &line_end);
+
+	g_signal_emit (doc, document_signals [SEARCH_HIGHLIGHT_UPDATED], 0, &line_start, &line_end);
+}
+
 void
 _pluma_document_search_region (PlumaDocument     *doc,
 			       const GtkTextIter *start,
@@ -2772,6 +3111,7 @@ insert_text_cb (PlumaDocument *doc,
 	gtk_text_iter_backward_chars (&start,
 				      g_utf8_strlen (text, length));
 
+	to_highlight_region_range (doc, &start, &end);
 	to_search_region_range (doc, &start, &end);
 }
 
@@ -2788,6 +3128,7 @@ delete_range_cb (PlumaDocument *doc,
 	d_start = *start;
 	d_end = *end;
 
+	to_highlight_region_range (doc, &d_start, &d_end);
 	to_search_region_range (doc, &d_start, &d_end);
 }
 
@@ -2853,6 +3194,298 @@ pluma_document_get_enable_search_highlighting (PlumaDocument *doc)
 	return (doc->priv->to_search_region != NULL);
 }
 
+typedef struct
+{
+	PlumaDocument *doc;
+	const gchar   *text;
+
+	/* matches are reported by increasing end offset, so the iter
+	 * at the end of the previous match only ever moves forward */
+	GtkTextIter    iter;
+	gsize          offset;
+} HighlightScan;
+
+static void
+highlight_match_cb (guint    term,
+		    gsize    offset,
+		    gsize    length,
+		    gpointer user_data)
+{
+	HighlightScan *scan = user_data;
+	GtkTextIter m_start;
+	GtkTextIter m_end;
+
+	gtk_text_iter_forward_chars (&scan->iter,
+				     g_utf8_pointer_to_offset (scan->text + scan->offset,
+							       scan->text + offset + length));
+	scan->offset = offset + length;
+
+	m_start = m_end = scan->iter;
+	gtk_text_iter_backward_chars (&m_start,
+				      g_utf8_pointer_to_offset (scan->text + offset,
+								scan->text + offset + length));
+
+	if (PLUMA_SEARCH_IS_ENTIRE_WORD (scan->doc->priv->highlight_flags) &&
+	    !(gtk_text_iter_starts_word (&m_start) && gtk_text_iter_ends_word (&m_end)))
+		return;
+
+	gtk_text_buffer_apply_tag (GTK_TEXT_BUFFER (scan->doc),
+				   g_ptr_array_index (scan->doc->priv->highlight_tags, term),
+				   &m_start,
+				   &m_end);
+}
+
+static void
+highlight_region (PlumaDocument *doc,
+		  GtkTextIter   *start,
+		  GtkTextIter   *end)
+{
+	GtkTextBuffer *buffer;
+	HighlightScan scan;
+	gchar *text;
+	guint i;
+
+	pluma_debug (DEBUG_DOCUMENT);
+
+	buffer = GTK_TEXT_BUFFER (doc);
+
+	/* keep the terms over syntax highlighting, the first term on top */
+	for (i = doc->priv->highlight_tags->len; i > 0; --i)
+	{
+		text_tag_set_highest_priority (g_ptr_array_index (doc->priv->highlight_tags, i - 1),
+					       buffer);
+	}
+
+	/* but under the search matches */
+	if (doc->priv->found_tag != NULL)
+		text_tag_set_highest_priority (doc->priv->found_tag, buffer);
+
+	for (i = 0; i < doc->priv->highlight_tags->len; ++i)
+	{
+		gtk_text_buffer_remove_tag (buffer,
+					    g_ptr_array_index (doc->priv->highlight_tags, i),
+					    start,
+					    end);
+	}
+
+	/* the slice has a character for each one of the buffer, so
+	 * the byte offsets of the matches map back to iters */
+	text = gtk_text_buffer_get_slice (buffer, start, end, TRUE);
+
+	scan.doc = doc;
+	scan.text = text;
+	scan.iter = *start;
+	scan.offset = 0;
+
+	/* a single pass finds all the terms */
+	pluma_multi_matcher_scan (doc->priv->highlight_matcher,
+				  text,
+				  -1,
+				  highlight_match_cb,
+				  &scan);
+
+	g_free (text);
+}
+
+void
+_pluma_document_highlight_region (PlumaDocument     *doc,
+				  const GtkTextIter *start,
+				  const GtkTextIter *end)
+{
+	PlumaTextRegion *region;
+	GtkTextIter start_scan;
+	GtkTextIter end_scan;
+	gint i;
+
+	pluma_debug (DEBUG_DOCUMENT);
+
+	g_return_if_fail (PLUMA_IS_DOCUMENT (doc));
+	g_return_if_fail (start != NULL);
+	g_return_if_fail (end != NULL);
+
+	if (doc->priv->to_highlight_region == NULL)
+		return;
+
+	/* get the subregions not yet highlighted */
+	region = pluma_text_region_intersect (doc->priv->to_highlight_region,
+					      start,
+					      end);
+	if (region == NULL)
+		return;
+
+	i = pluma_text_region_subregions (region);
+	pluma_text_region_nth_subregion (region, 0, &start_scan, NULL);
+	pluma_text_region_nth_subregion (region, i - 1, NULL, &end_scan);
+
+	pluma_text_region_destroy (region, TRUE);
+
+	gtk_text_iter_order (&start_scan, &end_scan);
+
+	/* edits can leave pieces of lines in the region */
+	gtk_text_iter_set_line_offset (&start_scan, 0);
+	if (!gtk_text_iter_ends_line (&end_scan))
+		gtk_text_iter_forward_to_line_end (&end_scan);
+
+	highlight_region (doc, &start_scan, &end_scan);
+
+	/* remove the just highlighted region */
+	pluma_text_region_subtract (doc->priv->to_highlight_region,
+				    start,
+				    end);
+}
+
+gboolean
+_pluma_document_get_has_highlight_terms (PlumaDocument *doc)
+{
+	g_return_val_if_fail (PLUMA_IS_DOCUMENT (doc), FALSE);
+
+	return (doc->priv->to_highlight_region != NULL);
+}
+
+static void
+get_highlight_term_colors (guint    n,
+			   GdkRGBA *fg,
+			   GdkRGBA *bg)
+{
+	gdouble hue;
+
+	/* the golden ratio spreads the hues of consecutive terms */
+	hue = n * 0.618033988749895;
+	hue -= (gint) hue;
+
+	gtk_hsv_to_rgb (hue, 0.4, 1.0, &bg->red, &bg->green, &bg->blue);
+	bg->alpha = 1.0;
+
+	/* the backgrounds are light whatever the style scheme */
+	fg->red = fg->green = fg->blue = 0.0;
+	fg->alpha = 1.0;
+}
+
+static void
+clear_highlight_terms (PlumaDocument *doc)
+{
+	if (doc->priv->highlight_tags != NULL)
+	{
+		GtkTextTagTable *table;
+		guint i;
+
+		table = gtk_text_buffer_get_tag_table (GTK_TEXT_BUFFER (doc));
+
+		/* this also removes the tags from the text */
+		for (i = 0; i < doc->priv->highlight_tags->len; ++i)
+		{
+			gtk_text_tag_table_remove (table,
+						   g_ptr_array_index (doc->priv->highlight_tags, i));
+		}
+
+		g_ptr_array_free (doc->priv->highlight_tags, TRUE);
+		doc->priv->highlight_tags = NULL;
+	}
+
+	if (doc->priv->to_highlight_region != NULL)
+	{
+		pluma_text_region_destroy (doc->priv->to_highlight_region, TRUE);
+		doc->priv->to_highlight_region = NULL;
+	}
+
+	pluma_multi_matcher_free (doc->priv->highlight_matcher);
+	doc->priv->highlight_matcher = NULL;
+
+	g_strfreev (doc->priv->highlight_terms);
+	doc->priv->highlight_terms = NULL;
+}
+
+/**
+ * pluma_document_set_highlight_terms:
+ * @doc: a #PlumaDocument
+ * @terms: (allow-none) (array zero-terminated=1): the terms to highlight
+ * @flags: #PLUMA_SEARCH_CASE_SENSITIVE and #PLUMA_SEARCH_ENTIRE_WORD
+ *
+ * Highlights all the occurrences of each one of @terms, each term in its
+ * own color, independently of the search text. The terms are matched
+ * inside a line, terms with a line break never match. Passing %NULL or an
+ * empty array removes the highlighting.
+ **/
+void
+pluma_document_set_highlight_terms (PlumaDocument       *doc,
+				    const gchar * const *terms,
+				    guint                flags)
+{
+	const gchar **line_terms;
+	GtkTextIter begin;
+	GtkTextIter end;
+	guint n;
+	guint i;
+
+	g_return_if_fail (PLUMA_IS_DOCUMENT (doc));
+
+	pluma_debug (DEBUG_DOCUMENT);
+
+	for (i = 0; terms != NULL && terms[i] != NULL; ++i)
+		g_return_if_fail (g_utf8_validate (terms[i], -1, NULL));
+
+	clear_highlight_terms (doc);
+
+	if (terms == NULL || terms[0] == NULL)
+		return;
+
+	n = g_strv_length ((gchar **) terms);
+
+	doc->priv->highlight_terms = g_strdupv ((gchar **) terms);
+	doc->priv->highlight_flags = flags;
+	doc->priv->highlight_tags = g_ptr_array_sized_new (n);
+
+	line_terms = g_new0 (const gchar *, n + 1);
+
+	for (i = 0; i < n; ++i)
+	{
+		GtkTextTag *tag;
+		GdkRGBA fg;
+		GdkRGBA bg;
+
+		line_terms[i] = strpbrk (terms[i], "\r\n") == NULL ? terms[i] : "";
+
+		get_highlight_term_colors (i, &fg, &bg);
+		tag = gtk_text_buffer_create_tag (GTK_TEXT_BUFFER (doc),
+						  NULL,
+						  "foreground-rgba", &fg,
+						  "background-rgba", &bg,
+						  NULL);
+
+		g_ptr_array_add (doc->priv->highlight_tags, tag);
+	}
+
+	doc->priv->highlight_matcher =
+		pluma_multi_matcher_new (line_terms,
+					 PLUMA_SEARCH_IS_CASE_SENSITIVE (flags));
+	g_free (line_terms);
+
+	doc->priv->to_highlight_region = pluma_text_region_new (GTK_TEXT_BUFFER (doc));
+
+	gtk_text_buffer_get_bounds (GTK_TEXT_BUFFER (doc), &begin, &end);
+	to_highlight_region_range (doc, &begin, &end);
+}
+
+/**
+ * pluma_document_get_highlight_terms:
+ * @doc: a #PlumaDocument
+ * @flags: (allow-none) (out): return location for the flags
+ *
+ * Returns: (transfer full) (array zero-terminated=1): the highlighted
+ * terms, or %NULL if there are none.
+ **/
+gchar **
+pluma_document_get_highlight_terms (PlumaDocument *doc,
+				    guint         *flags)
+{
+	g_return_val_if_fail (PLUMA_IS_DOCUMENT (doc), NULL);
+
+	if (flags != NULL)
+		*flags = doc->priv->highlight_flags;
+
+	return g_strdupv (doc->priv->highlight_terms);
+}
+
 void
 pluma_document_set_newline_type (PlumaDocument           *doc,
 				 PlumaDocumentNewlineType newline_type)
@@ -264,6 +264,26 @@ gint		 pluma_document_replace_all 	(PlumaDocument       *doc,
 						 const gchar         *replace,
 					    	 guint                flags);
 
+typedef void (*PlumaDocumentReplaceAllProgress) (gint     count,
+						 gdouble  fraction,
+						 gpointer user_data);
+
+void		 pluma_document_replace_all_async
+						(PlumaDocument                   *doc,
+						 const gchar                     *find,
+						 const gchar                     *replace,
+						 guint                            flags,
+						 GCancellable                    *cancellable,
+						 PlumaDocumentReplaceAllProgress  progress_callback,
+						 gpointer                         progress_user_data,
+						 GAsyncReadyCallback              callback,
+						 gpointer                         user_data);
+
+gint		 pluma_document_replace_all_finish
+						(PlumaDocument       *doc,
+						 GAsyncResult        *result,
+						 GError             **error);
+
 void 		 pluma_document_set_language 	(PlumaDocument       *doc,
 						 GtkSourceLanguage   *lang);
 GtkSourceLanguage
@@ -279,6 +299,15 @@ void		 pluma_document_set_enable_search_highlighting
 gboolean	 pluma_document_get_enable_search_highlighting
 						(PlumaDocument       *doc);
 
+void		 pluma_document_set_highlight_terms
+						(PlumaDocument       *doc,
+						 const gchar * const *terms,
+						 guint                flags);
+
+gchar		**pluma_document_get_highlight_terms
+						(PlumaDocument       *doc,
+						 guint               *flags);
+
 void		 pluma_document_set_newline_type (PlumaDocument           *doc,
 						  PlumaDocumentNewlineType newline_type);
 
@@ -301,6 +330,12 @@ void		 _pluma_document_set_readonly 	(PlumaDocument       *doc,
 glong		 _pluma_document_get_seconds_since_last_save_or_load
 						(PlumaDocument       *doc);
 
+void		 _pluma_document_set_highlight_deferred
+						(PlumaDocument       *doc,
+						 gboolean             deferred);
+gboolean	 _pluma_document_get_highlight_deferred
+						(PlumaDocument       *doc);
+
 /* Note: this is a sync stat: use only on local files */
 gboolean	_pluma_document_check_externally_modified
 						(PlumaDocument       *doc);
@@ -309,6 +344,13 @@ void		_pluma_document_search_region   (PlumaDocument       *doc,
 						 const GtkTextIter   *start,
 						 const GtkTextIter   *end);
 
+void		_pluma_document_highlight_region
+						(PlumaDocument       *doc,
+						 const GtkTextIter   *start,
+						 const GtkTextIter   *end);
+gboolean	_pluma_document_get_has_highlight_terms
+						(PlumaDocument       *doc);
+
 /* Search macros */
 #define PLUMA_SEARCH_IS_DONT_SET_FLAGS(sflags) ((sflags & PLUMA_SEARCH_DONT_SET_FLAGS) != 0)
 #define PLUMA_SEARCH_SET_DONT_SET_FLAGS(sflags,state) ((state == TRUE) ? \
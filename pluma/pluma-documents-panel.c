@@ -162,6 +162,32 @@ window_active_tab_changed (PlumaWindow         *window,
 	}
 }
 
+static void
+set_row (PlumaDocumentsPanel *panel,
+	 GtkTreeIter         *iter,
+	 PlumaTab            *tab)
+{
+	GdkPixbuf *pixbuf;
+	gchar *name;
+
+	name = tab_get_name (tab);
+	pixbuf = _pluma_tab_get_icon (tab);
+
+	gtk_list_store_set (GTK_LIST_STORE (panel->priv->model),
+			    iter,
+			    PIXBUF_COLUMN, pixbuf,
+			    NAME_COLUMN, name,
+			    TAB_COLUMN, tab,
+			    -1);
+
+	g_free (name);
+	if (pixbuf != NULL)
+		g_object_unref (pixbuf);
+}
+
+/* Brings the list in sync with the notebook: the rows of closed tabs are
+ * removed, then the remaining rows are moved where needed and the rows of
+ * new tabs inserted, leaving the rows already in place untouched. */
 static void
 refresh_list (PlumaDocumentsPanel *panel)
 {
@@ -171,44 +197,78 @@ refresh_list (PlumaDocumentsPanel *panel)
 	GList *l;
 	GtkWidget *nb;
 	GtkListStore *list_store;
+	GtkTreeIter iter;
+	GHashTable *open_tabs;
 	PlumaTab *active_tab;
+	gboolean valid;
 
 	/* g_debug ("refresh_list"); */
 
 	list_store = GTK_LIST_STORE (panel->priv->model);
 
-	gtk_list_store_clear (list_store);
-
 	active_tab = pluma_window_get_active_tab (panel->priv->window);
 
 	nb = _pluma_window_get_notebook (panel->priv->window);
 
 	tabs = gtk_container_get_children (GTK_CONTAINER (nb));
-	l = tabs;
+
+	open_tabs = g_hash_table_new (NULL, NULL);
+	for (l = tabs; l != NULL; l = g_list_next (l))
+		g_hash_table_add (open_tabs, l->data);
 
 	panel->priv->adding_tab = TRUE;
 
-	while (l != NULL)
+	valid = gtk_tree_model_get_iter_first (panel->priv->model, &iter);
+	while (valid)
 	{
-		GdkPixbuf *pixbuf;
-		gchar *name;
-		GtkTreeIter iter;
+		gpointer tab;
 
-		name = tab_get_name (PLUMA_TAB (l->data));
-		pixbuf = _pluma_tab_get_icon (PLUMA_TAB (l->data));
+		gtk_tree_model_get (panel->priv->model, &iter, TAB_COLUMN, &tab, -1);
 
-		/* Add a new row to the model */
-		gtk_list_store_append (list_store, &iter);
-		gtk_list_store_set (list_store,
-				    &iter,
-				    PIXBUF_COLUMN, pixbuf,
-				    NAME_COLUMN, name,
-				    TAB_COLUMN, l->data,
-				    -1);
+		if (g_hash_table_contains (open_tabs, tab))
+			valid = gtk_tree_model_iter_next (panel->priv->model, &iter);
+		else
+			valid = gtk_list_store_remove (list_store, &iter);
+	}
+
+	valid = gtk_tree_model_get_iter_first (panel->priv->model, &iter);
+
+	for (l = tabs; l != NULL; l = g_list_next (l))
+	{
+		gpointer tab = NULL;
+
+		if (valid)
+			gtk_tree_model_get (panel->priv->model, &iter, TAB_COLUMN, &tab, -1);
+
+		if (tab != l->data)
+		{
+			GtkTreeIter row;
+			gboolean found = FALSE;
 
-		g_free (name);
-		if (pixbuf != NULL)
-			g_object_unref (pixbuf);
+			/* look for the row of the tab further down */
+			if (valid)
+			{
+				row = iter;
+
+				while (!found && gtk_tree_model_iter_next (panel->priv->model, &row))
+				{
+					gtk_tree_model_get (panel->priv->model, &row, TAB_COLUMN, &tab, -1);
+					found = (tab == l->data);
+				}
+			}
+
+			if (found)
+			{
+				gtk_list_store_move_before (list_store, &row, valid ? &iter : NULL);
+			}
+			else
+			{
+				gtk_list_store_insert_before (list_store, &row, valid ? &iter : NULL);
+				set_row (panel, &row, PLUMA_TAB (l->data));
+			}
+
+			iter = row;
+		}
 
 		if (l->data == active_tab)
 		{
@@ -220,11 +280,12 @@ refresh_list (PlumaDocumentsPanel *panel)
 			gtk_tree_selection_select_iter (selection, &iter);
 		}
 
-		l = g_list_next (l);
+		valid = gtk_tree_model_iter_next (panel->priv->model, &iter);
 	}
 
 	panel->priv->adding_tab = FALSE;
 
+	g_hash_table_destroy (open_tabs);
 	g_list_free (tabs);
 }
 
@@ -233,25 +294,11 @@ sync_name_and_icon (PlumaTab            *tab,
 		    GParamSpec          *pspec,
 		    PlumaDocumentsPanel *panel)
 {
-	GdkPixbuf *pixbuf;
-	gchar *name;
 	GtkTreeIter iter;
 
 	get_iter_from_tab (panel, tab, &iter);
 
-	name = tab_get_name (tab);
-	pixbuf = _pluma_tab_get_icon (tab);
-
-	gtk_list_store_set (GTK_LIST_STORE (panel->priv->model),
-			    &iter,
-			    PIXBUF_COLUMN, pixbuf,
-			    NAME_COLUMN, name,
-			    TAB_COLUMN, tab,
-			    -1);
-
-	g_free (name);
-	if (pixbuf != NULL)
-		g_object_unref (pixbuf);
+	set_row (panel, &iter, tab);
 }
 
 static void
@@ -0,0 +1,1172 @@
+/*
+ * pluma-file-index.c
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+#include <glib/gstdio.h>
+
+#include "pluma-file-index.h"
+#include "pluma-dirs.h"
+#include "pluma-debug.h"
+#include "pluma-fuzzy-matcher.h"
+
+/**
+ * SECTION:pluma-file-index
+ * @short_description: recursive index of the files below a directory
+ * @include: pluma/pluma-file-index.h
+ *
+ * A #PlumaFileIndex keeps the relative paths of all the files and
+ * directories below a root directory. The tree is scanned asynchronously
+ * in the background and kept up to date with a #GFileMonitor for each
+ * directory. The index is saved to the user cache directory so that it can
+ * be used immediately in the next session, while it is being rescanned.
+ *
+ * There is only one index per root, see pluma_file_index_get_for_root().
+ * It is shared by all its users and freed with its monitors when the last
+ * of them releases it.
+ * Directories are stored with a trailing '/'. Hidden files and directories
+ * as well as backup files are not indexed.
+ */
+
+#define CACHE_MAGIC		"pluma-file-index 1"
+#define FILES_PER_CALLBACK	200
+#define MAX_FILES		500000
+#define MAX_MONITORS		4096
+#define SAVE_TIMEOUT		5 /* seconds */
+
+#define INDEX_ATTRIBUTES	G_FILE_ATTRIBUTE_STANDARD_NAME "," \
+				G_FILE_ATTRIBUTE_STANDARD_TYPE "," \
+				G_FILE_ATTRIBUTE_STANDARD_IS_HIDDEN "," \
+				G_FILE_ATTRIBUTE_STANDARD_IS_BACKUP
+
+typedef struct
+{
+	gchar *path;	/* relative to the root, '/' separated */
+	guint64 char_mask;
+	guint generation;
+} Entry;
+
+typedef struct
+{
+	Entry *entry;
+	gint score;
+} Match;
+
+typedef struct
+{
+	PlumaFileIndex *index;
+	gchar *dir;
+
+	/* the index may be gone once this is cancelled */
+	GCancellable *cancellable;
+} ScanDir;
+
+struct _PlumaFileIndexPrivate
+{
+	GFile *root;
+	gchar *cache_file;
+
+	GPtrArray *entries;
+	GHashTable *lookup;	/* path -> Entry */
+
+	GQueue *pending;	/* relative paths of directories to scan */
+	GHashTable *monitors;	/* relative path -> GFileMonitor */
+	GCancellable *cancellable;
+	gboolean scanning;
+	gboolean full_scan;	/* the first scan of the whole tree */
+	guint generation;
+
+	guint save_id;
+	gboolean dirty;
+	gboolean saving;
+};
+
+/* Signals */
+enum
+{
+	CHANGED,
+	SCAN_FINISHED,
+	LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+/* root uri -> PlumaFileIndex, the indexes are not referenced, they
+   remove themselves when disposed */
+static GHashTable *indexes = NULL;
+
+static void scan_next_dir (PlumaFileIndex *index);
+static void schedule_save (PlumaFileIndex *index);
+static GBytes *get_cache_contents (PlumaFileIndex *index);
+static void on_monitor_changed (GFileMonitor      *monitor,
+				GFile             *file,
+				GFile             *other_file,
+				GFileMonitorEvent  event_type,
+				PlumaFileIndex    *index);
+
+G_DEFINE_TYPE_WITH_PRIVATE (PlumaFileIndex, pluma_file_index, G_TYPE_OBJECT)
+
+static void
+entry_free (Entry *entry)
+{
+	g_free (entry->path);
+
+	g_slice_free (Entry, entry);
+}
+
+static void
+monitor_free (GFileMonitor *monitor)
+{
+	g_signal_handlers_disconnect_matched (monitor,
+					      G_SIGNAL_MATCH_FUNC,
+					      0, 0, NULL,
+					      on_monitor_changed,
+					      NULL);
+	g_file_monitor_cancel (monitor);
+	g_object_unref (monitor);
+}
+
+static void
+unregister_index (PlumaFileIndex *index)
+{
+	gchar *uri;
+
+	if (indexes == NULL)
+		return;
+
+	uri = g_file_get_uri (index->priv->root);
+
+	if (g_hash_table_lookup (indexes, uri) == index)
+		g_hash_table_remove (indexes, uri);
+
+	g_free (uri);
+
+	if (g_hash_table_size (indexes) == 0)
+	{
+		g_hash_table_destroy (indexes);
+		indexes = NULL;
+	}
+}
+
+/* The last user is gone, write the changes the save timeout did not get
+   to. A save in progress keeps a reference, so it cannot be running. */
+static void
+flush_cache (PlumaFileIndex *index)
+{
+	GBytes *bytes;
+	gchar *dir;
+	GError *error = NULL;
+
+	if (!index->priv->dirty || index->priv->scanning)
+		return;
+
+	bytes = get_cache_contents (index);
+	dir = g_path_get_dirname (index->priv->cache_file);
+	g_mkdir_with_parents (dir, 0755);
+
+	if (!g_file_set_contents (index->priv->cache_file,
+				  g_bytes_get_data (bytes, NULL),
+				  g_bytes_get_size (bytes),
+				  &error))
+	{
+		pluma_debug_message (DEBUG_UTILS,
+				     "Could not save file index: %s",
+				     error->message);
+
+		g_error_free (error);
+	}
+
+	index->priv->dirty = FALSE;
+
+	g_bytes_unref (bytes);
+	g_free (dir);
+}
+
+static void
+pluma_file_index_dispose (GObject *object)
+{
+	PlumaFileIndex *index = PLUMA_FILE_INDEX (object);
+
+	if (index->priv->root != NULL)
+	{
+		unregister_index (index);
+		flush_cache (index);
+	}
+
+	if (index->priv->cancellable != NULL)
+	{
+		g_cancellable_cancel (index->priv->cancellable);
+		g_clear_object (&index->priv->cancellable);
+	}
+
+	if (index->priv->save_id != 0)
+	{
+		g_source_remove (index->priv->save_id);
+		index->priv->save_id = 0;
+	}
+
+	g_hash_table_remove_all (index->priv->monitors);
+
+	G_OBJECT_CLASS (pluma_file_index_parent_class)->dispose (object);
+}
+
+static void
+pluma_file_index_finalize (GObject *object)
+{
+	PlumaFileIndex *index = PLUMA_FILE_INDEX (object);
+
+	g_clear_object (&index->priv->root);
+	g_free (index->priv->cache_file);
+
+	g_hash_table_destroy (index->priv->lookup);
+	g_hash_table_destroy (index->priv->monitors);
+	g_ptr_array_free (index->priv->entries, TRUE);
+	g_queue_free_full (index->priv->pending, g_free);
+
+	G_OBJECT_CLASS (pluma_file_index_parent_class)->finalize (object);
+}
+
+static void
+pluma_file_index_class_init (PlumaFileIndexClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->dispose = pluma_file_index_dispose;
+	object_class->finalize = pluma_file_index_finalize;
+
+	/**
+	 * PlumaFileIndex::changed:
+	 * @index: a #PlumaFileIndex
+	 *
+	 * The "changed" signal is emitted when files were added to or removed
+	 * from the index.
+	 */
+	signals[CHANGED] =
+		g_signal_new ("changed",
+			      G_OBJECT_CLASS_TYPE (object_class),
+			      G_SIGNAL_RUN_LAST,
+			      G_STRUCT_OFFSET (PlumaFileIndexClass, changed),
+			      NULL, NULL, NULL,
+			      G_TYPE_NONE, 0);
+
+	/**
+	 * PlumaFileIndex::scan-finished:
+	 * @index: a #PlumaFileIndex
+	 *
+	 * The "scan-finished" signal is emitted once, when the complete tree
+	 * has been scanned for the first time. Later updates from the file
+	 * monitors only emit #PlumaFileIndex::changed.
+	 */
+	signals[SCAN_FINISHED] =
+		g_signal_new ("scan-finished",
+			      G_OBJECT_CLASS_TYPE (object_class),
+			      G_SIGNAL_RUN_LAST,
+			      G_STRUCT_OFFSET (PlumaFileIndexClass, scan_finished),
+			      NULL, NULL, NULL,
+			      G_TYPE_NONE, 0);
+}
+
+static void
+pluma_file_index_init (PlumaFileIndex *index)
+{
+	index->priv = pluma_file_index_get_instance_private (index);
+
+	index->priv->entries = g_ptr_array_new_with_free_func ((GDestroyNotify) entry_free);
+	index->priv->lookup = g_hash_table_new (g_str_hash, g_str_equal);
+	index->priv->monitors = g_hash_table_new_full (g_str_hash,
+						       g_str_equal,
+						       g_free,
+						       (GDestroyNotify) monitor_free);
+	index->priv->pending = g_queue_new ();
+}
+
+static void
+save_ready_cb (GFile          *file,
+	       GAsyncResult   *result,
+	       PlumaFileIndex *index)
+{
+	GError *error = NULL;
+
+	index->priv->saving = FALSE;
+
+	if (!g_file_replace_contents_finish (file, result, NULL, &error))
+	{
+		pluma_debug_message (DEBUG_UTILS,
+				     "Could not save file index: %s",
+				     error->message);
+
+		if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+			index->priv->dirty = TRUE;
+
+		g_error_free (error);
+	}
+	else if (index->priv->dirty && index->priv->cancellable != NULL)
+	{
+		/* The index changed while it was being written */
+		schedule_save (index);
+	}
+
+	g_object_unref (index);
+}
+
+static GBytes *
+get_cache_contents (PlumaFileIndex *index)
+{
+	GString *contents;
+	gchar *uri;
+	guint i;
+
+	contents = g_string_sized_new (index->priv->entries->len * 32);
+	uri = g_file_get_uri (index->priv->root);
+
+	g_string_append (contents, CACHE_MAGIC "\n");
+	g_string_append (contents, uri);
+	g_string_append_c (contents, '\n');
+
+	for (i = 0; i < index->priv->entries->len; ++i)
+	{
+		Entry *entry = g_ptr_array_index (index->priv->entries, i);
+
+		g_string_append (contents, entry->path);
+		g_string_append_c (contents, '\n');
+	}
+
+	g_free (uri);
+
+	return g_string_free_to_bytes (contents);
+}
+
+static gboolean
+save_timeout (PlumaFileIndex *index)
+{
+	GBytes *bytes;
+	GFile *file;
+	gchar *dir;
+
+	index->priv->save_id = 0;
+
+	/* save_ready_cb saves again if needed */
+	if (!index->priv->dirty || index->priv->saving)
+		return FALSE;
+
+	/* Only the snapshot is taken here, the file is written
+	   asynchronously so that large trees do not block the UI */
+	bytes = get_cache_contents (index);
+
+	dir = g_path_get_dirname (index->priv->cache_file);
+	g_mkdir_with_parents (dir, 0755);
+
+	index->priv->dirty = FALSE;
+	index->priv->saving = TRUE;
+
+	file = g_file_new_for_path (index->priv->cache_file);
+
+	g_file_replace_contents_bytes_async (file,
+					     bytes,
+					     NULL,
+					     FALSE,
+					     G_FILE_CREATE_NONE,
+					     index->priv->cancellable,
+					     (GAsyncReadyCallback) save_ready_cb,
+					     g_object_ref (index));
+
+	g_object_unref (file);
+	g_bytes_unref (bytes);
+	g_free (dir);
+
+	return FALSE;
+}
+
+static void
+schedule_save (PlumaFileIndex *index)
+{
+	index->priv->dirty = TRUE;
+
+	/* Do not write a partial index while scanning */
+	if (index->priv->save_id != 0 || index->priv->scanning)
+		return;
+
+	index->priv->save_id = g_timeout_add_seconds (SAVE_TIMEOUT,
+						      (GSourceFunc) save_timeout,
+						      index);
+}
+
+static gboolean
+add_entry (PlumaFileIndex *index,
+	   const gchar    *path)
+{
+	Entry *entry;
+
+	entry = g_hash_table_lookup (index->priv->lookup, path);
+
+	if (entry != NULL)
+	{
+		entry->generation = index->priv->generation;
+		return FALSE;
+	}
+
+	if (index->priv->entries->len >= MAX_FILES)
+		return FALSE;
+
+	entry = g_slice_new (Entry);
+	entry->path = g_strdup (path);
+	entry->char_mask = pluma_fuzzy_matcher_get_char_mask (path);
+	entry->generation = index->priv->generation;
+
+	g_ptr_array_add (index->priv->entries, entry);
+	g_hash_table_insert (index->priv->lookup, entry->path, entry);
+
+	return TRUE;
+}
+
+static void
+remove_entry_at (PlumaFileIndex *index,
+		 guint           i)
+{
+	Entry *entry = g_ptr_array_index (index->priv->entries, i);
+
+	g_hash_table_remove (index->priv->lookup, entry->path);
+	g_ptr_array_remove_index_fast (index->priv->entries, i);
+}
+
+static gboolean
+monitor_is_below (const gchar *dir,
+		  GFileMonitor *monitor,
+		  const gchar *prefix)
+{
+	return g_str_has_prefix (dir, prefix);
+}
+
+/* Removes @path and, for directories, everything below it */
+static gboolean
+remove_path (PlumaFileIndex *index,
+	     const gchar    *path)
+{
+	gchar *prefix;
+	gsize len;
+	guint i;
+	gboolean removed = FALSE;
+
+	prefix = g_strconcat (path, "/", NULL);
+	len = strlen (prefix);
+
+	/* Go backwards, remove_index_fast moves the last entry into the hole */
+	for (i = index->priv->entries->len; i > 0; --i)
+	{
+		Entry *entry = g_ptr_array_index (index->priv->entries, i - 1);
+
+		if (strcmp (entry->path, path) == 0 ||
+		    strncmp (entry->path, prefix, len) == 0)
+		{
+			remove_entry_at (index, i - 1);
+			removed = TRUE;
+		}
+	}
+
+	g_hash_table_remove (index->priv->monitors, path);
+	g_hash_table_foreach_remove (index->priv->monitors,
+				     (GHRFunc) monitor_is_below,
+				     prefix);
+
+	g_free (prefix);
+
+	return removed;
+}
+
+static gchar *
+get_relative_path (PlumaFileIndex *index,
+		   GFile          *file)
+{
+	gchar *path;
+
+	if (g_file_equal (file, index->priv->root))
+		return g_strdup ("");
+
+	path = g_file_get_relative_path (index->priv->root, file);
+
+#ifdef G_OS_WIN32
+	if (path != NULL)
+		g_strdelimit (path, "\\", '/');
+#endif
+
+	return path;
+}
+
+static gchar *
+build_path (const gchar *dir,
+	    const gchar *name)
+{
+	if (*dir == '\0')
+		return g_strdup (name);
+
+	return g_strconcat (dir, "/", name, NULL);
+}
+
+static void
+queue_dir (PlumaFileIndex *index,
+	   const gchar    *dir)
+{
+	g_queue_push_tail (index->priv->pending, g_strdup (dir));
+
+	if (!index->priv->scanning)
+	{
+		index->priv->scanning = TRUE;
+		scan_next_dir (index);
+	}
+}
+
+static void
+on_monitor_changed (GFileMonitor      *monitor,
+		    GFile             *file,
+		    GFile             *other_file,
+		    GFileMonitorEvent  event_type,
+		    PlumaFileIndex    *index)
+{
+	gchar *path;
+	gchar *name;
+	gboolean changed = FALSE;
+
+	if (event_type != G_FILE_MONITOR_EVENT_CREATED &&
+	    event_type != G_FILE_MONITOR_EVENT_DELETED)
+		return;
+
+	name = g_file_get_basename (file);
+
+	if (name == NULL || *name == '.' || g_str_has_suffix (name, "~"))
+	{
+		g_free (name);
+		return;
+	}
+
+	g_free (name);
+
+	path = get_relative_path (index, file);
+
+	if (path == NULL || *path == '\0')
+	{
+		g_free (path);
+		return;
+	}
+
+	if (event_type == G_FILE_MONITOR_EVENT_DELETED)
+	{
+		changed = remove_path (index, path);
+	}
+	else if (g_file_query_file_type (file,
+					 G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+					 NULL) == G_FILE_TYPE_DIRECTORY)
+	{
+		gchar *dir = g_strconcat (path, "/", NULL);
+
+		changed = add_entry (index, dir);
+		queue_dir (index, path);
+
+		g_free (dir);
+	}
+	else
+	{
+		changed = add_entry (index, path);
+	}
+
+	g_free (path);
+
+	if (changed)
+	{
+		schedule_save (index);
+		g_signal_emit (index, signals[CHANGED], 0);
+	}
+}
+
+static void
+monitor_dir (PlumaFileIndex *index,
+	     GFile          *file,
+	     const gchar    *dir)
+{
+	GFileMonitor *monitor;
+
+	if (g_hash_table_contains (index->priv->monitors, dir) ||
+	    g_hash_table_size (index->priv->monitors) >= MAX_MONITORS)
+		return;
+
+	monitor = g_file_monitor_directory (file,
+					    G_FILE_MONITOR_NONE,
+					    NULL,
+					    NULL);
+
+	if (monitor == NULL)
+		return;
+
+	g_signal_connect (monitor,
+			  "changed",
+			  G_CALLBACK (on_monitor_changed),
+			  index);
+
+	g_hash_table_insert (index->priv->monitors, g_strdup (dir), monitor);
+}
+
+static void
+scan_finished (PlumaFileIndex *index)
+{
+	guint i;
+	gboolean removed = FALSE;
+
+	index->priv->scanning = FALSE;
+
+	/* The directories queued by the monitors only add entries, they
+	   are reported with "changed" as they are found */
+	if (!index->priv->full_scan)
+	{
+		schedule_save (index);
+		return;
+	}
+
+	index->priv->full_scan = FALSE;
+
+	/* Drop everything the scan did not see, e.g. entries from the cache
+	   for files which were removed since the last session */
+	for (i = index->priv->entries->len; i > 0; --i)
+	{
+		Entry *entry = g_ptr_array_index (index->priv->entries, i - 1);
+
+		if (entry->generation != index->priv->generation)
+		{
+			remove_entry_at (index, i - 1);
+			removed = TRUE;
+		}
+	}
+
+	pluma_debug_message (DEBUG_UTILS,
+			     "File index scan finished: %u files",
+			     index->priv->entries->len);
+
+	schedule_save (index);
+
+	if (removed)
+		g_signal_emit (index, signals[CHANGED], 0);
+
+	g_signal_emit (index, signals[SCAN_FINISHED], 0);
+}
+
+static void
+scan_dir_free (ScanDir *scan)
+{
+	g_object_unref (scan->cancellable);
+	g_free (scan->dir);
+	g_slice_free (ScanDir, scan);
+}
+
+static void
+next_files_cb (GFileEnumerator *enumerator,
+	       GAsyncResult    *result,
+	       ScanDir         *scan)
+{
+	PlumaFileIndex *index = scan->index;
+	GList *files;
+	GList *item;
+	gboolean changed = FALSE;
+	GError *error = NULL;
+
+	files = g_file_enumerator_next_files_finish (enumerator, result, &error);
+
+	if (g_cancellable_is_cancelled (scan->cancellable))
+	{
+		g_clear_error (&error);
+		g_list_free_full (files, g_object_unref);
+		g_object_unref (enumerator);
+		scan_dir_free (scan);
+		return;
+	}
+
+	if (error != NULL)
+	{
+		g_error_free (error);
+		g_object_unref (enumerator);
+		scan_dir_free (scan);
+
+		scan_next_dir (index);
+		return;
+	}
+
+	if (files == NULL)
+	{
+		monitor_dir (index, g_file_enumerator_get_container (enumerator), scan->dir);
+
+		g_object_unref (enumerator);
+		scan_dir_free (scan);
+
+		scan_next_dir (index);
+		return;
+	}
+
+	for (item = files; item; item = item->next)
+	{
+		GFileInfo *info = G_FILE_INFO (item->data);
+		const gchar *name = g_file_info_get_name (info);
+		GFileType type = g_file_info_get_file_type (info);
+		gchar *path;
+
+		if (g_file_info_get_is_hidden (info) ||
+		    g_file_info_get_is_backup (info) ||
+		    (type != G_FILE_TYPE_REGULAR && type != G_FILE_TYPE_DIRECTORY))
+			continue;
+
+		path = build_path (scan->dir, name);
+
+		if (type == G_FILE_TYPE_DIRECTORY)
+		{
+			gchar *dir = g_strconcat (path, "/", NULL);
+
+			changed = add_entry (index, dir) || changed;
+			g_queue_push_tail (index->priv->pending, path);
+
+			g_free (dir);
+		}
+		else
+		{
+			changed = add_entry (index, path) || changed;
+			g_free (path);
+		}
+	}
+
+	g_list_free_full (files, g_object_unref);
+
+	if (changed)
+		g_signal_emit (index, signals[CHANGED], 0);
+
+	g_file_enumerator_next_files_async (enumerator,
+					    FILES_PER_CALLBACK,
+					    G_PRIORITY_LOW,
+					    index->priv->cancellable,
+					    (GAsyncReadyCallback) next_files_cb,
+					    scan);
+}
+
+static void
+enumerate_children_cb (GFile        *file,
+		       GAsyncResult *result,
+		       ScanDir      *scan)
+{
+	PlumaFileIndex *index = scan->index;
+	GFileEnumerator *enumerator;
+	GError *error = NULL;
+
+	enumerator = g_file_enumerate_children_finish (file, result, &error);
+
+	if (g_cancellable_is_cancelled (scan->cancellable))
+	{
+		g_clear_error (&error);
+		g_clear_object (&enumerator);
+		scan_dir_free (scan);
+		return;
+	}
+
+	if (enumerator == NULL)
+	{
+		g_error_free (error);
+		scan_dir_free (scan);
+
+		scan_next_dir (index);
+		return;
+	}
+
+	g_file_enumerator_next_files_async (enumerator,
+					    FILES_PER_CALLBACK,
+					    G_PRIORITY_LOW,
+					    index->priv->cancellable,
+					    (GAsyncReadyCallback) next_files_cb,
+					    scan);
+}
+
+static void
+scan_next_dir (PlumaFileIndex *index)
+{
+	ScanDir *scan;
+	GFile *file;
+	gchar *dir;
+
+	dir = g_queue_pop_head (index->priv->pending);
+
+	if (dir == NULL)
+	{
+		scan_finished (index);
+		return;
+	}
+
+	if (*dir == '\0')
+		file = g_object_ref (index->priv->root);
+	else
+		file = g_file_resolve_relative_path (index->priv->root, dir);
+
+	scan = g_slice_new (ScanDir);
+	scan->index = index;
+	scan->dir = dir;
+	scan->cancellable = g_object_ref (index->priv->cancellable);
+
+	/* Symbolic links are not followed to avoid indexing loops */
+	g_file_enumerate_children_async (file,
+					 INDEX_ATTRIBUTES,
+					 G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+					 G_PRIORITY_LOW,
+					 index->priv->cancellable,
+					 (GAsyncReadyCallback) enumerate_children_cb,
+					 scan);
+
+	g_object_unref (file);
+}
+
+static void
+load_cache (PlumaFileIndex *index)
+{
+	gchar *contents;
+	gchar *uri;
+	gchar *line;
+	gchar *next;
+
+	if (!g_file_get_contents (index->priv->cache_file, &contents, NULL, NULL))
+		return;
+
+	if (!g_str_has_prefix (contents, CACHE_MAGIC "\n"))
+	{
+		g_free (contents);
+		return;
+	}
+
+	line = contents + strlen (CACHE_MAGIC "\n");
+	next = strchr (line, '\n');
+	uri = g_file_get_uri (index->priv->root);
+
+	/* Different roots with the same hash */
+	if (next == NULL ||
+	    strncmp (line, uri, next - line) != 0 ||
+	    strlen (uri) != (gsize) (next - line))
+	{
+		g_free (uri);
+		g_free (contents);
+		return;
+	}
+
+	g_free (uri);
+
+	for (line = next + 1; *line != '\0'; line = next + 1)
+	{
+		next = strchr (line, '\n');
+
+		if (next == NULL)
+			break;
+
+		*next = '\0';
+
+		if (*line != '\0')
+			add_entry (index, line);
+	}
+
+	g_free (contents);
+
+	pluma_debug_message (DEBUG_UTILS,
+			     "Loaded %u files from the file index cache",
+			     index->priv->entries->len);
+}
+
+static gchar *
+get_cache_file (GFile *root)
+{
+	gchar *uri;
+	gchar *hash;
+	gchar *cache_dir;
+	gchar *ret;
+
+	uri = g_file_get_uri (root);
+	hash = g_compute_checksum_for_string (G_CHECKSUM_SHA1, uri, -1);
+	cache_dir = pluma_dirs_get_user_cache_dir ();
+
+	ret = g_build_filename (cache_dir, "file-index", hash, NULL);
+
+	g_free (cache_dir);
+	g_free (hash);
+	g_free (uri);
+
+	return ret;
+}
+
+static PlumaFileIndex *
+pluma_file_index_new (GFile *root)
+{
+	PlumaFileIndex *index;
+
+	index = g_object_new (PLUMA_TYPE_FILE_INDEX, NULL);
+
+	index->priv->root = g_object_ref (root);
+	index->priv->cache_file = get_cache_file (root);
+	index->priv->cancellable = g_cancellable_new ();
+
+	/* Entries loaded from the cache keep generation 0 until the scan
+	   confirms them */
+	load_cache (index);
+
+	index->priv->generation = 1;
+	index->priv->full_scan = TRUE;
+	queue_dir (index, "");
+
+	return index;
+}
+
+/**
+ * pluma_file_index_get_for_root:
+ * @root: the root directory
+ *
+ * Gets the index of the files below @root. The index is shared, so calling
+ * this function again with the same directory returns the same index as
+ * long as a reference to it is kept. The first call starts scanning @root
+ * in the background, the index and its file monitors are freed when the
+ * last reference is released.
+ *
+ * Returns: (transfer full): the #PlumaFileIndex for @root, unref it with
+ * g_object_unref() when no longer needed.
+ */
+PlumaFileIndex *
+pluma_file_index_get_for_root (GFile *root)
+{
+	PlumaFileIndex *index;
+	gchar *uri;
+
+	g_return_val_if_fail (G_IS_FILE (root), NULL);
+
+	if (indexes == NULL)
+	{
+		indexes = g_hash_table_new_full (g_str_hash,
+						 g_str_equal,
+						 g_free,
+						 NULL);
+	}
+
+	uri = g_file_get_uri (root);
+	index = g_hash_table_lookup (indexes, uri);
+
+	if (index == NULL)
+	{
+		index = pluma_file_index_new (root);
+		g_hash_table_insert (indexes, uri, index);
+	}
+	else
+	{
+		g_object_ref (index);
+		g_free (uri);
+	}
+
+	return index;
+}
+
+/**
+ * pluma_file_index_get_root:
+ * @index: a #PlumaFileIndex
+ *
+ * Returns: (transfer none): the root directory of @index.
+ */
+GFile *
+pluma_file_index_get_root (PlumaFileIndex *index)
+{
+	g_return_val_if_fail (PLUMA_IS_FILE_INDEX (index), NULL);
+
+	return index->priv->root;
+}
+
+/**
+ * pluma_file_index_is_scanning:
+ * @index: a #PlumaFileIndex
+ *
+ * Returns: %TRUE until the first scan of the directory tree is finished.
+ * The index can already be queried, but may be incomplete or contain stale
+ * entries.
+ */
+gboolean
+pluma_file_index_is_scanning (PlumaFileIndex *index)
+{
+	g_return_val_if_fail (PLUMA_IS_FILE_INDEX (index), FALSE);
+
+	return index->priv->full_scan;
+}
+
+/**
+ * pluma_file_index_get_n_files:
+ * @index: a #PlumaFileIndex
+ *
+ * Returns: the number of files and directories in @index.
+ */
+guint
+pluma_file_index_get_n_files (PlumaFileIndex *index)
+{
+	g_return_val_if_fail (PLUMA_IS_FILE_INDEX (index), 0);
+
+	return index->priv->entries->len;
+}
+
+/* Better matches first, then shorter paths */
+static gint
+compare_matches (gconstpointer a,
+		 gconstpointer b)
+{
+	const Match *match1 = a;
+	const Match *match2 = b;
+	gsize len1;
+	gsize len2;
+
+	if (match1->score != match2->score)
+		return match1->score > match2->score ? -1 : 1;
+
+	len1 = strlen (match1->entry->path);
+	len2 = strlen (match2->entry->path);
+
+	if (len1 != len2)
+		return len1 < len2 ? -1 : 1;
+
+	return strcmp (match1->entry->path, match2->entry->path);
+}
+
+/* The heap keeps the worst of the best matches found so far at the top */
+static void
+heap_sift_down (Match *heap,
+		guint  size,
+		guint  i)
+{
+	while (TRUE)
+	{
+		guint worst = i;
+		guint left = 2 * i + 1;
+		guint right = 2 * i + 2;
+		Match tmp;
+
+		if (left < size && compare_matches (&heap[left], &heap[worst]) > 0)
+			worst = left;
+
+		if (right < size && compare_matches (&heap[right], &heap[worst]) > 0)
+			worst = right;
+
+		if (worst == i)
+			break;
+
+		tmp = heap[i];
+		heap[i] = heap[worst];
+		heap[worst] = tmp;
+
+		i = worst;
+	}
+}
+
+static void
+heap_sift_up (Match *heap,
+	      guint  i)
+{
+	while (i > 0)
+	{
+		guint parent = (i - 1) / 2;
+		Match tmp;
+
+		if (compare_matches (&heap[i], &heap[parent]) <= 0)
+			break;
+
+		tmp = heap[i];
+		heap[i] = heap[parent];
+		heap[parent] = tmp;
+
+		i = parent;
+	}
+}
+
+/**
+ * pluma_file_index_query:
+ * @index: a #PlumaFileIndex
+ * @query: the text to look for
+ * @max_results: the maximum number of results, or 0 for no limit
+ *
+ * Looks for the files whose relative path contains all the characters of
+ * @query in order, ignoring the case of ASCII characters. The results are
+ * ranked, matches of consecutive characters and at the start of path
+ * components, words and camelCase humps come first.
+ *
+ * Returns: (transfer full) (array zero-terminated=1): the relative paths of
+ * the best matching files, directories end with a '/'.
+ */
+gchar **
+pluma_file_index_query (PlumaFileIndex *index,
+			const gchar    *query,
+			guint           max_results)
+{
+	PlumaFuzzyMatcher *matcher;
+	GArray *matches;
+	Match *heap;
+	gchar **ret;
+	guint i;
+
+	g_return_val_if_fail (PLUMA_IS_FILE_INDEX (index), NULL);
+	g_return_val_if_fail (query != NULL, NULL);
+
+	if (max_results == 0 || max_results > index->priv->entries->len)
+		max_results = index->priv->entries->len;
+
+	matcher = pluma_fuzzy_matcher_new (query);
+	matches = g_array_sized_new (FALSE, FALSE, sizeof (Match), max_results);
+
+	for (i = 0; i < index->priv->entries->len; ++i)
+	{
+		Match match;
+
+		match.entry = g_ptr_array_index (index->priv->entries, i);
+
+		if (!pluma_fuzzy_matcher_match (matcher,
+						match.entry->path,
+						match.entry->char_mask,
+						&match.score))
+			continue;
+
+		heap = (Match *) matches->data;
+
+		if (matches->len < max_results)
+		{
+			g_array_append_val (matches, match);
+			heap_sift_up ((Match *) matches->data, matches->len - 1);
+		}
+		else if (max_results > 0 && compare_matches (&match, &heap[0]) < 0)
+		{
+			heap[0] = match;
+			heap_sift_down (heap, matches->len, 0);
+		}
+	}
+
+	g_array_sort (matches, compare_matches);
+
+	ret = g_new (gchar *, matches->len + 1);
+
+	for (i = 0; i < matches->len; ++i)
+	{
+		ret[i] = g_strdup (g_array_index (matches, Match, i).entry->path);
+	}
+
+	ret[matches->len] = NULL;
+
+	g_array_free (matches, TRUE);
+	pluma_fuzzy_matcher_free (matcher);
+
+	return ret;
+}
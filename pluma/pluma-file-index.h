@@ -0,0 +1,69 @@
+/*
+ * pluma-file-index.h
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PLUMA_FILE_INDEX_H__
+#define __PLUMA_FILE_INDEX_H__
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define PLUMA_TYPE_FILE_INDEX			(pluma_file_index_get_type ())
+#define PLUMA_FILE_INDEX(obj)			(G_TYPE_CHECK_INSTANCE_CAST ((obj), PLUMA_TYPE_FILE_INDEX, PlumaFileIndex))
+#define PLUMA_FILE_INDEX_CLASS(klass)		(G_TYPE_CHECK_CLASS_CAST ((klass), PLUMA_TYPE_FILE_INDEX, PlumaFileIndexClass))
+#define PLUMA_IS_FILE_INDEX(obj)		(G_TYPE_CHECK_INSTANCE_TYPE ((obj), PLUMA_TYPE_FILE_INDEX))
+#define PLUMA_IS_FILE_INDEX_CLASS(klass)	(G_TYPE_CHECK_CLASS_TYPE ((klass), PLUMA_TYPE_FILE_INDEX))
+#define PLUMA_FILE_INDEX_GET_CLASS(obj)		(G_TYPE_INSTANCE_GET_CLASS ((obj), PLUMA_TYPE_FILE_INDEX, PlumaFileIndexClass))
+
+typedef struct _PlumaFileIndex		PlumaFileIndex;
+typedef struct _PlumaFileIndexClass	PlumaFileIndexClass;
+typedef struct _PlumaFileIndexPrivate	PlumaFileIndexPrivate;
+
+struct _PlumaFileIndex {
+	GObject parent;
+
+	PlumaFileIndexPrivate *priv;
+};
+
+struct _PlumaFileIndexClass {
+	GObjectClass parent_class;
+
+	/* Signals */
+	void (*changed)		(PlumaFileIndex *index);
+	void (*scan_finished)	(PlumaFileIndex *index);
+};
+
+GType		 pluma_file_index_get_type		(void) G_GNUC_CONST;
+
+PlumaFileIndex	*pluma_file_index_get_for_root		(GFile          *root);
+
+GFile		*pluma_file_index_get_root		(PlumaFileIndex *index);
+gboolean	 pluma_file_index_is_scanning		(PlumaFileIndex *index);
+guint		 pluma_file_index_get_n_files		(PlumaFileIndex *index);
+
+gchar		**pluma_file_index_query		(PlumaFileIndex *index,
+							 const gchar    *query,
+							 guint           max_results);
+
+G_END_DECLS
+
+#endif /* __PLUMA_FILE_INDEX_H__ */
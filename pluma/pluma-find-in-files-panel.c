@@ -0,0 +1,628 @@
+/*
+ * pluma-find-in-files-panel.c
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "pluma-find-in-files-panel.h"
+#include "pluma-find-in-files.h"
+#include "pluma-message-bus.h"
+#include "pluma-debug.h"
+
+#include <glib/gi18n.h>
+
+struct _PlumaFindInFilesPanelPrivate
+{
+	PlumaWindow      *window;
+
+	PlumaFindInFiles *search;
+	GFile            *root;
+
+	GtkWidget        *entry;
+	GtkWidget        *folder_button;
+	GtkWidget        *find_button;
+	GtkWidget        *stop_button;
+	GtkWidget        *match_case_checkbutton;
+	GtkWidget        *regex_checkbutton;
+	GtkWidget        *entire_word_checkbutton;
+	GtkWidget        *status_label;
+
+	GtkWidget        *treeview;
+	GtkTreeStore     *store;
+
+	/* the row of the file of the last match */
+	GFile            *last_location;
+	GtkTreeIter       last_file_iter;
+
+	guint             folder_set_by_user : 1;
+};
+
+G_DEFINE_TYPE_WITH_PRIVATE (PlumaFindInFilesPanel, pluma_find_in_files_panel, GTK_TYPE_BOX)
+
+enum
+{
+	MARKUP_COLUMN,
+	LOCATION_COLUMN,
+	LINE_COLUMN,		/* -1 for the rows of the files */
+	OFFSET_COLUMN,
+	LENGTH_COLUMN,
+	N_COLUMNS
+};
+
+static void
+set_status (PlumaFindInFilesPanel *panel,
+	    const gchar           *status)
+{
+	gtk_label_set_text (GTK_LABEL (panel->priv->status_label), status);
+}
+
+static void
+set_running (PlumaFindInFilesPanel *panel,
+	     gboolean               running)
+{
+	gtk_widget_set_sensitive (panel->priv->stop_button, running);
+}
+
+static void
+search_match_cb (PlumaFindInFiles      *search,
+		 GFile                 *location,
+		 gint                   line,
+		 gint                   line_offset,
+		 gint                   length,
+		 const gchar           *text,
+		 PlumaFindInFilesPanel *panel)
+{
+	GtkTreeIter iter;
+	gchar *markup;
+	gboolean new_file = FALSE;
+
+	if (panel->priv->last_location == NULL ||
+	    !g_file_equal (location, panel->priv->last_location))
+	{
+		gchar *name;
+
+		name = g_file_get_relative_path (panel->priv->root, location);
+		if (name == NULL)
+			name = g_file_get_parse_name (location);
+
+		markup = g_markup_printf_escaped ("<b>%s</b>", name);
+
+		gtk_tree_store_insert_with_values (panel->priv->store,
+						   &panel->priv->last_file_iter,
+						   NULL,
+						   -1,
+						   MARKUP_COLUMN, markup,
+						   LOCATION_COLUMN, location,
+						   LINE_COLUMN, -1,
+						   OFFSET_COLUMN, 0,
+						   LENGTH_COLUMN, 0,
+						   -1);
+
+		g_free (markup);
+		g_free (name);
+
+		g_set_object (&panel->priv->last_location, location);
+		new_file = TRUE;
+	}
+
+	markup = g_markup_printf_escaped ("<span weight=\"light\">%d:</span> %s",
+					  line + 1,
+					  text);
+
+	gtk_tree_store_insert_with_values (panel->priv->store,
+					   &iter,
+					   &panel->priv->last_file_iter,
+					   -1,
+					   MARKUP_COLUMN, markup,
+					   LOCATION_COLUMN, location,
+					   LINE_COLUMN, line,
+					   OFFSET_COLUMN, line_offset,
+					   LENGTH_COLUMN, length,
+					   -1);
+
+	g_free (markup);
+
+	if (new_file)
+	{
+		GtkTreePath *path;
+
+		path = gtk_tree_model_get_path (GTK_TREE_MODEL (panel->priv->store),
+						&panel->priv->last_file_iter);
+		gtk_tree_view_expand_row (GTK_TREE_VIEW (panel->priv->treeview), path, FALSE);
+		gtk_tree_path_free (path);
+	}
+}
+
+static void
+search_finished_cb (PlumaFindInFiles      *search,
+		    PlumaFindInFilesPanel *panel)
+{
+	guint n_matches;
+	gchar *status;
+
+	set_running (panel, FALSE);
+
+	n_matches = pluma_find_in_files_get_n_matches (search);
+
+	if (n_matches == 0)
+	{
+		set_status (panel, _("No matches found"));
+		return;
+	}
+
+	if (pluma_find_in_files_get_truncated (search))
+		status = g_strdup_printf (_("Too many matches, only the first %u are shown"),
+					  n_matches);
+	else
+		status = g_strdup_printf (ngettext ("%u match found",
+						    "%u matches found",
+						    n_matches),
+					  n_matches);
+
+	set_status (panel, status);
+	g_free (status);
+}
+
+static void
+start_search (PlumaFindInFilesPanel *panel)
+{
+	const gchar *text;
+	guint flags = 0;
+	GError *error = NULL;
+
+	text = gtk_entry_get_text (GTK_ENTRY (panel->priv->entry));
+	if (*text == '\0')
+		return;
+
+	g_clear_object (&panel->priv->root);
+	panel->priv->root = gtk_file_chooser_get_file (GTK_FILE_CHOOSER (panel->priv->folder_button));
+	if (panel->priv->root == NULL)
+		return;
+
+	PLUMA_SEARCH_SET_CASE_SENSITIVE (flags,
+		gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (panel->priv->match_case_checkbutton)));
+	PLUMA_SEARCH_SET_MATCH_REGEX (flags,
+		gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (panel->priv->regex_checkbutton)));
+	PLUMA_SEARCH_SET_ENTIRE_WORD (flags,
+		gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (panel->priv->entire_word_checkbutton)));
+
+	gtk_tree_store_clear (panel->priv->store);
+	g_clear_object (&panel->priv->last_location);
+
+	if (!pluma_find_in_files_start (panel->priv->search,
+					panel->priv->root,
+					text,
+					flags,
+					&error))
+	{
+		set_running (panel, FALSE);
+		set_status (panel, error->message);
+		g_error_free (error);
+
+		return;
+	}
+
+	set_running (panel, TRUE);
+	set_status (panel, _("Searching..."));
+}
+
+static void
+stop_search (PlumaFindInFilesPanel *panel)
+{
+	if (!pluma_find_in_files_is_running (panel->priv->search))
+		return;
+
+	pluma_find_in_files_stop (panel->priv->search);
+
+	set_running (panel, FALSE);
+	set_status (panel, _("Search stopped"));
+}
+
+typedef struct
+{
+	gint line;
+	gint line_offset;
+	gint length;
+} GotoData;
+
+static void
+goto_match (PlumaTab *tab,
+	    gint      line,
+	    gint      line_offset,
+	    gint      length)
+{
+	PlumaDocument *doc;
+	PlumaView *view;
+	GtkTextIter start;
+	GtkTextIter end;
+
+	doc = pluma_tab_get_document (tab);
+	view = pluma_tab_get_view (tab);
+
+	pluma_document_goto_line_offset (doc, line, line_offset);
+
+	gtk_text_buffer_get_iter_at_mark (GTK_TEXT_BUFFER (doc),
+					  &start,
+					  gtk_text_buffer_get_insert (GTK_TEXT_BUFFER (doc)));
+	end = start;
+	gtk_text_iter_forward_chars (&end, length);
+	gtk_text_buffer_select_range (GTK_TEXT_BUFFER (doc), &end, &start);
+
+	pluma_view_scroll_to_cursor (view);
+	gtk_widget_grab_focus (GTK_WIDGET (view));
+}
+
+static void
+goto_data_free (GotoData *data)
+{
+	g_slice_free (GotoData, data);
+}
+
+static void
+document_loaded (PlumaDocument *doc,
+		 const GError  *error,
+		 GotoData      *data)
+{
+	GotoData match = *data;
+
+	/* frees data */
+	g_signal_handlers_disconnect_by_func (doc, document_loaded, data);
+
+	if (error == NULL)
+	{
+		goto_match (pluma_tab_get_from_document (doc),
+			    match.line,
+			    match.line_offset,
+			    match.length);
+	}
+}
+
+static void
+open_match (PlumaFindInFilesPanel *panel,
+	    GFile                 *location,
+	    gint                   line,
+	    gint                   line_offset,
+	    gint                   length)
+{
+	PlumaTab *tab;
+	GotoData *data;
+	gchar *uri;
+
+	tab = pluma_window_get_tab_from_location (panel->priv->window, location);
+
+	if (tab != NULL)
+	{
+		pluma_window_set_active_tab (panel->priv->window, tab);
+
+		if (pluma_tab_get_state (tab) == PLUMA_TAB_STATE_NORMAL)
+		{
+			goto_match (tab, line, line_offset, length);
+			return;
+		}
+	}
+	else
+	{
+		uri = g_file_get_uri (location);
+		tab = pluma_window_create_tab_from_uri (panel->priv->window,
+							uri,
+							NULL,
+							line + 1,
+							FALSE,
+							TRUE);
+		g_free (uri);
+
+		if (tab == NULL)
+			return;
+	}
+
+	/* move to the match once the document is loaded */
+	data = g_slice_new (GotoData);
+	data->line = line;
+	data->line_offset = line_offset;
+	data->length = length;
+
+	g_signal_connect_data (pluma_tab_get_document (tab),
+			       "loaded",
+			       G_CALLBACK (document_loaded),
+			       data,
+			       (GClosureNotify) goto_data_free,
+			       G_CONNECT_AFTER);
+}
+
+static void
+treeview_row_activated (GtkTreeView           *treeview,
+			GtkTreePath           *path,
+			GtkTreeViewColumn     *column,
+			PlumaFindInFilesPanel *panel)
+{
+	GtkTreeIter iter;
+	GFile *location;
+	gint line;
+	gint line_offset;
+	gint length;
+
+	if (!gtk_tree_model_get_iter (GTK_TREE_MODEL (panel->priv->store), &iter, path))
+		return;
+
+	gtk_tree_model_get (GTK_TREE_MODEL (panel->priv->store),
+			    &iter,
+			    LOCATION_COLUMN, &location,
+			    LINE_COLUMN, &line,
+			    OFFSET_COLUMN, &line_offset,
+			    LENGTH_COLUMN, &length,
+			    -1);
+
+	if (line < 0)
+	{
+		/* a file row */
+		if (gtk_tree_view_row_expanded (treeview, path))
+			gtk_tree_view_collapse_row (treeview, path);
+		else
+			gtk_tree_view_expand_row (treeview, path, FALSE);
+	}
+	else
+	{
+		open_match (panel, location, line, line_offset, length);
+	}
+
+	g_object_unref (location);
+}
+
+static void
+folder_button_file_set (GtkFileChooserButton  *button,
+			PlumaFindInFilesPanel *panel)
+{
+	panel->priv->folder_set_by_user = TRUE;
+}
+
+/* The file browser root if the plugin is active, else the directory
+ * of the active document, else the home directory */
+static GFile *
+get_default_root (PlumaFindInFilesPanel *panel)
+{
+	PlumaMessageBus *bus;
+	PlumaDocument *doc;
+	GFile *root = NULL;
+
+	bus = pluma_window_get_message_bus (panel->priv->window);
+
+	if (pluma_message_bus_is_registered (bus, "/plugins/filebrowser", "get_root"))
+	{
+		PlumaMessage *msg;
+		gchar *uri = NULL;
+
+		msg = pluma_message_bus_send_sync (bus, "/plugins/filebrowser", "get_root", NULL);
+		pluma_message_get (msg, "uri", &uri, NULL);
+
+		if (uri != NULL)
+		{
+			root = g_file_new_for_uri (uri);
+			g_free (uri);
+		}
+
+		g_object_unref (msg);
+	}
+
+	if (root != NULL && !g_file_is_native (root))
+		g_clear_object (&root);
+
+	doc = pluma_window_get_active_document (panel->priv->window);
+	if (root == NULL && doc != NULL && pluma_document_is_local (doc))
+	{
+		GFile *location;
+
+		location = pluma_document_get_location (doc);
+		root = g_file_get_parent (location);
+		g_object_unref (location);
+	}
+
+	if (root == NULL)
+		root = g_file_new_for_path (g_get_home_dir ());
+
+	return root;
+}
+
+static void
+pluma_find_in_files_panel_dispose (GObject *object)
+{
+	PlumaFindInFilesPanel *panel = PLUMA_FIND_IN_FILES_PANEL (object);
+
+	if (panel->priv->search != NULL)
+	{
+		g_signal_handlers_disconnect_by_data (panel->priv->search, panel);
+		g_clear_object (&panel->priv->search);
+	}
+
+	g_clear_object (&panel->priv->root);
+	g_clear_object (&panel->priv->last_location);
+
+	G_OBJECT_CLASS (pluma_find_in_files_panel_parent_class)->dispose (object);
+}
+
+static void
+pluma_find_in_files_panel_class_init (PlumaFindInFilesPanelClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->dispose = pluma_find_in_files_panel_dispose;
+}
+
+static void
+pluma_find_in_files_panel_init (PlumaFindInFilesPanel *panel)
+{
+	GtkWidget		*hbox;
+	GtkWidget		*sw;
+	GtkTreeViewColumn	*column;
+	GtkCellRenderer		*cell;
+
+	panel->priv = pluma_find_in_files_panel_get_instance_private (panel);
+
+	gtk_orientable_set_orientation (GTK_ORIENTABLE (panel),
+	                                GTK_ORIENTATION_VERTICAL);
+	gtk_box_set_spacing (GTK_BOX (panel), 6);
+
+	panel->priv->search = pluma_find_in_files_new ();
+	g_signal_connect (panel->priv->search,
+			  "match",
+			  G_CALLBACK (search_match_cb),
+			  panel);
+	g_signal_connect (panel->priv->search,
+			  "finished",
+			  G_CALLBACK (search_finished_cb),
+			  panel);
+
+	/* Search entry, folder and buttons */
+	hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 6);
+	gtk_box_pack_start (GTK_BOX (panel), hbox, FALSE, FALSE, 0);
+
+	panel->priv->entry = gtk_search_entry_new ();
+	gtk_entry_set_placeholder_text (GTK_ENTRY (panel->priv->entry),
+					_("Text to find"));
+	gtk_box_pack_start (GTK_BOX (hbox), panel->priv->entry, TRUE, TRUE, 0);
+	g_signal_connect_swapped (panel->priv->entry,
+				  "activate",
+				  G_CALLBACK (start_search),
+				  panel);
+
+	panel->priv->folder_button = gtk_file_chooser_button_new (_("Select a Folder"),
+								  GTK_FILE_CHOOSER_ACTION_SELECT_FOLDER);
+	gtk_file_chooser_set_local_only (GTK_FILE_CHOOSER (panel->priv->folder_button), TRUE);
+	gtk_box_pack_start (GTK_BOX (hbox), panel->priv->folder_button, FALSE, FALSE, 0);
+	g_signal_connect (panel->priv->folder_button,
+			  "file-set",
+			  G_CALLBACK (folder_button_file_set),
+			  panel);
+
+	panel->priv->find_button = gtk_button_new_with_mnemonic (_("_Find"));
+	gtk_box_pack_start (GTK_BOX (hbox), panel->priv->find_button, FALSE, FALSE, 0);
+	g_signal_connect_swapped (panel->priv->find_button,
+				  "clicked",
+				  G_CALLBACK (start_search),
+				  panel);
+
+	panel->priv->stop_button = gtk_button_new_with_mnemonic (_("_Stop"));
+	gtk_widget_set_sensitive (panel->priv->stop_button, FALSE);
+	gtk_box_pack_start (GTK_BOX (hbox), panel->priv->stop_button, FALSE, FALSE, 0);
+	g_signal_connect_swapped (panel->priv->stop_button,
+				  "clicked",
+				  G_CALLBACK (stop_search),
+				  panel);
+
+	/* Options and status */
+	hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 6);
+	gtk_box_pack_start (GTK_BOX (panel), hbox, FALSE, FALSE, 0);
+
+	panel->priv->match_case_checkbutton = gtk_check_button_new_with_mnemonic (_("_Match case"));
+	gtk_box_pack_start (GTK_BOX (hbox), panel->priv->match_case_checkbutton, FALSE, FALSE, 0);
+
+	panel->priv->entire_word_checkbutton = gtk_check_button_new_with_mnemonic (_("Match _entire word only"));
+	gtk_box_pack_start (GTK_BOX (hbox), panel->priv->entire_word_checkbutton, FALSE, FALSE, 0);
+
+	panel->priv->regex_checkbutton = gtk_check_button_new_with_mnemonic (_("Match as _regular expression"));
+	gtk_box_pack_start (GTK_BOX (hbox), panel->priv->regex_checkbutton, FALSE, FALSE, 0);
+
+	panel->priv->status_label = gtk_label_new (NULL);
+	gtk_label_set_ellipsize (GTK_LABEL (panel->priv->status_label), PANGO_ELLIPSIZE_END);
+	gtk_label_set_xalign (GTK_LABEL (panel->priv->status_label), 1.0);
+	gtk_box_pack_end (GTK_BOX (hbox), panel->priv->status_label, TRUE, TRUE, 0);
+
+	/* Results */
+	sw = gtk_scrolled_window_new (NULL, NULL);
+	gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (sw),
+					GTK_POLICY_AUTOMATIC,
+					GTK_POLICY_AUTOMATIC);
+	gtk_scrolled_window_set_shadow_type (GTK_SCROLLED_WINDOW (sw),
+                                             GTK_SHADOW_IN);
+	gtk_box_pack_start (GTK_BOX (panel), sw, TRUE, TRUE, 0);
+
+	panel->priv->store = gtk_tree_store_new (N_COLUMNS,
+						 G_TYPE_STRING,
+						 G_TYPE_FILE,
+						 G_TYPE_INT,
+						 G_TYPE_INT,
+						 G_TYPE_INT);
+
+	panel->priv->treeview = gtk_tree_view_new_with_model (GTK_TREE_MODEL (panel->priv->store));
+	g_object_unref (panel->priv->store);
+	gtk_tree_view_set_headers_visible (GTK_TREE_VIEW (panel->priv->treeview), FALSE);
+	gtk_container_add (GTK_CONTAINER (sw), panel->priv->treeview);
+
+	column = gtk_tree_view_column_new ();
+	cell = gtk_cell_renderer_text_new ();
+	g_object_set (cell, "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+	gtk_tree_view_column_pack_start (column, cell, TRUE);
+	gtk_tree_view_column_add_attribute (column, cell, "markup", MARKUP_COLUMN);
+	gtk_tree_view_append_column (GTK_TREE_VIEW (panel->priv->treeview), column);
+
+	g_signal_connect (panel->priv->treeview,
+			  "row-activated",
+			  G_CALLBACK (treeview_row_activated),
+			  panel);
+
+	gtk_widget_show_all (GTK_WIDGET (panel));
+}
+
+GtkWidget *
+pluma_find_in_files_panel_new (PlumaWindow *window)
+{
+	PlumaFindInFilesPanel *panel;
+
+	g_return_val_if_fail (PLUMA_IS_WINDOW (window), NULL);
+
+	panel = g_object_new (PLUMA_TYPE_FIND_IN_FILES_PANEL, NULL);
+	panel->priv->window = window;
+
+	return GTK_WIDGET (panel);
+}
+
+/**
+ * pluma_find_in_files_panel_focus_search:
+ * @panel: a #PlumaFindInFilesPanel
+ * @text: (allow-none): the text to search
+ *
+ * Prepares the panel for a new search in the default folder, unless the
+ * user picked another one, and focuses the search entry.
+ */
+void
+pluma_find_in_files_panel_focus_search (PlumaFindInFilesPanel *panel,
+					const gchar           *text)
+{
+	g_return_if_fail (PLUMA_IS_FIND_IN_FILES_PANEL (panel));
+
+	if (text != NULL)
+		gtk_entry_set_text (GTK_ENTRY (panel->priv->entry), text);
+
+	if (!panel->priv->folder_set_by_user)
+	{
+		GFile *root;
+
+		root = get_default_root (panel);
+		gtk_file_chooser_set_current_folder_file (GTK_FILE_CHOOSER (panel->priv->folder_button),
+							  root,
+							  NULL);
+		g_object_unref (root);
+	}
+
+	gtk_widget_grab_focus (panel->priv->entry);
+	gtk_editable_select_region (GTK_EDITABLE (panel->priv->entry), 0, -1);
+}
@@ -0,0 +1,80 @@
+/*
+ * pluma-find-in-files-panel.h
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PLUMA_FIND_IN_FILES_PANEL_H__
+#define __PLUMA_FIND_IN_FILES_PANEL_H__
+
+#include <gtk/gtk.h>
+
+#include <pluma/pluma-window.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Type checking and casting macros
+ */
+#define PLUMA_TYPE_FIND_IN_FILES_PANEL              (pluma_find_in_files_panel_get_type())
+#define PLUMA_FIND_IN_FILES_PANEL(obj)              (G_TYPE_CHECK_INSTANCE_CAST((obj), PLUMA_TYPE_FIND_IN_FILES_PANEL, PlumaFindInFilesPanel))
+#define PLUMA_FIND_IN_FILES_PANEL_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST((klass), PLUMA_TYPE_FIND_IN_FILES_PANEL, PlumaFindInFilesPanelClass))
+#define PLUMA_IS_FIND_IN_FILES_PANEL(obj)           (G_TYPE_CHECK_INSTANCE_TYPE((obj), PLUMA_TYPE_FIND_IN_FILES_PANEL))
+#define PLUMA_IS_FIND_IN_FILES_PANEL_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), PLUMA_TYPE_FIND_IN_FILES_PANEL))
+#define PLUMA_FIND_IN_FILES_PANEL_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS((obj), PLUMA_TYPE_FIND_IN_FILES_PANEL, PlumaFindInFilesPanelClass))
+
+/* Private structure type */
+typedef struct _PlumaFindInFilesPanelPrivate PlumaFindInFilesPanelPrivate;
+
+/*
+ * Main object structure
+ */
+typedef struct _PlumaFindInFilesPanel PlumaFindInFilesPanel;
+
+struct _PlumaFindInFilesPanel
+{
+	GtkBox vbox;
+
+	/*< private > */
+	PlumaFindInFilesPanelPrivate *priv;
+};
+
+/*
+ * Class definition
+ */
+typedef struct _PlumaFindInFilesPanelClass PlumaFindInFilesPanelClass;
+
+struct _PlumaFindInFilesPanelClass
+{
+	GtkBoxClass parent_class;
+};
+
+/*
+ * Public methods
+ */
+GType 		 pluma_find_in_files_panel_get_type	(void) G_GNUC_CONST;
+
+GtkWidget	*pluma_find_in_files_panel_new 		(PlumaWindow *window);
+
+void		 pluma_find_in_files_panel_focus_search	(PlumaFindInFilesPanel *panel,
+							 const gchar           *text);
+
+G_END_DECLS
+
+#endif  /* __PLUMA_FIND_IN_FILES_PANEL_H__  */
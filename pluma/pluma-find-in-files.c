@@ -0,0 +1,1151 @@
+/*
+ * pluma-find-in-files.c
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+#include <sys/stat.h>
+#include <glib/gi18n.h>
+#include <glib/gstdio.h>
+
+#include "pluma-find-in-files.h"
+#include "pluma-document.h"
+#include "pluma-utils.h"
+#include "pluma-debug.h"
+
+/**
+ * SECTION:pluma-find-in-files
+ * @short_description: search text in the files below a directory
+ * @include: pluma/pluma-find-in-files.h
+ *
+ * A #PlumaFindInFiles searches a literal string or a regular expression in
+ * all the files below a local root directory. The tree is walked by a
+ * background thread which hands the files to a pool of worker threads;
+ * each worker maps its file in memory, skips it if it looks binary, and
+ * looks for the matches with memchr() for plain strings or with #GRegex.
+ *
+ * Matching lines are delivered in batches on the main loop through the
+ * #PlumaFindInFiles::match signal, at most one per line. Hidden files and
+ * directories, backup files and the entries matched by the .gitignore
+ * files found along the way are skipped. Only a subset of the gitignore
+ * syntax is supported: negated patterns are ignored.
+ *
+ * The search flags are the #PlumaSearchFlags of pluma_document_replace_all().
+ */
+
+#define MAX_FILE_SIZE		(32 * 1024 * 1024)
+#define MAX_MATCHES		10000
+#define MAX_LINE_LENGTH		256	/* bytes of context kept per match */
+#define BINARY_CHECK_SIZE	8000
+#define FLUSH_INTERVAL		100	/* ms */
+#define IGNORE_FILE		".gitignore"
+
+typedef struct
+{
+	gint line;
+	gint line_offset;
+	gint length;
+	gchar *text;
+} Match;
+
+typedef struct
+{
+	gchar *path;
+	GArray *matches;
+} FileMatches;
+
+typedef struct
+{
+	GPatternSpec *spec;
+	gboolean anchored;
+	gboolean dir_only;
+} IgnoreRule;
+
+typedef struct _IgnoreList IgnoreList;
+
+struct _IgnoreList
+{
+	IgnoreList *parent;
+	gchar *base;		/* relative to the root, with a trailing '/' */
+	GPtrArray *rules;
+};
+
+typedef struct
+{
+	gchar *rel;		/* relative to the root, with a trailing '/' */
+	IgnoreList *ignore;
+} PendingDir;
+
+/* The state of a search, shared between the main loop and the threads */
+typedef struct
+{
+	volatile gint ref_count;
+
+	/* main thread only */
+	PlumaFindInFiles *search;
+	gboolean stopped;
+	gboolean finished;
+
+	gchar *root;
+	GCancellable *cancellable;
+
+	/* either a literal string or a regex */
+	gchar *literal;
+	gsize literal_len;
+	gboolean literal_caseless;
+	GRegex *regex;
+	GRegex *raw_regex;	/* for the files which are not valid UTF-8, may be NULL */
+
+	GMutex lock;
+	GPtrArray *results;	/* FileMatches, protected by lock */
+	gboolean flush_scheduled;
+	gboolean done;
+
+	volatile gint n_files;
+	volatile gint n_matches;
+	volatile gint truncated;
+} Job;
+
+struct _PlumaFindInFilesPrivate
+{
+	Job *job;
+};
+
+/* Signals */
+enum
+{
+	MATCH,
+	FINISHED,
+	LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+G_DEFINE_TYPE_WITH_PRIVATE (PlumaFindInFiles, pluma_find_in_files, G_TYPE_OBJECT)
+
+static void
+file_matches_free (FileMatches *fm)
+{
+	guint i;
+
+	for (i = 0; i < fm->matches->len; i++)
+		g_free (g_array_index (fm->matches, Match, i).text);
+
+	g_array_free (fm->matches, TRUE);
+	g_free (fm->path);
+
+	g_slice_free (FileMatches, fm);
+}
+
+static Job *
+job_ref (Job *job)
+{
+	g_atomic_int_inc (&job->ref_count);
+
+	return job;
+}
+
+static void
+job_unref (Job *job)
+{
+	if (!g_atomic_int_dec_and_test (&job->ref_count))
+		return;
+
+	g_free (job->root);
+	g_free (job->literal);
+	g_object_unref (job->cancellable);
+
+	if (job->regex != NULL)
+		g_regex_unref (job->regex);
+	if (job->raw_regex != NULL)
+		g_regex_unref (job->raw_regex);
+
+	g_ptr_array_free (job->results, TRUE);
+	g_mutex_clear (&job->lock);
+
+	g_slice_free (Job, job);
+}
+
+static void
+detach_job (PlumaFindInFiles *search)
+{
+	Job *job = search->priv->job;
+
+	if (job == NULL)
+		return;
+
+	job->stopped = TRUE;
+	job->search = NULL;
+	g_cancellable_cancel (job->cancellable);
+
+	search->priv->job = NULL;
+	job_unref (job);
+}
+
+static void
+pluma_find_in_files_dispose (GObject *object)
+{
+	detach_job (PLUMA_FIND_IN_FILES (object));
+
+	G_OBJECT_CLASS (pluma_find_in_files_parent_class)->dispose (object);
+}
+
+static void
+pluma_find_in_files_class_init (PlumaFindInFilesClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->dispose = pluma_find_in_files_dispose;
+
+	/**
+	 * PlumaFindInFiles::match:
+	 * @search: a #PlumaFindInFiles
+	 * @location: the file containing the match
+	 * @line: the line of the match, starting from 0
+	 * @line_offset: the offset of the match in the line, in characters
+	 * @length: the length of the match, in characters
+	 * @text: the text of the line, possibly shortened
+	 *
+	 * The "match" signal is emitted for each line containing a match,
+	 * see pluma_document_goto_line_offset().
+	 */
+	signals[MATCH] =
+		g_signal_new ("match",
+			      G_OBJECT_CLASS_TYPE (object_class),
+			      G_SIGNAL_RUN_LAST,
+			      G_STRUCT_OFFSET (PlumaFindInFilesClass, match),
+			      NULL, NULL, NULL,
+			      G_TYPE_NONE, 5,
+			      G_TYPE_FILE,
+			      G_TYPE_INT,
+			      G_TYPE_INT,
+			      G_TYPE_INT,
+			      G_TYPE_STRING);
+
+	/**
+	 * PlumaFindInFiles::finished:
+	 * @search: a #PlumaFindInFiles
+	 *
+	 * The "finished" signal is emitted when all the files have been
+	 * searched. It is not emitted if the search is stopped.
+	 */
+	signals[FINISHED] =
+		g_signal_new ("finished",
+			      G_OBJECT_CLASS_TYPE (object_class),
+			      G_SIGNAL_RUN_LAST,
+			      G_STRUCT_OFFSET (PlumaFindInFilesClass, finished),
+			      NULL, NULL, NULL,
+			      G_TYPE_NONE, 0);
+}
+
+static void
+pluma_find_in_files_init (PlumaFindInFiles *search)
+{
+	search->priv = pluma_find_in_files_get_instance_private (search);
+}
+
+/* Ignore rules */
+
+static IgnoreList *
+read_ignore_file (const gchar *dir,
+		  const gchar *rel,
+		  IgnoreList  *parent)
+{
+	IgnoreList *list;
+	gchar *filename;
+	gchar *contents;
+	gchar **lines;
+	gint i;
+
+	filename = g_build_filename (dir, IGNORE_FILE, NULL);
+
+	if (!g_file_get_contents (filename, &contents, NULL, NULL))
+	{
+		g_free (filename);
+		return parent;
+	}
+
+	g_free (filename);
+
+	list = g_slice_new (IgnoreList);
+	list->parent = parent;
+	list->base = g_strdup (rel);
+	list->rules = g_ptr_array_new ();
+
+	lines = g_strsplit (contents, "\n", -1);
+	g_free (contents);
+
+	for (i = 0; lines[i] != NULL; i++)
+	{
+		IgnoreRule *rule;
+		gchar *pattern = g_strchomp (lines[i]);
+		gboolean dir_only = FALSE;
+		gboolean anchored = FALSE;
+		gsize len;
+
+		if (*pattern == '\0' || *pattern == '#' || *pattern == '!')
+			continue;
+
+		len = strlen (pattern);
+		if (pattern[len - 1] == '/')
+		{
+			pattern[len - 1] = '\0';
+			dir_only = TRUE;
+		}
+
+		if (g_str_has_prefix (pattern, "**/"))
+		{
+			pattern += 3;
+		}
+		else if (*pattern == '/')
+		{
+			pattern++;
+			anchored = TRUE;
+		}
+		else if (strchr (pattern, '/') != NULL)
+		{
+			anchored = TRUE;
+		}
+
+		if (*pattern == '\0')
+			continue;
+
+		rule = g_slice_new (IgnoreRule);
+		rule->spec = g_pattern_spec_new (pattern);
+		rule->anchored = anchored;
+		rule->dir_only = dir_only;
+
+		g_ptr_array_add (list->rules, rule);
+	}
+
+	g_strfreev (lines);
+
+	if (list->rules->len == 0)
+	{
+		g_ptr_array_free (list->rules, TRUE);
+		g_free (list->base);
+		g_slice_free (IgnoreList, list);
+
+		return parent;
+	}
+
+	return list;
+}
+
+static void
+ignore_list_free (IgnoreList *list)
+{
+	guint i;
+
+	for (i = 0; i < list->rules->len; i++)
+	{
+		IgnoreRule *rule = g_ptr_array_index (list->rules, i);
+
+		g_pattern_spec_free (rule->spec);
+		g_slice_free (IgnoreRule, rule);
+	}
+
+	g_ptr_array_free (list->rules, TRUE);
+	g_free (list->base);
+
+	g_slice_free (IgnoreList, list);
+}
+
+static gboolean
+is_ignored (IgnoreList  *list,
+	    const gchar *rel,
+	    const gchar *name,
+	    gboolean     is_dir)
+{
+	for (; list != NULL; list = list->parent)
+	{
+		guint i;
+
+		for (i = 0; i < list->rules->len; i++)
+		{
+			IgnoreRule *rule = g_ptr_array_index (list->rules, i);
+			const gchar *target;
+
+			if (rule->dir_only && !is_dir)
+				continue;
+
+			if (rule->anchored)
+			{
+				/* relative to the directory of the ignore file */
+				if (!g_str_has_prefix (rel, list->base))
+					continue;
+
+				target = rel + strlen (list->base);
+			}
+			else
+			{
+				target = name;
+			}
+
+			if (g_pattern_match_string (rule->spec, target))
+				return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/* Matching */
+
+static const gchar *
+find_literal (const gchar *hay,
+	      gsize        hay_len,
+	      const gchar *needle,
+	      gsize        needle_len)
+{
+	const gchar *p = hay;
+	const gchar *last;
+
+	if (needle_len > hay_len)
+		return NULL;
+
+	last = hay + hay_len - needle_len;
+
+	/* memchr is vectorized by the C library, so it is the fast path
+	 * to the candidates */
+	while (p <= last)
+	{
+		p = memchr (p, needle[0], last - p + 1);
+		if (p == NULL)
+			return NULL;
+
+		if (memcmp (p + 1, needle + 1, needle_len - 1) == 0)
+			return p;
+
+		p++;
+	}
+
+	return NULL;
+}
+
+/* @needle is lowercase ASCII */
+static const gchar *
+find_literal_caseless (const gchar *hay,
+		       gsize        hay_len,
+		       const gchar *needle,
+		       gsize        needle_len)
+{
+	const gchar *p = hay;
+	const gchar *last;
+	gchar lower;
+	gchar upper;
+
+	if (needle_len > hay_len)
+		return NULL;
+
+	last = hay + hay_len - needle_len;
+	lower = needle[0];
+	upper = g_ascii_toupper (lower);
+
+	while (p <= last)
+	{
+		const gchar *l;
+		const gchar *u;
+
+		l = memchr (p, lower, last - p + 1);
+
+		if (upper != lower)
+		{
+			u = memchr (p, upper, (l != NULL ? l : last + 1) - p);
+			if (u != NULL)
+				l = u;
+		}
+
+		p = l;
+		if (p == NULL)
+			return NULL;
+
+		if (g_ascii_strncasecmp (p + 1, needle + 1, needle_len - 1) == 0)
+			return p;
+
+		p++;
+	}
+
+	return NULL;
+}
+
+static gboolean
+find_next (Job          *job,
+	   GRegex       *regex,
+	   const gchar  *buf,
+	   gsize         len,
+	   const gchar  *pos,
+	   const gchar **m_start,
+	   const gchar **m_end)
+{
+	GMatchInfo *info;
+	gint start;
+	gint end;
+
+	if (regex == NULL)
+	{
+		const gchar *p;
+
+		if (job->literal_caseless)
+			p = find_literal_caseless (pos, buf + len - pos,
+						   job->literal, job->literal_len);
+		else
+			p = find_literal (pos, buf + len - pos,
+					  job->literal, job->literal_len);
+
+		if (p == NULL)
+			return FALSE;
+
+		*m_start = p;
+		*m_end = p + job->literal_len;
+
+		return TRUE;
+	}
+
+	if (!g_regex_match_full (regex, buf, len, pos - buf, 0, &info, NULL))
+	{
+		g_match_info_free (info);
+		return FALSE;
+	}
+
+	g_match_info_fetch_pos (info, 0, &start, &end);
+	g_match_info_free (info);
+
+	*m_start = buf + start;
+	*m_end = buf + end;
+
+	return TRUE;
+}
+
+static gint
+count_chars (const gchar *start,
+	     const gchar *end)
+{
+	if (g_utf8_validate (start, end - start, NULL))
+		return g_utf8_strlen (start, end - start);
+
+	return end - start;
+}
+
+static gchar *
+get_line_text (const gchar *line_start,
+	       const gchar *line_end,
+	       const gchar *m_start)
+{
+	const gchar *start = line_start;
+	const gchar *end;
+	gchar *text;
+
+	/* keep the context around the match in very long lines */
+	if (m_start - start > MAX_LINE_LENGTH / 2)
+	{
+		start = m_start - MAX_LINE_LENGTH / 2;
+		while (start < m_start && (*start & 0xc0) == 0x80)
+			start++;
+	}
+
+	end = line_end;
+	if (end - start > MAX_LINE_LENGTH)
+	{
+		end = start + MAX_LINE_LENGTH;
+		while (end > start && (*end & 0xc0) == 0x80)
+			end--;
+	}
+
+	if (end > start && end[-1] == '\r')
+		end--;
+
+	text = g_strndup (start, end - start);
+
+	if (!g_utf8_validate (text, -1, NULL))
+	{
+		gchar *valid;
+
+		valid = pluma_utils_make_valid_utf8 (text);
+		g_free (text);
+		text = valid;
+	}
+
+	return text;
+}
+
+static GArray *
+search_buffer (Job         *job,
+	       const gchar *buf,
+	       gsize        len)
+{
+	GArray *matches = NULL;
+	GRegex *regex = NULL;
+	const gchar *end = buf + len;
+	const gchar *pos = buf;
+	const gchar *line_start = buf;
+	gint line = 0;
+
+	if (job->regex != NULL)
+	{
+		regex = g_utf8_validate (buf, len, NULL) ? job->regex : job->raw_regex;
+
+		if (regex == NULL)
+			return NULL;
+	}
+
+	while (pos < end && !g_cancellable_is_cancelled (job->cancellable))
+	{
+		const gchar *m_start;
+		const gchar *m_end;
+		const gchar *line_end;
+		const gchar *nl;
+		Match match;
+
+		if (!find_next (job, regex, buf, len, pos, &m_start, &m_end))
+			break;
+
+		/* count the lines up to the match */
+		while ((nl = memchr (pos, '\n', m_start - pos)) != NULL)
+		{
+			line++;
+			pos = nl + 1;
+		}
+		line_start = pos;
+
+		line_end = memchr (m_start, '\n', end - m_start);
+		if (line_end == NULL)
+			line_end = end;
+
+		if (g_atomic_int_add (&job->n_matches, 1) >= MAX_MATCHES)
+		{
+			g_atomic_int_set (&job->truncated, TRUE);
+			g_cancellable_cancel (job->cancellable);
+			break;
+		}
+
+		match.line = line;
+		match.line_offset = count_chars (line_start, m_start);
+		match.length = count_chars (m_start, MIN (m_end, line_end));
+		match.text = get_line_text (line_start, line_end, m_start);
+
+		if (matches == NULL)
+			matches = g_array_new (FALSE, FALSE, sizeof (Match));
+		g_array_append_val (matches, match);
+
+		/* at most one match per line */
+		line++;
+		pos = line_end + 1;
+	}
+
+	return matches;
+}
+
+/* Threads */
+
+static gboolean
+flush_results (Job *job)
+{
+	PlumaFindInFiles *search;
+	GPtrArray *results;
+	gboolean done;
+	guint i;
+	guint j;
+
+	g_mutex_lock (&job->lock);
+	results = job->results;
+	job->results = g_ptr_array_new_with_free_func ((GDestroyNotify) file_matches_free);
+	job->flush_scheduled = FALSE;
+	done = job->done;
+	g_mutex_unlock (&job->lock);
+
+	search = job->search;
+	if (search == NULL)
+	{
+		g_ptr_array_free (results, TRUE);
+		return FALSE;
+	}
+
+	g_object_ref (search);
+
+	/* a handler may stop the search */
+	for (i = 0; i < results->len && !job->stopped; i++)
+	{
+		FileMatches *fm = g_ptr_array_index (results, i);
+		GFile *location;
+
+		location = g_file_new_for_path (fm->path);
+
+		for (j = 0; j < fm->matches->len && !job->stopped; j++)
+		{
+			Match *m = &g_array_index (fm->matches, Match, j);
+
+			g_signal_emit (search,
+				       signals[MATCH],
+				       0,
+				       location,
+				       m->line,
+				       m->line_offset,
+				       m->length,
+				       m->text);
+		}
+
+		g_object_unref (location);
+	}
+
+	if (done && !job->stopped)
+	{
+		job->finished = TRUE;
+		g_signal_emit (search, signals[FINISHED], 0);
+	}
+
+	g_object_unref (search);
+	g_ptr_array_free (results, TRUE);
+
+	return FALSE;
+}
+
+static void
+schedule_flush (Job      *job,
+		gboolean  now)
+{
+	/* called with the lock held */
+	if (job->flush_scheduled)
+		return;
+
+	job->flush_scheduled = TRUE;
+
+	if (now)
+		g_idle_add_full (G_PRIORITY_DEFAULT_IDLE,
+				 (GSourceFunc) flush_results,
+				 job_ref (job),
+				 (GDestroyNotify) job_unref);
+	else
+		g_timeout_add_full (G_PRIORITY_DEFAULT_IDLE,
+				    FLUSH_INTERVAL,
+				    (GSourceFunc) flush_results,
+				    job_ref (job),
+				    (GDestroyNotify) job_unref);
+}
+
+static void
+scan_file (gchar *path,
+	   Job   *job)
+{
+	GMappedFile *mapped;
+	GArray *matches = NULL;
+	FileMatches *fm;
+	const gchar *buf;
+	gsize len;
+
+	if (g_cancellable_is_cancelled (job->cancellable))
+	{
+		g_free (path);
+		return;
+	}
+
+	mapped = g_mapped_file_new (path, FALSE, NULL);
+	if (mapped == NULL)
+	{
+		g_free (path);
+		return;
+	}
+
+	g_atomic_int_inc (&job->n_files);
+
+	buf = g_mapped_file_get_contents (mapped);
+	len = g_mapped_file_get_length (mapped);
+
+	/* skip binary files */
+	if (len > 0 && memchr (buf, '\0', MIN (len, BINARY_CHECK_SIZE)) == NULL)
+		matches = search_buffer (job, buf, len);
+
+	g_mapped_file_unref (mapped);
+
+	if (matches == NULL)
+	{
+		g_free (path);
+		return;
+	}
+
+	fm = g_slice_new (FileMatches);
+	fm->path = path;
+	fm->matches = matches;
+
+	g_mutex_lock (&job->lock);
+	g_ptr_array_add (job->results, fm);
+	schedule_flush (job, FALSE);
+	g_mutex_unlock (&job->lock);
+}
+
+static void
+walk_dir (Job         *job,
+	  GThreadPool *pool,
+	  PendingDir  *pending,
+	  GQueue      *dirs,
+	  GPtrArray   *ignore_lists)
+{
+	IgnoreList *ignore;
+	GDir *dir;
+	gchar *path;
+	const gchar *name;
+
+	path = g_build_filename (job->root, pending->rel, NULL);
+
+	dir = g_dir_open (path, 0, NULL);
+	if (dir == NULL)
+	{
+		g_free (path);
+		return;
+	}
+
+	ignore = read_ignore_file (path, pending->rel, pending->ignore);
+	if (ignore != pending->ignore)
+		g_ptr_array_add (ignore_lists, ignore);
+
+	while ((name = g_dir_read_name (dir)) != NULL)
+	{
+		GStatBuf st;
+		gchar *filename;
+		gchar *rel;
+		gboolean is_dir;
+
+		/* like the file index, skip hidden and backup files */
+		if (name[0] == '.' || g_str_has_suffix (name, "~"))
+			continue;
+
+		filename = g_build_filename (path, name, NULL);
+
+		/* do not follow the links to directories, they can loop */
+		if (g_lstat (filename, &st) != 0 ||
+		    (S_ISLNK (st.st_mode) &&
+		     (g_stat (filename, &st) != 0 || S_ISDIR (st.st_mode))))
+		{
+			g_free (filename);
+			continue;
+		}
+
+		is_dir = S_ISDIR (st.st_mode);
+		rel = g_strconcat (pending->rel, name, NULL);
+
+		if (is_ignored (ignore, rel, name, is_dir))
+		{
+			g_free (rel);
+			g_free (filename);
+			continue;
+		}
+
+		if (is_dir)
+		{
+			PendingDir *sub;
+
+			sub = g_slice_new (PendingDir);
+			sub->rel = g_strconcat (rel, "/", NULL);
+			sub->ignore = ignore;
+
+			g_queue_push_tail (dirs, sub);
+			g_free (filename);
+		}
+		else if (S_ISREG (st.st_mode) &&
+			 st.st_size > 0 && st.st_size <= MAX_FILE_SIZE)
+		{
+			g_thread_pool_push (pool, filename, NULL);
+		}
+		else
+		{
+			g_free (filename);
+		}
+
+		g_free (rel);
+	}
+
+	g_dir_close (dir);
+	g_free (path);
+}
+
+static gpointer
+walk_thread (Job *job)
+{
+	GThreadPool *pool;
+	GQueue dirs = G_QUEUE_INIT;
+	GPtrArray *ignore_lists;
+	PendingDir *pending;
+
+	pool = g_thread_pool_new ((GFunc) scan_file,
+				  job,
+				  g_get_num_processors (),
+				  FALSE,
+				  NULL);
+
+	ignore_lists = g_ptr_array_new_with_free_func ((GDestroyNotify) ignore_list_free);
+
+	pending = g_slice_new (PendingDir);
+	pending->rel = g_strdup ("");
+	pending->ignore = NULL;
+	g_queue_push_tail (&dirs, pending);
+
+	while ((pending = g_queue_pop_head (&dirs)) != NULL)
+	{
+		if (!g_cancellable_is_cancelled (job->cancellable))
+			walk_dir (job, pool, pending, &dirs, ignore_lists);
+
+		g_free (pending->rel);
+		g_slice_free (PendingDir, pending);
+	}
+
+	/* wait for the workers, the queued files are skipped quickly
+	 * when the search has been cancelled */
+	g_thread_pool_free (pool, FALSE, TRUE);
+
+	g_ptr_array_free (ignore_lists, TRUE);
+
+	g_mutex_lock (&job->lock);
+	job->done = TRUE;
+	schedule_flush (job, TRUE);
+	g_mutex_unlock (&job->lock);
+
+	job_unref (job);
+
+	return NULL;
+}
+
+static gboolean
+is_ascii (const gchar *str)
+{
+	for (; *str != '\0'; str++)
+	{
+		if ((guchar) *str >= 0x80)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+static gboolean
+compile_pattern (Job          *job,
+		 const gchar  *pattern,
+		 guint         flags,
+		 GError      **error)
+{
+	GRegexCompileFlags compile_flags;
+	gchar *regex;
+
+	if (!PLUMA_SEARCH_IS_MATCH_REGEX (flags) &&
+	    !PLUMA_SEARCH_IS_ENTIRE_WORD (flags) &&
+	    (PLUMA_SEARCH_IS_CASE_SENSITIVE (flags) || is_ascii (pattern)))
+	{
+		job->literal_caseless = !PLUMA_SEARCH_IS_CASE_SENSITIVE (flags);
+		job->literal = job->literal_caseless ?
+			       g_ascii_strdown (pattern, -1) : g_strdup (pattern);
+		job->literal_len = strlen (job->literal);
+
+		return TRUE;
+	}
+
+	if (PLUMA_SEARCH_IS_MATCH_REGEX (flags))
+		regex = g_strdup (pattern);
+	else
+		regex = g_regex_escape_string (pattern, -1);
+
+	if (PLUMA_SEARCH_IS_ENTIRE_WORD (flags))
+	{
+		gchar *tmp = regex;
+
+		regex = g_strdup_printf ("\\b(?:%s)\\b", tmp);
+		g_free (tmp);
+	}
+
+	compile_flags = G_REGEX_MULTILINE | G_REGEX_OPTIMIZE;
+	if (!PLUMA_SEARCH_IS_CASE_SENSITIVE (flags))
+		compile_flags |= G_REGEX_CASELESS;
+
+	job->regex = g_regex_new (regex, compile_flags, 0, error);
+	if (job->regex != NULL)
+		job->raw_regex = g_regex_new (regex, compile_flags | G_REGEX_RAW, 0, NULL);
+
+	g_free (regex);
+
+	return job->regex != NULL;
+}
+
+/**
+ * pluma_find_in_files_new:
+ *
+ * Returns: (transfer full): a new #PlumaFindInFiles
+ */
+PlumaFindInFiles *
+pluma_find_in_files_new (void)
+{
+	return g_object_new (PLUMA_TYPE_FIND_IN_FILES, NULL);
+}
+
+/**
+ * pluma_find_in_files_start:
+ * @search: a #PlumaFindInFiles
+ * @root: a local directory
+ * @pattern: the text to search
+ * @flags: the #PlumaSearchFlags
+ * @error: return location for a #GError, or %NULL
+ *
+ * Starts searching @pattern in the files below @root, stopping the
+ * current search if any.
+ *
+ * Returns: %FALSE if @root is not local or @pattern is not a valid
+ * regular expression.
+ */
+gboolean
+pluma_find_in_files_start (PlumaFindInFiles  *search,
+			   GFile             *root,
+			   const gchar       *pattern,
+			   guint              flags,
+			   GError           **error)
+{
+	GThread *thread;
+	Job *job;
+	gchar *path;
+
+	g_return_val_if_fail (PLUMA_IS_FIND_IN_FILES (search), FALSE);
+	g_return_val_if_fail (G_IS_FILE (root), FALSE);
+	g_return_val_if_fail (pattern != NULL && *pattern != '\0', FALSE);
+
+	path = g_file_get_path (root);
+	if (path == NULL)
+	{
+		g_set_error_literal (error,
+				     G_IO_ERROR,
+				     G_IO_ERROR_NOT_SUPPORTED,
+				     _("Only local folders can be searched"));
+		return FALSE;
+	}
+
+	job = g_slice_new0 (Job);
+	job->ref_count = 1;
+	job->root = path;
+	job->cancellable = g_cancellable_new ();
+	job->results = g_ptr_array_new_with_free_func ((GDestroyNotify) file_matches_free);
+	g_mutex_init (&job->lock);
+
+	if (!compile_pattern (job, pattern, flags, error))
+	{
+		job_unref (job);
+		return FALSE;
+	}
+
+	detach_job (search);
+
+	pluma_debug_message (DEBUG_SEARCH, "Searching '%s' in %s", pattern, path);
+
+	thread = g_thread_try_new ("pluma-find-in-files",
+				   (GThreadFunc) walk_thread,
+				   job_ref (job),
+				   error);
+	if (thread == NULL)
+	{
+		job_unref (job);
+		job_unref (job);
+		return FALSE;
+	}
+
+	g_thread_unref (thread);
+
+	job->search = search;
+	search->priv->job = job;
+
+	return TRUE;
+}
+
+/**
+ * pluma_find_in_files_stop:
+ * @search: a #PlumaFindInFiles
+ *
+ * Stops the current search. No more signals are emitted for it.
+ */
+void
+pluma_find_in_files_stop (PlumaFindInFiles *search)
+{
+	g_return_if_fail (PLUMA_IS_FIND_IN_FILES (search));
+
+	if (search->priv->job == NULL)
+		return;
+
+	search->priv->job->stopped = TRUE;
+	g_cancellable_cancel (search->priv->job->cancellable);
+}
+
+gboolean
+pluma_find_in_files_is_running (PlumaFindInFiles *search)
+{
+	g_return_val_if_fail (PLUMA_IS_FIND_IN_FILES (search), FALSE);
+
+	return search->priv->job != NULL &&
+	       !search->priv->job->stopped &&
+	       !search->priv->job->finished;
+}
+
+/**
+ * pluma_find_in_files_get_n_files:
+ * @search: a #PlumaFindInFiles
+ *
+ * Returns: the number of files searched so far by the last search
+ */
+guint
+pluma_find_in_files_get_n_files (PlumaFindInFiles *search)
+{
+	g_return_val_if_fail (PLUMA_IS_FIND_IN_FILES (search), 0);
+
+	if (search->priv->job == NULL)
+		return 0;
+
+	return g_atomic_int_get (&search->priv->job->n_files);
+}
+
+/**
+ * pluma_find_in_files_get_n_matches:
+ * @search: a #PlumaFindInFiles
+ *
+ * Returns: the number of matching lines found so far by the last search
+ */
+guint
+pluma_find_in_files_get_n_matches (PlumaFindInFiles *search)
+{
+	g_return_val_if_fail (PLUMA_IS_FIND_IN_FILES (search), 0);
+
+	if (search->priv->job == NULL)
+		return 0;
+
+	return MIN (g_atomic_int_get (&search->priv->job->n_matches), MAX_MATCHES);
+}
+
+/**
+ * pluma_find_in_files_get_truncated:
+ * @search: a #PlumaFindInFiles
+ *
+ * Returns: %TRUE if the last search stopped because it found too
+ * many matches
+ */
+gboolean
+pluma_find_in_files_get_truncated (PlumaFindInFiles *search)
+{
+	g_return_val_if_fail (PLUMA_IS_FIND_IN_FILES (search), FALSE);
+
+	if (search->priv->job == NULL)
+		return FALSE;
+
+	return g_atomic_int_get (&search->priv->job->truncated);
+}
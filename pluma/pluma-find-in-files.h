@@ -0,0 +1,78 @@
+/*
+ * pluma-find-in-files.h
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PLUMA_FIND_IN_FILES_H__
+#define __PLUMA_FIND_IN_FILES_H__
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define PLUMA_TYPE_FIND_IN_FILES		(pluma_find_in_files_get_type ())
+#define PLUMA_FIND_IN_FILES(obj)		(G_TYPE_CHECK_INSTANCE_CAST ((obj), PLUMA_TYPE_FIND_IN_FILES, PlumaFindInFiles))
+#define PLUMA_FIND_IN_FILES_CLASS(klass)	(G_TYPE_CHECK_CLASS_CAST ((klass), PLUMA_TYPE_FIND_IN_FILES, PlumaFindInFilesClass))
+#define PLUMA_IS_FIND_IN_FILES(obj)		(G_TYPE_CHECK_INSTANCE_TYPE ((obj), PLUMA_TYPE_FIND_IN_FILES))
+#define PLUMA_IS_FIND_IN_FILES_CLASS(klass)	(G_TYPE_CHECK_CLASS_TYPE ((klass), PLUMA_TYPE_FIND_IN_FILES))
+#define PLUMA_FIND_IN_FILES_GET_CLASS(obj)	(G_TYPE_INSTANCE_GET_CLASS ((obj), PLUMA_TYPE_FIND_IN_FILES, PlumaFindInFilesClass))
+
+typedef struct _PlumaFindInFiles		PlumaFindInFiles;
+typedef struct _PlumaFindInFilesClass		PlumaFindInFilesClass;
+typedef struct _PlumaFindInFilesPrivate		PlumaFindInFilesPrivate;
+
+struct _PlumaFindInFiles {
+	GObject parent;
+
+	PlumaFindInFilesPrivate *priv;
+};
+
+struct _PlumaFindInFilesClass {
+	GObjectClass parent_class;
+
+	/* Signals */
+	void (*match)		(PlumaFindInFiles *search,
+				 GFile            *location,
+				 gint              line,
+				 gint              line_offset,
+				 gint              length,
+				 const gchar      *text);
+	void (*finished)	(PlumaFindInFiles *search);
+};
+
+GType			 pluma_find_in_files_get_type		(void) G_GNUC_CONST;
+
+PlumaFindInFiles	*pluma_find_in_files_new		(void);
+
+gboolean		 pluma_find_in_files_start		(PlumaFindInFiles *search,
+								 GFile            *root,
+								 const gchar      *pattern,
+								 guint             flags,
+								 GError          **error);
+void			 pluma_find_in_files_stop		(PlumaFindInFiles *search);
+
+gboolean		 pluma_find_in_files_is_running		(PlumaFindInFiles *search);
+guint			 pluma_find_in_files_get_n_files	(PlumaFindInFiles *search);
+guint			 pluma_find_in_files_get_n_matches	(PlumaFindInFiles *search);
+gboolean		 pluma_find_in_files_get_truncated	(PlumaFindInFiles *search);
+
+G_END_DECLS
+
+#endif /* __PLUMA_FIND_IN_FILES_H__ */
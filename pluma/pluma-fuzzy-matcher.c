@@ -0,0 +1,299 @@
+/*
+ * pluma-fuzzy-matcher.c
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Subsequence matching of a query against file paths, ranked like fzy:
+ * every query character has to appear in the candidate in order, and the
+ * score rewards consecutive characters and characters at the start of a
+ * path component, a word or a camelCase hump, while gaps cost a little.
+ *
+ * Matching is case insensitive for ASCII only, other characters have to
+ * match exactly. Candidates are first rejected with a 64 bit mask of the
+ * characters they contain, which is precomputed by the caller.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+
+#include "pluma-fuzzy-matcher.h"
+
+#define MAX_QUERY_LEN		64
+#define MAX_CANDIDATE_LEN	1024
+
+#define SCORE_MIN		(-(1 << 28))
+
+#define SCORE_GAP_LEADING	-5
+#define SCORE_GAP_TRAILING	-5
+#define SCORE_GAP_INNER		-10
+#define SCORE_MATCH_CONSECUTIVE	1000
+#define SCORE_MATCH_SLASH	900
+#define SCORE_MATCH_WORD	800
+#define SCORE_MATCH_CAPITAL	700
+#define SCORE_MATCH_DOT		600
+
+struct _PlumaFuzzyMatcher
+{
+	gchar *query;	/* ASCII lower case */
+	gsize len;
+	guint64 mask;
+
+	/* Rows of the scoring matrices, reused between candidates */
+	gint *bonus;
+	gint *d_prev;
+	gint *d_cur;
+	gint *m_prev;
+	gint *m_cur;
+};
+
+static inline guint
+char_bit (guchar c)
+{
+	c = g_ascii_tolower (c);
+
+	if (c >= 'a' && c <= 'z')
+		return c - 'a';
+
+	if (c >= '0' && c <= '9')
+		return 26 + (c - '0');
+
+	/* Everything else shares the remaining bits */
+	return 36 + (c % 28);
+}
+
+/**
+ * pluma_fuzzy_matcher_get_char_mask:
+ * @str: a string
+ *
+ * Computes the character mask of @str used to quickly reject candidates.
+ * Callers matching the same candidates many times should compute it once.
+ *
+ * Returns: the character mask of @str.
+ */
+guint64
+pluma_fuzzy_matcher_get_char_mask (const gchar *str)
+{
+	guint64 mask = 0;
+
+	for (; *str != '\0'; ++str)
+		mask |= G_GUINT64_CONSTANT (1) << char_bit (*str);
+
+	return mask;
+}
+
+PlumaFuzzyMatcher *
+pluma_fuzzy_matcher_new (const gchar *query)
+{
+	PlumaFuzzyMatcher *matcher;
+
+	g_return_val_if_fail (query != NULL, NULL);
+
+	matcher = g_slice_new0 (PlumaFuzzyMatcher);
+
+	matcher->query = g_ascii_strdown (query, -1);
+	matcher->len = strlen (matcher->query);
+	matcher->mask = pluma_fuzzy_matcher_get_char_mask (matcher->query);
+
+	if (matcher->len <= MAX_QUERY_LEN)
+	{
+		matcher->bonus = g_new (gint, MAX_CANDIDATE_LEN);
+		matcher->d_prev = g_new (gint, MAX_CANDIDATE_LEN);
+		matcher->d_cur = g_new (gint, MAX_CANDIDATE_LEN);
+		matcher->m_prev = g_new (gint, MAX_CANDIDATE_LEN);
+		matcher->m_cur = g_new (gint, MAX_CANDIDATE_LEN);
+	}
+
+	return matcher;
+}
+
+void
+pluma_fuzzy_matcher_free (PlumaFuzzyMatcher *matcher)
+{
+	if (matcher == NULL)
+		return;
+
+	g_free (matcher->query);
+	g_free (matcher->bonus);
+	g_free (matcher->d_prev);
+	g_free (matcher->d_cur);
+	g_free (matcher->m_prev);
+	g_free (matcher->m_cur);
+
+	g_slice_free (PlumaFuzzyMatcher, matcher);
+}
+
+static gint
+compute_bonus (gchar prev,
+	       gchar c)
+{
+	if (prev == '/')
+		return SCORE_MATCH_SLASH;
+
+	if (prev == '-' || prev == '_' || prev == ' ')
+		return SCORE_MATCH_WORD;
+
+	if (prev == '.')
+		return SCORE_MATCH_DOT;
+
+	if (g_ascii_islower (prev) && g_ascii_isupper (c))
+		return SCORE_MATCH_CAPITAL;
+
+	return 0;
+}
+
+static gboolean
+is_subsequence (const gchar *query,
+		const gchar *candidate)
+{
+	for (; *query != '\0'; ++candidate)
+	{
+		if (*candidate == '\0')
+			return FALSE;
+
+		if (g_ascii_tolower (*candidate) == *query)
+			++query;
+	}
+
+	return TRUE;
+}
+
+static gint
+compute_score (PlumaFuzzyMatcher *matcher,
+	       const gchar       *candidate,
+	       gsize              n)
+{
+	gsize m = matcher->len;
+	gsize i;
+	gsize j;
+	gint *tmp;
+	gchar prev = '/';
+
+	/* The start of the candidate counts as the start of a component */
+	for (j = 0; j < n; ++j)
+	{
+		matcher->bonus[j] = compute_bonus (prev, candidate[j]);
+		prev = candidate[j];
+	}
+
+	for (i = 0; i < m; ++i)
+	{
+		gint prev_score = SCORE_MIN;
+		gint gap_score = i == m - 1 ? SCORE_GAP_TRAILING : SCORE_GAP_INNER;
+		gchar q = matcher->query[i];
+
+		for (j = 0; j < n; ++j)
+		{
+			if (g_ascii_tolower (candidate[j]) == q)
+			{
+				gint score = SCORE_MIN;
+
+				if (i == 0)
+				{
+					score = (gint) j * SCORE_GAP_LEADING + matcher->bonus[j];
+				}
+				else if (j > 0)
+				{
+					score = MAX (matcher->m_prev[j - 1] + matcher->bonus[j],
+						     matcher->d_prev[j - 1] + SCORE_MATCH_CONSECUTIVE);
+				}
+
+				matcher->d_cur[j] = score;
+				prev_score = MAX (score, prev_score + gap_score);
+			}
+			else
+			{
+				matcher->d_cur[j] = SCORE_MIN;
+				prev_score = prev_score + gap_score;
+			}
+
+			/* Keep unreachable cells from wrapping around */
+			prev_score = MAX (prev_score, SCORE_MIN);
+			matcher->m_cur[j] = prev_score;
+		}
+
+		tmp = matcher->d_prev;
+		matcher->d_prev = matcher->d_cur;
+		matcher->d_cur = tmp;
+
+		tmp = matcher->m_prev;
+		matcher->m_prev = matcher->m_cur;
+		matcher->m_cur = tmp;
+	}
+
+	return matcher->m_prev[n - 1];
+}
+
+/**
+ * pluma_fuzzy_matcher_match:
+ * @matcher: a #PlumaFuzzyMatcher
+ * @candidate: the string to match
+ * @char_mask: the character mask of @candidate
+ * @score: (out) (optional): return location for the score
+ *
+ * Matches @candidate against the query of @matcher. Higher scores are
+ * better matches. Candidates too long to be scored get the lowest score.
+ *
+ * Returns: %TRUE if all the characters of the query appear in @candidate.
+ */
+gboolean
+pluma_fuzzy_matcher_match (PlumaFuzzyMatcher *matcher,
+			   const gchar       *candidate,
+			   guint64            char_mask,
+			   gint              *score)
+{
+	gsize n;
+
+	g_return_val_if_fail (matcher != NULL, FALSE);
+	g_return_val_if_fail (candidate != NULL, FALSE);
+
+	if ((char_mask & matcher->mask) != matcher->mask)
+		return FALSE;
+
+	if (!is_subsequence (matcher->query, candidate))
+		return FALSE;
+
+	if (score == NULL)
+		return TRUE;
+
+	n = strlen (candidate);
+
+	if (matcher->len == 0 ||
+	    matcher->len > MAX_QUERY_LEN ||
+	    n > MAX_CANDIDATE_LEN)
+	{
+		*score = SCORE_MIN;
+		return TRUE;
+	}
+
+	if (matcher->len == n)
+	{
+		/* Only possible when the candidate is the query */
+		*score = G_MAXINT;
+		return TRUE;
+	}
+
+	*score = compute_score (matcher, candidate, n);
+
+	return TRUE;
+}
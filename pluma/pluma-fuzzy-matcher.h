@@ -0,0 +1,44 @@
+/*
+ * pluma-fuzzy-matcher.h
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PLUMA_FUZZY_MATCHER_H__
+#define __PLUMA_FUZZY_MATCHER_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _PlumaFuzzyMatcher PlumaFuzzyMatcher;
+
+PlumaFuzzyMatcher	*pluma_fuzzy_matcher_new		(const gchar       *query);
+void			 pluma_fuzzy_matcher_free		(PlumaFuzzyMatcher *matcher);
+
+guint64			 pluma_fuzzy_matcher_get_char_mask	(const gchar       *str);
+
+gboolean		 pluma_fuzzy_matcher_match		(PlumaFuzzyMatcher *matcher,
+								 const gchar       *candidate,
+								 guint64            char_mask,
+								 gint              *score);
+
+G_END_DECLS
+
+#endif /* __PLUMA_FUZZY_MATCHER_H__ */
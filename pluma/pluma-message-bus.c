@@ -4,6 +4,11 @@
 #include <stdarg.h>
 #include <gobject/gvaluecollector.h>
 
+/* Maximum time spent delivering queued messages in one go, in microseconds */
+#define DISPATCH_TIME_BUDGET	5000
+
+#define DEFAULT_MAX_QUEUED	1024
+
 /**
  * PlumaMessageCallback:
  * @bus: the #PlumaMessageBus on which the message was sent
@@ -15,6 +20,27 @@
  *
  */
 
+/**
+ * PlumaMessageBusPriority:
+ * @PLUMA_MESSAGE_BUS_PRIORITY_HIGH: delivered before any other queued message
+ * @PLUMA_MESSAGE_BUS_PRIORITY_DEFAULT: the default priority
+ * @PLUMA_MESSAGE_BUS_PRIORITY_LOW: delivered once no other message is queued
+ *
+ * The priority with which asynchronously sent messages of a message type
+ * are delivered.
+ */
+
+/**
+ * PlumaMessageBusDelivery:
+ * @PLUMA_MESSAGE_BUS_DELIVERY_QUEUE: every message is delivered
+ * @PLUMA_MESSAGE_BUS_DELIVERY_COALESCE: a message replaces the pending
+ * message of the same type, only the last value is delivered
+ * @PLUMA_MESSAGE_BUS_DELIVERY_DROPPABLE: the message is dropped when the
+ * queue is full
+ *
+ * How asynchronously sent messages of a message type are queued.
+ */
+
 /**
  * SECTION:pluma-message-bus
  * @short_description: internal message communication bus
@@ -92,10 +118,14 @@
 
 typedef struct
 {
-	gchar *object_path;
-	gchar *method;
-
-	GList *listeners;
+	GQuark id;
+
+	/* Listener structs in connection order. While the message is being
+	 * dispatched, disconnected listeners only get their callback cleared
+	 * and are compacted away once the dispatch is done. */
+	GArray *listeners;
+	guint n_removed;
+	guint dispatch_depth;
 } Message;
 
 typedef struct
@@ -110,21 +140,46 @@ typedef struct
 
 typedef struct
 {
-	Message *message;
-	GList *listener;
-} IdMap;
+	PlumaMessageBusPriority priority;
+	PlumaMessageBusDelivery delivery;
+
+	/* queue link of the pending message of a coalescing type */
+	GList *pending;
+} Delivery;
+
+typedef struct
+{
+	PlumaMessage *message;
+	Delivery *delivery;
+	gint64 queued_time;
+} QueuedMessage;
+
+#define N_PRIORITIES (PLUMA_MESSAGE_BUS_PRIORITY_LOW + 1)
 
 struct _PlumaMessageBusPrivate
 {
-	GHashTable *messages;
-	GHashTable *idmap;
+	GHashTable *messages; /* mapping from message type id to Message */
+	GHashTable *idmap; /* mapping from listener id to Message */
+
+	GQueue queues[N_PRIORITIES];
+	guint n_queued;
+	guint max_queued;
+	GHashTable *deliveries; /* mapping from message type id to Delivery */
 
-	GList *message_queue;
 	guint idle_id;
+	gint idle_priority;
+
+	/* statistics */
+	guint max_queue_depth;
+	guint64 n_dispatched;
+	guint64 n_coalesced;
+	guint64 n_dropped;
+	gint64 total_latency;
+	gint64 max_latency;
 
 	guint next_id;
 
-	GHashTable *types; /* mapping from identifier to PlumaMessageType */
+	GHashTable *types; /* mapping from message type id to PlumaMessageType */
 };
 
 /* signals */
@@ -136,6 +191,19 @@ enum
 	LAST_SIGNAL
 };
 
+enum
+{
+	PROP_0,
+	PROP_QUEUE_DEPTH,
+	PROP_MAX_QUEUE_DEPTH,
+	PROP_MAX_QUEUED,
+	PROP_N_DISPATCHED,
+	PROP_N_COALESCED,
+	PROP_N_DROPPED,
+	PROP_AVERAGE_LATENCY,
+	PROP_MAX_LATENCY
+};
+
 static guint message_bus_signals[LAST_SIGNAL] = { 0 };
 
 static void pluma_message_bus_dispatch_real (PlumaMessageBus *bus,
@@ -144,34 +212,91 @@ static void pluma_message_bus_dispatch_real (PlumaMessageBus *bus,
 G_DEFINE_TYPE_WITH_PRIVATE (PlumaMessageBus, pluma_message_bus, G_TYPE_OBJECT)
 
 static void
-listener_free (Listener *listener)
+listener_clear (Listener *listener)
 {
-	if (listener->destroy_data)
+	if (listener->callback != NULL && listener->destroy_data)
 		listener->destroy_data (listener->userdata);
-
-	g_free (listener);
 }
 
 static void
 message_free (Message *message)
 {
-	g_free (message->method);
-	g_free (message->object_path);
+	guint i;
 
-	g_list_free_full (message->listeners, (GDestroyNotify) listener_free);
+	for (i = 0; i < message->listeners->len; ++i)
+		listener_clear (&g_array_index (message->listeners, Listener, i));
 
-	g_free (message);
+	g_array_free (message->listeners, TRUE);
+	g_slice_free (Message, message);
+}
+
+/* Quark of pluma_message_type_identifier (object_path, method), the
+ * identifier is built on the stack for the common, short, ones */
+static GQuark
+identifier_quark (const gchar *object_path,
+		  const gchar *method,
+		  gboolean     create)
+{
+	gchar buffer[256];
+	gchar *identifier;
+	gsize path_len;
+	gsize method_len;
+	GQuark id;
+
+	path_len = strlen (object_path);
+	method_len = strlen (method);
+
+	if (path_len + method_len + 2 <= sizeof (buffer))
+	{
+		identifier = buffer;
+
+		memcpy (identifier, object_path, path_len);
+		identifier[path_len] = '.';
+		memcpy (identifier + path_len + 1, method, method_len + 1);
+	}
+	else
+	{
+		identifier = pluma_message_type_identifier (object_path, method);
+	}
+
+	id = create ? g_quark_from_string (identifier)
+		    : g_quark_try_string (identifier);
+
+	if (identifier != buffer)
+		g_free (identifier);
+
+	return id;
+}
+
+static void
+queued_message_free (QueuedMessage *queued)
+{
+	g_object_unref (queued->message);
+	g_slice_free (QueuedMessage, queued);
+}
+
+static void
+delivery_free (Delivery *delivery)
+{
+	g_slice_free (Delivery, delivery);
 }
 
 static void
 pluma_message_bus_finalize (GObject *object)
 {
 	PlumaMessageBus *bus = PLUMA_MESSAGE_BUS (object);
+	gint i;
 
 	if (bus->priv->idle_id != 0)
 		g_source_remove (bus->priv->idle_id);
 
-	g_list_free_full (bus->priv->message_queue, g_object_unref);
+	for (i = 0; i < N_PRIORITIES; ++i)
+	{
+		g_queue_foreach (&bus->priv->queues[i], (GFunc)queued_message_free, NULL);
+		g_queue_clear (&bus->priv->queues[i]);
+	}
+
+	g_hash_table_destroy (bus->priv->deliveries);
 
 	g_hash_table_destroy (bus->priv->messages);
 	g_hash_table_destroy (bus->priv->idmap);
@@ -180,12 +305,75 @@ pluma_message_bus_finalize (GObject *object)
 	G_OBJECT_CLASS (pluma_message_bus_parent_class)->finalize (object);
 }
 
+static void
+pluma_message_bus_get_property (GObject    *object,
+				guint       prop_id,
+				GValue     *value,
+				GParamSpec *pspec)
+{
+	PlumaMessageBus *bus = PLUMA_MESSAGE_BUS (object);
+
+	switch (prop_id)
+	{
+		case PROP_QUEUE_DEPTH:
+			g_value_set_uint (value, bus->priv->n_queued);
+			break;
+		case PROP_MAX_QUEUE_DEPTH:
+			g_value_set_uint (value, bus->priv->max_queue_depth);
+			break;
+		case PROP_MAX_QUEUED:
+			g_value_set_uint (value, bus->priv->max_queued);
+			break;
+		case PROP_N_DISPATCHED:
+			g_value_set_uint64 (value, bus->priv->n_dispatched);
+			break;
+		case PROP_N_COALESCED:
+			g_value_set_uint64 (value, bus->priv->n_coalesced);
+			break;
+		case PROP_N_DROPPED:
+			g_value_set_uint64 (value, bus->priv->n_dropped);
+			break;
+		case PROP_AVERAGE_LATENCY:
+			g_value_set_int64 (value,
+					   bus->priv->n_dispatched > 0 ?
+					   bus->priv->total_latency / (gint64) bus->priv->n_dispatched : 0);
+			break;
+		case PROP_MAX_LATENCY:
+			g_value_set_int64 (value, bus->priv->max_latency);
+			break;
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+			break;
+	}
+}
+
+static void
+pluma_message_bus_set_property (GObject      *object,
+				guint         prop_id,
+				const GValue *value,
+				GParamSpec   *pspec)
+{
+	PlumaMessageBus *bus = PLUMA_MESSAGE_BUS (object);
+
+	switch (prop_id)
+	{
+		case PROP_MAX_QUEUED:
+			bus->priv->max_queued = g_value_get_uint (value);
+			break;
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+			break;
+	}
+}
+
 static void
 pluma_message_bus_class_init (PlumaMessageBusClass *klass)
 {
 	GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
 	object_class->finalize = pluma_message_bus_finalize;
+	object_class->get_property = pluma_message_bus_get_property;
+	object_class->set_property = pluma_message_bus_set_property;
 
 	klass->dispatch = pluma_message_bus_dispatch_real;
 
@@ -247,22 +435,84 @@ pluma_message_bus_class_init (PlumaMessageBusClass *klass)
 			      G_TYPE_NONE,
 			      1,
 			      PLUMA_TYPE_MESSAGE_TYPE);
+
+	/* The statistics are not notified, they would change on every
+	 * message. Read them when needed. */
+	g_object_class_install_property (object_class, PROP_QUEUE_DEPTH,
+					 g_param_spec_uint ("queue-depth",
+							    "Queue Depth",
+							    "The number of queued messages",
+							    0, G_MAXUINT, 0,
+							    G_PARAM_READABLE |
+							    G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property (object_class, PROP_MAX_QUEUE_DEPTH,
+					 g_param_spec_uint ("max-queue-depth",
+							    "Maximum Queue Depth",
+							    "The highest number of queued messages so far",
+							    0, G_MAXUINT, 0,
+							    G_PARAM_READABLE |
+							    G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property (object_class, PROP_MAX_QUEUED,
+					 g_param_spec_uint ("max-queued",
+							    "Maximum Queued",
+							    "The number of queued messages from which on droppable messages are dropped",
+							    1, G_MAXUINT, DEFAULT_MAX_QUEUED,
+							    G_PARAM_READWRITE |
+							    G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property (object_class, PROP_N_DISPATCHED,
+					 g_param_spec_uint64 ("n-dispatched",
+							      "Dispatched",
+							      "The number of delivered queued messages",
+							      0, G_MAXUINT64, 0,
+							      G_PARAM_READABLE |
+							      G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property (object_class, PROP_N_COALESCED,
+					 g_param_spec_uint64 ("n-coalesced",
+							      "Coalesced",
+							      "The number of messages replaced by a newer message",
+							      0, G_MAXUINT64, 0,
+							      G_PARAM_READABLE |
+							      G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property (object_class, PROP_N_DROPPED,
+					 g_param_spec_uint64 ("n-dropped",
+							      "Dropped",
+							      "The number of messages dropped because the queue was full",
+							      0, G_MAXUINT64, 0,
+							      G_PARAM_READABLE |
+							      G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property (object_class, PROP_AVERAGE_LATENCY,
+					 g_param_spec_int64 ("average-latency",
+							     "Average Latency",
+							     "The average time in microseconds a message was queued",
+							     0, G_MAXINT64, 0,
+							     G_PARAM_READABLE |
+							     G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property (object_class, PROP_MAX_LATENCY,
+					 g_param_spec_int64 ("max-latency",
+							     "Maximum Latency",
+							     "The longest time in microseconds a message was queued",
+							     0, G_MAXINT64, 0,
+							     G_PARAM_READABLE |
+							     G_PARAM_STATIC_STRINGS));
 }
 
 static Message *
 message_new (PlumaMessageBus *bus,
-	     const gchar     *object_path,
-	     const gchar     *method)
+	     GQuark           id)
 {
-	Message *message = g_new (Message, 1);
+	Message *message = g_slice_new0 (Message);
 
-	message->object_path = g_strdup (object_path);
-	message->method = g_strdup (method);
-	message->listeners = NULL;
+	message->id = id;
+	message->listeners = g_array_new (FALSE, FALSE, sizeof (Listener));
 
-	g_hash_table_insert (bus->priv->messages,
-			     pluma_message_type_identifier (object_path, method),
-			     message);
+	g_hash_table_insert (bus->priv->messages, GUINT_TO_POINTER (id), message);
 	return message;
 }
 
@@ -272,22 +522,79 @@ lookup_message (PlumaMessageBus *bus,
 	       const gchar      *method,
 	       gboolean          create)
 {
-	gchar *identifier;
+	GQuark id;
 	Message *message;
 
-	identifier = pluma_message_type_identifier (object_path, method);
-	message = (Message *)g_hash_table_lookup (bus->priv->messages, identifier);
-	g_free (identifier);
+	id = identifier_quark (object_path, method, create);
+
+	if (id == 0)
+		return NULL;
+
+	message = (Message *)g_hash_table_lookup (bus->priv->messages,
+						  GUINT_TO_POINTER (id));
 
 	if (!message && !create)
 		return NULL;
 
 	if (!message)
-		message = message_new (bus, object_path, method);
+		message = message_new (bus, id);
 
 	return message;
 }
 
+static guint
+find_listener (Message *message,
+	       guint    id)
+{
+	guint i;
+
+	for (i = 0; i < message->listeners->len; ++i)
+	{
+		Listener *listener = &g_array_index (message->listeners, Listener, i);
+
+		if (listener->id == id && listener->callback != NULL)
+			return i;
+	}
+
+	return G_MAXUINT;
+}
+
+static void
+compact_listeners (PlumaMessageBus *bus,
+		   Message         *message)
+{
+	guint i;
+	guint n = 0;
+
+	if (message->dispatch_depth > 0)
+		return;
+
+	if (message->n_removed > 0)
+	{
+		for (i = 0; i < message->listeners->len; ++i)
+		{
+			Listener *listener = &g_array_index (message->listeners, Listener, i);
+
+			if (listener->callback == NULL)
+				continue;
+
+			if (n != i)
+				g_array_index (message->listeners, Listener, n) = *listener;
+
+			++n;
+		}
+
+		g_array_set_size (message->listeners, n);
+		message->n_removed = 0;
+	}
+
+	if (message->listeners->len == 0)
+	{
+		/* remove message because it does not have any listeners */
+		g_hash_table_remove (bus->priv->messages, GUINT_TO_POINTER (message->id));
+	}
+}
+
 static guint
 add_listener (PlumaMessageBus      *bus,
 	      Message		   *message,
@@ -295,69 +602,56 @@ add_listener (PlumaMessageBus      *bus,
 	      gpointer		    userdata,
 	      GDestroyNotify        destroy_data)
 {
-	Listener *listener;
-	IdMap *idmap;
+	Listener listener;
 
-	listener = g_new (Listener, 1);
-	listener->id = ++bus->priv->next_id;
-	listener->callback = callback;
-	listener->userdata = userdata;
-	listener->blocked = FALSE;
-	listener->destroy_data = destroy_data;
+	listener.id = ++bus->priv->next_id;
+	listener.callback = callback;
+	listener.userdata = userdata;
+	listener.blocked = FALSE;
+	listener.destroy_data = destroy_data;
 
-	message->listeners = g_list_append (message->listeners, listener);
+	g_array_append_val (message->listeners, listener);
 
-	idmap = g_new (IdMap, 1);
-	idmap->message = message;
-	idmap->listener = g_list_last (message->listeners);
-
-	g_hash_table_insert (bus->priv->idmap, GINT_TO_POINTER (listener->id), idmap);
-	return listener->id;
+	g_hash_table_insert (bus->priv->idmap, GINT_TO_POINTER (listener.id), message);
+	return listener.id;
 }
 
 static void
 remove_listener (PlumaMessageBus *bus,
 		 Message         *message,
-		 GList		 *listener)
+		 guint            index)
 {
-	Listener *lst;
+	Listener lst;
 
-	lst = (Listener *)listener->data;
+	lst = g_array_index (message->listeners, Listener, index);
 
 	/* remove from idmap */
-	g_hash_table_remove (bus->priv->idmap, GINT_TO_POINTER (lst->id));
-	listener_free (lst);
+	g_hash_table_remove (bus->priv->idmap, GINT_TO_POINTER (lst.id));
 
-	/* remove from list of listeners */
-	message->listeners = g_list_delete_link (message->listeners, listener);
+	/* mark as removed, the dispatch loop may still be walking the array */
+	g_array_index (message->listeners, Listener, index).callback = NULL;
+	++message->n_removed;
 
-	if (!message->listeners)
-	{
-		/* remove message because it does not have any listeners */
-		g_hash_table_remove (bus->priv->messages, message);
-	}
+	compact_listeners (bus, message);
+
+	if (lst.destroy_data)
+		lst.destroy_data (lst.userdata);
 }
 
 static void
 block_listener (PlumaMessageBus *bus,
 		Message		*message,
-		GList		*listener)
+		guint		 index)
 {
-	Listener *lst;
-
-	lst = (Listener *)listener->data;
-	lst->blocked = TRUE;
+	g_array_index (message->listeners, Listener, index).blocked = TRUE;
 }
 
 static void
 unblock_listener (PlumaMessageBus *bus,
 		  Message	  *message,
-		  GList		  *listener)
+		  guint		   index)
 {
-	Listener *lst;
-
-	lst = (Listener *)listener->data;
-	lst->blocked = FALSE;
+	g_array_index (message->listeners, Listener, index).blocked = FALSE;
 }
 
 static void
@@ -365,29 +659,38 @@ dispatch_message_real (PlumaMessageBus *bus,
 		       Message         *msg,
 		       PlumaMessage    *message)
 {
-	GList *item;
+	guint n_listeners;
+	guint i;
 
-	for (item = msg->listeners; item; item = item->next)
+	/* listeners connected while dispatching only get the next message */
+	n_listeners = msg->listeners->len;
+	++msg->dispatch_depth;
+
+	for (i = 0; i < n_listeners; ++i)
 	{
-		Listener *listener = (Listener *)item->data;
+		/* the array may be reallocated by the callbacks, so do not
+		 * keep pointers into it across calls */
+		Listener *listener = &g_array_index (msg->listeners, Listener, i);
 
-		if (!listener->blocked)
+		if (listener->callback != NULL && !listener->blocked)
 			listener->callback (bus, message, listener->userdata);
 	}
+
+	--msg->dispatch_depth;
+	compact_listeners (bus, msg);
 }
 
 static void
 pluma_message_bus_dispatch_real (PlumaMessageBus *bus,
 				 PlumaMessage    *message)
 {
-	const gchar *object_path;
-	const gchar *method;
+	PlumaMessageType *message_type;
 	Message *msg;
 
-	object_path = pluma_message_get_object_path (message);
-	method = pluma_message_get_method (message);
+	message_type = pluma_message_get_message_type (message);
 
-	msg = lookup_message (bus, object_path, method, FALSE);
+	msg = (Message *)g_hash_table_lookup (bus->priv->messages,
+					      GUINT_TO_POINTER (pluma_message_type_get_id (message_type)));
 
 	if (msg)
 		dispatch_message_real (bus, msg, message);
@@ -400,49 +703,115 @@ dispatch_message (PlumaMessageBus *bus,
 	g_signal_emit (bus, message_bus_signals[DISPATCH], 0, message);
 }
 
+static QueuedMessage *
+pop_queued_message (PlumaMessageBus *bus)
+{
+	gint i;
+
+	for (i = 0; i < N_PRIORITIES; ++i)
+	{
+		GList *link;
+		QueuedMessage *queued;
+
+		link = g_queue_pop_head_link (&bus->priv->queues[i]);
+
+		if (link == NULL)
+			continue;
+
+		queued = (QueuedMessage *)link->data;
+
+		if (queued->delivery && queued->delivery->pending == link)
+			queued->delivery->pending = NULL;
+
+		g_list_free_1 (link);
+		--bus->priv->n_queued;
+
+		return queued;
+	}
+
+	return NULL;
+}
+
+static gboolean idle_dispatch (PlumaMessageBus *bus);
+
+static void
+schedule_dispatch (PlumaMessageBus *bus,
+		   gint             priority)
+{
+	bus->priv->idle_priority = priority;
+	bus->priv->idle_id = g_idle_add_full (priority,
+					      (GSourceFunc)idle_dispatch,
+					      bus,
+					      NULL);
+}
+
 static gboolean
 idle_dispatch (PlumaMessageBus *bus)
 {
-	GList *list;
-	GList *item;
-
-	/* make sure to set idle_id to 0 first so that any new async messages
-	   will be queued properly */
-	bus->priv->idle_id = 0;
+	gint64 start;
+	gboolean ret = TRUE;
 
-	/* reverse queue to get correct delivery order */
-	list = g_list_reverse (bus->priv->message_queue);
-	bus->priv->message_queue = NULL;
+	g_object_ref (bus);
+	start = g_get_monotonic_time ();
 
-	for (item = list; item; item = item->next)
+	/* messages sent by the callbacks are delivered in the same run,
+	 * as long as there is time left */
+	do
 	{
-		PlumaMessage *msg = PLUMA_MESSAGE (item->data);
+		QueuedMessage *queued;
+		gint64 latency;
+
+		queued = pop_queued_message (bus);
+
+		if (queued == NULL)
+			break;
+
+		latency = g_get_monotonic_time () - queued->queued_time;
 
-		dispatch_message (bus, msg);
+		bus->priv->n_dispatched++;
+		bus->priv->total_latency += latency;
+		bus->priv->max_latency = MAX (bus->priv->max_latency, latency);
+
+		dispatch_message (bus, queued->message);
+		queued_message_free (queued);
+	} while (g_get_monotonic_time () - start < DISPATCH_TIME_BUDGET);
+
+	if (bus->priv->n_queued == 0)
+	{
+		bus->priv->idle_id = 0;
+		ret = FALSE;
+	}
+	else if (bus->priv->idle_priority != G_PRIORITY_DEFAULT_IDLE)
+	{
+		/* out of time: continue after pending redraws and input */
+		schedule_dispatch (bus, G_PRIORITY_DEFAULT_IDLE);
+		ret = FALSE;
 	}
 
-	g_list_free_full (list, g_object_unref);
-	return FALSE;
+	g_object_unref (bus);
+	return ret;
 }
 
-typedef void (*MatchCallback) (PlumaMessageBus *, Message *, GList *);
+typedef void (*MatchCallback) (PlumaMessageBus *, Message *, guint);
 
 static void
 process_by_id (PlumaMessageBus  *bus,
 	       guint	         id,
 	       MatchCallback     processor)
 {
-	IdMap *idmap;
+	Message *message;
+	guint index;
 
-	idmap = (IdMap *)g_hash_table_lookup (bus->priv->idmap, GINT_TO_POINTER (id));
+	message = (Message *)g_hash_table_lookup (bus->priv->idmap, GINT_TO_POINTER (id));
+	index = message != NULL ? find_listener (message, id) : G_MAXUINT;
 
-	if (idmap == NULL)
+	if (index == G_MAXUINT)
 	{
 		g_warning ("No handler registered with id `%d'", id);
 		return;
 	}
 
-	processor (bus, idmap->message, idmap->listener);
+	processor (bus, message, index);
 }
 
 static void
@@ -454,7 +823,7 @@ process_by_match (PlumaMessageBus      *bus,
 	          MatchCallback         processor)
 {
 	Message *message;
-	GList *item;
+	guint i;
 
 	message = lookup_message (bus, object_path, method, FALSE);
 
@@ -464,14 +833,14 @@ process_by_match (PlumaMessageBus      *bus,
 		return;
 	}
 
-	for (item = message->listeners; item; item = item->next)
+	for (i = 0; i < message->listeners->len; ++i)
 	{
-		Listener *listener = (Listener *)item->data;
+		Listener *listener = &g_array_index (message->listeners, Listener, i);
 
 		if (listener->callback == callback &&
 		    listener->userdata == userdata)
 		{
-			processor (bus, message, item);
+			processor (bus, message, i);
 			return;
 		}
 	}
@@ -482,22 +851,31 @@ process_by_match (PlumaMessageBus      *bus,
 static void
 pluma_message_bus_init (PlumaMessageBus *self)
 {
+	gint i;
+
 	self->priv = pluma_message_bus_get_instance_private (self);
 
-	self->priv->messages = g_hash_table_new_full (g_str_hash,
-						      g_str_equal,
-						      (GDestroyNotify)g_free,
+	self->priv->messages = g_hash_table_new_full (g_direct_hash,
+						      g_direct_equal,
+						      NULL,
 						      (GDestroyNotify)message_free);
 
-	self->priv->idmap = g_hash_table_new_full (g_direct_hash,
-	 					   g_direct_equal,
-	 					   NULL,
-	 					   (GDestroyNotify)g_free);
+	self->priv->idmap = g_hash_table_new (g_direct_hash, g_direct_equal);
 
-	self->priv->types = g_hash_table_new_full (g_str_hash,
-						   g_str_equal,
-						   (GDestroyNotify)g_free,
+	self->priv->types = g_hash_table_new_full (g_direct_hash,
+						   g_direct_equal,
+						   NULL,
 						   (GDestroyNotify)pluma_message_type_unref);
+
+	self->priv->deliveries = g_hash_table_new_full (g_direct_hash,
+							g_direct_equal,
+							NULL,
+							(GDestroyNotify)delivery_free);
+
+	for (i = 0; i < N_PRIORITIES; ++i)
+		g_queue_init (&self->priv->queues[i]);
+
+	self->priv->max_queued = DEFAULT_MAX_QUEUED;
 }
 
 /**
@@ -557,18 +935,19 @@ pluma_message_bus_lookup (PlumaMessageBus *bus,
 			  const gchar	  *object_path,
 			  const gchar	  *method)
 {
-	gchar *identifier;
-	PlumaMessageType *message_type;
+	GQuark id;
 
 	g_return_val_if_fail (PLUMA_IS_MESSAGE_BUS (bus), NULL);
 	g_return_val_if_fail (object_path != NULL, NULL);
 	g_return_val_if_fail (method != NULL, NULL);
 
-	identifier = pluma_message_type_identifier (object_path, method);
-	message_type = PLUMA_MESSAGE_TYPE (g_hash_table_lookup (bus->priv->types, identifier));
+	id = identifier_quark (object_path, method, FALSE);
 
-	g_free (identifier);
-	return message_type;
+	if (id == 0)
+		return NULL;
+
+	return PLUMA_MESSAGE_TYPE (g_hash_table_lookup (bus->priv->types,
+							GUINT_TO_POINTER (id)));
 }
 
 /**
@@ -600,7 +979,6 @@ pluma_message_bus_register (PlumaMessageBus *bus,
 			    guint	     num_optional,
 			    ...)
 {
-	gchar *identifier;
 	va_list var_args;
 	PlumaMessageType *message_type;
 
@@ -613,9 +991,6 @@ pluma_message_bus_register (PlumaMessageBus *bus,
 		return NULL;
 	}
 
-	identifier = pluma_message_type_identifier (object_path, method);
-	g_hash_table_lookup (bus->priv->types, identifier);
-
 	va_start (var_args, num_optional);
 	message_type = pluma_message_type_new_valist (object_path,
 						      method,
@@ -625,13 +1000,11 @@ pluma_message_bus_register (PlumaMessageBus *bus,
 
 	if (message_type)
 	{
-		g_hash_table_insert (bus->priv->types, identifier, message_type);
+		g_hash_table_insert (bus->priv->types,
+				     GUINT_TO_POINTER (pluma_message_type_get_id (message_type)),
+				     message_type);
 		g_signal_emit (bus, message_bus_signals[REGISTERED], 0, message_type);
 	}
-	else
-	{
-		g_free (identifier);
-	}
 
 	return message_type;
 }
@@ -641,21 +1014,19 @@ pluma_message_bus_unregister_real (PlumaMessageBus  *bus,
 				   PlumaMessageType *message_type,
 				   gboolean          remove_from_store)
 {
-	gchar *identifier;
+	gpointer id;
 
 	g_return_if_fail (PLUMA_IS_MESSAGE_BUS (bus));
 
-	identifier = pluma_message_type_identifier (pluma_message_type_get_object_path (message_type),
-						    pluma_message_type_get_method (message_type));
+	id = GUINT_TO_POINTER (pluma_message_type_get_id (message_type));
 
 	/* Keep message type alive for signal emission */
 	pluma_message_type_ref (message_type);
 
-	if (!remove_from_store || g_hash_table_remove (bus->priv->types, identifier))
+	if (!remove_from_store || g_hash_table_remove (bus->priv->types, id))
 		g_signal_emit (bus, message_bus_signals[UNREGISTERED], 0, message_type);
 
 	pluma_message_type_unref (message_type);
-	g_free (identifier);
 }
 
 /**
@@ -684,7 +1055,7 @@ typedef struct
 } UnregisterInfo;
 
 static gboolean
-unregister_each (const gchar      *identifier,
+unregister_each (gpointer          id,
 		 PlumaMessageType *message_type,
 		 UnregisterInfo   *info)
 {
@@ -742,18 +1113,11 @@ pluma_message_bus_is_registered (PlumaMessageBus	*bus,
 				 const gchar	*object_path,
 				 const gchar	*method)
 {
-	gchar *identifier;
-	gboolean ret;
-
 	g_return_val_if_fail (PLUMA_IS_MESSAGE_BUS (bus), FALSE);
 	g_return_val_if_fail (object_path != NULL, FALSE);
 	g_return_val_if_fail (method != NULL, FALSE);
 
-	identifier = pluma_message_type_identifier (object_path, method);
-	ret = g_hash_table_lookup (bus->priv->types, identifier) != NULL;
-
-	g_free(identifier);
-	return ret;
+	return pluma_message_bus_lookup (bus, object_path, method) != NULL;
 }
 
 typedef struct
@@ -763,7 +1127,7 @@ typedef struct
 } ForeachInfo;
 
 static void
-foreach_type (const gchar      *key,
+foreach_type (gpointer          id,
 	      PlumaMessageType *message_type,
 	      ForeachInfo      *info)
 {
@@ -972,19 +1336,112 @@ static void
 send_message_real (PlumaMessageBus *bus,
 		   PlumaMessage    *message)
 {
+	PlumaMessageBusPriority priority = PLUMA_MESSAGE_BUS_PRIORITY_DEFAULT;
+	QueuedMessage *queued;
+	Delivery *delivery;
+	GQueue *queue;
+	GQuark id;
+
 	if (!validate_message (message))
 	{
 		return;
 	}
 
-	bus->priv->message_queue = g_list_prepend (bus->priv->message_queue,
-						   g_object_ref (message));
+	id = pluma_message_type_get_id (pluma_message_get_message_type (message));
+	delivery = g_hash_table_lookup (bus->priv->deliveries, GUINT_TO_POINTER (id));
+
+	if (delivery != NULL)
+	{
+		priority = delivery->priority;
+
+		if (delivery->pending != NULL)
+		{
+			/* last value wins, in the place of the first one */
+			queued = (QueuedMessage *)delivery->pending->data;
+
+			g_object_unref (queued->message);
+			queued->message = g_object_ref (message);
+
+			bus->priv->n_coalesced++;
+			return;
+		}
+
+		if (delivery->delivery == PLUMA_MESSAGE_BUS_DELIVERY_DROPPABLE &&
+		    bus->priv->n_queued >= bus->priv->max_queued)
+		{
+			bus->priv->n_dropped++;
+			return;
+		}
+	}
+
+	queued = g_slice_new (QueuedMessage);
+	queued->message = g_object_ref (message);
+	queued->delivery = delivery;
+	queued->queued_time = g_get_monotonic_time ();
+
+	queue = &bus->priv->queues[priority];
+	g_queue_push_tail (queue, queued);
+
+	if (delivery != NULL && delivery->delivery == PLUMA_MESSAGE_BUS_DELIVERY_COALESCE)
+		delivery->pending = queue->tail;
+
+	bus->priv->n_queued++;
+	bus->priv->max_queue_depth = MAX (bus->priv->max_queue_depth,
+					  bus->priv->n_queued);
 
 	if (bus->priv->idle_id == 0)
-		bus->priv->idle_id = g_idle_add_full (G_PRIORITY_HIGH,
-						      (GSourceFunc)idle_dispatch,
-						      bus,
-						      NULL);
+		schedule_dispatch (bus, G_PRIORITY_HIGH);
+}
+
+/**
+ * pluma_message_bus_set_delivery:
+ * @bus: a #PlumaMessageBus
+ * @object_path: the object path
+ * @method: the method
+ * @priority: the priority of the messages
+ * @delivery: how the messages are queued
+ *
+ * Sets how messages @method at @object_path sent asynchronously are queued
+ * and in which order they are delivered. Messages are delivered by priority,
+ * and in the order in which they were sent within the same priority.
+ *
+ * Use %PLUMA_MESSAGE_BUS_DELIVERY_COALESCE for messages carrying a state,
+ * where only the last value matters, and
+ * %PLUMA_MESSAGE_BUS_DELIVERY_DROPPABLE for messages which may get lost
+ * when the queue holds #PlumaMessageBus:max-queued messages. Synchronously
+ * sent messages are not affected.
+ *
+ */
+void
+pluma_message_bus_set_delivery (PlumaMessageBus         *bus,
+				const gchar             *object_path,
+				const gchar             *method,
+				PlumaMessageBusPriority  priority,
+				PlumaMessageBusDelivery  delivery)
+{
+	Delivery *info;
+	GQuark id;
+
+	g_return_if_fail (PLUMA_IS_MESSAGE_BUS (bus));
+	g_return_if_fail (object_path != NULL);
+	g_return_if_fail (method != NULL);
+	g_return_if_fail (priority < N_PRIORITIES);
+
+	id = identifier_quark (object_path, method, TRUE);
+	info = g_hash_table_lookup (bus->priv->deliveries, GUINT_TO_POINTER (id));
+
+	/* queued messages keep pointing to it, so it is only updated */
+	if (info == NULL)
+	{
+		info = g_slice_new0 (Delivery);
+		g_hash_table_insert (bus->priv->deliveries, GUINT_TO_POINTER (id), info);
+	}
+
+	info->priority = priority;
+	info->delivery = delivery;
+
+	if (delivery != PLUMA_MESSAGE_BUS_DELIVERY_COALESCE)
+		info->pending = NULL;
 }
 
 /**
@@ -997,6 +1454,10 @@ send_message_real (PlumaMessageBus *bus,
  * convenience function pluma_message_bus_send() can be used to easily send
  * a message without constructing the message object explicitly first.
  *
+ * Queued messages are delivered from an idle handler in batches limited in
+ * time, so that a burst of messages does not block redraws. See also
+ * pluma_message_bus_set_delivery().
+ *
  */
 void
 pluma_message_bus_send_message (PlumaMessageBus *bus,
@@ -36,6 +36,20 @@ struct _PlumaMessageBusClass {
 					 PlumaMessageType *message_type);
 };
 
+typedef enum
+{
+	PLUMA_MESSAGE_BUS_PRIORITY_HIGH,
+	PLUMA_MESSAGE_BUS_PRIORITY_DEFAULT,
+	PLUMA_MESSAGE_BUS_PRIORITY_LOW
+} PlumaMessageBusPriority;
+
+typedef enum
+{
+	PLUMA_MESSAGE_BUS_DELIVERY_QUEUE,
+	PLUMA_MESSAGE_BUS_DELIVERY_COALESCE,
+	PLUMA_MESSAGE_BUS_DELIVERY_DROPPABLE
+} PlumaMessageBusDelivery;
+
 typedef void (* PlumaMessageCallback) 	(PlumaMessageBus *bus,
 					 PlumaMessage	 *message,
 					 gpointer	  userdata);
@@ -107,6 +121,13 @@ void pluma_message_bus_unblock_by_func	  (PlumaMessageBus	*bus,
 					   PlumaMessageCallback	 callback,
 					   gpointer		 userdata);
 
+/* queueing of asynchronous messages */
+void pluma_message_bus_set_delivery	  (PlumaMessageBus	   *bus,
+					   const gchar		   *object_path,
+					   const gchar		   *method,
+					   PlumaMessageBusPriority  priority,
+					   PlumaMessageBusDelivery  delivery);
+
 /* sending messages */
 void pluma_message_bus_send_message	  (PlumaMessageBus	*bus,
 					   PlumaMessage		*message);
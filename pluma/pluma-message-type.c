@@ -47,6 +47,7 @@ struct _PlumaMessageType
 
 	gchar *object_path;
 	gchar *method;
+	GQuark id;
 
 	guint num_arguments;
 	guint num_required;
@@ -243,6 +244,7 @@ pluma_message_type_new_valist (const gchar *object_path,
 			       va_list      var_args)
 {
 	PlumaMessageType *message_type;
+	gchar *identifier;
 
 	g_return_val_if_fail (object_path != NULL, NULL);
 	g_return_val_if_fail (method != NULL, NULL);
@@ -254,6 +256,11 @@ pluma_message_type_new_valist (const gchar *object_path,
 	message_type->object_path = g_strdup(object_path);
 	message_type->method = g_strdup(method);
 	message_type->num_arguments = 0;
+
+	identifier = pluma_message_type_identifier (object_path, method);
+	message_type->id = g_quark_from_string (identifier);
+	g_free (identifier);
+
 	message_type->arguments = g_hash_table_new_full (g_str_hash,
 							 g_str_equal,
 							 (GDestroyNotify)g_free,
@@ -467,6 +474,23 @@ pluma_message_type_get_method (PlumaMessageType *message_type)
 	return message_type->method;
 }
 
+/**
+ * pluma_message_type_get_id:
+ * @message_type: the #PlumaMessageType
+ *
+ * Get the interned identifier of the message type. It is the #GQuark of
+ * the string returned by pluma_message_type_identifier() and is shared by
+ * all message types with the same object path and method.
+ *
+ * Return value: the message type identifier
+ *
+ */
+GQuark
+pluma_message_type_get_id (PlumaMessageType *message_type)
+{
+	return message_type->id;
+}
+
 /**
  * pluma_message_type_lookup:
  * @message_type: the #PlumaMessageType
@@ -52,6 +52,7 @@ PlumaMessage *pluma_message_type_instantiate 	 (PlumaMessageType *message_type,
 
 const gchar *pluma_message_type_get_object_path	 (PlumaMessageType *message_type);
 const gchar *pluma_message_type_get_method	 (PlumaMessageType *message_type);
+GQuark pluma_message_type_get_id		 (PlumaMessageType *message_type);
 
 GType pluma_message_type_lookup			 (PlumaMessageType *message_type,
 						  const gchar      *key);
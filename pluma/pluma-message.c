@@ -257,6 +257,23 @@ pluma_message_get_object_path (PlumaMessage *message)
 	return pluma_message_type_get_object_path (message->priv->type);
 }
 
+/**
+ * pluma_message_get_message_type:
+ * @message: the #PlumaMessage
+ *
+ * Get the type the message was instantiated from.
+ *
+ * Return value: (transfer none): the #PlumaMessageType of @message
+ *
+ */
+PlumaMessageType *
+pluma_message_get_message_type (PlumaMessage *message)
+{
+	g_return_val_if_fail (PLUMA_IS_MESSAGE (message), NULL);
+
+	return message->priv->type;
+}
+
 /**
  * pluma_message_set:
  * @message: the #PlumaMessage
@@ -30,7 +30,7 @@ struct _PlumaMessageClass {
 
 GType pluma_message_get_type (void) G_GNUC_CONST;
 
-struct _PlumaMessageType pluma_message_get_message_type (PlumaMessage *message);
+struct _PlumaMessageType *pluma_message_get_message_type (PlumaMessage *message);
 
 void pluma_message_get			(PlumaMessage	 *message,
 					 ...) G_GNUC_NULL_TERMINATED;
@@ -0,0 +1,284 @@
+/*
+ * pluma-multi-matcher.c
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Aho-Corasick matching of a set of literal terms: the terms are compiled
+ * once into a deterministic automaton over bytes, then every occurrence of
+ * every term is found in a single pass over the text, one table lookup per
+ * byte, however many terms there are.
+ *
+ * Bytes are first mapped to equivalence classes, the bytes that appear in
+ * no term all sharing class 0, which keeps the transition table small.
+ * Matching is case insensitive for ASCII only, like the fuzzy matcher.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+
+#include "pluma-multi-matcher.h"
+
+#define NO_STATE	G_MAXUINT32
+
+struct _PlumaMultiMatcher
+{
+	guint n_terms;
+	gsize *lengths;
+
+	guint8 classes[256];
+	guint n_classes;
+
+	guint n_states;
+	guint32 *delta;		/* n_states rows of n_classes transitions */
+	gint *term;		/* the term ending in each state, or -1 */
+	guint32 *output;	/* the next state with a term on the failure
+				 * chain, or the root when there is none */
+};
+
+static inline guchar
+fold (guchar   c,
+      gboolean case_sensitive)
+{
+	return case_sensitive ? c : g_ascii_tolower (c);
+}
+
+static void
+build_classes (PlumaMultiMatcher   *matcher,
+	       const gchar * const *terms,
+	       gboolean             case_sensitive)
+{
+	guint i;
+	gint c;
+
+	matcher->n_classes = 1;
+
+	for (i = 0; terms[i] != NULL; ++i)
+	{
+		const guchar *p;
+
+		for (p = (const guchar *) terms[i]; *p != '\0'; ++p)
+		{
+			guchar b = fold (*p, case_sensitive);
+
+			if (matcher->classes[b] == 0)
+				matcher->classes[b] = matcher->n_classes++;
+		}
+	}
+
+	/* Upper case letters go through the same transitions */
+	if (!case_sensitive)
+	{
+		for (c = 'A'; c <= 'Z'; ++c)
+			matcher->classes[c] = matcher->classes[g_ascii_tolower (c)];
+	}
+}
+
+static void
+build_trie (PlumaMultiMatcher   *matcher,
+	    const gchar * const *terms,
+	    gboolean             case_sensitive)
+{
+	gsize max_states = 1;
+	guint i;
+
+	for (i = 0; i < matcher->n_terms; ++i)
+		max_states += matcher->lengths[i];
+
+	matcher->delta = g_new (guint32, max_states * matcher->n_classes);
+	matcher->term = g_new (gint, max_states);
+	matcher->output = g_new0 (guint32, max_states);
+
+	memset (matcher->delta, 0xff, max_states * matcher->n_classes * sizeof (guint32));
+	matcher->term[0] = -1;
+	matcher->n_states = 1;
+
+	for (i = 0; i < matcher->n_terms; ++i)
+	{
+		const guchar *p;
+		guint32 state = 0;
+
+		/* Empty terms would match everywhere */
+		if (matcher->lengths[i] == 0)
+			continue;
+
+		for (p = (const guchar *) terms[i]; *p != '\0'; ++p)
+		{
+			guint32 *next;
+
+			next = &matcher->delta[state * matcher->n_classes +
+					       matcher->classes[fold (*p, case_sensitive)]];
+
+			if (*next == NO_STATE)
+			{
+				*next = matcher->n_states++;
+				matcher->term[*next] = -1;
+			}
+
+			state = *next;
+		}
+
+		/* A repeated term is reported with its first index */
+		if (matcher->term[state] < 0)
+			matcher->term[state] = i;
+	}
+}
+
+/* Turns the trie into the automaton: a breadth first walk computes the
+ * failure link of each state, replaces the missing transitions by those
+ * of the failure state and chains the states where a term ends. */
+static void
+build_automaton (PlumaMultiMatcher *matcher)
+{
+	guint32 *fail;
+	guint32 *queue;
+	guint head = 0;
+	guint tail = 0;
+	guint c;
+
+	fail = g_new0 (guint32, matcher->n_states);
+	queue = g_new (guint32, matcher->n_states);
+
+	queue[tail++] = 0;
+
+	while (head < tail)
+	{
+		guint32 state = queue[head++];
+		guint32 *row = &matcher->delta[state * matcher->n_classes];
+		guint32 *fail_row = &matcher->delta[fail[state] * matcher->n_classes];
+
+		for (c = 0; c < matcher->n_classes; ++c)
+		{
+			if (row[c] == NO_STATE)
+			{
+				row[c] = state == 0 ? 0 : fail_row[c];
+				continue;
+			}
+
+			fail[row[c]] = state == 0 ? 0 : fail_row[c];
+			matcher->output[row[c]] = matcher->term[fail[row[c]]] >= 0 ?
+						  fail[row[c]] :
+						  matcher->output[fail[row[c]]];
+
+			queue[tail++] = row[c];
+		}
+	}
+
+	g_free (queue);
+	g_free (fail);
+}
+
+/**
+ * pluma_multi_matcher_new:
+ * @terms: a %NULL terminated array of terms
+ * @case_sensitive: whether the ASCII letters have to match exactly
+ *
+ * Compiles @terms into a matcher. Empty terms never match.
+ *
+ * Returns: a new #PlumaMultiMatcher, free it with pluma_multi_matcher_free().
+ */
+PlumaMultiMatcher *
+pluma_multi_matcher_new (const gchar * const *terms,
+			 gboolean             case_sensitive)
+{
+	PlumaMultiMatcher *matcher;
+	guint i;
+
+	g_return_val_if_fail (terms != NULL, NULL);
+
+	matcher = g_slice_new0 (PlumaMultiMatcher);
+
+	matcher->n_terms = g_strv_length ((gchar **) terms);
+	matcher->lengths = g_new (gsize, matcher->n_terms);
+
+	for (i = 0; i < matcher->n_terms; ++i)
+		matcher->lengths[i] = strlen (terms[i]);
+
+	build_classes (matcher, terms, case_sensitive);
+	build_trie (matcher, terms, case_sensitive);
+	build_automaton (matcher);
+
+	return matcher;
+}
+
+void
+pluma_multi_matcher_free (PlumaMultiMatcher *matcher)
+{
+	if (matcher == NULL)
+		return;
+
+	g_free (matcher->lengths);
+	g_free (matcher->delta);
+	g_free (matcher->term);
+	g_free (matcher->output);
+
+	g_slice_free (PlumaMultiMatcher, matcher);
+}
+
+/**
+ * pluma_multi_matcher_scan:
+ * @matcher: a #PlumaMultiMatcher
+ * @text: the text to scan
+ * @len: the length of @text in bytes, or -1 if it is nul terminated
+ * @func: the function called for each occurrence
+ * @user_data: data passed to @func
+ *
+ * Calls @func with the index of the term, the byte offset and the byte
+ * length of each occurrence of any term in @text, overlapping occurrences
+ * included. Occurrences are reported by increasing end offset, and
+ * occurrences ending at the same offset from the longest to the shortest.
+ */
+void
+pluma_multi_matcher_scan (PlumaMultiMatcher    *matcher,
+			  const gchar          *text,
+			  gssize                len,
+			  PlumaMultiMatcherFunc func,
+			  gpointer              user_data)
+{
+	const guchar *p = (const guchar *) text;
+	guint32 state = 0;
+	gsize i;
+
+	g_return_if_fail (matcher != NULL);
+	g_return_if_fail (text != NULL);
+	g_return_if_fail (func != NULL);
+
+	if (len < 0)
+		len = strlen (text);
+
+	for (i = 0; i < (gsize) len; ++i)
+	{
+		guint32 s;
+
+		state = matcher->delta[state * matcher->n_classes + matcher->classes[p[i]]];
+
+		s = matcher->term[state] >= 0 ? state : matcher->output[state];
+
+		for (; s != 0; s = matcher->output[s])
+		{
+			guint t = matcher->term[s];
+
+			func (t, i + 1 - matcher->lengths[t], matcher->lengths[t], user_data);
+		}
+	}
+}
@@ -44,15 +44,216 @@
 #include "pluma-dirs.h"
 #include "pluma-settings.h"
 
+/* Plugins can ask to be loaded only when they are first needed, with a
+ * semicolon separated list of triggers in their .plugin file, e.g.
+ *
+ *   X-Pluma-Activate-On=idle;language:python;
+ *
+ * "idle"            once the first window has been drawn
+ * "action:<name>"   the first time a window action is activated
+ * "language:<id>"   a document of that language becomes active
+ * "panel:side", "panel:bottom"
+ *                   the panel is shown
+ *
+ * Until then the plugin is kept enabled in the settings, but not loaded.
+ */
+#define ACTIVATE_ON_KEY "Pluma-Activate-On"
+
 struct _PlumaPluginsEnginePrivate
 {
 	GSettings *plugin_settings;
+
+	/* module name -> PeasPluginInfo, enabled but not loaded yet */
+	GHashTable *deferred;
+
+	/* module name -> load time in milliseconds */
+	GHashTable *load_times;
+
+	gboolean lazy;
+	gboolean syncing;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (PlumaPluginsEngine, pluma_plugins_engine, PEAS_TYPE_ENGINE)
 
 PlumaPluginsEngine *default_engine = NULL;
 
+static gboolean
+has_triggers (PeasPluginInfo *info)
+{
+	const gchar *triggers;
+
+	triggers = peas_plugin_info_get_external_data (info, ACTIVATE_ON_KEY);
+
+	return triggers != NULL && *triggers != '\0';
+}
+
+static gboolean
+has_trigger (PeasPluginInfo *info,
+             const gchar    *trigger)
+{
+	const gchar *triggers;
+	gchar **list;
+	gboolean found = FALSE;
+	gint i;
+
+	triggers = peas_plugin_info_get_external_data (info, ACTIVATE_ON_KEY);
+
+	if (triggers == NULL)
+		return FALSE;
+
+	list = g_strsplit (triggers, ";", -1);
+
+	for (i = 0; list[i] != NULL && !found; i++)
+	{
+		found = (strcmp (g_strstrip (list[i]), trigger) == 0);
+	}
+
+	g_strfreev (list);
+
+	return found;
+}
+
+static void
+save_active_plugins (PlumaPluginsEngine *engine)
+{
+	gchar **loaded;
+	GPtrArray *active;
+	GHashTableIter iter;
+	gpointer module;
+	gint i;
+
+	loaded = peas_engine_get_loaded_plugins (PEAS_ENGINE (engine));
+	active = g_ptr_array_new ();
+
+	for (i = 0; loaded[i] != NULL; i++)
+		g_ptr_array_add (active, loaded[i]);
+
+	g_hash_table_iter_init (&iter, engine->priv->deferred);
+	while (g_hash_table_iter_next (&iter, &module, NULL))
+		g_ptr_array_add (active, module);
+
+	g_ptr_array_add (active, NULL);
+
+	engine->priv->syncing = TRUE;
+	g_settings_set_strv (engine->priv->plugin_settings,
+	                     PLUMA_SETTINGS_ACTIVE_PLUGINS,
+	                     (const gchar * const *) active->pdata);
+	engine->priv->syncing = FALSE;
+
+	g_ptr_array_free (active, TRUE);
+	g_strfreev (loaded);
+}
+
+static void
+load_plugins_from_settings (PlumaPluginsEngine *engine)
+{
+	gchar **active;
+	const GList *plugins;
+
+	if (engine->priv->syncing)
+		return;
+
+	active = g_settings_get_strv (engine->priv->plugin_settings,
+	                              PLUMA_SETTINGS_ACTIVE_PLUGINS);
+
+	engine->priv->syncing = TRUE;
+
+	for (plugins = peas_engine_get_plugin_list (PEAS_ENGINE (engine));
+	     plugins != NULL;
+	     plugins = plugins->next)
+	{
+		PeasPluginInfo *info = plugins->data;
+		const gchar *module = peas_plugin_info_get_module_name (info);
+
+		if (g_strv_contains ((const gchar * const *) active, module))
+		{
+			if (peas_plugin_info_is_loaded (info) ||
+			    g_hash_table_contains (engine->priv->deferred, module))
+				continue;
+
+			if (engine->priv->lazy && has_triggers (info))
+			{
+				pluma_debug_message (DEBUG_PLUGINS, "Deferring %s", module);
+
+				g_hash_table_insert (engine->priv->deferred,
+				                     g_strdup (module),
+				                     info);
+			}
+			else
+			{
+				peas_engine_load_plugin (PEAS_ENGINE (engine), info);
+			}
+		}
+		else
+		{
+			g_hash_table_remove (engine->priv->deferred, module);
+
+			if (peas_plugin_info_is_loaded (info))
+				peas_engine_unload_plugin (PEAS_ENGINE (engine), info);
+		}
+	}
+
+	engine->priv->syncing = FALSE;
+
+	g_strfreev (active);
+}
+
+static void
+active_plugins_changed (GSettings          *settings,
+                        const gchar        *key,
+                        PlumaPluginsEngine *engine)
+{
+	load_plugins_from_settings (engine);
+}
+
+static void
+pluma_plugins_engine_load_plugin (PeasEngine     *engine,
+                                  PeasPluginInfo *info)
+{
+	PlumaPluginsEngine *pengine = PLUMA_PLUGINS_ENGINE (engine);
+	const gchar *module = peas_plugin_info_get_module_name (info);
+	gint64 start;
+
+	start = g_get_monotonic_time ();
+
+	/* the module name lives as long as the engine */
+	pluma_debug_trace_begin (module);
+	PEAS_ENGINE_CLASS (pluma_plugins_engine_parent_class)->load_plugin (engine, info);
+	pluma_debug_trace_end (module);
+
+	g_hash_table_remove (pengine->priv->deferred, module);
+
+	if (peas_plugin_info_is_loaded (info))
+	{
+		gdouble *msecs;
+
+		msecs = g_new (gdouble, 1);
+		*msecs = (g_get_monotonic_time () - start) / 1000.0;
+
+		pluma_debug_message (DEBUG_PLUGINS, "Loaded %s in %.3f ms", module, *msecs);
+
+		g_hash_table_insert (pengine->priv->load_times, g_strdup (module), msecs);
+	}
+
+	if (!pengine->priv->syncing)
+		save_active_plugins (pengine);
+}
+
+static void
+pluma_plugins_engine_unload_plugin (PeasEngine     *engine,
+                                    PeasPluginInfo *info)
+{
+	PlumaPluginsEngine *pengine = PLUMA_PLUGINS_ENGINE (engine);
+
+	PEAS_ENGINE_CLASS (pluma_plugins_engine_parent_class)->unload_plugin (engine, info);
+
+	g_hash_table_remove (pengine->priv->load_times,
+	                     peas_plugin_info_get_module_name (info));
+
+	if (!pengine->priv->syncing)
+		save_active_plugins (pengine);
+}
+
 static void
 pluma_plugins_engine_init (PlumaPluginsEngine *engine)
 {
@@ -66,6 +267,10 @@ pluma_plugins_engine_init (PlumaPluginsEngine *engine)
 	engine->priv = pluma_plugins_engine_get_instance_private (engine);
 
 	engine->priv->plugin_settings = g_settings_new (PLUMA_SCHEMA_ID);
+	engine->priv->deferred = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	engine->priv->load_times = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	engine->priv->lazy = g_settings_get_boolean (engine->priv->plugin_settings,
+	                                             PLUMA_SETTINGS_LAZY_PLUGINS);
 
 	/* This should be moved to libpeas */
 	if (!g_irepository_require (g_irepository_get_default (),
@@ -100,11 +305,12 @@ pluma_plugins_engine_init (PlumaPluginsEngine *engine)
 	                             PLUMA_LIBDIR "/plugins",
 	                             PLUMA_DATADIR "/plugins");
 
-	g_settings_bind (engine->priv->plugin_settings,
-	                 PLUMA_SETTINGS_ACTIVE_PLUGINS,
-	                 engine,
-	                 "loaded-plugins",
-	                 G_SETTINGS_BIND_DEFAULT);
+	g_signal_connect (engine->priv->plugin_settings,
+	                  "changed::" PLUMA_SETTINGS_ACTIVE_PLUGINS,
+	                  G_CALLBACK (active_plugins_changed),
+	                  engine);
+
+	load_plugins_from_settings (engine);
 }
 
 static void
@@ -112,21 +318,35 @@ pluma_plugins_engine_dispose (GObject *object)
 {
 	PlumaPluginsEngine *engine = PLUMA_PLUGINS_ENGINE (object);
 
+	/* PeasEngine unloads the plugins while disposing: that must
+	 * not be saved as the active plugins of the next session */
+	engine->priv->syncing = TRUE;
+
+	if (engine->priv->plugin_settings != NULL)
+		g_signal_handlers_disconnect_by_data (engine->priv->plugin_settings, engine);
+
+	G_OBJECT_CLASS (pluma_plugins_engine_parent_class)->dispose (object);
+
 	if (engine->priv->plugin_settings != NULL)
 	{
 		g_object_unref (engine->priv->plugin_settings);
 		engine->priv->plugin_settings = NULL;
 	}
 
-	G_OBJECT_CLASS (pluma_plugins_engine_parent_class)->dispose (object);
+	g_clear_pointer (&engine->priv->deferred, g_hash_table_destroy);
+	g_clear_pointer (&engine->priv->load_times, g_hash_table_destroy);
 }
 
 static void
 pluma_plugins_engine_class_init (PlumaPluginsEngineClass *klass)
 {
 	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+	PeasEngineClass *engine_class = PEAS_ENGINE_CLASS (klass);
 
 	object_class->dispose = pluma_plugins_engine_dispose;
+
+	engine_class->load_plugin = pluma_plugins_engine_load_plugin;
+	engine_class->unload_plugin = pluma_plugins_engine_unload_plugin;
 }
 
 PlumaPluginsEngine *
@@ -142,3 +362,88 @@ pluma_plugins_engine_get_default (void)
 	return default_engine;
 }
 
+
+/**
+ * pluma_plugins_engine_trigger:
+ * @engine: a #PlumaPluginsEngine
+ * @trigger: the trigger, e.g. "language:python"
+ *
+ * Loads the deferred plugins that are waiting for @trigger.
+ */
+void
+pluma_plugins_engine_trigger (PlumaPluginsEngine *engine,
+                              const gchar        *trigger)
+{
+	GHashTableIter iter;
+	gpointer info;
+	GList *ready = NULL;
+	GList *l;
+
+	g_return_if_fail (PLUMA_IS_PLUGINS_ENGINE (engine));
+	g_return_if_fail (trigger != NULL);
+
+	if (g_hash_table_size (engine->priv->deferred) == 0)
+		return;
+
+	g_hash_table_iter_init (&iter, engine->priv->deferred);
+	while (g_hash_table_iter_next (&iter, NULL, &info))
+	{
+		if (has_trigger (info, trigger))
+			ready = g_list_prepend (ready, info);
+	}
+
+	for (l = ready; l != NULL; l = l->next)
+	{
+		pluma_debug_message (DEBUG_PLUGINS, "Trigger %s loads %s",
+		                     trigger, peas_plugin_info_get_module_name (l->data));
+
+		peas_engine_load_plugin (PEAS_ENGINE (engine), l->data);
+	}
+
+	g_list_free (ready);
+}
+
+/**
+ * pluma_plugins_engine_load_deferred:
+ * @engine: a #PlumaPluginsEngine
+ *
+ * Loads all the deferred plugins right away.
+ */
+void
+pluma_plugins_engine_load_deferred (PlumaPluginsEngine *engine)
+{
+	GList *deferred;
+	GList *l;
+
+	g_return_if_fail (PLUMA_IS_PLUGINS_ENGINE (engine));
+
+	deferred = g_hash_table_get_values (engine->priv->deferred);
+
+	for (l = deferred; l != NULL; l = l->next)
+		peas_engine_load_plugin (PEAS_ENGINE (engine), l->data);
+
+	g_list_free (deferred);
+}
+
+/**
+ * pluma_plugins_engine_get_load_time:
+ * @engine: a #PlumaPluginsEngine
+ * @info: a #PeasPluginInfo
+ *
+ * Returns: the time it took to load the plugin, in milliseconds, or -1 if
+ * it is not loaded.
+ */
+gdouble
+pluma_plugins_engine_get_load_time (PlumaPluginsEngine *engine,
+                                    PeasPluginInfo     *info)
+{
+	gdouble *msecs;
+
+	g_return_val_if_fail (PLUMA_IS_PLUGINS_ENGINE (engine), -1);
+	g_return_val_if_fail (info != NULL, -1);
+
+	msecs = g_hash_table_lookup (engine->priv->load_times,
+	                             peas_plugin_info_get_module_name (info));
+
+	return msecs != NULL ? *msecs : -1;
+}
@@ -64,6 +64,14 @@ GType			 pluma_plugins_engine_get_type		(void) G_GNUC_CONST;
 
 PlumaPluginsEngine	*pluma_plugins_engine_get_default	(void);
 
+void			 pluma_plugins_engine_trigger		(PlumaPluginsEngine *engine,
+								 const gchar        *trigger);
+
+void			 pluma_plugins_engine_load_deferred	(PlumaPluginsEngine *engine);
+
+gdouble			 pluma_plugins_engine_get_load_time	(PlumaPluginsEngine *engine,
+								 PeasPluginInfo     *info);
+
 G_END_DECLS
 
 #endif  /* __PLUMA_PLUGINS_ENGINE_H__ */
@@ -550,12 +550,22 @@ parse_window (GKeyFile *state_file, const char *group_name)
 					     "URI: %s (%s)",
 					     documents[i],
 					     jump_to ? "active" : "not active");
-			pluma_window_create_tab_from_uri (window,
-							  documents[i],
-							  NULL,
-							  0,
-							  FALSE,
-							  jump_to);
+
+			/* only the active document is loaded right away,
+			 * the other tabs wait for their turn or to be shown */
+			if (jump_to)
+				pluma_window_create_tab_from_uri (window,
+								  documents[i],
+								  NULL,
+								  0,
+								  FALSE,
+								  TRUE);
+			else
+				_pluma_cmd_load_file_deferred (window,
+							       documents[i],
+							       NULL,
+							       0,
+							       FALSE);
 		}
 		g_strfreev (documents);
 	}
@@ -90,7 +90,7 @@ pluma_settings_space_drawer_generic (GSettings              *settings,
 
     pluma_debug (DEBUG_PREFS);
 
-    views = pluma_app_get_views (pluma_app_get_default ());
+    views = _pluma_app_get_created_views (pluma_app_get_default ());
     l = views;
 
     while (l != NULL)
@@ -113,7 +113,7 @@ pluma_settings_draw_generic (GSettings              *settings,
 
     pluma_debug (DEBUG_PREFS);
 
-    views = pluma_app_get_views (pluma_app_get_default ());
+    views = _pluma_app_get_created_views (pluma_app_get_default ());
     l = views;
 
     while (l != NULL)
@@ -172,7 +172,7 @@ set_font (PlumaSettings *self,
 
     ts = g_settings_get_uint (self->priv->editor_settings, PLUMA_SETTINGS_TABS_SIZE);
 
-    views = pluma_app_get_views (pluma_app_get_default ());
+    views = _pluma_app_get_created_views (pluma_app_get_default ());
 
     for (l = views; l != NULL; l = g_list_next (l))
     {
@@ -376,7 +376,7 @@ on_wrap_mode_changed (GSettings     *settings,
 
     wrap_mode = pluma_settings_get_wrap_mode (settings, key);
 
-    views = pluma_app_get_views (pluma_app_get_default ());
+    views = _pluma_app_get_created_views (pluma_app_get_default ());
 
     for (l = views; l != NULL; l = g_list_next (l))
     {
@@ -398,7 +398,7 @@ on_tabs_size_changed (GSettings     *settings,
 
     ts = CLAMP (ts, 1, 24);
 
-    views = pluma_app_get_views (pluma_app_get_default ());
+    views = _pluma_app_get_created_views (pluma_app_get_default ());
 
     for (l = views; l != NULL; l = g_list_next (l))
     {
@@ -418,7 +418,7 @@ on_insert_spaces_changed (GSettings     *settings,
 
     spaces = g_settings_get_boolean (settings, key);
 
-    views = pluma_app_get_views (pluma_app_get_default ());
+    views = _pluma_app_get_created_views (pluma_app_get_default ());
 
     for (l = views; l != NULL; l = g_list_next (l))
     {
@@ -439,7 +439,7 @@ on_auto_indent_changed (GSettings     *settings,
 
     enable = g_settings_get_boolean (settings, key);
 
-    views = pluma_app_get_views (pluma_app_get_default ());
+    views = _pluma_app_get_created_views (pluma_app_get_default ());
 
     for (l = views; l != NULL; l = g_list_next (l))
     {
@@ -459,7 +459,7 @@ on_display_line_numbers_changed (GSettings     *settings,
 
     line_numbers = g_settings_get_boolean (settings, key);
 
-    views = pluma_app_get_views (pluma_app_get_default ());
+    views = _pluma_app_get_created_views (pluma_app_get_default ());
 
     for (l = views; l != NULL; l = g_list_next (l))
     {
@@ -479,7 +479,7 @@ on_hl_current_line_changed (GSettings     *settings,
 
     hl = g_settings_get_boolean (settings, key);
 
-    views = pluma_app_get_views (pluma_app_get_default ());
+    views = _pluma_app_get_created_views (pluma_app_get_default ());
 
     for (l = views; l != NULL; l = g_list_next (l))
     {
@@ -520,7 +520,7 @@ on_display_right_margin_changed (GSettings     *settings,
 
     display = g_settings_get_boolean (settings, key);
 
-    views = pluma_app_get_views (pluma_app_get_default ());
+    views = _pluma_app_get_created_views (pluma_app_get_default ());
 
     for (l = views; l != NULL; l = g_list_next (l))
     {
@@ -542,7 +542,7 @@ on_right_margin_position_changed (GSettings     *settings,
 
     pos = CLAMP (pos, 1, 160);
 
-    views = pluma_app_get_views (pluma_app_get_default ());
+    views = _pluma_app_get_created_views (pluma_app_get_default ());
 
     for (l = views; l != NULL; l = g_list_next (l))
     {
@@ -562,7 +562,7 @@ on_smart_home_end_changed (GSettings     *settings,
 
     smart_he = pluma_settings_get_smart_home_end (self);
 
-    views = pluma_app_get_views (pluma_app_get_default ());
+    views = _pluma_app_get_created_views (pluma_app_get_default ());
 
     for (l = views; l != NULL; l = g_list_next (l))
     {
@@ -587,7 +587,9 @@ on_syntax_highlighting_changed (GSettings     *settings,
 
     for (l = docs; l != NULL; l = g_list_next (l))
     {
-        gtk_source_buffer_set_highlight_syntax (GTK_SOURCE_BUFFER (l->data), enable);
+        /* deferred documents pick the setting up when they are shown */
+        if (!_pluma_document_get_highlight_deferred (PLUMA_DOCUMENT (l->data)))
+            gtk_source_buffer_set_highlight_syntax (GTK_SOURCE_BUFFER (l->data), enable);
     }
 
     g_list_free (docs);
@@ -872,7 +874,9 @@ _pluma_settings_get_singleton (void)
 {
     if (singleton == NULL)
     {
+        pluma_debug_trace_begin ("settings init");
         singleton = g_object_new (PLUMA_TYPE_SETTINGS, NULL);
+        pluma_debug_trace_end ("settings init");
     }
 
     return singleton;
@@ -133,6 +133,7 @@ GSList *                pluma_settings_get_writable_vfs_schemes (GSettings *sett
 #define PLUMA_SETTINGS_ENCODING_AUTO_DETECTED       "auto-detected-encodings"
 #define PLUMA_SETTINGS_ENCODING_SHOWN_IN_MENU       "shown-in-menu-encodings"
 #define PLUMA_SETTINGS_ACTIVE_PLUGINS               "active-plugins"
+#define PLUMA_SETTINGS_LAZY_PLUGINS                 "lazy-plugins"
 #define PLUMA_SETTINGS_SHOW_SINGLE_TAB              "show-single-tab"
 #define PLUMA_SETTINGS_SHOW_TABS_WITH_SIDE_PANE     "show-tabs-with-side-pane"
 #define PLUMA_SETTINGS_CTRL_TABS_SWITCH_TABS        "ctrl-tab-switch-tabs"
@@ -42,6 +42,7 @@ struct _PlumaStatusComboBoxPrivate
 enum
 {
 	CHANGED,
+	POPUP,
 	NUM_SIGNALS
 };
 
@@ -164,6 +165,15 @@ pluma_status_combo_box_class_init (PlumaStatusComboBoxClass *klass)
 			  g_cclosure_marshal_VOID__OBJECT, G_TYPE_NONE, 1,
 			  GTK_TYPE_MENU_ITEM);
 
+	/* emitted before the menu is shown, the items can be added lazily */
+	signals[POPUP] =
+	    g_signal_new ("popup",
+			  G_OBJECT_CLASS_TYPE (object_class),
+			  G_SIGNAL_RUN_LAST,
+			  G_STRUCT_OFFSET (PlumaStatusComboBoxClass,
+					   popup), NULL, NULL,
+			  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
 	g_object_class_install_property (object_class, PROP_LABEL,
 					 g_param_spec_string ("label",
 					 		      "LABEL",
@@ -188,6 +198,8 @@ button_press_event (GtkWidget           *widget,
 	GtkAllocation allocation;
 	gint max_height;
 
+	g_signal_emit (combo, signals[POPUP], 0);
+
 	gtk_widget_get_preferred_size (combo->priv->menu, NULL, &request);
 	gtk_widget_get_allocation (GTK_WIDGET (combo), &allocation);
 
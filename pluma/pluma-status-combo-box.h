@@ -51,6 +51,7 @@ struct _PlumaStatusComboBoxClass {
 
 	void (*changed) (PlumaStatusComboBox *combo,
 			 GtkMenuItem         *item);
+	void (*popup)   (PlumaStatusComboBox *combo);
 };
 
 GType pluma_status_combo_box_get_type 			(void) G_GNUC_CONST;
@@ -53,7 +53,10 @@ struct _PlumaTabPrivate
 	GSettings	       *editor_settings;
 	PlumaTabState	        state;
 
+	PlumaDocument	       *document;
+
 	GtkWidget	       *overlay;
+	/* created when the tab is first shown, see create_view () */
 	GtkWidget	       *view;
 	GtkWidget	       *view_scrolled_window;
 	GtkWidget	       *view_map_frame;
@@ -63,6 +66,9 @@ struct _PlumaTabPrivate
 
 	PlumaPrintJob          *print_job;
 
+	/* set while a replace all is running */
+	GCancellable           *replace_cancellable;
+
 	/* tmp data for saving */
 	gchar		       *tmp_save_uri;
 
@@ -70,6 +76,10 @@ struct _PlumaTabPrivate
 	gint                    tmp_line_pos;
 	const PlumaEncoding    *tmp_encoding;
 
+	/* load requested with _pluma_tab_load_deferred () */
+	gchar                  *pending_uri;
+	gboolean                pending_create;
+
 	GTimer 		       *timer;
 	guint		        times_called;
 
@@ -94,7 +104,8 @@ enum
 	PROP_NAME,
 	PROP_STATE,
 	PROP_AUTO_SAVE,
-	PROP_AUTO_SAVE_INTERVAL
+	PROP_AUTO_SAVE_INTERVAL,
+	PROP_VIEW
 };
 
 static gboolean pluma_tab_auto_save (PlumaTab *tab);
@@ -194,6 +205,9 @@ pluma_tab_get_property (GObject    *object,
 			g_value_set_int (value,
 					 pluma_tab_get_auto_save_interval (tab));
 			break;
+		case PROP_VIEW:
+			g_value_set_object (value, tab->priv->view);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -224,6 +238,21 @@ pluma_tab_set_property (GObject      *object,
 	}
 }
 
+static void
+pluma_tab_dispose (GObject *object)
+{
+	PlumaTab *tab = PLUMA_TAB (object);
+
+	/* do not let a replace all go on once the tab is gone */
+	if (tab->priv->replace_cancellable != NULL)
+	{
+		g_cancellable_cancel (tab->priv->replace_cancellable);
+		g_clear_object (&tab->priv->replace_cancellable);
+	}
+
+	G_OBJECT_CLASS (pluma_tab_parent_class)->dispose (object);
+}
+
 static void
 pluma_tab_finalize (GObject *object)
 {
@@ -233,6 +262,7 @@ pluma_tab_finalize (GObject *object)
 		g_timer_destroy (tab->priv->timer);
 
 	g_free (tab->priv->tmp_save_uri);
+	g_free (tab->priv->pending_uri);
 
 	if (tab->priv->auto_save_timeout > 0)
 		remove_auto_save_timeout (tab);
@@ -247,6 +277,8 @@ pluma_tab_finalize (GObject *object)
 	a warning when trying to close pluma while print-preview is active */
 	g_clear_object (&tab->priv->editor_settings);
 
+	g_clear_object (&tab->priv->document);
+
 	G_OBJECT_CLASS (pluma_tab_parent_class)->finalize (object);
 }
 
@@ -255,6 +287,7 @@ pluma_tab_class_init (PlumaTabClass *klass)
 {
 	GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
+	object_class->dispose = pluma_tab_dispose;
 	object_class->finalize = pluma_tab_finalize;
 	object_class->get_property = pluma_tab_get_property;
 	object_class->set_property = pluma_tab_set_property;
@@ -297,6 +330,21 @@ pluma_tab_class_init (PlumaTabClass *klass)
 							   0,
 							   G_PARAM_READWRITE |
 							   G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * PlumaTab:view:
+	 *
+	 * The #PlumaView of the tab, %NULL until the tab is first shown
+	 * if it was created in the background.
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_VIEW,
+					 g_param_spec_object ("view",
+							      "View",
+							      "The tab's view",
+							      PLUMA_TYPE_VIEW,
+							      G_PARAM_READABLE |
+							      G_PARAM_STATIC_STRINGS));
 }
 
 /**
@@ -331,6 +379,7 @@ set_cursor_according_to_state (GtkTextView   *view,
 	    (state == PLUMA_TAB_STATE_SAVING)           ||
 	    (state == PLUMA_TAB_STATE_PRINTING)         ||
 	    (state == PLUMA_TAB_STATE_PRINT_PREVIEWING) ||
+	    (state == PLUMA_TAB_STATE_GENERIC_NOT_EDITABLE) ||
 	    (state == PLUMA_TAB_STATE_CLOSING))
 	{
 		cursor = gdk_cursor_new_for_display (
@@ -359,6 +408,17 @@ set_cursor_according_to_state (GtkTextView   *view,
 	}
 }
 
+static void
+view_mapped (GtkWidget *view,
+	     PlumaTab  *tab)
+{
+	/* the tab is shown, it can not wait anymore */
+	_pluma_tab_start_deferred_load (tab);
+
+	_pluma_document_set_highlight_deferred (pluma_tab_get_document (tab),
+						FALSE);
+}
+
 static void
 view_realized (GtkTextView *view,
 	       PlumaTab    *tab)
@@ -373,6 +433,9 @@ set_view_properties_according_to_state (PlumaTab      *tab,
 	gboolean val;
 	gboolean hl_current_line;
 
+	if (tab->priv->view == NULL)
+		return;
+
 	hl_current_line = g_settings_get_boolean (tab->priv->editor_settings,
 						  PLUMA_SETTINGS_HIGHLIGHT_CURRENT_LINE);
 
@@ -420,8 +483,9 @@ pluma_tab_set_state (PlumaTab      *tab,
 		}
 	}
 
-	set_cursor_according_to_state (GTK_TEXT_VIEW (tab->priv->view),
-				       state);
+	if (tab->priv->view != NULL)
+		set_cursor_according_to_state (GTK_TEXT_VIEW (tab->priv->view),
+					       state);
 
 	g_object_notify (G_OBJECT (tab), "state");
 }
@@ -587,7 +651,8 @@ load_cancelled (GtkWidget        *area,
 static gboolean
 scroll_to_cursor (PlumaTab *tab)
 {
-	pluma_view_scroll_to_cursor (PLUMA_VIEW (tab->priv->view));
+	if (tab->priv->view != NULL)
+		pluma_view_scroll_to_cursor (PLUMA_VIEW (tab->priv->view));
 	tab->priv->idle_scroll = 0;
 	return FALSE;
 }
@@ -1494,11 +1559,73 @@ tab_mount_operation_factory (PlumaDocument *doc,
 	return gtk_mount_operation_new (GTK_WINDOW (window));
 }
 
+/* Creates the view and the overview map of the tab. A tab created with
+ * _pluma_tab_new_unrealized () only holds its document until it is
+ * shown, or until something asks for its view. */
+static void
+create_view (PlumaTab *tab)
+{
+	GtkWidget *map;
+	GtkCssProvider *provider;
+
+	g_return_if_fail (tab->priv->view == NULL);
+
+	pluma_debug (DEBUG_TAB);
+
+	tab->priv->view = pluma_view_new (tab->priv->document);
+	gtk_widget_show (tab->priv->view);
+	g_object_set_data (G_OBJECT (tab->priv->view), PLUMA_TAB_KEY, tab);
+
+	gtk_container_add (GTK_CONTAINER (tab->priv->view_scrolled_window),
+			   tab->priv->view);
+
+	map = gtk_source_map_new();
+
+	provider = gtk_css_provider_new ();
+	gtk_css_provider_load_from_data (provider,
+					 "textview { font-family: Monospace; font-size: 1pt; }",
+					 -1,
+					 NULL);
+	gtk_style_context_add_provider (gtk_widget_get_style_context (map),
+					GTK_STYLE_PROVIDER (provider),
+					GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+	g_object_unref (provider);
+
+	gtk_source_map_set_view (GTK_SOURCE_MAP(map), GTK_SOURCE_VIEW(tab->priv->view));
+	gtk_container_add (GTK_CONTAINER(tab->priv->view_map_frame), map);
+	gtk_widget_show (map);
+
+	g_signal_connect_after (tab->priv->view,
+				"focus-in-event",
+				G_CALLBACK (view_focused_in),
+				tab);
+
+	g_signal_connect_after (tab->priv->view,
+				"realize",
+				G_CALLBACK (view_realized),
+				tab);
+
+	g_signal_connect (tab->priv->view,
+			  "map",
+			  G_CALLBACK (view_mapped),
+			  tab);
+
+	set_view_properties_according_to_state (tab, tab->priv->state);
+
+	/* the document may have been loaded while there was no view */
+	if (tab->priv->state == PLUMA_TAB_STATE_NORMAL &&
+	    tab->priv->idle_scroll == 0)
+	{
+		tab->priv->idle_scroll = g_idle_add ((GSourceFunc)scroll_to_cursor, tab);
+	}
+
+	g_object_notify (G_OBJECT (tab), "view");
+}
+
 static void
 pluma_tab_init (PlumaTab *tab)
 {
 	GtkWidget *hbox;
-	GtkWidget *map;
 	GtkWidget *sw;
 	PlumaDocument *doc;
 	PlumaLockdownMask lockdown;
@@ -1543,20 +1670,15 @@ pluma_tab_init (PlumaTab *tab)
 	if (tab->priv->auto_save_interval <= 0)
 		tab->priv->auto_save_interval = GPM_DEFAULT_AUTO_SAVE_INTERVAL;*/
 
-	/* Create the view */
+	/* Create the document, the view comes later */
 	doc = pluma_document_new ();
+	tab->priv->document = doc;
 	g_object_set_data (G_OBJECT (doc), PLUMA_TAB_KEY, tab);
 
 	_pluma_document_set_mount_operation_factory (doc,
 						     tab_mount_operation_factory,
 						     tab);
 
-	tab->priv->view = pluma_view_new (doc);
-	g_object_unref (doc);
-	gtk_widget_show (tab->priv->view);
-	g_object_set_data (G_OBJECT (tab->priv->view), PLUMA_TAB_KEY, tab);
-
-	gtk_container_add (GTK_CONTAINER (sw), tab->priv->view);
 	gtk_scrolled_window_set_shadow_type (GTK_SCROLLED_WINDOW (sw),
 					     GTK_SHADOW_IN);
 	gtk_widget_show (sw);
@@ -1564,20 +1686,6 @@ pluma_tab_init (PlumaTab *tab)
 	/* Create the minimap overlay */
 	tab->priv->overlay = gtk_overlay_new ();
 	tab->priv->view_map_frame = gtk_frame_new (NULL);
-	map = gtk_source_map_new();
-
-	GtkCssProvider *provider = gtk_css_provider_new ();
-	gtk_css_provider_load_from_data (provider,
-					 "textview { font-family: Monospace; font-size: 1pt; }",
-					 -1,
-					 NULL);
-	gtk_style_context_add_provider (gtk_widget_get_style_context (map),
-					GTK_STYLE_PROVIDER (provider),
-					GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
-	g_object_unref (provider);
-
-	gtk_source_map_set_view (GTK_SOURCE_MAP(map), GTK_SOURCE_VIEW(tab->priv->view));
-	gtk_container_add (GTK_CONTAINER(tab->priv->view_map_frame), map);
 	gtk_widget_show (tab->priv->view_map_frame);
 
 	/* Start packing */
@@ -1624,24 +1732,37 @@ pluma_tab_init (PlumaTab *tab)
 			  "saved",
 			  G_CALLBACK (document_saved),
 			  tab);
+}
 
-	g_signal_connect_after (tab->priv->view,
-				"focus-in-event",
-				G_CALLBACK (view_focused_in),
-				tab);
+GtkWidget *
+_pluma_tab_new (void)
+{
+	PlumaTab *tab;
 
-	g_signal_connect_after (tab->priv->view,
-				"realize",
-				G_CALLBACK (view_realized),
-				tab);
+	tab = PLUMA_TAB (g_object_new (PLUMA_TYPE_TAB, NULL));
+	create_view (tab);
+
+	return GTK_WIDGET (tab);
 }
 
+/* The view of the tab is only created when the tab is first shown */
 GtkWidget *
-_pluma_tab_new (void)
+_pluma_tab_new_unrealized (void)
 {
 	return GTK_WIDGET (g_object_new (PLUMA_TYPE_TAB, NULL));
 }
 
+/* Creates the view of a tab made with _pluma_tab_new_unrealized (),
+ * does nothing if the tab already has a view */
+void
+_pluma_tab_realize_view (PlumaTab *tab)
+{
+	g_return_if_fail (PLUMA_IS_TAB (tab));
+
+	if (tab->priv->view == NULL)
+		create_view (tab);
+}
+
 /* Whether create is TRUE, creates a new empty document if location does
    not refer to an existing file */
 GtkWidget *
@@ -1669,13 +1790,16 @@ _pluma_tab_new_from_uri (const gchar         *uri,
  * pluma_tab_get_view:
  * @tab: a #PlumaTab
  *
- * Gets the #PlumaView inside @tab.
+ * Gets the #PlumaView inside @tab. The view of a tab opened in the
+ * background is created by this call if it was not shown yet.
  *
  * Returns: (transfer none): the #PlumaView inside @tab
  */
 PlumaView *
 pluma_tab_get_view (PlumaTab *tab)
 {
+	_pluma_tab_realize_view (tab);
+
 	return PLUMA_VIEW (tab->priv->view);
 }
 
@@ -1690,8 +1814,7 @@ pluma_tab_get_view (PlumaTab *tab)
 PlumaDocument *
 pluma_tab_get_document (PlumaTab *tab)
 {
-	return PLUMA_DOCUMENT (gtk_text_view_get_buffer (
-					GTK_TEXT_VIEW (tab->priv->view)));
+	return tab->priv->document;
 }
 
 #define MAX_DOC_NAME_LENGTH 40
@@ -1919,6 +2042,40 @@ get_icon (GtkIconTheme *theme,
 	return resize_icon (pixbuf, size);
 }
 
+/* Icon of a file that is not loaded yet, guessed from its name only so
+ * that opening many files does not stat each of them */
+static GdkPixbuf *
+get_icon_from_name (GtkIconTheme *theme,
+		    const gchar  *uri,
+		    gint          size)
+{
+	GdkPixbuf *pixbuf = NULL;
+	GtkIconInfo *icon_info;
+	gchar *basename;
+	gchar *content_type;
+	GIcon *gicon;
+
+	basename = g_path_get_basename (uri);
+	content_type = g_content_type_guess (basename, NULL, 0, NULL);
+	gicon = g_content_type_get_icon (content_type);
+
+	icon_info = gtk_icon_theme_lookup_by_gicon (theme, gicon, size, 0);
+	if (icon_info != NULL)
+	{
+		pixbuf = gtk_icon_info_load_icon (icon_info, NULL);
+		g_object_unref (icon_info);
+	}
+
+	g_object_unref (gicon);
+	g_free (content_type);
+	g_free (basename);
+
+	if (pixbuf == NULL)
+		return get_stock_icon (theme, "text-x-generic", size);
+
+	return resize_icon (pixbuf, size);
+}
+
 /* FIXME: add support for theme changed. I think it should be as easy as
    call g_object_notify (tab, "name") when the icon theme changes */
 GdkPixbuf *
@@ -1938,6 +2095,10 @@ _pluma_tab_get_icon (PlumaTab *tab)
 
 	gtk_icon_size_lookup (GTK_ICON_SIZE_MENU, NULL, &icon_size);
 
+	/* a tab waiting for its document to be loaded looks like any other */
+	if (tab->priv->pending_uri != NULL)
+		return get_icon_from_name (theme, tab->priv->pending_uri, icon_size);
+
 	switch (tab->priv->state)
 	{
 		case PLUMA_TAB_STATE_LOADING:
@@ -2054,6 +2215,67 @@ _pluma_tab_load (PlumaTab            *tab,
 			     create);
 }
 
+/* Puts the tab in the loading state, with the name of the file, but only
+ * starts loading when _pluma_tab_start_deferred_load () is called or when
+ * the tab is shown. Until it is shown the document is not highlighted. */
+void
+_pluma_tab_load_deferred (PlumaTab            *tab,
+			  const gchar         *uri,
+			  const PlumaEncoding *encoding,
+			  gint                 line_pos,
+			  gboolean             create)
+{
+	PlumaDocument *doc;
+
+	g_return_if_fail (PLUMA_IS_TAB (tab));
+	g_return_if_fail (tab->priv->state == PLUMA_TAB_STATE_NORMAL);
+
+	doc = pluma_tab_get_document (tab);
+	g_return_if_fail (PLUMA_IS_DOCUMENT (doc));
+
+	pluma_tab_set_state (tab, PLUMA_TAB_STATE_LOADING);
+
+	tab->priv->tmp_line_pos = line_pos;
+	tab->priv->tmp_encoding = encoding;
+
+	g_free (tab->priv->pending_uri);
+	tab->priv->pending_uri = g_strdup (uri);
+	tab->priv->pending_create = create;
+
+	if (tab->priv->auto_save_timeout > 0)
+		remove_auto_save_timeout (tab);
+
+	_pluma_document_set_highlight_deferred (doc, TRUE);
+	pluma_document_set_uri (doc, uri);
+}
+
+/* Returns FALSE if there was no deferred load to start */
+gboolean
+_pluma_tab_start_deferred_load (PlumaTab *tab)
+{
+	gchar *uri;
+
+	g_return_val_if_fail (PLUMA_IS_TAB (tab), FALSE);
+
+	if (tab->priv->pending_uri == NULL)
+		return FALSE;
+
+	g_return_val_if_fail (tab->priv->state == PLUMA_TAB_STATE_LOADING, FALSE);
+
+	uri = tab->priv->pending_uri;
+	tab->priv->pending_uri = NULL;
+
+	pluma_document_load (pluma_tab_get_document (tab),
+			     uri,
+			     tab->priv->tmp_encoding,
+			     tab->priv->tmp_line_pos,
+			     tab->priv->pending_create);
+
+	g_free (uri);
+
+	return TRUE;
+}
+
 void
 _pluma_tab_revert (PlumaTab *tab)
 {
@@ -2651,6 +2873,147 @@ _pluma_tab_print_preview (PlumaTab     *tab)
 					  GTK_PRINT_OPERATION_ACTION_PREVIEW);
 }
 
+static void
+replace_all_cancelled (GtkWidget *area,
+		       gint       response_id,
+		       PlumaTab  *tab)
+{
+	if (tab->priv->replace_cancellable != NULL)
+		g_cancellable_cancel (tab->priv->replace_cancellable);
+}
+
+static void
+replace_all_progress (gint      count,
+		      gdouble   fraction,
+		      PlumaTab *tab)
+{
+	gchar *msg;
+
+	if (tab->priv->message_area == NULL)
+		return;
+
+	/* the message area is shown only if replacing takes a while */
+	gtk_widget_show (tab->priv->message_area);
+
+	msg = g_strdup_printf (ngettext ("Replaced %d occurrence",
+					 "Replaced %d occurrences",
+					 count),
+			       count);
+
+	pluma_progress_message_area_set_text (PLUMA_PROGRESS_MESSAGE_AREA (tab->priv->message_area),
+					      msg);
+	pluma_progress_message_area_set_fraction (PLUMA_PROGRESS_MESSAGE_AREA (tab->priv->message_area),
+						  fraction);
+
+	g_free (msg);
+}
+
+static void
+replace_all_ready_cb (PlumaDocument *doc,
+		      GAsyncResult  *result,
+		      GTask         *task)
+{
+	PlumaTab *tab;
+	GError *error = NULL;
+	gint count;
+
+	tab = PLUMA_TAB (g_task_get_source_object (task));
+
+	count = pluma_document_replace_all_finish (doc, result, &error);
+
+	/* NULL if the tab has been disposed meanwhile */
+	if (tab->priv->replace_cancellable != NULL)
+	{
+		g_clear_object (&tab->priv->replace_cancellable);
+
+		set_message_area (tab, NULL); /* destroy the message area */
+
+		pluma_tab_set_state (tab, PLUMA_TAB_STATE_NORMAL);
+
+		gtk_widget_grab_focus (GTK_WIDGET (pluma_tab_get_view (tab)));
+	}
+
+	if (error != NULL)
+		g_task_return_error (task, error);
+	else
+		g_task_return_int (task, count);
+
+	g_object_unref (task);
+}
+
+/* Replaces all the occurrences of @find without blocking the main loop:
+ * meanwhile the tab is not editable and shows a progress message area
+ * from which the user can cancel, reverting the document. Documents
+ * without undo history are processed at once. */
+void
+_pluma_tab_replace_all (PlumaTab            *tab,
+			const gchar         *find,
+			const gchar         *replace,
+			guint                flags,
+			GAsyncReadyCallback  callback,
+			gpointer             user_data)
+{
+	GtkWidget *area;
+	GTask *task;
+
+	g_return_if_fail (PLUMA_IS_TAB (tab));
+	g_return_if_fail (tab->priv->state == PLUMA_TAB_STATE_NORMAL);
+	g_return_if_fail (tab->priv->replace_cancellable == NULL);
+
+	/* without undo history the replacements could not be reverted
+	 * on cancel: do them at once */
+	if (gtk_source_buffer_get_max_undo_levels (GTK_SOURCE_BUFFER (tab->priv->document)) == 0)
+	{
+		task = g_task_new (tab, NULL, callback, user_data);
+		g_task_return_int (task,
+				   pluma_document_replace_all (tab->priv->document,
+							       find,
+							       replace,
+							       flags));
+		g_object_unref (task);
+
+		return;
+	}
+
+	tab->priv->replace_cancellable = g_cancellable_new ();
+
+	task = g_task_new (tab, tab->priv->replace_cancellable, callback, user_data);
+
+	area = pluma_progress_message_area_new ("edit-find-replace",
+						_("Replacing all occurrences"),
+						TRUE);
+	g_signal_connect (area,
+			  "response",
+			  G_CALLBACK (replace_all_cancelled),
+			  tab);
+
+	/* like for printing, the area is not shown before the first
+	 * progress so that quick replacements do not flicker */
+	set_message_area (tab, area);
+
+	pluma_tab_set_state (tab, PLUMA_TAB_STATE_GENERIC_NOT_EDITABLE);
+
+	pluma_document_replace_all_async (tab->priv->document,
+					  find,
+					  replace,
+					  flags,
+					  tab->priv->replace_cancellable,
+					  (PlumaDocumentReplaceAllProgress) replace_all_progress,
+					  tab,
+					  (GAsyncReadyCallback) replace_all_ready_cb,
+					  task);
+}
+
+gint
+_pluma_tab_replace_all_finish (PlumaTab      *tab,
+			       GAsyncResult  *result,
+			       GError       **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, tab), -1);
+
+	return g_task_propagate_int (G_TASK (result), error);
+}
+
 void
 _pluma_tab_mark_for_closing (PlumaTab *tab)
 {
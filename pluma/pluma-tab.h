@@ -128,6 +128,8 @@ void		 pluma_tab_set_info_bar		(PlumaTab            *tab,
  * Non exported methods
  */
 GtkWidget 	*_pluma_tab_new 		(void);
+GtkWidget 	*_pluma_tab_new_unrealized	(void);
+void		 _pluma_tab_realize_view	(PlumaTab            *tab);
 
 /* Whether create is TRUE, creates a new empty document if location does
    not refer to an existing file */
@@ -143,6 +145,12 @@ void		 _pluma_tab_load		(PlumaTab            *tab,
 						 const PlumaEncoding *encoding,
 						 gint                 line_pos,
 						 gboolean             create);
+void		 _pluma_tab_load_deferred	(PlumaTab            *tab,
+						 const gchar         *uri,
+						 const PlumaEncoding *encoding,
+						 gint                 line_pos,
+						 gboolean             create);
+gboolean	 _pluma_tab_start_deferred_load	(PlumaTab            *tab);
 void		 _pluma_tab_revert		(PlumaTab            *tab);
 void		 _pluma_tab_save		(PlumaTab            *tab);
 void		 _pluma_tab_save_as		(PlumaTab            *tab,
@@ -153,6 +161,16 @@ void		 _pluma_tab_save_as		(PlumaTab            *tab,
 void		 _pluma_tab_print		(PlumaTab            *tab);
 void		 _pluma_tab_print_preview	(PlumaTab            *tab);
 
+void		 _pluma_tab_replace_all		(PlumaTab            *tab,
+						 const gchar         *find,
+						 const gchar         *replace,
+						 guint                flags,
+						 GAsyncReadyCallback  callback,
+						 gpointer             user_data);
+gint		 _pluma_tab_replace_all_finish	(PlumaTab            *tab,
+						 GAsyncResult        *result,
+						 GError             **error);
+
 void		 _pluma_tab_mark_for_closing	(PlumaTab	     *tab);
 
 gboolean	 _pluma_tab_can_close		(PlumaTab	     *tab);
@@ -63,6 +63,10 @@ static const GtkActionEntry pluma_always_sensitive_menu_entries[] =
 	{ "EditPreferences", "preferences-desktop", N_("Pr_eferences"), NULL,
 	  N_("Configure the application"), G_CALLBACK (_pluma_cmd_edit_preferences) },
 
+	/* Search menu */
+	{ "SearchFindInFiles", "edit-find", N_("Find in Fi_les..."), "<shift><control>H",
+	  N_("Search for text in the files of a folder"), G_CALLBACK (_pluma_cmd_search_find_in_files) },
+
 	/* Help menu */
 	{"HelpContents", "help-browser", N_("_Contents"), "F1",
 	 N_("Open the pluma manual"), G_CALLBACK (_pluma_cmd_help_contents) },
@@ -128,6 +132,8 @@ static const GtkActionEntry pluma_menu_entries[] =
 	  N_("Search for and replace text"), G_CALLBACK (_pluma_cmd_search_replace) },
 	{ "SearchClearHighlight", NULL, N_("_Clear Highlight"), "<shift><control>K",
 	  N_("Clear highlighting of search matches"), G_CALLBACK (_pluma_cmd_search_clear_highlight) },
+	{ "SearchHighlightTerms", NULL, N_("Highlight _Terms..."), NULL,
+	  N_("Highlight several terms at once, each in its own color"), G_CALLBACK (_pluma_cmd_search_highlight_terms) },
 	{ "SearchGoToLine", "go-jump", N_("Go to _Line..."), "<control>I",
 	  N_("Go to a specific line"), G_CALLBACK (_pluma_cmd_search_goto_line) },
 	{ "SearchIncrementalSearch", "edit-find", N_("_Incremental Search..."), "<control>K",
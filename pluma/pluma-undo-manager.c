@@ -0,0 +1,259 @@
+/*
+ * pluma-undo-manager.c
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * pluma is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * pluma is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with pluma; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Wraps the default undo manager of a GtkSourceBuffer, which records the
+ * changes, so that the redo steps can be forgotten without clearing the
+ * undo history: GtkSourceUndoManager has no way to drop only them.
+ *
+ * After pluma_undo_manager_forget_redo() the redo steps of that time are
+ * hidden. The undos which follow make as many steps redoable again, and
+ * a new change drops the redo history anyway.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "pluma-undo-manager.h"
+
+struct _PlumaUndoManagerPrivate
+{
+	GtkSourceBuffer      *buffer;
+	GtkSourceUndoManager *manager;
+
+	/* the number of redo steps which can be redone,
+	 * -1 when all of them can */
+	gint n_redo;
+};
+
+static void pluma_undo_manager_iface_init (GtkSourceUndoManagerIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (PlumaUndoManager, pluma_undo_manager, G_TYPE_OBJECT,
+			 G_ADD_PRIVATE (PlumaUndoManager)
+			 G_IMPLEMENT_INTERFACE (GTK_SOURCE_TYPE_UNDO_MANAGER,
+						pluma_undo_manager_iface_init))
+
+static void
+pluma_undo_manager_dispose (GObject *object)
+{
+	PlumaUndoManager *manager = PLUMA_UNDO_MANAGER (object);
+
+	if (manager->priv->buffer != NULL)
+	{
+		g_signal_handlers_disconnect_by_data (manager->priv->buffer, manager);
+		g_object_remove_weak_pointer (G_OBJECT (manager->priv->buffer),
+					      (gpointer *) &manager->priv->buffer);
+		manager->priv->buffer = NULL;
+	}
+
+	if (manager->priv->manager != NULL)
+	{
+		g_signal_handlers_disconnect_by_data (manager->priv->manager, manager);
+		g_clear_object (&manager->priv->manager);
+	}
+
+	G_OBJECT_CLASS (pluma_undo_manager_parent_class)->dispose (object);
+}
+
+static void
+pluma_undo_manager_class_init (PlumaUndoManagerClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->dispose = pluma_undo_manager_dispose;
+}
+
+static void
+pluma_undo_manager_init (PlumaUndoManager *manager)
+{
+	manager->priv = pluma_undo_manager_get_instance_private (manager);
+
+	manager->priv->n_redo = -1;
+}
+
+static gboolean
+pluma_undo_manager_can_undo (GtkSourceUndoManager *undo_manager)
+{
+	PlumaUndoManager *manager = PLUMA_UNDO_MANAGER (undo_manager);
+
+	return gtk_source_undo_manager_can_undo (manager->priv->manager);
+}
+
+static gboolean
+pluma_undo_manager_can_redo (GtkSourceUndoManager *undo_manager)
+{
+	PlumaUndoManager *manager = PLUMA_UNDO_MANAGER (undo_manager);
+
+	return manager->priv->n_redo != 0 &&
+	       gtk_source_undo_manager_can_redo (manager->priv->manager);
+}
+
+static void
+set_n_redo (PlumaUndoManager *manager,
+	    gint              n_redo)
+{
+	gboolean could_redo;
+
+	could_redo = pluma_undo_manager_can_redo (GTK_SOURCE_UNDO_MANAGER (manager));
+	manager->priv->n_redo = n_redo;
+
+	if (could_redo != pluma_undo_manager_can_redo (GTK_SOURCE_UNDO_MANAGER (manager)))
+		gtk_source_undo_manager_can_redo_changed (GTK_SOURCE_UNDO_MANAGER (manager));
+}
+
+static void
+pluma_undo_manager_undo (GtkSourceUndoManager *undo_manager)
+{
+	PlumaUndoManager *manager = PLUMA_UNDO_MANAGER (undo_manager);
+
+	gtk_source_undo_manager_undo (manager->priv->manager);
+
+	if (manager->priv->n_redo >= 0)
+		set_n_redo (manager, manager->priv->n_redo + 1);
+}
+
+static void
+pluma_undo_manager_redo (GtkSourceUndoManager *undo_manager)
+{
+	PlumaUndoManager *manager = PLUMA_UNDO_MANAGER (undo_manager);
+
+	if (manager->priv->n_redo == 0)
+		return;
+
+	gtk_source_undo_manager_redo (manager->priv->manager);
+
+	if (manager->priv->n_redo > 0)
+		set_n_redo (manager, manager->priv->n_redo - 1);
+}
+
+static void
+pluma_undo_manager_begin_not_undoable_action (GtkSourceUndoManager *undo_manager)
+{
+	PlumaUndoManager *manager = PLUMA_UNDO_MANAGER (undo_manager);
+
+	gtk_source_undo_manager_begin_not_undoable_action (manager->priv->manager);
+}
+
+static void
+pluma_undo_manager_end_not_undoable_action (GtkSourceUndoManager *undo_manager)
+{
+	PlumaUndoManager *manager = PLUMA_UNDO_MANAGER (undo_manager);
+
+	gtk_source_undo_manager_end_not_undoable_action (manager->priv->manager);
+}
+
+static void
+pluma_undo_manager_iface_init (GtkSourceUndoManagerIface *iface)
+{
+	iface->can_undo = pluma_undo_manager_can_undo;
+	iface->can_redo = pluma_undo_manager_can_redo;
+	iface->undo = pluma_undo_manager_undo;
+	iface->redo = pluma_undo_manager_redo;
+	iface->begin_not_undoable_action = pluma_undo_manager_begin_not_undoable_action;
+	iface->end_not_undoable_action = pluma_undo_manager_end_not_undoable_action;
+}
+
+static void
+can_undo_changed_cb (GtkSourceUndoManager *undo_manager,
+		     PlumaUndoManager     *manager)
+{
+	gtk_source_undo_manager_can_undo_changed (GTK_SOURCE_UNDO_MANAGER (manager));
+}
+
+static void
+can_redo_changed_cb (GtkSourceUndoManager *undo_manager,
+		     PlumaUndoManager     *manager)
+{
+	/* the redo history is gone, with the forgotten steps */
+	if (!gtk_source_undo_manager_can_redo (undo_manager))
+		manager->priv->n_redo = -1;
+
+	gtk_source_undo_manager_can_redo_changed (GTK_SOURCE_UNDO_MANAGER (manager));
+}
+
+static void
+max_undo_levels_notify_cb (GtkSourceBuffer  *buffer,
+			   GParamSpec       *pspec,
+			   PlumaUndoManager *manager)
+{
+	/* the buffer sets the levels only on its own default manager */
+	g_object_set (manager->priv->manager,
+		      "max-undo-levels", gtk_source_buffer_get_max_undo_levels (buffer),
+		      NULL);
+}
+
+/**
+ * pluma_undo_manager_new:
+ * @buffer: a #GtkSourceBuffer
+ *
+ * Creates an undo manager wrapping the current undo manager of @buffer,
+ * to be set on @buffer with gtk_source_buffer_set_undo_manager().
+ *
+ * Returns: (transfer full): the new undo manager
+ */
+GtkSourceUndoManager *
+pluma_undo_manager_new (GtkSourceBuffer *buffer)
+{
+	PlumaUndoManager *manager;
+
+	g_return_val_if_fail (GTK_SOURCE_IS_BUFFER (buffer), NULL);
+
+	manager = g_object_new (PLUMA_TYPE_UNDO_MANAGER, NULL);
+
+	manager->priv->buffer = buffer;
+	g_object_add_weak_pointer (G_OBJECT (buffer),
+				   (gpointer *) &manager->priv->buffer);
+
+	manager->priv->manager = g_object_ref (gtk_source_buffer_get_undo_manager (buffer));
+
+	g_signal_connect (manager->priv->manager,
+			  "can-undo-changed",
+			  G_CALLBACK (can_undo_changed_cb),
+			  manager);
+	g_signal_connect (manager->priv->manager,
+			  "can-redo-changed",
+			  G_CALLBACK (can_redo_changed_cb),
+			  manager);
+	g_signal_connect (buffer,
+			  "notify::max-undo-levels",
+			  G_CALLBACK (max_undo_levels_notify_cb),
+			  manager);
+
+	return GTK_SOURCE_UNDO_MANAGER (manager);
+}
+
+/**
+ * pluma_undo_manager_forget_redo:
+ * @manager: a #PlumaUndoManager
+ *
+ * Makes the current redo steps impossible to redo, while the undo history
+ * is kept.
+ */
+void
+pluma_undo_manager_forget_redo (PlumaUndoManager *manager)
+{
+	g_return_if_fail (PLUMA_IS_UNDO_MANAGER (manager));
+
+	if (gtk_source_undo_manager_can_redo (manager->priv->manager))
+		set_n_redo (manager, 0);
+}
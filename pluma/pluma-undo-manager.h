@@ -0,0 +1,61 @@
+/*
+ * pluma-undo-manager.h
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * pluma is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * pluma is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with pluma; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ */
+
+#ifndef __PLUMA_UNDO_MANAGER_H__
+#define __PLUMA_UNDO_MANAGER_H__
+
+#include <gtksourceview/gtksource.h>
+
+G_BEGIN_DECLS
+
+#define PLUMA_TYPE_UNDO_MANAGER			(pluma_undo_manager_get_type ())
+#define PLUMA_UNDO_MANAGER(obj)			(G_TYPE_CHECK_INSTANCE_CAST ((obj), PLUMA_TYPE_UNDO_MANAGER, PlumaUndoManager))
+#define PLUMA_UNDO_MANAGER_CLASS(klass)		(G_TYPE_CHECK_CLASS_CAST ((klass), PLUMA_TYPE_UNDO_MANAGER, PlumaUndoManagerClass))
+#define PLUMA_IS_UNDO_MANAGER(obj)		(G_TYPE_CHECK_INSTANCE_TYPE ((obj), PLUMA_TYPE_UNDO_MANAGER))
+#define PLUMA_IS_UNDO_MANAGER_CLASS(klass)	(G_TYPE_CHECK_CLASS_TYPE ((klass), PLUMA_TYPE_UNDO_MANAGER))
+#define PLUMA_UNDO_MANAGER_GET_CLASS(obj)	(G_TYPE_INSTANCE_GET_CLASS ((obj), PLUMA_TYPE_UNDO_MANAGER, PlumaUndoManagerClass))
+
+typedef struct _PlumaUndoManager		PlumaUndoManager;
+typedef struct _PlumaUndoManagerClass		PlumaUndoManagerClass;
+typedef struct _PlumaUndoManagerPrivate		PlumaUndoManagerPrivate;
+
+struct _PlumaUndoManager
+{
+	GObject parent;
+
+	PlumaUndoManagerPrivate *priv;
+};
+
+struct _PlumaUndoManagerClass
+{
+	GObjectClass parent_class;
+};
+
+GType			 pluma_undo_manager_get_type		(void) G_GNUC_CONST;
+
+GtkSourceUndoManager	*pluma_undo_manager_new			(GtkSourceBuffer  *buffer);
+
+void			 pluma_undo_manager_forget_redo		(PlumaUndoManager *manager);
+
+G_END_DECLS
+
+#endif /* __PLUMA_UNDO_MANAGER_H__ */
@@ -2143,7 +2143,8 @@ pluma_view_draw (GtkWidget *widget,
     window = gtk_text_view_get_window (text_view, GTK_TEXT_WINDOW_TEXT);
 
     if (gtk_cairo_should_draw_window (cr, window) &&
-        pluma_document_get_enable_search_highlighting (doc))
+        (pluma_document_get_enable_search_highlighting (doc) ||
+         _pluma_document_get_has_highlight_terms (doc)))
     {
         GdkRectangle visible_rect;
         GtkTextIter iter1, iter2;
@@ -2156,6 +2157,9 @@ pluma_view_draw (GtkWidget *widget,
                                      + visible_rect.height, NULL);
         gtk_text_iter_forward_line (&iter2);
 
+        _pluma_document_highlight_region (doc,
+                                          &iter1,
+                                          &iter2);
         _pluma_document_search_region (doc,
                                        &iter1,
                                        &iter2);
@@ -2432,6 +2436,8 @@ search_highlight_updated_cb (PlumaDocument *doc,
     text_view = GTK_TEXT_VIEW (view);
 
     g_return_if_fail (pluma_document_get_enable_search_highlighting (
+                      PLUMA_DOCUMENT (gtk_text_view_get_buffer (text_view))) ||
+                      _pluma_document_get_has_highlight_terms (
                       PLUMA_DOCUMENT (gtk_text_view_get_buffer (text_view))));
 
     /* get visible area */
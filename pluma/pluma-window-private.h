@@ -51,6 +51,9 @@ struct _PlumaWindowPrivate
 	GtkWidget      *side_panel;
 	GtkWidget      *bottom_panel;
 
+	/* created on first use */
+	GtkWidget      *find_in_files_panel;
+
 	GtkWidget      *hpaned;
 	GtkWidget      *vpaned;
 
@@ -83,7 +86,7 @@ struct _PlumaWindowPrivate
 	GtkActionGroup *panes_action_group;
 	GtkActionGroup *languages_action_group;
 	GtkActionGroup *documents_list_action_group;
-	guint           documents_list_menu_ui_id;
+	GPtrArray      *documents_list_actions;
 	GtkWidget      *toolbar;
 	GtkWidget      *toolbar_recent_menu;
 	GtkWidget      *menubar;
@@ -116,6 +119,8 @@ struct _PlumaWindowPrivate
 
 	gboolean        removing_tabs : 1;
 	gboolean        dispose_has_run : 1;
+	gboolean        languages_menu_built : 1;
+	gboolean        language_combo_filled : 1;
 };
 
 G_END_DECLS
@@ -66,6 +66,8 @@
 #define LANGUAGE_NONE (const gchar *)"LangNone"
 #define TAB_WIDTH_DATA "PlumaWindowTabWidthData"
 #define LANGUAGE_DATA "PlumaWindowLanguageData"
+#define DOCUMENTS_LIST_TAB_DATA "PlumaWindowDocumentsListTabData"
+#define DOCUMENTS_LIST_MERGE_ID_DATA "PlumaWindowDocumentsListMergeIdData"
 #define FULLSCREEN_ANIMATION_SPEED 4
 
 #define PLUMA_WINDOW_DEFAULT_WIDTH 650
@@ -271,6 +273,8 @@ pluma_window_finalize (GObject *object)
     if (window->priv->default_location != NULL)
         g_object_unref (window->priv->default_location);
 
+    g_ptr_array_unref (window->priv->documents_list_actions);
+
     G_OBJECT_CLASS (pluma_window_parent_class)->finalize (object);
 }
 
@@ -911,6 +915,12 @@ set_sensitivity_according_to_tab (PlumaWindow *window,
                               (state_normal ||
                               state == PLUMA_TAB_STATE_EXTERNALLY_MODIFIED_NOTIFICATION) && b);
 
+    action = gtk_action_group_get_action (window->priv->action_group,
+                                          "SearchHighlightTerms");
+    gtk_action_set_sensitive (action,
+                              (state_normal ||
+                              state == PLUMA_TAB_STATE_EXTERNALLY_MODIFIED_NOTIFICATION));
+
     action = gtk_action_group_get_action (window->priv->action_group,
                                           "SearchGoToLine");
     gtk_action_set_sensitive (action,
@@ -976,44 +986,79 @@ escape_section_name (const gchar *name)
     return ret;
 }
 
+typedef struct
+{
+    GtkSourceLanguage *language;
+    gchar             *escaped_section;
+    gchar             *section_label;
+    gchar             *label;
+    gchar             *tip;
+} LanguageMenuEntry;
+
+/* The sorted languages and the strings of their menu items, computed
+ * once and shared by the menus of all the windows */
+static GArray *
+get_language_menu_entries (void)
+{
+    static GArray *entries = NULL;
+    GSList *languages;
+    GSList *l;
+
+    if (entries != NULL)
+        return entries;
+
+    entries = g_array_new (FALSE, FALSE, sizeof (LanguageMenuEntry));
+
+    languages = pluma_language_manager_list_languages_sorted (pluma_get_language_manager (),
+                                                              FALSE);
+
+    for (l = languages; l != NULL; l = l->next)
+    {
+        LanguageMenuEntry entry;
+        const gchar *section;
+        const gchar *name;
+
+        entry.language = l->data;
+
+        section = gtk_source_language_get_section (entry.language);
+        entry.escaped_section = escape_section_name (section);
+        entry.section_label = pluma_utils_escape_underscores (section, -1);
+
+        name = gtk_source_language_get_name (entry.language);
+        entry.label = pluma_utils_escape_underscores (name, -1);
+        entry.tip = g_strdup_printf (_("Use %s highlight mode"), name);
+
+        g_array_append_val (entries, entry);
+    }
+
+    g_slist_free (languages);
+
+    return entries;
+}
+
 static void
-create_language_menu_item (GtkSourceLanguage *lang,
-                           gint           index,
-                           guint          ui_id,
-                           PlumaWindow       *window)
+create_language_menu_item (const LanguageMenuEntry *entry,
+                           gint                     index,
+                           guint                    ui_id,
+                           GSList                 **group,
+                           PlumaWindow             *window)
 {
     GtkAction *section_action;
     GtkRadioAction *action;
-    GtkAction *normal_action;
-    GSList *group;
-    const gchar *section;
-    gchar *escaped_section;
     const gchar *lang_id;
-    const gchar *lang_name;
-    gchar *escaped_lang_name;
-    gchar *tip;
     gchar *path;
 
-    section = gtk_source_language_get_section (lang);
-    escaped_section = escape_section_name (section);
-
     /* check if the section submenu exists or create it */
     section_action = gtk_action_group_get_action (window->priv->languages_action_group,
-                                                  escaped_section);
+                                                  entry->escaped_section);
 
     if (section_action == NULL)
     {
-        gchar *section_name;
-
-        section_name = pluma_utils_escape_underscores (section, -1);
-
-        section_action = gtk_action_new (escaped_section,
-                                         section_name,
+        section_action = gtk_action_new (entry->escaped_section,
+                                         entry->section_label,
                                          NULL,
                                          NULL);
 
-        g_free (section_name);
-
         gtk_action_group_add_action (window->priv->languages_action_group,
                                      section_action);
         g_object_unref (section_action);
@@ -1021,30 +1066,24 @@ create_language_menu_item (GtkSourceLanguage *lang,
         gtk_ui_manager_add_ui (window->priv->manager,
                                ui_id,
                                "/MenuBar/ViewMenu/ViewHighlightModeMenu/LanguagesMenuPlaceholder",
-                               escaped_section,
-                               escaped_section,
+                               entry->escaped_section,
+                               entry->escaped_section,
                                GTK_UI_MANAGER_MENU,
                                FALSE);
     }
 
     /* now add the language item to the section */
-    lang_name = gtk_source_language_get_name (lang);
-    lang_id = gtk_source_language_get_id (lang);
+    lang_id = gtk_source_language_get_id (entry->language);
 
-    escaped_lang_name = pluma_utils_escape_underscores (lang_name, -1);
-
-    tip = g_strdup_printf (_("Use %s highlight mode"), lang_name);
     path = g_strdup_printf ("/MenuBar/ViewMenu/ViewHighlightModeMenu/LanguagesMenuPlaceholder/%s",
-                            escaped_section);
+                            entry->escaped_section);
 
     action = gtk_radio_action_new (lang_id,
-                                   escaped_lang_name,
-                                   tip,
+                                   entry->label,
+                                   entry->tip,
                                    NULL,
                                    index);
 
-    g_free (escaped_lang_name);
-
     /* Action is added with a NULL accel to make the accel overridable */
     gtk_action_group_add_action_with_accel (window->priv->languages_action_group,
                                             GTK_ACTION (action),
@@ -1052,10 +1091,8 @@ create_language_menu_item (GtkSourceLanguage *lang,
     g_object_unref (action);
 
     /* add the action to the same radio group of the "Normal" action */
-    normal_action = gtk_action_group_get_action (window->priv->languages_action_group,
-                                                 LANGUAGE_NONE);
-    group = gtk_radio_action_get_group (GTK_RADIO_ACTION (normal_action));
-    gtk_radio_action_set_group (action, group);
+    gtk_radio_action_set_group (action, *group);
+    *group = gtk_radio_action_get_group (action);
 
     g_signal_connect (action,
                       "activate",
@@ -1071,21 +1108,26 @@ create_language_menu_item (GtkSourceLanguage *lang,
                            FALSE);
 
     g_free (path);
-    g_free (tip);
-    g_free (escaped_section);
 }
 
+static void update_languages_menu (PlumaWindow *window);
+
 static void
 create_languages_menu (PlumaWindow *window)
 {
     GtkRadioAction *action_none;
-    GSList *languages;
-    GSList *l;
+    GArray *entries;
+    GSList *group;
     guint id;
-    gint i;
+    guint i;
+
+    if (window->priv->languages_menu_built)
+        return;
 
     pluma_debug (DEBUG_WINDOW);
 
+    window->priv->languages_menu_built = TRUE;
+
     /* add the "Plain Text" item before all the others */
 
     /* Translators: "Plain Text" means that no highlight mode is selected in the
@@ -1117,18 +1159,30 @@ create_languages_menu (PlumaWindow *window)
     gtk_toggle_action_set_active (GTK_TOGGLE_ACTION (action_none), TRUE);
 
     /* now add all the known languages */
-    languages = pluma_language_manager_list_languages_sorted (pluma_get_language_manager (),
-                                                              FALSE);
+    entries = get_language_menu_entries ();
+    group = gtk_radio_action_get_group (action_none);
 
-    for (l = languages, i = 0; l != NULL; l = l->next, ++i)
+    for (i = 0; i < entries->len; ++i)
     {
-        create_language_menu_item (l->data,
+        create_language_menu_item (&g_array_index (entries, LanguageMenuEntry, i),
                                    i,
                                    id,
+                                   &group,
                                    window);
     }
 
-    g_slist_free (languages);
+    update_languages_menu (window);
+}
+
+/* The languages menu is only built the first time the View menu is
+ * opened, most windows never need it */
+static void
+view_menu_selected (GtkMenuItem *item,
+                    PlumaWindow *window)
+{
+    create_languages_menu (window);
+
+    g_signal_handlers_disconnect_by_func (item, view_menu_selected, window);
 }
 
 static void
@@ -1145,6 +1199,9 @@ update_languages_menu (PlumaWindow *window)
     if (doc == NULL)
         return;
 
+    if (!window->priv->languages_menu_built)
+        return;
+
     lang = pluma_document_get_language (doc);
     if (lang != NULL)
         lang_id = gtk_source_language_get_id (lang);
@@ -1498,6 +1555,18 @@ setup_toolbar_open_button (PlumaWindow *window,
     return toolbar_recent_menu;
 }
 
+static void
+ui_manager_pre_activate (GtkUIManager *manager,
+                         GtkAction    *action,
+                         gpointer      data)
+{
+    gchar *trigger;
+
+    trigger = g_strconcat ("action:", gtk_action_get_name (action), NULL);
+    pluma_plugins_engine_trigger (pluma_plugins_engine_get_default (), trigger);
+    g_free (trigger);
+}
+
 static void
 create_menu_bar_and_toolbar (PlumaWindow *window,
                              GtkWidget   *main_box)
@@ -1513,6 +1582,11 @@ create_menu_bar_and_toolbar (PlumaWindow *window,
     manager = gtk_ui_manager_new ();
     window->priv->manager = manager;
 
+    g_signal_connect (manager,
+                      "pre-activate",
+                      G_CALLBACK (ui_manager_pre_activate),
+                      NULL);
+
     gtk_window_add_accel_group (GTK_WINDOW (window),
                                 gtk_ui_manager_get_accel_group (manager));
 
@@ -1632,7 +1706,6 @@ create_menu_bar_and_toolbar (PlumaWindow *window,
     window->priv->languages_action_group = action_group;
     gtk_ui_manager_insert_action_group (manager, action_group, 0);
     g_object_unref (action_group);
-    create_languages_menu (window);
 
     /* list of open documents menu */
     action_group = gtk_action_group_new ("DocumentsListActions");
@@ -1642,6 +1715,10 @@ create_menu_bar_and_toolbar (PlumaWindow *window,
     g_object_unref (action_group);
 
     window->priv->menubar = gtk_ui_manager_get_widget (manager, "/MenuBar");
+    g_signal_connect (gtk_ui_manager_get_widget (manager, "/MenuBar/ViewMenu"),
+                      "select",
+                      G_CALLBACK (view_menu_selected),
+                      window);
     gtk_box_pack_start (GTK_BOX (main_box),
                         window->priv->menubar,
                         FALSE,
@@ -1708,105 +1785,176 @@ get_menu_tip_for_tab (PlumaTab *tab)
 }
 
 static void
-update_documents_list_menu (PlumaWindow *window)
+sync_documents_list_item (PlumaWindow *window,
+                          GtkAction   *action,
+                          PlumaTab    *tab)
+{
+    gchar *tab_name;
+    gchar *name;
+    gchar *tip;
+
+    tab_name = _pluma_tab_get_name (tab);
+    name = pluma_utils_escape_underscores (tab_name, -1);
+    tip =  get_menu_tip_for_tab (tab);
+
+    g_object_set (action, "label", name, "tooltip", tip, NULL);
+    g_object_set_data (G_OBJECT (action), DOCUMENTS_LIST_TAB_DATA, tab);
+
+    g_free (tab_name);
+    g_free (name);
+    g_free (tip);
+}
+
+static void
+add_documents_list_item (PlumaWindow *window)
 {
     PlumaWindowPrivate *p = window->priv;
-    GList *actions, *l;
-    gint n, i;
+    GtkRadioAction *action;
+    gchar *action_name;
+    gchar *accel;
     guint id;
-    GSList *group = NULL;
+    gint i;
 
-    pluma_debug (DEBUG_WINDOW);
+    i = p->documents_list_actions->len;
 
-    g_return_if_fail (p->documents_list_action_group != NULL);
+    /* NOTE: the action is associated to the position of the tab in
+     * the notebook not to the tab itself! This is needed to work
+     * around the gtk+ bug #170727: gtk leaves around the accels
+     * of the action. Since the accel depends on the tab position
+     * the problem is worked around, action with the same name always
+     * get the same accel.
+     */
+    action_name = g_strdup_printf ("Tab_%d", i);
 
-    if (p->documents_list_menu_ui_id != 0)
-        gtk_ui_manager_remove_ui (p->manager,
-                                  p->documents_list_menu_ui_id);
+    /* alt + 1, 2, 3... 0 to switch to the first ten tabs */
+    accel = (i < 10) ? g_strdup_printf ("<alt>%d", (i + 1) % 10) : NULL;
 
-    actions = gtk_action_group_list_actions (p->documents_list_action_group);
-    for (l = actions; l != NULL; l = l->next)
+    action = gtk_radio_action_new (action_name,
+                                   NULL,
+                                   NULL,
+                                   NULL,
+                                   i);
+
+    if (i > 0)
     {
-        g_signal_handlers_disconnect_by_func (GTK_ACTION (l->data),
-                                              G_CALLBACK (documents_list_menu_activate),
-                                              window);
-         gtk_action_group_remove_action (p->documents_list_action_group,
-                                         GTK_ACTION (l->data));
+        GtkRadioAction *first = g_ptr_array_index (p->documents_list_actions, 0);
+
+        gtk_radio_action_join_group (action, first);
     }
-    g_list_free (actions);
+
+    gtk_action_group_add_action_with_accel (p->documents_list_action_group,
+                                            GTK_ACTION (action),
+                                            accel);
+
+    g_signal_connect (action,
+                      "activate",
+                      G_CALLBACK (documents_list_menu_activate),
+                      window);
+
+    /* one merge id per item, so that the last one can be removed alone */
+    id = gtk_ui_manager_new_merge_id (p->manager);
+
+    gtk_ui_manager_add_ui (p->manager,
+                           id,
+                           "/MenuBar/DocumentsMenu/DocumentsListPlaceholder",
+                           action_name, action_name,
+                           GTK_UI_MANAGER_MENUITEM,
+                           FALSE);
+
+    g_object_set_data (G_OBJECT (action), DOCUMENTS_LIST_MERGE_ID_DATA, GUINT_TO_POINTER (id));
+
+    g_ptr_array_add (p->documents_list_actions, action);
+
+    g_free (action_name);
+    g_free (accel);
+}
+
+static void
+remove_last_documents_list_item (PlumaWindow *window)
+{
+    PlumaWindowPrivate *p = window->priv;
+    GtkAction *action;
+    guint id;
+
+    action = g_ptr_array_index (p->documents_list_actions,
+                                p->documents_list_actions->len - 1);
+
+    id = GPOINTER_TO_UINT (g_object_get_data (G_OBJECT (action), DOCUMENTS_LIST_MERGE_ID_DATA));
+    gtk_ui_manager_remove_ui (p->manager, id);
+
+    g_signal_handlers_disconnect_by_func (action,
+                                          G_CALLBACK (documents_list_menu_activate),
+                                          window);
+    gtk_radio_action_join_group (GTK_RADIO_ACTION (action), NULL);
+    gtk_action_group_remove_action (p->documents_list_action_group, action);
+
+    g_ptr_array_remove_index (p->documents_list_actions,
+                              p->documents_list_actions->len - 1);
+}
+
+/* Brings the documents menu in sync with the notebook by adding or
+ * removing items at the end and relabeling only the positions whose tab
+ * changed, instead of building the whole menu again. */
+static void
+update_documents_list_menu (PlumaWindow *window)
+{
+    PlumaWindowPrivate *p = window->priv;
+    gint n, i;
+
+    pluma_debug (DEBUG_WINDOW);
+
+    g_return_if_fail (p->documents_list_action_group != NULL);
 
     n = gtk_notebook_get_n_pages (GTK_NOTEBOOK (p->notebook));
 
-    id = (n > 0) ? gtk_ui_manager_new_merge_id (p->manager) : 0;
+    while ((gint) p->documents_list_actions->len > n)
+        remove_last_documents_list_item (window);
+
+    while ((gint) p->documents_list_actions->len < n)
+        add_documents_list_item (window);
 
     for (i = 0; i < n; i++)
     {
+        GtkAction *action;
         GtkWidget *tab;
-        GtkRadioAction *action;
-        gchar *action_name;
-        gchar *tab_name;
-        gchar *name;
-        gchar *tip;
-        gchar *accel;
 
+        action = g_ptr_array_index (p->documents_list_actions, i);
         tab = gtk_notebook_get_nth_page (GTK_NOTEBOOK (p->notebook), i);
 
-        /* NOTE: the action is associated to the position of the tab in
-         * the notebook not to the tab itself! This is needed to work
-         * around the gtk+ bug #170727: gtk leaves around the accels
-         * of the action. Since the accel depends on the tab position
-         * the problem is worked around, action with the same name always
-         * get the same accel.
-         */
-        action_name = g_strdup_printf ("Tab_%d", i);
-        tab_name = _pluma_tab_get_name (PLUMA_TAB (tab));
-        name = pluma_utils_escape_underscores (tab_name, -1);
-        tip =  get_menu_tip_for_tab (PLUMA_TAB (tab));
-
-        /* alt + 1, 2, 3... 0 to switch to the first ten tabs */
-        accel = (i < 10) ? g_strdup_printf ("<alt>%d", (i + 1) % 10) : NULL;
-
-        action = gtk_radio_action_new (action_name,
-                                       name,
-                                       tip,
-                                       NULL,
-                                       i);
-
-        if (group != NULL)
-            gtk_radio_action_set_group (action, group);
-
-        /* note that group changes each time we add an action, so it must be updated */
-        group = gtk_radio_action_get_group (action);
-
-        gtk_action_group_add_action_with_accel (p->documents_list_action_group,
-                                                GTK_ACTION (action),
-                                                accel);
+        if (g_object_get_data (G_OBJECT (action), DOCUMENTS_LIST_TAB_DATA) != tab)
+            sync_documents_list_item (window, action, PLUMA_TAB (tab));
+    }
 
-        g_signal_connect (action,
-                          "activate",
-                          G_CALLBACK (documents_list_menu_activate),
-                          window);
+    i = gtk_notebook_get_current_page (GTK_NOTEBOOK (p->notebook));
 
-        gtk_ui_manager_add_ui (p->manager,
-                               id,
-                               "/MenuBar/DocumentsMenu/DocumentsListPlaceholder",
-                               action_name, action_name,
-                               GTK_UI_MANAGER_MENUITEM,
-                               FALSE);
+    if (i >= 0 && i < n)
+    {
+        GtkAction *action = g_ptr_array_index (p->documents_list_actions, i);
 
-        if (PLUMA_TAB (tab) == p->active_tab)
-            gtk_toggle_action_set_active (GTK_TOGGLE_ACTION (action), TRUE);
+        g_signal_handlers_block_by_func (action,
+                                         G_CALLBACK (documents_list_menu_activate),
+                                         window);
+        gtk_toggle_action_set_active (GTK_TOGGLE_ACTION (action), TRUE);
+        g_signal_handlers_unblock_by_func (action,
+                                           G_CALLBACK (documents_list_menu_activate),
+                                           window);
+    }
+}
 
-        g_object_unref (action);
+static void
+forget_documents_list_tab (PlumaWindow *window,
+                           PlumaTab    *tab)
+{
+    guint i;
 
-        g_free (action_name);
-        g_free (tab_name);
-        g_free (name);
-        g_free (tip);
-        g_free (accel);
-    }
+    /* a new tab could be allocated at the same address */
+    for (i = 0; i < window->priv->documents_list_actions->len; i++)
+    {
+        GObject *action = g_ptr_array_index (window->priv->documents_list_actions, i);
 
-    p->documents_list_menu_ui_id = id;
+        if (g_object_get_data (action, DOCUMENTS_LIST_TAB_DATA) == tab)
+            g_object_set_data (action, DOCUMENTS_LIST_TAB_DATA, NULL);
+    }
 }
 
 /* Returns TRUE if status bar is visible */
@@ -1966,14 +2114,12 @@ fill_tab_width_combo (PlumaWindow *window)
 static void
 fill_language_combo (PlumaWindow *window)
 {
-    GtkSourceLanguageManager *manager;
-    GSList *languages;
-    GSList *item;
+    GArray *entries;
     GtkWidget *menu_item;
     const gchar *name;
+    guint i;
 
-    manager = pluma_get_language_manager ();
-    languages = pluma_language_manager_list_languages_sorted (manager, FALSE);
+    entries = get_language_menu_entries ();
 
     name = _("Plain Text");
     menu_item = gtk_menu_item_new_with_label (name);
@@ -1984,9 +2130,9 @@ fill_language_combo (PlumaWindow *window)
                                      GTK_MENU_ITEM (menu_item),
                                      name);
 
-    for (item = languages; item; item = item->next)
+    for (i = 0; i < entries->len; ++i)
     {
-        GtkSourceLanguage *lang = GTK_SOURCE_LANGUAGE (item->data);
+        GtkSourceLanguage *lang = g_array_index (entries, LanguageMenuEntry, i).language;
 
         name = gtk_source_language_get_name (lang);
         menu_item = gtk_menu_item_new_with_label (name);
@@ -2001,8 +2147,28 @@ fill_language_combo (PlumaWindow *window)
                                          GTK_MENU_ITEM (menu_item),
                                          name);
     }
+}
 
-    g_slist_free (languages);
+static void set_language_combo_item (PlumaWindow       *window,
+                                     GtkSourceLanguage *language);
+
+/* Like the languages menu, the combo is only filled when it is first
+ * opened */
+static void
+language_combo_popup (PlumaStatusComboBox *combo,
+                      PlumaWindow         *window)
+{
+    PlumaDocument *doc;
+
+    if (window->priv->language_combo_filled)
+        return;
+
+    window->priv->language_combo_filled = TRUE;
+    fill_language_combo (window);
+
+    doc = pluma_window_get_active_document (window);
+    if (doc != NULL)
+        set_language_combo_item (window, pluma_document_get_language (doc));
 }
 
 static void
@@ -2046,8 +2212,9 @@ create_statusbar (PlumaWindow *window,
                       TRUE,
                       0);
 
-    fill_language_combo (window);
-
+    g_signal_connect (window->priv->language_combo, "popup",
+                      G_CALLBACK (language_combo_popup),
+                      window);
     g_signal_connect (window->priv->language_combo, "changed",
                       G_CALLBACK (language_combo_changed),
                       window);
@@ -2365,22 +2532,26 @@ tab_width_changed (GObject     *object,
 }
 
 static void
-language_changed (GObject     *object,
-                  GParamSpec  *pspec,
-                  PlumaWindow *window)
+set_language_combo_item (PlumaWindow       *window,
+                         GtkSourceLanguage *language)
 {
     GList *items;
     GList *item;
     PlumaStatusComboBox *combo = PLUMA_STATUS_COMBO_BOX (window->priv->language_combo);
-    GtkSourceLanguage *new_language;
     const gchar *new_id;
 
-    items = pluma_status_combo_box_get_items (combo);
+    if (!window->priv->language_combo_filled)
+    {
+        gtk_label_set_text (pluma_status_combo_box_get_item_label (combo),
+                            language != NULL ? gtk_source_language_get_name (language)
+                                             : _("Plain Text"));
+        return;
+    }
 
-    new_language = gtk_source_buffer_get_language (GTK_SOURCE_BUFFER (object));
+    items = pluma_status_combo_box_get_items (combo);
 
-    if (new_language)
-        new_id = gtk_source_language_get_id (new_language);
+    if (language)
+        new_id = gtk_source_language_get_id (language);
     else
         new_id = NULL;
 
@@ -2407,6 +2578,27 @@ language_changed (GObject     *object,
     g_list_free (items);
 }
 
+static void
+language_changed (GObject     *object,
+                  GParamSpec  *pspec,
+                  PlumaWindow *window)
+{
+    GtkSourceLanguage *new_language;
+
+    new_language = gtk_source_buffer_get_language (GTK_SOURCE_BUFFER (object));
+
+    set_language_combo_item (window, new_language);
+
+    if (new_language != NULL)
+    {
+        gchar *trigger;
+
+        trigger = g_strconcat ("language:", gtk_source_language_get_id (new_language), NULL);
+        pluma_plugins_engine_trigger (pluma_plugins_engine_get_default (), trigger);
+        g_free (trigger);
+    }
+}
+
 static void
 notebook_switch_page (GtkNotebook     *book,
                       GtkWidget       *pg,
@@ -2723,10 +2915,6 @@ sync_name (PlumaTab    *tab,
            PlumaWindow *window)
 {
     GtkAction *action;
-    gchar *action_name;
-    gchar *tab_name;
-    gchar *escaped_name;
-    gchar *tip;
     gint n;
     PlumaDocument *doc;
 
@@ -2742,23 +2930,10 @@ sync_name (PlumaTab    *tab,
 
     /* sync the item in the documents list menu */
     n = gtk_notebook_page_num (GTK_NOTEBOOK (window->priv->notebook), GTK_WIDGET (tab));
+    g_return_if_fail (n >= 0 && n < (gint) window->priv->documents_list_actions->len);
 
-    action_name = g_strdup_printf ("Tab_%d", n);
-    action = gtk_action_group_get_action (window->priv->documents_list_action_group,
-                                          action_name);
-    g_free (action_name);
-    g_return_if_fail (action != NULL);
-
-    tab_name = _pluma_tab_get_name (tab);
-    escaped_name = pluma_utils_escape_underscores (tab_name, -1);
-    tip =  get_menu_tip_for_tab (tab);
-
-    g_object_set (action, "label", escaped_name, NULL);
-    g_object_set (action, "tooltip", tip, NULL);
-
-    g_free (tab_name);
-    g_free (escaped_name);
-    g_free (tip);
+    action = g_ptr_array_index (window->priv->documents_list_actions, n);
+    sync_documents_list_item (window, action, tab);
 
     peas_extension_set_call (window->priv->extensions, "update_state");
 }
@@ -3204,6 +3379,48 @@ update_sensitivity_according_to_open_tabs (PlumaWindow *window)
                                     window->priv->num_tabs != 0);
 }
 
+/* Unlike pluma_tab_get_view () this does not create the view of a tab
+ * opened in the background */
+static PlumaView *
+peek_tab_view (PlumaTab *tab)
+{
+    PlumaView *view;
+
+    g_object_get (tab, "view", &view, NULL);
+
+    /* the tab keeps it alive */
+    if (view != NULL)
+        g_object_unref (view);
+
+    return view;
+}
+
+static void
+connect_view_signals (PlumaWindow *window,
+                      PlumaView   *view)
+{
+    g_signal_connect (view,
+                      "toggle_overwrite",
+                      G_CALLBACK (update_overwrite_mode_statusbar),
+                      window);
+    g_signal_connect (view,
+                      "notify::editable",
+                      G_CALLBACK (editable_changed),
+                      window);
+    g_signal_connect (view,
+                      "drop_uris",
+                      G_CALLBACK (drop_uris_cb),
+                      NULL);
+}
+
+static void
+tab_view_created (PlumaTab    *tab,
+                  GParamSpec  *pspec,
+                  PlumaWindow *window)
+{
+    connect_view_signals (window, pluma_tab_get_view (tab));
+}
+
 static void
 notebook_tab_added (PlumaNotebook *notebook,
                     PlumaTab      *tab,
@@ -3220,7 +3437,7 @@ notebook_tab_added (PlumaNotebook *notebook,
 
     update_sensitivity_according_to_open_tabs (window);
 
-    view = pluma_tab_get_view (tab);
+    view = peek_tab_view (tab);
     doc = pluma_tab_get_document (tab);
 
     /* IMPORTANT: remember to disconnect the signal in notebook_tab_removed
@@ -3263,21 +3480,18 @@ notebook_tab_added (PlumaNotebook *notebook,
                       "notify::read-only",
                       G_CALLBACK (readonly_changed),
                       window);
-    g_signal_connect (view,
-                      "toggle_overwrite",
-                      G_CALLBACK (update_overwrite_mode_statusbar),
-                      window);
-    g_signal_connect (view,
-                      "notify::editable",
-                      G_CALLBACK (editable_changed),
-                      window);
 
-    update_documents_list_menu (window);
+    /* the view of a tab opened in the background is created when
+     * the tab is first shown */
+    if (view != NULL)
+        connect_view_signals (window, view);
+    else
+        g_signal_connect (tab,
+                          "notify::view",
+                          G_CALLBACK (tab_view_created),
+                          window);
 
-    g_signal_connect (view,
-                      "drop_uris",
-                      G_CALLBACK (drop_uris_cb),
-                      NULL);
+    update_documents_list_menu (window);
 
     update_window_state (window);
 
@@ -3298,7 +3512,7 @@ notebook_tab_removed (PlumaNotebook *notebook,
 
     --window->priv->num_tabs;
 
-    view = pluma_tab_get_view (tab);
+    view = peek_tab_view (tab);
     doc = pluma_tab_get_document (tab);
 
     g_signal_handlers_disconnect_by_func (tab,
@@ -3307,6 +3521,9 @@ notebook_tab_removed (PlumaNotebook *notebook,
     g_signal_handlers_disconnect_by_func (tab,
                                           G_CALLBACK (sync_state),
                                           window);
+    g_signal_handlers_disconnect_by_func (tab,
+                                          G_CALLBACK (tab_view_created),
+                                          window);
     g_signal_handlers_disconnect_by_func (doc,
                                           G_CALLBACK (update_cursor_position_statusbar),
                                           window);
@@ -3328,15 +3545,20 @@ notebook_tab_removed (PlumaNotebook *notebook,
     g_signal_handlers_disconnect_by_func (doc,
                                           G_CALLBACK (readonly_changed),
                                           window);
-    g_signal_handlers_disconnect_by_func (view,
-                                          G_CALLBACK (update_overwrite_mode_statusbar),
-                                          window);
-    g_signal_handlers_disconnect_by_func (view,
-                                          G_CALLBACK (editable_changed),
-                                          window);
-    g_signal_handlers_disconnect_by_func (view,
-                                          G_CALLBACK (drop_uris_cb),
-                                          NULL);
+    if (view != NULL)
+    {
+        g_signal_handlers_disconnect_by_func (view,
+                                              G_CALLBACK (update_overwrite_mode_statusbar),
+                                              window);
+        g_signal_handlers_disconnect_by_func (view,
+                                              G_CALLBACK (editable_changed),
+                                              window);
+        g_signal_handlers_disconnect_by_func (view,
+                                              G_CALLBACK (drop_uris_cb),
+                                              NULL);
+    }
+
+    forget_documents_list_tab (window, tab);
 
 #if GLIB_CHECK_VERSION(2,62,0)
     if (tab == pluma_window_get_active_tab (window))
@@ -3634,6 +3856,9 @@ side_panel_visibility_changed (GtkWidget   *side_panel,
                             PLUMA_SETTINGS_SIDE_PANE_VISIBLE,
                             visible);
 
+    if (visible)
+        pluma_plugins_engine_trigger (pluma_plugins_engine_get_default (), "panel:side");
+
     action = gtk_action_group_get_action (window->priv->panes_action_group,
                                           "ViewSidePane");
 
@@ -3688,6 +3913,9 @@ bottom_panel_visibility_changed (PlumaPanel  *bottom_panel,
                             PLUMA_SETTINGS_BOTTOM_PANE_VISIBLE,
                             visible);
 
+    if (visible)
+        pluma_plugins_engine_trigger (pluma_plugins_engine_get_default (), "panel:bottom");
+
     action = gtk_action_group_get_action (window->priv->panes_action_group,
                                           "ViewBottomPane");
 
@@ -3855,6 +4083,30 @@ window_unrealized (GtkWidget *window,
                                           window);
 }
 
+static gboolean
+load_idle_plugins (gpointer data)
+{
+    pluma_plugins_engine_trigger (pluma_plugins_engine_get_default (), "idle");
+
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+window_first_draw (GtkWidget *window,
+                   cairo_t   *cr,
+                   gpointer   data)
+{
+    pluma_debug_trace_mark ("first paint");
+
+    /* let the window be painted and be responsive before loading the
+     * plugins which asked to wait */
+    g_idle_add_full (G_PRIORITY_LOW, load_idle_plugins, NULL, NULL);
+
+    g_signal_handlers_disconnect_by_func (window, window_first_draw, data);
+
+    return FALSE;
+}
+
 static void
 check_window_is_active (PlumaWindow *window,
                         GParamSpec *property,
@@ -3959,9 +4211,13 @@ pluma_window_init (PlumaWindow *window)
 {
     GtkWidget *main_box;
     GtkTargetList *tl;
+    GTimer *timer;
 
     pluma_debug (DEBUG_WINDOW);
 
+    pluma_debug_trace_begin ("window creation");
+    timer = g_timer_new ();
+
     window->priv = pluma_window_get_instance_private (window);
     window->priv->active_tab = NULL;
     window->priv->num_tabs = 0;
@@ -3971,6 +4227,7 @@ pluma_window_init (PlumaWindow *window)
     window->priv->fullscreen_controls = NULL;
     window->priv->fullscreen_animation_timeout_id = 0;
     window->priv->editor_settings = g_settings_new (PLUMA_SCHEMA_ID);
+    window->priv->documents_list_actions = g_ptr_array_new_with_free_func (g_object_unref);
 
     window->priv->message_bus = pluma_message_bus_new ();
 
@@ -4073,6 +4330,10 @@ pluma_window_init (PlumaWindow *window)
                       "unrealize",
                       G_CALLBACK (window_unrealized),
                       NULL);
+    g_signal_connect_after (window,
+                            "draw",
+                            G_CALLBACK (window_first_draw),
+                            NULL);
 
     /* Check if the window is active for fullscreen */
     g_signal_connect (window,
@@ -4103,6 +4364,11 @@ pluma_window_init (PlumaWindow *window)
 
     update_sensitivity_according_to_open_tabs (window);
 
+    pluma_debug_message (DEBUG_WINDOW, "Window created in %.3f ms",
+                         g_timer_elapsed (timer, NULL) * 1000);
+    g_timer_destroy (timer);
+    pluma_debug_trace_end ("window creation");
+
     pluma_debug_message (DEBUG_WINDOW, "END");
 }
 
@@ -4300,11 +4566,7 @@ pluma_window_get_documents (PlumaWindow *window)
 static void
 add_view (PlumaTab *tab, GList **res)
 {
-    PlumaView *view;
-
-    view = pluma_tab_get_view (tab);
-
-    *res = g_list_prepend (*res, view);
+    *res = g_list_prepend (*res, pluma_tab_get_view (tab));
 }
 
 /**
@@ -4312,6 +4574,8 @@ add_view (PlumaTab *tab, GList **res)
  * @window: a #PlumaWindow
  *
  * Gets a list with all the views in the window. This list must be freed.
+ * The views of the tabs opened in the background that were never shown
+ * are created by this call.
  *
  * Returns: (element-type Pluma.View) (transfer container): a newly allocated
  * list with all the views in the window
@@ -4332,6 +4596,36 @@ pluma_window_get_views (PlumaWindow *window)
     return res;
 }
 
+static void
+add_created_view (PlumaTab *tab, GList **res)
+{
+    PlumaView *view;
+
+    view = peek_tab_view (tab);
+
+    if (view != NULL)
+        *res = g_list_prepend (*res, view);
+}
+
+/* Like pluma_window_get_views, but leaves out the tabs opened in the
+ * background that have no view yet, for the callers that only update
+ * the existing views, e.g. with settings a new view reads anyway */
+GList *
+_pluma_window_get_created_views (PlumaWindow *window)
+{
+    GList *res = NULL;
+
+    g_return_val_if_fail (PLUMA_IS_WINDOW (window), NULL);
+
+    gtk_container_foreach (GTK_CONTAINER (window->priv->notebook),
+                           (GtkCallback)add_created_view,
+                           &res);
+
+    res = g_list_reverse (res);
+
+    return res;
+}
+
 /**
  * pluma_window_close_tab:
  * @window: a #PlumaWindow
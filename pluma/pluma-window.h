@@ -163,6 +163,8 @@ PlumaMessageBus	*pluma_window_get_message_bus		(PlumaWindow         *window);
  */
 GtkWidget	*_pluma_window_get_notebook		(PlumaWindow         *window);
 
+GList		*_pluma_window_get_created_views	(PlumaWindow         *window);
+
 PlumaWindow	*_pluma_window_move_tab_to_new_window	(PlumaWindow         *window,
 							 PlumaTab            *tab);
 gboolean	 _pluma_window_is_removing_tabs		(PlumaWindow         *window);
@@ -240,102 +240,191 @@ display_open_if_needed (const gchar *name)
 }
 
 /* serverside */
-static void
-on_message_received (const char *message,
-		     gpointer    data)
+
+/* The requests received within this delay are executed together, so that
+ * the files of scripts running pluma for every file are opened at once */
+#define REQUESTS_AGGREGATION_DELAY 50
+
+typedef struct
 {
-	const PlumaEncoding *encoding = NULL;
-	gchar **commands;
-	gchar **params;
+	guint32 timestamp;
+	gchar *display_name;
 	gint workspace;
 	gint viewport_x;
 	gint viewport_y;
-	gchar *display_name;
-	gint i;
-	PlumaApp *app;
-	PlumaWindow *window;
-	GdkDisplay *display;
-	GdkScreen *screen;
 
-	g_return_if_fail (message != NULL);
+	gboolean new_window;
+	gboolean new_document;
 
-	pluma_debug_message (DEBUG_APP, "Received message:\n%s\n", message);
+	gint line_position;
+	const PlumaEncoding *encoding;
+	GSList *files;
+} BaconRequest;
 
-	commands = g_strsplit (message, "\v", -1);
+static GQueue pending_requests = G_QUEUE_INIT;
+static guint pending_requests_id = 0;
 
-	/* header */
-	params = g_strsplit (commands[0], "\t", 6);
-	startup_timestamp = atoi (params[0]);
-	display_name = params[1];
-	workspace = atoi (params[3]);
-	viewport_x = atoi (params[4]);
-	viewport_y = atoi (params[5]);
-
-	display = display_open_if_needed (display_name);
-	if (display == NULL)
+static void
+bacon_request_free (BaconRequest *request)
+{
+	g_free (request->display_name);
+	g_slist_free_full (request->files, g_object_unref);
+	g_slice_free (BaconRequest, request);
+}
+
+/* Cuts str at the first sep and returns the token before it, str is moved
+ * after sep or set to NULL at the end of the string */
+static gchar *
+next_token (gchar **str,
+	    gchar   sep)
+{
+	gchar *token = *str;
+	gchar *end;
+
+	if (token == NULL)
+		return NULL;
+
+	end = strchr (token, sep);
+	if (end != NULL)
 	{
-		g_warning ("Could not open display %s\n", display_name);
-		g_strfreev (params);
-		goto out;
+		*end = '\0';
+		*str = end + 1;
+	}
+	else
+	{
+		*str = NULL;
 	}
 
-	screen = gdk_display_get_default_screen (display);
+	return token;
+}
 
-	g_strfreev (params);
+/* See send_bacon_message () for the format of the message */
+static BaconRequest *
+parse_request (const gchar *message)
+{
+	BaconRequest *request;
+	gchar *copy;
+	gchar *body;
+	gchar *header;
+	gchar *command;
+	gchar *fields[6];
+	guint i;
+
+	copy = g_strdup (message);
+	body = copy;
+
+	header = next_token (&body, '\v');
+	for (i = 0; i < G_N_ELEMENTS (fields); i++)
+	{
+		fields[i] = next_token (&header, '\t');
+
+		if (fields[i] == NULL)
+		{
+			g_warning ("Invalid bacon message");
+			g_free (copy);
 
-	/* body */
-	for (i = 1; commands[i] != NULL; i++)
+			return NULL;
+		}
+	}
+
+	request = g_slice_new0 (BaconRequest);
+	request->timestamp = strtoul (fields[0], NULL, 10);
+	request->display_name = g_strdup (fields[1]);
+	request->workspace = atoi (fields[3]);
+	request->viewport_x = atoi (fields[4]);
+	request->viewport_y = atoi (fields[5]);
+
+	while ((command = next_token (&body, '\v')) != NULL)
 	{
-		params = g_strsplit (commands[i], "\t", -1);
+		gchar *name;
+
+		name = next_token (&command, '\t');
 
-		if (strcmp (params[0], "NEW-WINDOW") == 0)
+		if (strcmp (name, "NEW-WINDOW") == 0)
 		{
-			new_window_option = TRUE;
+			request->new_window = TRUE;
 		}
-		else if (strcmp (params[0], "NEW-DOCUMENT") == 0)
+		else if (strcmp (name, "NEW-DOCUMENT") == 0)
 		{
-			new_document_option = TRUE;
+			request->new_document = TRUE;
 		}
-		else if (strcmp (params[0], "OPEN-URIS") == 0)
+		else if (strcmp (name, "OPEN-URIS") == 0)
 		{
-			gint n_uris, j;
-			gchar **uris;
+			gchar *line;
+			gchar *charset;
+			gchar *uri;
 
-			line_position = atoi (params[1]);
+			line = next_token (&command, '\t');
+			charset = next_token (&command, '\t');
 
-			if (*params[2] != '\0')
-				encoding = pluma_encoding_get_from_charset (params[2]);
+			/* the number of uris is not needed */
+			next_token (&command, '\t');
 
-			n_uris = atoi (params[3]);
-			uris = g_strsplit (params[4], " ", n_uris);
+			if (line != NULL)
+				request->line_position = atoi (line);
 
-			for (j = 0; j < n_uris; j++)
-			{
-				GFile *file;
+			if (charset != NULL && *charset != '\0')
+				request->encoding = pluma_encoding_get_from_charset (charset);
 
-				file = g_file_new_for_uri (uris[j]);
-				file_list = g_slist_prepend (file_list, file);
+			while ((uri = next_token (&command, ' ')) != NULL)
+			{
+				if (*uri != '\0')
+					request->files = g_slist_prepend (request->files,
+									  g_file_new_for_uri (uri));
 			}
-
-			file_list = g_slist_reverse (file_list);
-
-			/* the list takes ownerhip of the strings,
-			 * only free the array */
-			g_free (uris);
 		}
 		else
 		{
 			g_warning ("Unexpected bacon command");
 		}
+	}
+
+	request->files = g_slist_reverse (request->files);
+
+	g_free (copy);
 
-		g_strfreev (params);
+	return request;
+}
+
+/* Whether the files of request can be opened along with the ones of batch */
+static gboolean
+can_merge_requests (BaconRequest *batch,
+		    BaconRequest *request)
+{
+	return batch->files != NULL &&
+	       request->files != NULL &&
+	       !batch->new_window &&
+	       !request->new_window &&
+	       !batch->new_document &&
+	       !request->new_document &&
+	       batch->line_position == request->line_position &&
+	       batch->encoding == request->encoding &&
+	       batch->workspace == request->workspace &&
+	       batch->viewport_x == request->viewport_x &&
+	       batch->viewport_y == request->viewport_y &&
+	       strcmp (batch->display_name, request->display_name) == 0;
+}
+
+static void
+execute_request (BaconRequest *request)
+{
+	PlumaApp *app;
+	PlumaWindow *window;
+	GdkDisplay *display;
+	GdkScreen *screen;
+
+	display = display_open_if_needed (request->display_name);
+	if (display == NULL)
+	{
+		g_warning ("Could not open display %s\n", request->display_name);
+		return;
 	}
 
-	/* execute the commands */
+	screen = gdk_display_get_default_screen (display);
 
 	app = pluma_app_get_default ();
 
-	if (new_window_option)
+	if (request->new_window)
 	{
 		window = pluma_app_create_window (app, screen);
 	}
@@ -344,19 +433,19 @@ on_message_received (const char *message,
 		/* get a window in the current workspace (if exists) and raise it */
 		window = _pluma_app_get_window_in_viewport (app,
 							    screen,
-							    workspace,
-							    viewport_x,
-							    viewport_y);
+							    request->workspace,
+							    request->viewport_x,
+							    request->viewport_y);
 	}
 
-	if (file_list != NULL)
+	if (request->files != NULL)
 	{
 		_pluma_cmd_load_files_from_prompt (window,
-						   file_list,
-						   encoding,
-						   line_position);
+						   request->files,
+						   request->encoding,
+						   request->line_position);
 
-		if (new_document_option)
+		if (request->new_document)
 			pluma_window_create_tab (window, TRUE);
 	}
 	else
@@ -366,7 +455,7 @@ on_message_received (const char *message,
 
 		if (doc == NULL ||
 		    !pluma_document_is_untouched (doc) ||
-		    new_document_option)
+		    request->new_document)
 			pluma_window_create_tab (window, TRUE);
 	}
 
@@ -381,6 +470,8 @@ on_message_received (const char *message,
 
 	if (GDK_IS_X11_DISPLAY (gdk_display_get_default ()))
 	{
+		startup_timestamp = request->timestamp;
+
 		if (startup_timestamp <= 0)
 			startup_timestamp = gdk_x11_get_server_time (gtk_widget_get_window (GTK_WIDGET (window)));
 
@@ -388,12 +479,69 @@ on_message_received (const char *message,
 		gtk_window_present (GTK_WINDOW (window));
 	}
 	else
-		gtk_window_present_with_time (GTK_WINDOW (window), GPOINTER_TO_UINT (data));
+		gtk_window_present_with_time (GTK_WINDOW (window), request->timestamp);
+}
 
- out:
-	g_strfreev (commands);
+static gboolean
+execute_pending_requests (gpointer data)
+{
+	BaconRequest *batch = NULL;
+	BaconRequest *request;
+
+	pending_requests_id = 0;
+
+	while ((request = g_queue_pop_head (&pending_requests)) != NULL)
+	{
+		if (batch != NULL && can_merge_requests (batch, request))
+		{
+			pluma_debug_message (DEBUG_APP, "Merging the request");
+
+			batch->files = g_slist_concat (batch->files, request->files);
+			request->files = NULL;
+			batch->timestamp = MAX (batch->timestamp, request->timestamp);
+
+			bacon_request_free (request);
+			continue;
+		}
+
+		if (batch != NULL)
+		{
+			execute_request (batch);
+			bacon_request_free (batch);
+		}
+
+		batch = request;
+	}
+
+	if (batch != NULL)
+	{
+		execute_request (batch);
+		bacon_request_free (batch);
+	}
 
-	free_command_line_data ();
+	return G_SOURCE_REMOVE;
+}
+
+static void
+on_message_received (const char *message,
+		     gpointer    data)
+{
+	BaconRequest *request;
+
+	g_return_if_fail (message != NULL);
+
+	pluma_debug_message (DEBUG_APP, "Received message:\n%s\n", message);
+
+	request = parse_request (message);
+	if (request == NULL)
+		return;
+
+	g_queue_push_tail (&pending_requests, request);
+
+	if (pending_requests_id == 0)
+		pending_requests_id = g_timeout_add (REQUESTS_AGGREGATION_DELAY,
+						     execute_pending_requests,
+						     NULL);
 }
 
 /* clientside */
@@ -417,6 +565,10 @@ send_bacon_message (void)
 	 * So the delimiters are \v for the commands, \t for the tokens in
 	 * a command and ' ' for the uris: note that such delimiters cannot
 	 * be part of an uri, this way parsing is easier.
+	 *
+	 * The requests received in a short time are executed together, the
+	 * files of consecutive OPEN-URIS requests for the same window being
+	 * opened at once.
 	 */
 
 	pluma_debug (DEBUG_APP);
@@ -511,6 +663,7 @@ main (int argc, char *argv[])
 	/* Setup debugging */
 	pluma_debug_init ();
 	pluma_debug_message (DEBUG_APP, "Startup");
+	pluma_debug_trace_begin ("main");
 
 	setlocale (LC_ALL, "");
 
@@ -589,14 +742,20 @@ main (int argc, char *argv[])
 
 	/* Init plugins engine */
 	pluma_debug_message (DEBUG_APP, "Init plugins");
+	pluma_debug_trace_begin ("plugins engine");
 	engine = pluma_plugins_engine_get_default ();
+	pluma_debug_trace_end ("plugins engine");
 
 	/* Initialize session management */
 	pluma_debug_message (DEBUG_APP, "Init session manager");
 	pluma_session_init ();
 
 	if (pluma_session_is_restored ())
+	{
+		pluma_debug_trace_begin ("session restore");
 		restored = pluma_session_load ();
+		pluma_debug_trace_end ("session restore");
+	}
 
 	if (!restored)
 	{
@@ -637,10 +796,14 @@ main (int argc, char *argv[])
 
 	pluma_debug_message (DEBUG_APP, "Start gtk-main");
 
+	pluma_debug_trace_end ("main");
+
 	gtk_main();
 
 	bacon_message_connection_free (connection);
 
+	pluma_debug_trace_dump ();
+
 	/* We kept the original engine reference here. So let's unref it to
 	 * finalize it properly.
 	 */
@@ -0,0 +1,190 @@
+/*
+ * find-in-files.c
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * pluma is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * pluma is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with pluma; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ */
+
+#include "pluma-find-in-files.h"
+#include "pluma-document.h"
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct
+{
+	GMainLoop *loop;
+	GString *matches;
+} SearchData;
+
+static gchar *root = NULL;
+
+static void
+write_file (const gchar *name,
+	    const gchar *contents,
+	    gssize       len)
+{
+	gchar *filename;
+	gchar *dir;
+
+	filename = g_build_filename (root, name, NULL);
+	dir = g_path_get_dirname (filename);
+
+	g_assert_cmpint (g_mkdir_with_parents (dir, 0755), ==, 0);
+	g_assert (g_file_set_contents (filename, contents, len, NULL));
+
+	g_free (dir);
+	g_free (filename);
+}
+
+static void
+match_cb (PlumaFindInFiles *search,
+	  GFile            *location,
+	  gint              line,
+	  gint              line_offset,
+	  gint              length,
+	  const gchar      *text,
+	  SearchData       *data)
+{
+	gchar *name;
+
+	name = g_file_get_basename (location);
+	g_string_append_printf (data->matches, "%s:%d:%d:%d:%s;",
+				name, line, line_offset, length, text);
+	g_free (name);
+}
+
+static void
+finished_cb (PlumaFindInFiles *search,
+	     SearchData       *data)
+{
+	g_main_loop_quit (data->loop);
+}
+
+static gchar *
+run_search (const gchar *pattern,
+	    guint        flags)
+{
+	PlumaFindInFiles *search;
+	SearchData data;
+	GFile *location;
+
+	data.loop = g_main_loop_new (NULL, FALSE);
+	data.matches = g_string_new (NULL);
+
+	search = pluma_find_in_files_new ();
+	g_signal_connect (search, "match", G_CALLBACK (match_cb), &data);
+	g_signal_connect (search, "finished", G_CALLBACK (finished_cb), &data);
+
+	location = g_file_new_for_path (root);
+	g_assert (pluma_find_in_files_start (search, location, pattern, flags, NULL));
+	g_object_unref (location);
+
+	g_main_loop_run (data.loop);
+
+	g_object_unref (search);
+	g_main_loop_unref (data.loop);
+
+	return g_string_free (data.matches, FALSE);
+}
+
+static void
+test_literal (void)
+{
+	gchar *matches;
+
+	matches = run_search ("foo", PLUMA_SEARCH_CASE_SENSITIVE);
+	g_assert_cmpstr (matches, ==, "a.txt:0:0:3:foo bar;a.txt:2:4:3:baz foo foo;");
+	g_free (matches);
+
+	/* the second match is in a subdirectory */
+	matches = run_search ("FOO", 0);
+	g_assert (strstr (matches, "a.txt:0:0:3:foo bar;") != NULL);
+	g_assert (strstr (matches, "b.c:1:2:3:  FOO;") != NULL);
+	g_free (matches);
+}
+
+static void
+test_regex (void)
+{
+	GFile *location;
+	PlumaFindInFiles *search;
+	GError *error = NULL;
+	gchar *matches;
+
+	matches = run_search ("^b[a-z]+", PLUMA_SEARCH_CASE_SENSITIVE | PLUMA_SEARCH_MATCH_REGEX);
+	g_assert_cmpstr (matches, ==, "a.txt:2:0:3:baz foo foo;");
+	g_free (matches);
+
+	matches = run_search ("fo", PLUMA_SEARCH_ENTIRE_WORD);
+	g_assert_cmpstr (matches, ==, "");
+	g_free (matches);
+
+	search = pluma_find_in_files_new ();
+	location = g_file_new_for_path (root);
+	g_assert (!pluma_find_in_files_start (search, location, "(", PLUMA_SEARCH_MATCH_REGEX, &error));
+	g_assert (error != NULL && error->domain == G_REGEX_ERROR);
+	g_error_free (error);
+	g_object_unref (location);
+	g_object_unref (search);
+}
+
+static void
+test_skipped (void)
+{
+	gchar *matches;
+
+	/* hidden, ignored and binary files */
+	matches = run_search ("skipped", 0);
+	g_assert_cmpstr (matches, ==, "");
+	g_free (matches);
+}
+
+int main (int   argc,
+          char *argv[])
+{
+	gint ret;
+	gchar *cmd;
+
+	g_test_init (&argc, &argv, NULL);
+
+	root = g_dir_make_tmp ("pluma-find-in-files-XXXXXX", NULL);
+	g_assert (root != NULL);
+
+	write_file ("a.txt", "foo bar\nnothing\nbaz foo foo\n", -1);
+	write_file ("sub/b.c", "int x;\n  FOO\n", -1);
+	write_file (".gitignore", "*.log\nbuild/\n", -1);
+	write_file ("c.log", "skipped\n", -1);
+	write_file ("build/d.txt", "skipped\n", -1);
+	write_file (".hidden/e.txt", "skipped\n", -1);
+	write_file ("f.bin", "skipped\0\n", 9);
+
+	g_test_add_func ("/find-in-files/literal", test_literal);
+	g_test_add_func ("/find-in-files/regex", test_regex);
+	g_test_add_func ("/find-in-files/skipped", test_skipped);
+
+	ret = g_test_run ();
+
+	cmd = g_strdup_printf ("rm -rf %s", root);
+	g_assert_cmpint (system (cmd), ==, 0);
+	g_free (cmd);
+	g_free (root);
+
+	return ret;
+}
@@ -0,0 +1,111 @@
+/*
+ * fuzzy-matcher.c
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * pluma is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * pluma is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with pluma; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ */
+
+#include "pluma-fuzzy-matcher.h"
+#include <glib.h>
+
+static gboolean
+match (PlumaFuzzyMatcher *matcher,
+       const gchar       *candidate,
+       gint              *score)
+{
+	return pluma_fuzzy_matcher_match (matcher,
+					  candidate,
+					  pluma_fuzzy_matcher_get_char_mask (candidate),
+					  score);
+}
+
+static void
+test_subsequence (void)
+{
+	PlumaFuzzyMatcher *matcher;
+
+	matcher = pluma_fuzzy_matcher_new ("pfb");
+
+	g_assert (match (matcher, "plugins/filebrowser", NULL));
+	g_assert (match (matcher, "Pluma-File-Browser.c", NULL));
+	g_assert (!match (matcher, "plugins/sort", NULL));
+	g_assert (!match (matcher, "bfp", NULL));
+	g_assert (!match (matcher, "", NULL));
+
+	pluma_fuzzy_matcher_free (matcher);
+}
+
+static void
+test_prefilter (void)
+{
+	PlumaFuzzyMatcher *matcher;
+
+	matcher = pluma_fuzzy_matcher_new ("xyz");
+
+	/* A mask without the query characters rejects the candidate */
+	g_assert (!pluma_fuzzy_matcher_match (matcher,
+					      "x/y/z",
+					      pluma_fuzzy_matcher_get_char_mask ("abc"),
+					      NULL));
+	g_assert (match (matcher, "x/y/z", NULL));
+
+	pluma_fuzzy_matcher_free (matcher);
+}
+
+static void
+test_ranking (void)
+{
+	PlumaFuzzyMatcher *matcher;
+	gint score1;
+	gint score2;
+
+	matcher = pluma_fuzzy_matcher_new ("doc");
+
+	/* Consecutive characters beat scattered ones */
+	g_assert (match (matcher, "src/document.c", &score1));
+	g_assert (match (matcher, "src/dummy-object.c", &score2));
+	g_assert_cmpint (score1, >, score2);
+
+	/* Start of a path component beats the middle of a word */
+	g_assert (match (matcher, "docs/a", &score1));
+	g_assert (match (matcher, "undocumented/a", &score2));
+	g_assert_cmpint (score1, >, score2);
+
+	pluma_fuzzy_matcher_free (matcher);
+
+	matcher = pluma_fuzzy_matcher_new ("fb");
+
+	/* camelCase humps count as word starts */
+	g_assert (match (matcher, "fooBar", &score1));
+	g_assert (match (matcher, "foobar", &score2));
+	g_assert_cmpint (score1, >, score2);
+
+	pluma_fuzzy_matcher_free (matcher);
+}
+
+int main (int   argc,
+          char *argv[])
+{
+	g_test_init (&argc, &argv, NULL);
+
+	g_test_add_func ("/fuzzy-matcher/subsequence", test_subsequence);
+	g_test_add_func ("/fuzzy-matcher/prefilter", test_prefilter);
+	g_test_add_func ("/fuzzy-matcher/ranking", test_ranking);
+
+	return g_test_run ();
+}
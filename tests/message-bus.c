@@ -0,0 +1,231 @@
+/*
+ * message-bus.c
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * pluma is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * pluma is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with pluma; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ */
+
+#include "pluma-message-bus.h"
+#include "pluma-message.h"
+#include <glib.h>
+
+#define OBJECT_PATH "/tests/message-bus"
+
+static const gchar *methods[] = { "high", "default", "low", "state", "drop", "slow", NULL };
+
+static void
+record_cb (PlumaMessageBus *bus,
+	   PlumaMessage    *message,
+	   GString         *log)
+{
+	gint value = 0;
+
+	pluma_message_get (message, "value", &value, NULL);
+	g_string_append_printf (log, "%s:%d;", pluma_message_get_method (message), value);
+
+	if (g_strcmp0 (pluma_message_get_method (message), "slow") == 0)
+		g_usleep (2000);
+}
+
+static PlumaMessageBus *
+create_bus (GString *log)
+{
+	PlumaMessageBus *bus;
+	gint i;
+
+	bus = pluma_message_bus_new ();
+
+	for (i = 0; methods[i] != NULL; ++i)
+	{
+		pluma_message_bus_register (bus, OBJECT_PATH, methods[i], 0,
+					    "value", G_TYPE_INT,
+					    NULL);
+		pluma_message_bus_connect (bus, OBJECT_PATH, methods[i],
+					   (PlumaMessageCallback) record_cb,
+					   log, NULL);
+	}
+
+	pluma_message_bus_set_delivery (bus, OBJECT_PATH, "high",
+					PLUMA_MESSAGE_BUS_PRIORITY_HIGH,
+					PLUMA_MESSAGE_BUS_DELIVERY_QUEUE);
+	pluma_message_bus_set_delivery (bus, OBJECT_PATH, "low",
+					PLUMA_MESSAGE_BUS_PRIORITY_LOW,
+					PLUMA_MESSAGE_BUS_DELIVERY_QUEUE);
+	pluma_message_bus_set_delivery (bus, OBJECT_PATH, "state",
+					PLUMA_MESSAGE_BUS_PRIORITY_DEFAULT,
+					PLUMA_MESSAGE_BUS_DELIVERY_COALESCE);
+	pluma_message_bus_set_delivery (bus, OBJECT_PATH, "drop",
+					PLUMA_MESSAGE_BUS_PRIORITY_DEFAULT,
+					PLUMA_MESSAGE_BUS_DELIVERY_DROPPABLE);
+
+	return bus;
+}
+
+static void
+send_value (PlumaMessageBus *bus,
+            const gchar     *method,
+            gint             value)
+{
+	pluma_message_bus_send (bus, OBJECT_PATH, method, "value", value, NULL);
+}
+
+static void
+flush (PlumaMessageBus *bus)
+{
+	guint depth;
+
+	do
+	{
+		g_main_context_iteration (NULL, TRUE);
+		g_object_get (bus, "queue-depth", &depth, NULL);
+	} while (depth > 0);
+}
+
+static void
+test_lanes (void)
+{
+	PlumaMessageBus *bus;
+	GString *log;
+
+	log = g_string_new (NULL);
+	bus = create_bus (log);
+
+	/* by priority, then in the order in which they were sent */
+	send_value (bus, "low", 1);
+	send_value (bus, "default", 2);
+	send_value (bus, "high", 3);
+	send_value (bus, "low", 4);
+	send_value (bus, "high", 5);
+
+	flush (bus);
+	g_assert_cmpstr (log->str, ==, "high:3;high:5;default:2;low:1;low:4;");
+
+	g_object_unref (bus);
+	g_string_free (log, TRUE);
+}
+
+static void
+test_coalesce (void)
+{
+	PlumaMessageBus *bus;
+	GString *log;
+	guint64 coalesced;
+
+	log = g_string_new (NULL);
+	bus = create_bus (log);
+
+	/* the last value is delivered in the place of the first one */
+	send_value (bus, "state", 1);
+	send_value (bus, "default", 2);
+	send_value (bus, "state", 3);
+	send_value (bus, "state", 4);
+
+	flush (bus);
+	g_assert_cmpstr (log->str, ==, "state:4;default:2;");
+
+	g_object_get (bus, "n-coalesced", &coalesced, NULL);
+	g_assert_cmpuint (coalesced, ==, 2);
+
+	/* once delivered, a new state message is queued again */
+	g_string_truncate (log, 0);
+	send_value (bus, "state", 5);
+
+	flush (bus);
+	g_assert_cmpstr (log->str, ==, "state:5;");
+
+	g_object_unref (bus);
+	g_string_free (log, TRUE);
+}
+
+static void
+test_bound (void)
+{
+	PlumaMessageBus *bus;
+	GString *log;
+	guint64 dropped;
+	guint64 coalesced;
+
+	log = g_string_new (NULL);
+	bus = create_bus (log);
+
+	g_object_set (bus, "max-queued", 2, NULL);
+
+	send_value (bus, "drop", 1);
+	send_value (bus, "default", 2);
+
+	/* the queue is full: droppable messages are lost, the others are
+	 * still queued and the coalescing ones merged */
+	send_value (bus, "drop", 3);
+	send_value (bus, "default", 4);
+	send_value (bus, "state", 5);
+	send_value (bus, "state", 6);
+
+	flush (bus);
+	g_assert_cmpstr (log->str, ==, "drop:1;default:2;default:4;state:6;");
+
+	g_object_get (bus, "n-dropped", &dropped, "n-coalesced", &coalesced, NULL);
+	g_assert_cmpuint (dropped, ==, 1);
+	g_assert_cmpuint (coalesced, ==, 1);
+
+	g_object_unref (bus);
+	g_string_free (log, TRUE);
+}
+
+static void
+test_budget (void)
+{
+	PlumaMessageBus *bus;
+	GString *log;
+	guint depth;
+	gint i;
+
+	log = g_string_new (NULL);
+	bus = create_bus (log);
+
+	for (i = 0; i < 20; ++i)
+		send_value (bus, "slow", i);
+
+	/* each message takes 2ms, one dispatch stops once its time is up */
+	g_main_context_iteration (NULL, TRUE);
+
+	g_object_get (bus, "queue-depth", &depth, NULL);
+	g_assert_cmpuint (depth, >, 0);
+	g_assert_cmpuint (depth, <, 20);
+
+	flush (bus);
+
+	g_object_get (bus, "queue-depth", &depth, NULL);
+	g_assert_cmpuint (depth, ==, 0);
+	g_assert (g_str_has_suffix (log->str, "slow:19;"));
+
+	g_object_unref (bus);
+	g_string_free (log, TRUE);
+}
+
+int main (int   argc,
+          char *argv[])
+{
+	g_test_init (&argc, &argv, NULL);
+
+	g_test_add_func ("/message-bus/lanes", test_lanes);
+	g_test_add_func ("/message-bus/coalesce", test_coalesce);
+	g_test_add_func ("/message-bus/bound", test_bound);
+	g_test_add_func ("/message-bus/budget", test_budget);
+
+	return g_test_run ();
+}
@@ -0,0 +1,94 @@
+/*
+ * multi-matcher.c
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * pluma is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * pluma is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with pluma; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ */
+
+#include "pluma-multi-matcher.h"
+#include <glib.h>
+
+static void
+match_cb (guint    term,
+	  gsize    offset,
+	  gsize    length,
+	  gpointer user_data)
+{
+	g_string_append_printf (user_data, "%u:%u:%u;",
+				term, (guint) offset, (guint) length);
+}
+
+static gchar *
+scan (const gchar * const *terms,
+      gboolean             case_sensitive,
+      const gchar         *text)
+{
+	PlumaMultiMatcher *matcher;
+	GString *matches;
+
+	matches = g_string_new (NULL);
+
+	matcher = pluma_multi_matcher_new (terms, case_sensitive);
+	pluma_multi_matcher_scan (matcher, text, -1, match_cb, matches);
+	pluma_multi_matcher_free (matcher);
+
+	return g_string_free (matches, FALSE);
+}
+
+static void
+test_overlapping (void)
+{
+	const gchar *terms[] = { "he", "she", "his", "hers", NULL };
+	gchar *matches;
+
+	/* Every occurrence of every term in a single pass */
+	matches = scan (terms, TRUE, "ushers");
+	g_assert_cmpstr (matches, ==, "1:1:3;0:2:2;3:2:4;");
+	g_free (matches);
+
+	matches = scan (terms, TRUE, "no match");
+	g_assert_cmpstr (matches, ==, "");
+	g_free (matches);
+}
+
+static void
+test_case (void)
+{
+	const gchar *terms[] = { "ERROR", "warn", "", "Warn", "é", NULL };
+	gchar *matches;
+
+	/* Empty terms never match and repeated terms use the first index */
+	matches = scan (terms, FALSE, "error: WARNING é É");
+	g_assert_cmpstr (matches, ==, "0:0:5;1:7:4;4:15:2;");
+	g_free (matches);
+
+	matches = scan (terms, TRUE, "error: WARNING Warning");
+	g_assert_cmpstr (matches, ==, "3:15:4;");
+	g_free (matches);
+}
+
+int main (int   argc,
+          char *argv[])
+{
+	g_test_init (&argc, &argv, NULL);
+
+	g_test_add_func ("/multi-matcher/overlapping", test_overlapping);
+	g_test_add_func ("/multi-matcher/case", test_case);
+
+	return g_test_run ();
+}
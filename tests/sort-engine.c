@@ -0,0 +1,208 @@
+/*
+ * sort-engine.c
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * pluma is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * pluma is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with pluma; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ */
+
+#include "pluma-sort-engine.h"
+#include <glib.h>
+#include <string.h>
+#include <stdlib.h>
+
+static void
+check_sort (const gchar            *text,
+	    const PlumaSortOptions *options,
+	    const gchar            *expected)
+{
+	gchar *sorted;
+
+	sorted = pluma_sort_lines (text, -1, options);
+	g_assert_cmpstr (sorted, ==, expected);
+	g_free (sorted);
+}
+
+static void
+test_stable (void)
+{
+	PlumaSortOptions options = { PLUMA_SORT_KEY_TEXT, };
+
+	options.ignore_case = TRUE;
+
+	/* equal keys keep the order they had in the text */
+	check_sort ("b\nA\na\nB\n", &options, "A\na\nb\nB\n");
+	check_sort ("B\na\nA\nb\n", &options, "a\nA\nB\nb\n");
+
+	options.reverse = TRUE;
+	check_sort ("b\nA\na\nB\n", &options, "b\nB\nA\na\n");
+
+	options.reverse = FALSE;
+	options.remove_duplicates = TRUE;
+	check_sort ("b\nA\na\nB\n", &options, "A\nb\n");
+}
+
+static void
+test_bytes (void)
+{
+	PlumaSortOptions options = { PLUMA_SORT_KEY_TEXT, };
+
+	/* the text is compared in the collation order by default */
+	g_assert_cmpint (options.mode, ==, 0);
+
+	options.mode = PLUMA_SORT_KEY_BYTES;
+	check_sort ("b\nB\na\nA\n", &options, "A\nB\na\nb\n");
+	check_sort ("\xc3\xa9\nz\ne\n", &options, "e\nz\n\xc3\xa9\n");
+}
+
+static void
+test_natural (void)
+{
+	PlumaSortOptions options = { PLUMA_SORT_KEY_NATURAL, };
+
+	check_sort ("file10\nfile2\nfile1\nfile02\n", &options,
+		    "file1\nfile2\nfile02\nfile10\n");
+	check_sort ("b1\na10\na9\n", &options, "a9\na10\nb1\n");
+}
+
+static void
+test_version (void)
+{
+	PlumaSortOptions options = { PLUMA_SORT_KEY_VERSION, };
+
+	check_sort ("1.10\n1.9\n1.0\n1.0~rc1\n", &options,
+		    "1.0~rc1\n1.0\n1.9\n1.10\n");
+
+	/* letters sort before the other characters */
+	check_sort ("2.0.1\n2.0\n2.0a\n", &options, "2.0\n2.0a\n2.0.1\n");
+}
+
+static void
+test_numeric (void)
+{
+	PlumaSortOptions options = { PLUMA_SORT_KEY_NUMERIC, };
+
+	check_sort ("10\n-2\n3.5\n 7\n", &options, "-2\n3.5\n 7\n10\n");
+
+	/* the lines without a number come first, in text order */
+	check_sort ("10\nxyz\n-2\n\nabc\n", &options, "\nabc\nxyz\n-2\n10\n");
+	check_sort ("inf\n1\nnan\n", &options, "inf\nnan\n1\n");
+
+	/* only the same text makes a line without a number a duplicate */
+	options.remove_duplicates = TRUE;
+	check_sort ("x\n1\ny\nx\n1.0\n", &options, "x\ny\n1\n");
+}
+
+static void
+test_fields (void)
+{
+	PlumaSortOptions options = { PLUMA_SORT_KEY_NUMERIC, };
+
+	options.field = 2;
+	options.delimiter = ',';
+	check_sort ("a,3,x\nb,1,y\nc,2,z\n", &options, "b,1,y\nc,2,z\na,3,x\n");
+
+	/* runs of white space separate the fields, leading blanks are
+	 * skipped; a missing field is empty */
+	options.mode = PLUMA_SORT_KEY_TEXT;
+	options.delimiter = 0;
+	check_sort ("  x  b\ny\ta\nz\n", &options, "z\ny\ta\n  x  b\n");
+
+	options.field = 1;
+	options.start_column = 1;
+	check_sort ("ab\nba\n", &options, "ba\nab\n");
+}
+
+static void
+test_terminators (void)
+{
+	PlumaSortOptions options = { PLUMA_SORT_KEY_TEXT, };
+
+	/* the terminators stay at their position */
+	check_sort ("b\r\na\r\nc", &options, "a\r\nb\r\nc");
+	check_sort ("c\r\nb\na\r\n", &options, "a\r\nb\nc\r\n");
+	check_sort ("b\ra\n", &options, "a\rb\n");
+	check_sort ("", &options, "");
+
+	options.remove_duplicates = TRUE;
+	check_sort ("b\r\na\r\nb\n", &options, "a\r\nb\n");
+}
+
+#define N_LINES 100000
+
+static void
+test_threaded (void)
+{
+	PlumaSortOptions options = { PLUMA_SORT_KEY_NUMERIC, };
+	GString *text;
+	gchar *sorted;
+	gchar **lines;
+	gint i;
+
+	/* enough lines to sort the halves on separate threads */
+	text = g_string_new (NULL);
+
+	for (i = 0; i < N_LINES; ++i)
+	{
+		g_string_append_printf (text, "%d %d\n",
+					g_test_rand_int_range (0, 1000), i);
+	}
+
+	sorted = pluma_sort_lines (text->str, text->len, &options);
+	g_assert_cmpuint (strlen (sorted), ==, text->len);
+
+	lines = g_strsplit (sorted, "\n", -1);
+	g_assert_cmpuint (g_strv_length (lines), ==, N_LINES + 1);
+
+	for (i = 1; i < N_LINES; ++i)
+	{
+		glong key1, key2;
+		glong pos1, pos2;
+		gchar *end;
+
+		key1 = strtol (lines[i - 1], &end, 10);
+		pos1 = strtol (end, NULL, 10);
+		key2 = strtol (lines[i], &end, 10);
+		pos2 = strtol (end, NULL, 10);
+
+		g_assert_cmpint (key1, <=, key2);
+
+		if (key1 == key2)
+			g_assert_cmpint (pos1, <, pos2);
+	}
+
+	g_strfreev (lines);
+	g_free (sorted);
+	g_string_free (text, TRUE);
+}
+
+int main (int   argc,
+          char *argv[])
+{
+	g_test_init (&argc, &argv, NULL);
+
+	g_test_add_func ("/sort-engine/stable", test_stable);
+	g_test_add_func ("/sort-engine/bytes", test_bytes);
+	g_test_add_func ("/sort-engine/natural", test_natural);
+	g_test_add_func ("/sort-engine/version", test_version);
+	g_test_add_func ("/sort-engine/numeric", test_numeric);
+	g_test_add_func ("/sort-engine/fields", test_fields);
+	g_test_add_func ("/sort-engine/terminators", test_terminators);
+	g_test_add_func ("/sort-engine/threaded", test_threaded);
+
+	return g_test_run ();
+}
@@ -0,0 +1,102 @@
+/*
+ * trail-save.c
+ * This file is part of pluma
+ *
+ * Copyright (C) 2012-2021 MATE Developers
+ *
+ * pluma is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * pluma is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with pluma; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ */
+
+#include "pluma-trail-save-strip.h"
+#include <gtk/gtk.h>
+
+/* U+2029 PARAGRAPH SEPARATOR */
+#define PS "\xe2\x80\xa9"
+
+static void
+check_strip (const gchar *text,
+	     gint         first_modified,
+	     gint         last_modified,
+	     const gchar *expected)
+{
+	GtkTextBuffer *buffer;
+	GtkTextTag *tag = NULL;
+	GtkTextIter start, end;
+	gchar *stripped;
+
+	buffer = gtk_text_buffer_new (NULL);
+	gtk_text_buffer_set_text (buffer, text, -1);
+
+	if (first_modified >= 0)
+	{
+		tag = gtk_text_buffer_create_tag (buffer, NULL, NULL);
+
+		gtk_text_buffer_get_iter_at_line (buffer, &start, first_modified);
+		gtk_text_buffer_get_iter_at_line (buffer, &end, last_modified);
+		gtk_text_iter_forward_to_line_end (&end);
+		gtk_text_buffer_apply_tag (buffer, tag, &start, &end);
+	}
+
+	pluma_trail_save_strip_trailing_spaces (buffer, tag);
+
+	gtk_text_buffer_get_bounds (buffer, &start, &end);
+	stripped = gtk_text_buffer_get_slice (buffer, &start, &end, TRUE);
+	g_assert_cmpstr (stripped, ==, expected);
+
+	g_free (stripped);
+	g_object_unref (buffer);
+}
+
+static void
+test_all_lines (void)
+{
+	check_strip ("a  \nb\t\n \nc", -1, -1, "a\nb\n\nc");
+	check_strip ("a \r\nb \rc \n", -1, -1, "a\r\nb\rc\n");
+	check_strip ("no spaces\n", -1, -1, "no spaces\n");
+	check_strip ("", -1, -1, "");
+	check_strip ("end  ", -1, -1, "end");
+}
+
+static void
+test_paragraph_separator (void)
+{
+	/* the lines after a U+2029 keep their text */
+	check_strip ("a " PS "b  \nc\t\n", -1, -1, "a" PS "b\nc\n");
+	check_strip (PS " " PS "x  y \n", -1, -1, PS PS "x  y\n");
+
+	/* U+2028 LINE SEPARATOR does not end a line of the buffer */
+	check_strip ("a \xe2\x80\xa8" "b \n", -1, -1, "a \xe2\x80\xa8" "b\n");
+}
+
+static void
+test_modified_lines (void)
+{
+	check_strip ("a \nb \nc \nd \n", 1, 2, "a \nb\nc\nd \n");
+	check_strip ("a " PS "b " PS "c \n", 2, 2, "a " PS "b " PS "c\n");
+	check_strip ("a " PS "b \nc \n", 1, 1, "a " PS "b\nc \n");
+}
+
+int main (int   argc,
+          char *argv[])
+{
+	g_test_init (&argc, &argv, NULL);
+
+	g_test_add_func ("/trail-save/all-lines", test_all_lines);
+	g_test_add_func ("/trail-save/paragraph-separator", test_paragraph_separator);
+	g_test_add_func ("/trail-save/modified-lines", test_modified_lines);
+
+	return g_test_run ();
+}